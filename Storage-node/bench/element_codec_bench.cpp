@@ -0,0 +1,109 @@
+/**
+ * element_codec_bench.cpp - G1 元素编码格式基准
+ *
+ * 对比 uncompressed_hex 与 compressed_base64 两种格式的文本长度、
+ * 编码耗时与解码耗时（压缩格式解码需要开方恢复y坐标）。
+ *
+ * 用法: ./element_codec_bench [元素个数]
+ */
+
+#include "../../common/element_codec.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 与 StorageNode / StorageClient 一致的 Type A 参数
+const char* kPairingParams =
+    "type a\n"
+    "q 8780710799663312522437781984754049815806883199414208211028653399266475630880222957078625179422662221423155858769582317459277713367317481324925129998224791\n"
+    "h 12016012264891146079388821366740534204802954401251311822919615131047207289359704531102844802183906537786776\n"
+    "r 730750818665451621361119245571504901405976559617\n"
+    "exp2 159\n"
+    "exp1 107\n"
+    "sign1 1\n"
+    "sign0 1\n";
+
+double elapsed_us(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 2000;
+    if (count <= 0) {
+        count = 2000;
+    }
+
+    pairing_t pairing;
+    if (pairing_init_set_buf(pairing, kPairingParams, strlen(kPairingParams)) != 0) {
+        std::cerr << "❌ 配对参数初始化失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "  G1 元素编码格式基准 (" << count << " 个元素)" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    // 随机元素（模拟 TS_F / kt_wi / Ti_bar）
+    std::vector<element_s> elems(count);
+    for (auto& e : elems) {
+        element_init_G1(&e, pairing);
+        element_random(&e);
+    }
+
+    element_t decoded;
+    element_init_G1(decoded, pairing);
+    std::vector<unsigned char> buf;
+
+    const ElementFormat formats[] = {ElementFormat::UncompressedHex, ElementFormat::CompressedBase64};
+    double baseline_len = 0;
+    for (ElementFormat format : formats) {
+        std::vector<std::string> texts(count);
+
+        auto enc_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; ++i) {
+            texts[i] = element_codec::encode(&elems[i], format, buf);
+        }
+        double enc_us = elapsed_us(enc_start);
+
+        auto dec_start = std::chrono::steady_clock::now();
+        int mismatches = 0;
+        for (int i = 0; i < count; ++i) {
+            if (!element_codec::decode(texts[i], decoded, buf) || element_cmp(decoded, &elems[i]) != 0) {
+                mismatches++;
+            }
+        }
+        double dec_us = elapsed_us(dec_start);
+
+        double len = static_cast<double>(texts[0].size());
+        if (baseline_len == 0) {
+            baseline_len = len;
+        }
+
+        std::cout << "\n📦 " << element_codec::format_name(format) << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "   文本长度:   " << texts[0].size() << " 字符 ("
+                  << (100.0 * len / baseline_len) << "%)" << std::endl;
+        std::cout << "   编码:       " << enc_us / count << " us/元素" << std::endl;
+        std::cout << "   解码:       " << dec_us / count << " us/元素" << std::endl;
+        std::cout << "   往返校验:   " << (mismatches == 0 ? "✅ 通过" : "❌ 失败") << std::endl;
+        if (mismatches != 0) {
+            return 1;
+        }
+    }
+
+    element_clear(decoded);
+    for (auto& e : elems) {
+        element_clear(&e);
+    }
+    pairing_clear(pairing);
+    return 0;
+}
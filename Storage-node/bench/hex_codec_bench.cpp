@@ -0,0 +1,198 @@
+/**
+ * hex_codec_bench.cpp - hex 编解码微基准
+ *
+ * 对比原 stringstream/stoi 实现与 common/hex_codec.h 的标量、SSSE3、AVX2 实现，
+ * 并在计时前做一致性与输入校验检查。
+ *
+ * 用法: ./hex_codec_bench [迭代次数]
+ */
+
+#include "../../common/hex_codec.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// ==================== 原实现（对照组） ====================
+
+std::string legacy_bytes_to_hex(const unsigned char* data, size_t len) {
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (size_t i = 0; i < len; ++i) {
+        ss << std::setw(2) << static_cast<int>(data[i]);
+    }
+    return ss.str();
+}
+
+std::vector<unsigned char> legacy_hex_to_bytes(const std::string& hex) {
+    std::vector<unsigned char> bytes;
+    for (size_t i = 0; i < hex.length(); i += 2) {
+        std::string byte_str = hex.substr(i, 2);
+        bytes.push_back(static_cast<unsigned char>(std::stoi(byte_str, nullptr, 16)));
+    }
+    return bytes;
+}
+
+// ==================== 计时辅助 ====================
+
+struct Impl {
+    const char* name;
+    hex_codec::detail::EncodeFn encode;
+    hex_codec::detail::DecodeFn decode;
+};
+
+std::vector<Impl> available_impls() {
+    std::vector<Impl> impls;
+    impls.push_back({"scalar", hex_codec::detail::encode_scalar, hex_codec::detail::decode_scalar});
+#ifdef VDS_HEX_CODEC_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("ssse3")) {
+        impls.push_back({"ssse3", hex_codec::detail::encode_ssse3, hex_codec::detail::decode_ssse3});
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        impls.push_back({"avx2", hex_codec::detail::encode_avx2, hex_codec::detail::decode_avx2});
+    }
+#endif
+    return impls;
+}
+
+template <typename Fn>
+double time_ns_per_op(int iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+volatile size_t g_sink = 0;  // 防止编译器消除被测代码
+
+bool check_correctness(const std::vector<Impl>& impls) {
+    std::mt19937 rng(42);
+    for (size_t len = 0; len <= 300; ++len) {
+        std::vector<unsigned char> data(len);
+        for (auto& b : data) b = static_cast<unsigned char>(rng());
+        std::string expected = legacy_bytes_to_hex(data.data(), len);
+
+        // 大写输入同样合法
+        std::string upper = expected;
+        for (auto& c : upper) c = static_cast<char>(toupper(c));
+
+        for (const Impl& impl : impls) {
+            std::string hex(2 * len, '\0');
+            impl.encode(data.data(), len, &hex[0]);
+            if (hex != expected) {
+                std::cerr << "❌ " << impl.name << " 编码结果错误 (len=" << len << ")" << std::endl;
+                return false;
+            }
+            std::vector<unsigned char> back(len);
+            if (!impl.decode(hex.data(), hex.size(), back.data()) || back != data ||
+                !impl.decode(upper.data(), upper.size(), back.data()) || back != data) {
+                std::cerr << "❌ " << impl.name << " 解码结果错误 (len=" << len << ")" << std::endl;
+                return false;
+            }
+            // 任意位置的非法字符都必须被拒绝
+            if (len > 0) {
+                const char bad_chars[] = {'g', 'G', 'z', ' ', '/', ':', '@', '`', '\0', '\xff'};
+                for (char bad : bad_chars) {
+                    std::string broken = expected;
+                    broken[rng() % broken.size()] = bad;
+                    if (impl.decode(broken.data(), broken.size(), back.data())) {
+                        std::cerr << "❌ " << impl.name << " 未拒绝非法字符 0x" << std::hex
+                                  << (static_cast<int>(bad) & 0xFF) << std::dec << std::endl;
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    std::vector<unsigned char> out;
+    if (hex_codec::decode(std::string("abc"), out)) {
+        std::cerr << "❌ 未拒绝奇数长度输入" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void bench_size(const std::vector<Impl>& impls, size_t len, int iterations) {
+    std::mt19937 rng(7);
+    std::vector<unsigned char> data(len);
+    for (auto& b : data) b = static_cast<unsigned char>(rng());
+    std::string hex = legacy_bytes_to_hex(data.data(), len);
+
+    double legacy_enc = time_ns_per_op(iterations, [&]() {
+        g_sink += legacy_bytes_to_hex(data.data(), len).size();
+    });
+    double legacy_dec = time_ns_per_op(iterations, [&]() {
+        g_sink += legacy_hex_to_bytes(hex).size();
+    });
+
+    std::cout << "\n📏 输入 " << len << " 字节 (" << 2 * len << " hex字符), 迭代 "
+              << iterations << " 次" << std::endl;
+    std::cout << std::left << std::setw(10) << "实现"
+              << std::right << std::setw(14) << "编码 ns/op" << std::setw(10) << "加速"
+              << std::setw(14) << "解码 ns/op" << std::setw(10) << "加速" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(10) << "legacy"
+              << std::right << std::setw(14) << legacy_enc << std::setw(10) << "1.0x"
+              << std::setw(14) << legacy_dec << std::setw(10) << "1.0x" << std::endl;
+
+    std::string out_hex(2 * len, '\0');
+    std::vector<unsigned char> out_bytes(len);
+    for (const Impl& impl : impls) {
+        // 与调用方一致：输出写入复用的缓冲区
+        double enc = time_ns_per_op(iterations, [&]() {
+            impl.encode(data.data(), len, &out_hex[0]);
+            g_sink += static_cast<unsigned char>(out_hex[0]);
+        });
+        double dec = time_ns_per_op(iterations, [&]() {
+            g_sink += impl.decode(hex.data(), hex.size(), out_bytes.data());
+        });
+        std::ostringstream enc_x, dec_x;
+        enc_x << std::fixed << std::setprecision(1) << legacy_enc / enc << "x";
+        dec_x << std::fixed << std::setprecision(1) << legacy_dec / dec << "x";
+        std::cout << std::left << std::setw(10) << impl.name
+                  << std::right << std::setw(14) << enc << std::setw(10) << enc_x.str()
+                  << std::setw(14) << dec << std::setw(10) << dec_x.str() << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+    if (iterations <= 0) {
+        iterations = 200000;
+    }
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Hex 编解码微基准" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "默认实现: " << hex_codec::implementation() << std::endl;
+
+    std::vector<Impl> impls = available_impls();
+    if (!check_correctness(impls)) {
+        return 1;
+    }
+    std::cout << "✅ 一致性检查通过 (";
+    for (size_t i = 0; i < impls.size(); ++i) {
+        std::cout << (i ? ", " : "") << impls[i].name;
+    }
+    std::cout << ")" << std::endl;
+
+    // 32字节: SHA256/状态/指针；128字节: 未压缩G1元素；4096字节: 一个数据块
+    bench_size(impls, 32, iterations);
+    bench_size(impls, 128, iterations);
+    bench_size(impls, 4096, iterations / 20 > 0 ? iterations / 20 : 1);
+
+    return 0;
+}
@@ -0,0 +1,460 @@
+/**
+ * vds_bench.cpp - 密码学原语与序列化辅助函数的微基准
+ *
+ * 直接调用 StorageNode 的实现（computeHashH1/H2/H3、compute_prf、decrypt_pointer、
+ * serializeElement/deserializeElement、bytesToHex/hexToBytes、JSON 读写）以及
+ * G1 幂运算与配对，输入取实际运行中的典型大小。
+ *
+ * 每项先校准批量大小使单次采样不少于 --min-sample-ms，预热一次后采集 --repeat 次，
+ * 报告每次操作耗时的最小值/中位数/均值/p90/最大值/标准差/MAD，以中位数计算吞吐量。
+ *
+ * 用法: ./vds_bench [--repeat N] [--min-sample-ms T] [--filter 子串] [--json 输出文件]
+ *                   [--json-entries N]
+ */
+
+#include "../storage_node.h"
+#include "../../common/perf_metrics.h"
+
+#include <openssl/evp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Options {
+    int repeat = 15;
+    double min_sample_ms = 20;
+    std::string filter;
+    std::string json_file = "vds_bench.json";
+    int json_entries = 1000;
+};
+
+struct BenchResult {
+    std::string name;
+    size_t size_bytes = 0;     // 单次操作的输入大小（0 = 不适用）
+    uint64_t batch = 0;        // 每次采样的操作次数
+    std::vector<double> ns;    // 每次采样的单次操作耗时（纳秒）
+    double min = 0, median = 0, mean = 0, p90 = 0, max = 0, stddev = 0, mad = 0;
+};
+
+volatile size_t g_sink = 0;  // 防止编译器消除被测代码
+
+double quantile(const std::vector<double>& sorted, double q) {
+    double pos = q * static_cast<double>(sorted.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - static_cast<double>(lo));
+}
+
+void summarize(BenchResult& r) {
+    std::vector<double> sorted = r.ns;
+    std::sort(sorted.begin(), sorted.end());
+    r.min = sorted.front();
+    r.max = sorted.back();
+    r.median = quantile(sorted, 0.5);
+    r.p90 = quantile(sorted, 0.9);
+    double sum = 0;
+    for (double v : sorted) {
+        sum += v;
+    }
+    r.mean = sum / static_cast<double>(sorted.size());
+    double var = 0;
+    for (double v : sorted) {
+        var += (v - r.mean) * (v - r.mean);
+    }
+    r.stddev = sorted.size() > 1 ? std::sqrt(var / static_cast<double>(sorted.size() - 1)) : 0;
+    std::vector<double> dev;
+    dev.reserve(sorted.size());
+    for (double v : sorted) {
+        dev.push_back(std::fabs(v - r.median));
+    }
+    std::sort(dev.begin(), dev.end());
+    r.mad = quantile(dev, 0.5);
+}
+
+class Runner {
+public:
+    explicit Runner(const Options& options) : options_(options) {}
+
+    /**
+     * run() - 校准批量 -> 预热 -> 采样，fn 执行一次被测操作
+     */
+    void run(const std::string& name, size_t size_bytes, const std::function<void()>& fn) {
+        if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) {
+            return;
+        }
+
+        BenchResult r;
+        r.name = name;
+        r.size_bytes = size_bytes;
+
+        // 校准：批量翻倍直到单次采样达到 min_sample_ms
+        uint64_t batch = 1;
+        uint64_t target_ns = static_cast<uint64_t>(options_.min_sample_ms * 1e6);
+        while (true) {
+            uint64_t elapsed = time_batch(fn, batch);
+            if (elapsed >= target_ns || batch >= (1ull << 30)) {
+                break;
+            }
+            uint64_t scale = elapsed > 0 ? target_ns / elapsed + 1 : 2;
+            batch *= std::min<uint64_t>(std::max<uint64_t>(scale, 2), 16);
+        }
+        r.batch = batch;
+
+        time_batch(fn, batch);  // 预热
+        for (int i = 0; i < options_.repeat; ++i) {
+            r.ns.push_back(static_cast<double>(time_batch(fn, batch)) / static_cast<double>(batch));
+        }
+        summarize(r);
+        print(r);
+        results_.push_back(std::move(r));
+    }
+
+    bool write_json(const std::string& path) const {
+        Json::Value root;
+        root["benchmark"] = "vds_bench";
+        std::time_t now = std::time(nullptr);
+        char stamp[32];
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", std::localtime(&now));
+        root["timestamp"] = stamp;
+        root["config"]["repeat"] = options_.repeat;
+        root["config"]["min_sample_ms"] = options_.min_sample_ms;
+        root["config"]["json_entries"] = options_.json_entries;
+
+        Json::Value list(Json::arrayValue);
+        for (const auto& r : results_) {
+            Json::Value item;
+            item["name"] = r.name;
+            item["size_bytes"] = static_cast<Json::UInt64>(r.size_bytes);
+            item["batch"] = static_cast<Json::UInt64>(r.batch);
+            item["samples"] = static_cast<int>(r.ns.size());
+            item["ns_per_op"]["min"] = r.min;
+            item["ns_per_op"]["median"] = r.median;
+            item["ns_per_op"]["mean"] = r.mean;
+            item["ns_per_op"]["p90"] = r.p90;
+            item["ns_per_op"]["max"] = r.max;
+            item["ns_per_op"]["stddev"] = r.stddev;
+            item["ns_per_op"]["mad"] = r.mad;
+            item["ops_per_sec"] = r.median > 0 ? 1e9 / r.median : 0.0;
+            if (r.size_bytes > 0 && r.median > 0) {
+                item["mb_per_sec"] = static_cast<double>(r.size_bytes) / r.median * 1e9 / (1024.0 * 1024.0);
+            }
+            list.append(item);
+        }
+        root["results"] = list;
+
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            return false;
+        }
+        Json::StreamWriterBuilder writer;
+        writer["indentation"] = "  ";
+        out << Json::writeString(writer, root) << "\n";
+        return out.good();
+    }
+
+private:
+    static uint64_t time_batch(const std::function<void()>& fn, uint64_t batch) {
+        uint64_t start = perf_metrics::now_ns();
+        for (uint64_t i = 0; i < batch; ++i) {
+            fn();
+        }
+        return perf_metrics::now_ns() - start;
+    }
+
+    static void print(const BenchResult& r) {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1);
+        line << "   " << std::left << std::setw(34) << r.name << std::right
+             << std::setw(14) << r.median << " ns"
+             << "  (min " << r.min << ", p90 " << r.p90
+             << ", MAD " << std::setprecision(1) << (r.median > 0 ? 100.0 * r.mad / r.median : 0) << "%)";
+        std::cout << line.str() << std::endl;
+    }
+
+    const Options& options_;
+    std::vector<BenchResult> results_;
+};
+
+std::string random_bytes(std::mt19937_64& rng, size_t len) {
+    std::string out(len, '\0');
+    for (auto& c : out) {
+        c = static_cast<char>(rng() & 0xff);
+    }
+    return out;
+}
+
+std::string random_hex(std::mt19937_64& rng, size_t hex_len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out(hex_len, '0');
+    for (auto& c : out) {
+        c = digits[rng() & 0xf];
+    }
+    return out;
+}
+
+// ID_F = H1(C) 的十进制表示（SHA-256 摘要小于 N，约 77 位十进制数）
+std::string random_file_id(std::mt19937_64& rng) {
+    std::string out(77, '0');
+    for (auto& c : out) {
+        c = static_cast<char>('0' + rng() % 10);
+    }
+    out[0] = static_cast<char>('1' + rng() % 9);
+    return out;
+}
+
+// 与客户端 encryptPointer 相同的构造（AES-256-CBC，零IV，密钥取状态哈希前32字节），
+// 该函数在 StorageClient 中为私有成员，这里按相同调用序列复现以便对照 decrypt_pointer
+std::string encrypt_pointer(const std::string& current_state_hash, const std::string& previous_state) {
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) {
+        return "";
+    }
+    unsigned char key[32] = {0};
+    size_t key_hex_len = std::min<size_t>(current_state_hash.length(), 64) & ~static_cast<size_t>(1);
+    if (!hex_codec::decode(current_state_hash.data(), key_hex_len, key)) {
+        EVP_CIPHER_CTX_free(ctx);
+        return "";
+    }
+    unsigned char iv[16] = {0};
+    std::vector<unsigned char> ciphertext(previous_state.size() + EVP_CIPHER_block_size(EVP_aes_256_cbc()));
+    int len = 0;
+    int total_len = 0;
+    if (EVP_EncryptInit_ex(ctx, EVP_aes_256_cbc(), nullptr, key, iv) != 1 ||
+        EVP_EncryptUpdate(ctx, ciphertext.data(), &len,
+                          reinterpret_cast<const unsigned char*>(previous_state.data()),
+                          static_cast<int>(previous_state.size())) != 1) {
+        EVP_CIPHER_CTX_free(ctx);
+        return "";
+    }
+    total_len = len;
+    if (EVP_EncryptFinal_ex(ctx, ciphertext.data() + len, &len) != 1) {
+        EVP_CIPHER_CTX_free(ctx);
+        return "";
+    }
+    total_len += len;
+    EVP_CIPHER_CTX_free(ctx);
+    return hex_codec::encode(ciphertext.data(), static_cast<size_t>(total_len));
+}
+
+// 与 index_db.json 结构一致的 JSON（每个文件：ID_F、PK、state、file_path、TS_F、keywords）
+Json::Value make_index_json(StorageNode& node, int entries, std::mt19937_64& rng) {
+    element_t e;
+    element_init_G1(e, node.pairing);
+    auto g1_text = [&]() {
+        element_random(e);
+        return node.serializeElement(e);
+    };
+
+    Json::Value root;
+    root["element_format"] = element_codec::format_name(node.element_format);
+    Json::Value database(Json::arrayValue);
+    for (int i = 0; i < entries; ++i) {
+        Json::Value f;
+        f["ID_F"] = random_file_id(rng);
+        f["PK"] = g1_text();
+        f["state"] = "valid";
+        f["file_path"] = "data/EncFiles/" + f["ID_F"].asString() + ".enc";
+        for (int t = 0; t < 8; ++t) {
+            f["TS_F"].append(g1_text());
+        }
+        for (int k = 0; k < 3; ++k) {
+            Json::Value kw;
+            kw["ptr_i"] = random_hex(rng, 96);
+            kw["kt_wi"] = g1_text();
+            kw["Ti_bar"] = g1_text();
+            f["keywords"].append(kw);
+        }
+        database.append(f);
+    }
+    root["database"] = database;
+    element_clear(e);
+    return root;
+}
+
+bool parse_args(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--repeat" && has_value) {
+            options.repeat = std::max(3, std::atoi(argv[++i]));
+        } else if (arg == "--min-sample-ms" && has_value) {
+            options.min_sample_ms = std::max(0.1, std::atof(argv[++i]));
+        } else if (arg == "--filter" && has_value) {
+            options.filter = argv[++i];
+        } else if (arg == "--json" && has_value) {
+            options.json_file = argv[++i];
+        } else if (arg == "--json-entries" && has_value) {
+            options.json_entries = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "用法: " << argv[0] << " [--repeat N] [--min-sample-ms T] [--filter 子串]"
+                      << " [--json 输出文件] [--json-entries N]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        return 1;
+    }
+
+    fs::path work_dir = fs::temp_directory_path() / ("vds_bench_" + std::to_string(getpid()));
+    fs::create_directories(work_dir);
+
+    StorageNode node(work_dir.string());
+    {
+        // Setup 会打印参数信息，基准输出中不需要
+        std::ostringstream quiet;
+        std::streambuf* saved = std::cout.rdbuf(quiet.rdbuf());
+        bool ok = node.setup_cryptography(160, "");
+        std::cout.rdbuf(saved);
+        if (!ok) {
+            std::cerr << "❌ 密码学参数初始化失败" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "  VDS 原语微基准 (" << options.repeat << " 次采样, 每次 >= "
+              << options.min_sample_ms << " ms)" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    Runner runner(options);
+    std::mt19937_64 rng(42);
+
+    mpz_t scalar;
+    mpz_init(scalar);
+    element_t a, b, out;
+    element_init_G1(a, node.pairing);
+    element_init_G1(b, node.pairing);
+    element_init_G1(out, node.pairing);
+    element_t gt;
+    element_init_GT(gt, node.pairing);
+    element_random(a);
+    element_random(b);
+
+    // ==================== 哈希与PRF ====================
+    std::cout << "\n🔑 哈希与PRF" << std::endl;
+    const std::string id_f = random_file_id(rng);
+    const std::string seed = random_hex(rng, 64);
+    const std::string state = random_hex(rng, 64);
+    const std::string chunk_4k = random_bytes(rng, 4 * 1024);
+    const std::string chunk_1m = random_bytes(rng, 1024 * 1024);
+    const std::string h2_input = id_f + "17";
+
+    runner.run("computeHashH1/4KiB", chunk_4k.size(), [&]() { node.computeHashH1(chunk_4k, scalar); });
+    runner.run("computeHashH1/1MiB", chunk_1m.size(), [&]() { node.computeHashH1(chunk_1m, scalar); });
+    runner.run("computeHashH2/ID_F||i", h2_input.size(), [&]() { node.computeHashH2(h2_input, out); });
+    runner.run("computeHashH3/state", state.size(), [&]() {
+        g_sink += node.computeHashH3(state).size();
+    });
+    std::string prf_buf;
+    int prf_index = 0;
+    runner.run("compute_prf", seed.size() + id_f.size(), [&]() {
+        node.compute_prf(scalar, seed, id_f, prf_index++ & 0xff, prf_buf);
+    });
+
+    // ==================== 群运算 ====================
+    std::cout << "\n🧮 群运算" << std::endl;
+    node.compute_prf(scalar, seed, id_f, 1, prf_buf);
+    runner.run("element_pow_mpz/G1", 0, [&]() { element_pow_mpz(out, a, scalar); });
+    runner.run("element_mul/G1", 0, [&]() { element_mul(out, a, b); });
+    runner.run("pairing_apply", 0, [&]() { pairing_apply(gt, a, b, node.pairing); });
+
+    // ==================== 指针加解密 ====================
+    std::cout << "\n🔐 指针加解密" << std::endl;
+    const std::string state_hash = node.computeHashH3(state);
+    const std::string prev_state = random_hex(rng, 64);
+    const std::string pointer = encrypt_pointer(state_hash, prev_state);
+    if (node.decrypt_pointer(state_hash, pointer) != prev_state) {
+        std::cerr << "❌ 指针往返校验失败" << std::endl;
+        return 1;
+    }
+    runner.run("encryptPointer", prev_state.size(), [&]() {
+        g_sink += encrypt_pointer(state_hash, prev_state).size();
+    });
+    runner.run("decrypt_pointer", pointer.size(), [&]() {
+        g_sink += node.decrypt_pointer(state_hash, pointer).size();
+    });
+
+    // ==================== 序列化 ====================
+    std::cout << "\n📦 序列化" << std::endl;
+    std::vector<unsigned char> buf;
+    const ElementFormat formats[] = {ElementFormat::CompressedBase64, ElementFormat::UncompressedHex};
+    for (ElementFormat format : formats) {
+        node.element_format = format;
+        const std::string suffix = std::string("/") + element_codec::format_name(format);
+        std::string text = node.serializeElement(a, buf);
+        if (!node.deserializeElement(text, out, buf) || element_cmp(out, a) != 0) {
+            std::cerr << "❌ 元素往返校验失败: " << suffix << std::endl;
+            return 1;
+        }
+        runner.run("serializeElement" + suffix, 0, [&]() { g_sink += node.serializeElement(a, buf).size(); });
+        runner.run("deserializeElement" + suffix, text.size(), [&]() {
+            g_sink += node.deserializeElement(text, out, buf);
+        });
+    }
+    node.element_format = node.default_element_format;
+
+    const std::string raw_32 = random_bytes(rng, 32);
+    const std::string raw_4k = chunk_4k;
+    const std::string hex_32 = node.bytesToHex(reinterpret_cast<const unsigned char*>(raw_32.data()), raw_32.size());
+    const std::string hex_4k = node.bytesToHex(reinterpret_cast<const unsigned char*>(raw_4k.data()), raw_4k.size());
+    runner.run("bytesToHex/32B", raw_32.size(), [&]() {
+        g_sink += node.bytesToHex(reinterpret_cast<const unsigned char*>(raw_32.data()), raw_32.size()).size();
+    });
+    runner.run("bytesToHex/4KiB", raw_4k.size(), [&]() {
+        g_sink += node.bytesToHex(reinterpret_cast<const unsigned char*>(raw_4k.data()), raw_4k.size()).size();
+    });
+    std::vector<unsigned char> bytes;
+    runner.run("hexToBytes/32B", hex_32.size(), [&]() { node.hexToBytes(hex_32, bytes); g_sink += bytes.size(); });
+    runner.run("hexToBytes/4KiB", hex_4k.size(), [&]() { node.hexToBytes(hex_4k, bytes); g_sink += bytes.size(); });
+
+    // ==================== JSON 读写 ====================
+    std::cout << "\n📝 JSON 读写 (" << options.json_entries << " 个文件条目)" << std::endl;
+    Json::Value index_json = make_index_json(node, options.json_entries, rng);
+    const std::string json_path = (work_dir / "index_bench.json").string();
+    if (!node.save_json_to_file(index_json, json_path)) {
+        return 1;
+    }
+    size_t json_size = static_cast<size_t>(fs::file_size(json_path));
+    runner.run("save_json_to_file", json_size, [&]() { g_sink += node.save_json_to_file(index_json, json_path); });
+    runner.run("load_json_from_file", json_size, [&]() { g_sink += node.load_json_from_file(json_path).size(); });
+
+    element_clear(gt);
+    element_clear(out);
+    element_clear(b);
+    element_clear(a);
+    mpz_clear(scalar);
+
+    std::error_code ec;
+    fs::remove_all(work_dir, ec);
+
+    if (!runner.write_json(options.json_file)) {
+        std::cerr << "❌ 结果写入失败: " << options.json_file << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ 结果已保存: " << options.json_file << std::endl;
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "storage_node.h"
+#include "node_server.h"
 #include <iostream>
 #include <csignal>
 #include <cstring>
@@ -6,12 +7,18 @@
 #include <iomanip>
 
 StorageNode* g_node = nullptr;
+NodeServer* g_server = nullptr;
 
 // ============================================================================
 // 信号处理和程序控制
 // ============================================================================
 
 void signal_handler(int signal) {
+    // 服务模式：只通知事件循环退出，由主线程回收线程并保存数据
+    if (g_server) {
+        g_server->request_stop();
+        return;
+    }
     std::cout << "\n\n🛑 正在优雅地关闭存储节点..." << std::endl;
     if (g_node) {
         g_node->save_index_database();
@@ -53,9 +60,12 @@ void print_menu() {
     std::cout << "║     5  插入文件 (需要JSON参数)                           ║" << std::endl;
     std::cout << "║     6  检索文件                                          ║" << std::endl;
     std::cout << "║     7  删除文件 (从JSON)                                 ║" << std::endl;
+    std::cout << "║     18 批量删除文件 (目录，一次提交)                     ║" << std::endl;
+    std::cout << "║     19 回收已删除文件的存储空间                          ║" << std::endl;
     std::cout << "║                                                          ║" << std::endl;
     std::cout << "║  🔍 搜索功能                                              ║" << std::endl;
     std::cout << "║     8  搜索关键词关联文件证明 (完整搜索)                 ║" << std::endl;
+    std::cout << "║     16 批量搜索证明 (目录/线程池)                        ║" << std::endl;
     std::cout << "║                                                          ║" << std::endl;
     std::cout << "║  🔐 证明与验证                                            ║" << std::endl;
     std::cout << "║     9  获取文件证明 (输入文件ID)                        ║" << std::endl;
@@ -68,10 +78,13 @@ void print_menu() {
     std::cout << "║     14 导出文件元数据                                   ║" << std::endl;
     std::cout << "║     15 查看详细状态                                     ║" << std::endl;
     std::cout << "║                                                          ║" << std::endl;
+    std::cout << "║  🌐 服务模式                                              ║" << std::endl;
+    std::cout << "║     17 启动TCP服务 (Ctrl+C 停止)                        ║" << std::endl;
+    std::cout << "║                                                          ║" << std::endl;
     std::cout << "║     0  退出程序                                          ║" << std::endl;
     std::cout << "║                                                          ║" << std::endl;
     std::cout << "╚══════════════════════════════════════════════════════════╝" << std::endl;
-    std::cout << "\n👉 请输入选项 [0-15]: ";
+    std::cout << "\n👉 请输入选项 [0-19]: ";
 }
 
 // ============================================================================
@@ -257,16 +270,23 @@ void handle_insert_file(StorageNode* node) {
     std::cout << "       ├─ kt_wi: 关键词标签（必需）" << std::endl;
     std::cout << "       └─ ptr_i: 指针（可选）" << std::endl;
     
-    std::cout << "\n📂 请输入参数JSON文件路径: ";
+    std::cout << "\n💡 也可直接输入客户端生成的 .vdsb 插入请求包（包含参数与密文）" << std::endl;
+    
+    std::cout << "\n📂 请输入插入请求包或参数JSON文件路径: ";
     clear_input_buffer();
     std::getline(std::cin, param_json_path);
     
-    std::cout << "📂 请输入加密文件路径: ";
-    std::getline(std::cin, enc_file_path);
+    bool is_bundle = insert_bundle::is_bundle(param_json_path);
+    if (!is_bundle) {
+        std::cout << "📂 请输入加密文件路径: ";
+        std::getline(std::cin, enc_file_path);
+    }
     
     std::cout << "\n⏳ 正在插入文件..." << std::endl;
     
-    if (node->insert_file(param_json_path, enc_file_path)) {
+    bool inserted = is_bundle ? node->insert_bundle(param_json_path)
+                              : node->insert_file(param_json_path, enc_file_path);
+    if (inserted) {
         std::cout << "\n✅ 文件插入成功!" << std::endl;
         std::cout << "   ├─ 文件已存储" << std::endl;
         std::cout << "   ├─ 索引已更新" << std::endl;
@@ -366,6 +386,60 @@ void handle_delete_file_from_json(StorageNode* node) {
     wait_for_enter();
 }
 
+void handle_batch_delete_from_dir(StorageNode* node) {
+    print_section_header("批量删除文件 (目录)", "🗑️");
+    
+    std::string delete_dir;
+    
+    std::cout << "\n💡 说明:" << std::endl;
+    std::cout << "   ├─ 目录下每个 *.json 为一个删除请求 (ID_F, PK, del)" << std::endl;
+    std::cout << "   ├─ 数据库只加载一次，kt_wi 按群运算除去 del" << std::endl;
+    std::cout << "   └─ 全部修改一次提交，单个请求失败不影响其他请求" << std::endl;
+    
+    std::cout << "\n📂 请输入删除请求目录: ";
+    clear_input_buffer();
+    std::getline(std::cin, delete_dir);
+    
+    std::cout << "\n⚠️  警告: 此操作将标记目录中所有文件为无效并更新相关索引!" << std::endl;
+    char confirm;
+    std::cout << "❓ 确认删除? (y/n): ";
+    std::cin >> confirm;
+    
+    if (confirm == 'y' || confirm == 'Y') {
+        if (node->delete_files_from_dir(delete_dir)) {
+            std::cout << "\n✅ 批量删除完成!" << std::endl;
+        } else {
+            std::cout << "\n❌ 批量删除存在失败的请求!" << std::endl;
+        }
+    } else {
+        std::cout << "\n🚫 操作已取消" << std::endl;
+    }
+    
+    wait_for_enter();
+}
+
+void handle_compact_deleted_files(StorageNode* node) {
+    print_section_header("回收已删除文件", "🧹");
+    
+    std::cout << "\n💡 说明:" << std::endl;
+    std::cout << "   ├─ 删除已删除文件的密文，元数据缩减为墓碑记录" << std::endl;
+    std::cout << "   └─ 搜索链节点保留，搜索与验证结果不变" << std::endl;
+    
+    std::cout << "\n📊 待回收文件: " << node->get_pending_compaction_count() << std::endl;
+    
+    CompactionStats run;
+    if (node->compact_deleted_files(&run)) {
+        CompactionStats totals = node->get_compaction_stats();
+        std::cout << "\n✅ 回收完成!" << std::endl;
+        std::cout << "   ├─ 本次回收: " << run.files << " 个文件, " << run.total_bytes() << " 字节" << std::endl;
+        std::cout << "   └─ 累计回收: " << totals.files << " 个文件, " << totals.total_bytes() << " 字节" << std::endl;
+    } else {
+        std::cout << "\n❌ 回收失败!" << std::endl;
+    }
+    
+    wait_for_enter();
+}
+
 // ============================================================================
 // 搜索功能处理函数
 // ============================================================================
@@ -378,7 +452,9 @@ void handle_search_keywords_proof(StorageNode* node) {
     std::cout << "\n💡 JSON文件格式说明:" << std::endl;
     std::cout << "   ├─ PK: 客户端公钥" << std::endl;
     std::cout << "   ├─ T: 搜索令牌" << std::endl;
-    std::cout << "   └─ std: 最新状态" << std::endl;
+    std::cout << "   ├─ std: 最新状态" << std::endl;
+    std::cout << "   ├─ budget_ms / max_hops: 可选，搜索预算（超出返回部分证明）" << std::endl;
+    std::cout << "   └─ continuation: 可选，上一段证明返回的续传令牌" << std::endl;
     
     std::cout << "\n📂 请输入搜索参数JSON文件路径: ";
     clear_input_buffer();
@@ -398,6 +474,36 @@ void handle_search_keywords_proof(StorageNode* node) {
     wait_for_enter();
 }
 
+void handle_batch_search_proof(StorageNode* node) {
+    print_section_header("批量搜索证明 (目录)", "🔍");
+    
+    std::string search_dir;
+    int num_threads = 0;
+    
+    std::cout << "\n💡 说明:" << std::endl;
+    std::cout << "   ├─ 目录下每个 *.json 为一个搜索请求 (PK, T, std)" << std::endl;
+    std::cout << "   ├─ 数据库只加载一次，请求在线程池中并行执行" << std::endl;
+    std::cout << "   └─ 证明保存到 SearchProof/[T].json" << std::endl;
+    
+    std::cout << "\n📂 请输入搜索请求目录: ";
+    clear_input_buffer();
+    std::getline(std::cin, search_dir);
+    
+    std::cout << "🧵 请输入线程数 (0 = 自动): ";
+    std::cin >> num_threads;
+    if (std::cin.fail()) {
+        num_threads = 0;
+    }
+    
+    if (node->SearchKeywordsBatchProofFromDir(search_dir, num_threads)) {
+        std::cout << "\n✅ 批量搜索完成!" << std::endl;
+    } else {
+        std::cout << "\n❌ 批量搜索存在失败的请求!" << std::endl;
+    }
+    
+    wait_for_enter();
+}
+
 // ============================================================================
 // 证明与验证处理函数
 // ============================================================================
@@ -605,6 +711,79 @@ void handle_detailed_status(StorageNode* node) {
     wait_for_enter();
 }
 
+// ============================================================================
+// 服务模式
+// ============================================================================
+
+/**
+ * run_service() - 在 server_port 上运行TCP服务，直到收到 SIGINT/SIGTERM
+ * @param num_workers 工作线程数（<=0 表示使用硬件并发数）
+ * @param record_dir 非空时把每个请求录制到该目录（见 common/op_trace.h）
+ * @return 服务正常启动并退出返回true
+ */
+bool run_service(StorageNode* node, int num_workers, const std::string& record_dir = "") {
+    NodeServer server(node, node->get_server_port(), num_workers, node->get_bind_address());
+    if (!record_dir.empty()) {
+        std::string error;
+        if (!server.start_recording(record_dir, error)) {
+            std::cerr << "   └─ ❌ 请求录制开启失败: " << error << std::endl;
+            return false;
+        }
+    }
+    if (!server.start()) {
+        return false;
+    }
+    g_server = &server;
+    if (node->get_bind_address() != "127.0.0.1") {
+        std::cout << "   ├─ ⚠️  监听非本机地址：删除/回收/上传/取回请求不需要认证，请用防火墙限制访问" << std::endl;
+    }
+    std::cout << "   ├─ 协议: 长度前缀帧（见 common/node_protocol.h）" << std::endl;
+    if (!record_dir.empty()) {
+        std::cout << "   ├─ 请求录制: " << record_dir << "/" << op_trace::kTraceFile << std::endl;
+    }
+    std::cout << "   └─ 按 Ctrl+C 停止服务" << std::endl;
+    
+    // 服务期间在后台回收已删除文件（config.json storage.compaction_interval_sec）
+    node->start_compactor();
+    
+    server.wait();
+    g_server = nullptr;
+    node->stop_compactor();
+    
+    NodeServer::Stats stats = server.stats();
+    std::cout << "\n📊 服务统计" << std::endl;
+    std::cout << "   ├─ 连接数:   " << stats.connections_accepted << std::endl;
+    std::cout << "   ├─ 请求数:   " << stats.requests << " (失败 " << stats.failed_requests << ")" << std::endl;
+    std::cout << "   ├─ 接收字节: " << stats.bytes_in << std::endl;
+    std::cout << "   " << (record_dir.empty() ? "└─" : "├─") << " 发送字节: " << stats.bytes_out << std::endl;
+    if (!record_dir.empty()) {
+        std::cout << "   └─ 录制请求: " << server.recorded_requests() << std::endl;
+    }
+    
+    node->save_index_database();
+    node->save_search_database();
+    node->save_node_info();
+    return true;
+}
+
+void handle_start_service(StorageNode* node) {
+    print_section_header("启动TCP服务", "🌐");
+    
+    std::string input;
+    std::cout << "\n🧵 工作线程数 (直接按 Enter 使用硬件并发数): ";
+    clear_input_buffer();
+    std::getline(std::cin, input);
+    int num_workers = input.empty() ? 0 : std::atoi(input.c_str());
+    
+    std::cout << "\n⏳ 正在启动服务 (端口 " << node->get_server_port() << ")..." << std::endl;
+    if (!run_service(node, num_workers)) {
+        std::cout << "\n❌ 服务启动失败!" << std::endl;
+    }
+    
+    std::cout << "\n⏎ 按 Enter 继续...";
+    std::cin.get();
+}
+
 // ============================================================================
 // 主程序
 // ============================================================================
@@ -618,13 +797,27 @@ int main(int argc, char* argv[]) {
     std::string data_dir = "../data";
     int port = 9000;
     
-    // 解析命令行参数
+    bool serve_mode = false;
+    int serve_workers = 0;
+    std::string record_dir;
+    
+    // 解析命令行参数: storage_node [data_dir] [port] [--serve [workers]] [--record trace_dir]
     if (argc > 1) {
         data_dir = argv[1];
     }
     if (argc > 2) {
         port = std::atoi(argv[2]);
     }
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--serve") == 0) {
+            serve_mode = true;
+            if (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0) {
+                serve_workers = std::atoi(argv[++i]);
+            }
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_dir = argv[++i];
+        }
+    }
     
     // 显示欢迎横幅
     print_banner();
@@ -712,6 +905,13 @@ int main(int argc, char* argv[]) {
         // 显示初始状态
         g_node->print_status();
         
+        // 非交互服务模式
+        if (serve_mode) {
+            bool ok = run_service(g_node, serve_workers, record_dir);
+            delete g_node;
+            return ok ? 0 : 1;
+        }
+        
         // ========================================
         // 主菜单循环
         // ========================================
@@ -723,7 +923,7 @@ int main(int argc, char* argv[]) {
             std::cin >> choice;
             
             if (std::cin.fail()) {
-                std::cout << "\n❌ 输入无效，请输入数字 0-17" << std::endl;
+                std::cout << "\n❌ 输入无效，请输入数字 0-19" << std::endl;
                 clear_input_buffer();
                 wait_for_enter();
                 continue;
@@ -740,9 +940,12 @@ int main(int argc, char* argv[]) {
                 case 5:  handle_insert_file(g_node);              break;
                 case 6:  handle_retrieve_file(g_node);            break;
                 case 7:  handle_delete_file_from_json(g_node);    break;
+                case 18: handle_batch_delete_from_dir(g_node);    break;
+                case 19: handle_compact_deleted_files(g_node);    break;
                 
                 // 搜索功能
                 case 8:  handle_search_keywords_proof(g_node);    break;
+                case 16: handle_batch_search_proof(g_node);       break;
                 
                 // 证明与验证
                 case 9: handle_get_file_proof(g_node);           break;
@@ -755,6 +958,9 @@ int main(int argc, char* argv[]) {
                 case 14: handle_export_metadata(g_node);          break;
                 case 15: handle_detailed_status(g_node);          break;
                 
+                // 服务模式
+                case 17: handle_start_service(g_node);            break;
+                
                 // 退出
                 case 0:
                     std::cout << "\n╔══════════════════════════════════════════════════════════╗" << std::endl;
@@ -769,7 +975,7 @@ int main(int argc, char* argv[]) {
                     return 0;
                 
                 default:
-                    std::cout << "\n❌ 无效选项，请选择 0-17" << std::endl;
+                    std::cout << "\n❌ 无效选项，请选择 0-19" << std::endl;
                     wait_for_enter();
             }
         }
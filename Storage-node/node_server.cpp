@@ -0,0 +1,789 @@
+#include "node_server.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <set>
+
+namespace {
+
+// 单次可读事件最多读取的字节数，避免大上传独占事件循环（水平触发，未读完会再次通知）
+constexpr size_t kMaxReadPerEvent = 4 * 1024 * 1024;
+constexpr int kMaxEvents = 128;
+// 空闲上传会话的检查间隔（开启 upload_idle_timeout_sec 时事件循环按此周期醒来）
+constexpr int kUploadReapIntervalMs = 10000;
+
+Json::Value error_response(const Json::Value& id, const std::string& message) {
+    Json::Value response;
+    response["id"] = id;
+    response["ok"] = false;
+    response["error"] = message;
+    return response;
+}
+
+Json::Value compaction_json(const CompactionStats& stats) {
+    Json::Value out;
+    out["runs"] = static_cast<Json::UInt64>(stats.runs);
+    out["files"] = static_cast<Json::UInt64>(stats.files);
+    out["ciphertext_bytes"] = static_cast<Json::UInt64>(stats.ciphertext_bytes);
+    out["metadata_bytes"] = static_cast<Json::UInt64>(stats.metadata_bytes);
+    out["index_bytes"] = static_cast<Json::UInt64>(stats.index_bytes);
+    out["reclaimed_bytes"] = static_cast<Json::UInt64>(stats.total_bytes());
+    out["elapsed_ms"] = stats.elapsed_ms;
+    return out;
+}
+
+// 延迟直方图只按已知操作名分组，其余归入 "unknown"，避免任意请求撑大统计表
+const std::string& latency_metric(const std::string& op) {
+    static const std::set<std::string> known = {
+        "ping", "status", "memory", "insert", "upload_begin", "upload_append", "upload_commit",
+        "upload_abort", "delete", "delete_batch", "compact", "search", "file_proof",
+        "verify_search", "verify_file", "retrieve"};
+    static const std::string unknown = "unknown";
+    auto it = known.find(op);
+    return it == known.end() ? unknown : *it;
+}
+
+} // namespace
+
+// ==================== 构造函数和析构函数 ====================
+
+NodeServer::NodeServer(StorageNode* node, int port, int num_workers, const std::string& bind_address)
+    : node_(node),
+      requested_port_(port),
+      port_(port),
+      num_workers_(num_workers),
+      bind_address_(bind_address),
+      listen_fd_(-1),
+      epoll_fd_(-1),
+      wakeup_fd_(-1),
+      running_(false),
+      stopping_(false),
+      next_conn_id_(kFirstConnectionId),
+      reap_queued_(false),
+      connections_accepted_(0),
+      connections_open_(0),
+      requests_(0),
+      failed_requests_(0),
+      bytes_in_(0),
+      bytes_out_(0) {
+    if (num_workers_ <= 0) {
+        num_workers_ = static_cast<int>(std::thread::hardware_concurrency());
+        if (num_workers_ <= 0) {
+            num_workers_ = 4;
+        }
+    }
+}
+
+NodeServer::~NodeServer() {
+    if (running_) {
+        stop();
+    }
+}
+
+// ==================== 启动与停止 ====================
+
+bool NodeServer::start() {
+    if (running_) {
+        std::cerr << "❌ 服务已在运行" << std::endl;
+        return false;
+    }
+    if (!node_ || !node_->crypto_initialized) {
+        std::cerr << "❌ 密码学系统未初始化，无法启动服务" << std::endl;
+        return false;
+    }
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "❌ 创建监听套接字失败: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(requested_port_));
+    if (inet_pton(AF_INET, bind_address_.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "❌ 无效的监听地址: " << bind_address_ << std::endl;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, SOMAXCONN) != 0) {
+        std::cerr << "❌ 绑定端口 " << requested_port_ << " 失败: " << std::strerror(errno) << std::endl;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    if (getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) == 0) {
+        port_ = ntohs(addr.sin_port);
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || wakeup_fd_ < 0) {
+        std::cerr << "❌ 创建 epoll/eventfd 失败: " << std::strerror(errno) << std::endl;
+        wait();
+        return false;
+    }
+
+    epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = kListenerId;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &ev);
+    ev.data.u64 = kWakeupId;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &ev);
+
+    stopping_ = false;
+    running_ = true;
+    for (int i = 0; i < num_workers_; ++i) {
+        workers_.emplace_back(&NodeServer::worker_loop, this);
+    }
+    loop_thread_ = std::thread(&NodeServer::event_loop, this);
+
+    std::cout << "🌐 存储节点服务已启动: " << bind_address_ << ":" << port_
+              << " (工作线程 " << num_workers_ << ")" << std::endl;
+    return true;
+}
+
+void NodeServer::request_stop() {
+    stopping_ = true;
+    wake();
+}
+
+void NodeServer::wait() {
+    if (loop_thread_.joinable()) {
+        loop_thread_.join();
+    }
+    // 未处理的请求直接丢弃；维护任务（关闭时放弃上传等）在工作线程退出后补做
+    std::vector<Task> maintenance;
+    {
+        std::lock_guard<std::mutex> lock(task_mutex_);
+        stopping_ = true;
+        for (auto& task : tasks_) {
+            if (task.kind != Task::Kind::Request) {
+                maintenance.push_back(std::move(task));
+            }
+        }
+        tasks_.clear();
+    }
+    task_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+    completions_.clear();
+    for (const auto& task : maintenance) {
+        run_maintenance(task);
+    }
+
+    for (int* fd : {&listen_fd_, &epoll_fd_, &wakeup_fd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    if (running_) {
+        running_ = false;
+        std::cout << "🛑 存储节点服务已停止" << std::endl;
+    }
+}
+
+void NodeServer::stop() {
+    request_stop();
+    wait();
+}
+
+NodeServer::Stats NodeServer::stats() const {
+    Stats s;
+    s.connections_accepted = connections_accepted_.load();
+    s.connections_open = connections_open_.load();
+    s.requests = requests_.load();
+    s.failed_requests = failed_requests_.load();
+    s.bytes_in = bytes_in_.load();
+    s.bytes_out = bytes_out_.load();
+    return s;
+}
+
+bool NodeServer::start_recording(const std::string& trace_dir, std::string& error) {
+    if (running_) {
+        error = "服务已启动，录制须在 start() 之前开启";
+        return false;
+    }
+    auto recorder = std::make_unique<op_trace::Recorder>();
+    if (!recorder->open(trace_dir, error)) {
+        return false;
+    }
+    recorder_ = std::move(recorder);
+    return true;
+}
+
+void NodeServer::wake() {
+    if (wakeup_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t n = ::write(wakeup_fd_, &one, sizeof(one));
+        (void)n;
+    }
+}
+
+// ==================== 事件循环 ====================
+
+void NodeServer::event_loop() {
+    epoll_event events[kMaxEvents];
+    int timeout_ms = node_->upload_idle_timeout_sec > 0 ? kUploadReapIntervalMs : -1;
+    uint64_t last_reap_ns = perf_metrics::now_ns();
+    while (!stopping_) {
+        int n = epoll_wait(epoll_fd_, events, kMaxEvents, timeout_ms);
+        if (timeout_ms > 0 && perf_metrics::elapsed_ms(last_reap_ns) >= kUploadReapIntervalMs) {
+            // 上一轮回收尚未完成时不再重复投递
+            if (!reap_queued_.exchange(true)) {
+                post_maintenance(Task::Kind::ReapUploads, 0);
+            }
+            last_reap_ns = perf_metrics::now_ns();
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "❌ epoll_wait 失败: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        for (int i = 0; i < n && !stopping_; ++i) {
+            uint64_t id = events[i].data.u64;
+            uint32_t mask = events[i].events;
+
+            if (id == kListenerId) {
+                accept_connections();
+                continue;
+            }
+            if (id == kWakeupId) {
+                uint64_t value;
+                ssize_t r = ::read(wakeup_fd_, &value, sizeof(value));
+                (void)r;
+                drain_completions();
+                continue;
+            }
+
+            auto it = connections_.find(id);
+            if (it == connections_.end()) {
+                continue;
+            }
+            if (mask & EPOLLERR) {
+                close_connection(id);
+                continue;
+            }
+            if (mask & (EPOLLIN | EPOLLHUP | EPOLLRDHUP)) {
+                handle_readable(it->second);
+                it = connections_.find(id);
+                if (it == connections_.end()) {
+                    continue;
+                }
+            }
+            if (mask & EPOLLOUT) {
+                flush(it->second);
+            }
+        }
+    }
+
+    std::vector<uint64_t> ids;
+    for (const auto& kv : connections_) {
+        ids.push_back(kv.first);
+    }
+    for (uint64_t id : ids) {
+        close_connection(id);
+    }
+}
+
+void NodeServer::accept_connections() {
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "⚠️  accept 失败: " << std::strerror(errno) << std::endl;
+            }
+            return;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        uint64_t id = next_conn_id_++;
+        Connection& conn = connections_[id];
+        conn.fd = fd;
+        conn.id = id;
+
+        epoll_event ev;
+        std::memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.u64 = id;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            std::cerr << "⚠️  注册连接失败: " << std::strerror(errno) << std::endl;
+            ::close(fd);
+            connections_.erase(id);
+            continue;
+        }
+        connections_accepted_++;
+        connections_open_++;
+    }
+}
+
+void NodeServer::handle_readable(Connection& conn) {
+    char chunk[64 * 1024];
+    size_t total = 0;
+    while (total < kMaxReadPerEvent) {
+        ssize_t n = ::recv(conn.fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            conn.in.append(chunk, static_cast<size_t>(n));
+            total += static_cast<size_t>(n);
+            continue;
+        }
+        if (n == 0) {
+            conn.peer_closed = true;
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        close_connection(conn.id);
+        return;
+    }
+    bytes_in_ += total;
+
+    uint64_t id = conn.id;
+    dispatch_frames(conn);
+    auto it = connections_.find(id);
+    if (it == connections_.end()) {
+        return;
+    }
+    Connection& c = it->second;
+    if (c.peer_closed) {
+        // 对端不再发送：停止监听读事件，等在途请求的响应写完后关闭
+        c.reading = false;
+        update_interest(c);
+        if (c.in_flight == 0 && c.out_offset >= c.out.size()) {
+            close_connection(id);
+        }
+    }
+}
+
+void NodeServer::dispatch_frames(Connection& conn) {
+    size_t offset = 0;
+    while (conn.in_flight < kMaxInFlightPerConnection) {
+        size_t consumed, json_begin, json_len, payload_len;
+        node_protocol::ParseStatus st = node_protocol::parse_frame(
+            conn.in.data() + offset, conn.in.size() - offset, node_protocol::kDefaultMaxFrameBytes,
+            consumed, json_begin, json_len, payload_len);
+        if (st == node_protocol::ParseStatus::NeedMore) {
+            break;
+        }
+        if (st == node_protocol::ParseStatus::Error) {
+            std::cerr << "⚠️  连接 " << conn.id << " 发送了非法帧，已断开" << std::endl;
+            close_connection(conn.id);
+            return;
+        }
+        const char* frame = conn.in.data() + offset;
+        Task task;
+        task.conn_id = conn.id;
+        if (recorder_) {
+            task.received_ns = perf_metrics::now_ns();
+        }
+        task.json.assign(frame + json_begin, json_len);
+        task.payload.assign(frame + json_begin + json_len, payload_len);
+        {
+            std::lock_guard<std::mutex> lock(task_mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        task_cv_.notify_one();
+        conn.in_flight++;
+        requests_++;
+        offset += consumed;
+    }
+    if (offset > 0) {
+        conn.in.erase(0, offset);
+    }
+
+    // 背压：在途请求达到上限时暂停读取该连接
+    bool want_read = !conn.peer_closed && conn.in_flight < kMaxInFlightPerConnection;
+    if (want_read != conn.reading) {
+        conn.reading = want_read;
+        update_interest(conn);
+    }
+}
+
+bool NodeServer::flush(Connection& conn) {
+    while (conn.out_offset < conn.out.size()) {
+        ssize_t n = ::send(conn.fd, conn.out.data() + conn.out_offset,
+                           conn.out.size() - conn.out_offset, MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.out_offset += static_cast<size_t>(n);
+            bytes_out_ += static_cast<uint64_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!conn.writing) {
+                conn.writing = true;
+                update_interest(conn);
+            }
+            return true;
+        }
+        close_connection(conn.id);
+        return false;
+    }
+
+    conn.out.clear();
+    conn.out_offset = 0;
+    if (conn.writing) {
+        conn.writing = false;
+        update_interest(conn);
+    }
+    if (conn.peer_closed && conn.in_flight == 0) {
+        close_connection(conn.id);
+        return false;
+    }
+    return true;
+}
+
+void NodeServer::update_interest(Connection& conn) {
+    epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = 0;
+    if (conn.reading) ev.events |= EPOLLIN | EPOLLRDHUP;
+    if (conn.writing) ev.events |= EPOLLOUT;
+    ev.data.u64 = conn.id;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn.fd, &ev);
+}
+
+void NodeServer::close_connection(uint64_t conn_id) {
+    auto it = connections_.find(conn_id);
+    if (it == connections_.end()) {
+        return;
+    }
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    ::close(it->second.fd);
+    connections_.erase(it);
+    connections_open_--;
+    
+    // 连接上未提交的分块上传无法再继续，交给工作线程删除临时文件并释放会话
+    // （关闭时仍在执行的 upload_begin 建立的会话由空闲超时回收）
+    post_maintenance(Task::Kind::AbortUploads, conn_id);
+}
+
+void NodeServer::post_maintenance(Task::Kind kind, uint64_t conn_id) {
+    Task task;
+    task.kind = kind;
+    task.conn_id = conn_id;
+    {
+        std::lock_guard<std::mutex> lock(task_mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    task_cv_.notify_one();
+}
+
+void NodeServer::run_maintenance(const Task& task) {
+    if (task.kind == Task::Kind::AbortUploads) {
+        size_t aborted = node_->abort_uploads_of(task.conn_id);
+        if (aborted > 0) {
+            std::cout << "   连接 " << task.conn_id << " 已关闭，放弃 " << aborted << " 个未完成的上传" << std::endl;
+        }
+    } else if (task.kind == Task::Kind::ReapUploads) {
+        node_->reap_idle_uploads();
+        reap_queued_ = false;
+    }
+}
+
+void NodeServer::drain_completions() {
+    std::vector<Completion> done;
+    {
+        std::lock_guard<std::mutex> lock(completion_mutex_);
+        done.swap(completions_);
+    }
+    for (auto& completion : done) {
+        auto it = connections_.find(completion.conn_id);
+        if (it == connections_.end()) {
+            continue;  // 连接已关闭，丢弃响应
+        }
+        Connection& conn = it->second;
+        conn.in_flight--;
+        conn.out.append(completion.frame);
+        if (!flush(conn)) {
+            continue;
+        }
+        // 在途请求低于上限后继续处理已缓冲的请求帧
+        if (!conn.reading && !conn.peer_closed) {
+            dispatch_frames(conn);
+        }
+    }
+}
+
+// ==================== 工作线程 ====================
+
+void NodeServer::worker_loop() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(task_mutex_);
+            task_cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        if (task.kind != Task::Kind::Request) {
+            run_maintenance(task);
+            continue;
+        }
+
+        uint64_t start_ns = perf_metrics::now_ns();
+        Json::Value request;
+        Json::Value response;
+        std::string response_payload;
+        std::string error;
+        if (!node_protocol::parse_json_text(task.json.data(), task.json.size(), request, error)) {
+            response = error_response(0, "请求JSON解析失败: " + error);
+        } else {
+            try {
+                response = handle_request(request, task.payload, response_payload, task.conn_id);
+            } catch (const std::exception& e) {
+                response = error_response(request.get("id", 0), std::string("请求处理异常: ") + e.what());
+                response_payload.clear();
+            }
+        }
+        if (!response.get("ok", false).asBool()) {
+            failed_requests_++;
+        }
+        uint64_t end_ns = perf_metrics::now_ns();
+        latency_.record_ns(latency_metric(request.get("op", "").asString()), end_ns - start_ns);
+
+        Completion completion;
+        completion.conn_id = task.conn_id;
+        std::string response_json = node_protocol::to_json_text(response);
+        node_protocol::append_frame(response_json, response_payload.data(),
+                                    response_payload.size(), completion.frame);
+        if (recorder_) {
+            recorder_->record(task.conn_id, task.received_ns, start_ns, end_ns, request, task.payload,
+                              response, response_json.size() + response_payload.size());
+        }
+        {
+            std::lock_guard<std::mutex> lock(completion_mutex_);
+            completions_.push_back(std::move(completion));
+        }
+        wake();
+    }
+}
+
+// ==================== 请求分发 ====================
+
+Json::Value NodeServer::handle_request(const Json::Value& request, const std::string& payload,
+                                       std::string& response_payload, uint64_t conn_id) {
+    const Json::Value id = request.get("id", 0);
+    const std::string op = request.get("op", "").asString();
+
+    Json::Value response;
+    response["id"] = id;
+    response["ok"] = false;
+    Json::Value result(Json::objectValue);
+
+    if (op == "ping") {
+        result["node_id"] = node_->get_node_id();
+        response["ok"] = true;
+
+    } else if (op == "status") {
+        result["node_id"] = node_->get_node_id();
+        result["file_count"] = static_cast<Json::UInt64>(node_->get_file_count());
+        result["search_index_count"] = static_cast<Json::UInt64>(node_->get_search_index_count());
+        result["uploads"] = static_cast<Json::UInt64>(node_->get_upload_count());
+        {
+            auto lock = node_->read_lock();
+            result["element_format"] = element_codec::format_name(node_->element_format);
+        }
+        result["pending_compaction"] = static_cast<Json::UInt64>(node_->get_pending_compaction_count());
+        result["compaction"] = compaction_json(node_->get_compaction_stats());
+        result["latency"] = latency_.to_json();
+        response["ok"] = true;
+
+    } else if (op == "memory") {
+        // 需要遍历全部数据库估算占用（O(N)，期间持有读锁），不放在 status 中
+        result["node_id"] = node_->get_node_id();
+        result["memory"] = node_->get_memory_usage().to_json();
+        response["ok"] = true;
+
+    } else if (op == "insert") {
+        bool ok;
+        std::string ID_F;
+        if (request.isMember("params")) {
+            // 旧版形式：insert.json 参数 + 密文负载
+            ID_F = request["params"].get("ID_F", "").asString();
+            ok = node_->insert_from_params(request["params"], payload);
+        } else {
+            insert_bundle::Bundle bundle;
+            std::string error;
+            if (!insert_bundle::parse(payload, bundle, error)) {
+                return error_response(id, "请求包解析失败: " + error);
+            }
+            ID_F = bundle.ID_F;
+            ok = node_->insert_from_bundle(bundle);
+        }
+        if (!ok) {
+            return error_response(id, "插入失败");
+        }
+        result["ID_F"] = ID_F;
+        response["ok"] = true;
+
+    } else if (op == "upload_begin") {
+        // 分块上传：元数据来自 params（insert.json）或仅含元数据的请求包负载
+        uint64_t size = request.get("size", 0).asUInt64();
+        std::string upload_id;
+        bool ok;
+        if (request.isMember("params")) {
+            ok = node_->begin_upload(request["params"], size, upload_id, conn_id);
+        } else {
+            insert_bundle::Bundle header;
+            std::string error;
+            if (!insert_bundle::parse(payload, header, error)) {
+                return error_response(id, "请求包解析失败: " + error);
+            }
+            ok = node_->begin_upload(header, size, upload_id, conn_id);
+        }
+        if (!ok) {
+            return error_response(id, "上传创建失败");
+        }
+        result["upload_id"] = upload_id;
+        response["ok"] = true;
+
+    } else if (op == "upload_append") {
+        std::string upload_id = request.get("upload_id", "").asString();
+        uint64_t offset = request.get("offset", 0).asUInt64();
+        if (!node_->append_upload(upload_id, offset, payload.data(), payload.size())) {
+            return error_response(id, "分块追加失败");
+        }
+        result["received"] = static_cast<Json::UInt64>(offset + payload.size());
+        response["ok"] = true;
+
+    } else if (op == "upload_commit") {
+        std::string upload_id = request.get("upload_id", "").asString();
+        std::shared_ptr<UploadSession> session = node_->find_upload(upload_id);
+        if (!session || !node_->commit_upload(upload_id)) {
+            return error_response(id, "上传提交失败");
+        }
+        result["ID_F"] = session->entry.ID_F;
+        response["ok"] = true;
+
+    } else if (op == "upload_abort") {
+        node_->abort_upload(request.get("upload_id", "").asString());
+        response["ok"] = true;
+
+    } else if (op == "delete") {
+        if (!node_->delete_file(request["params"])) {
+            return error_response(id, "删除失败");
+        }
+        result["ID_F"] = request["params"].get("ID_F", "").asString();
+        response["ok"] = true;
+
+    } else if (op == "delete_batch") {
+        const Json::Value& params = request["params"];
+        if (!params.isArray()) {
+            return error_response(id, "params 必须为删除参数数组");
+        }
+        std::vector<Json::Value> params_list(params.begin(), params.end());
+        std::vector<DeleteResult> results;
+        node_->delete_files_batch(params_list, &results);
+
+        Json::UInt64 deleted = 0;
+        Json::Value items(Json::arrayValue);
+        for (const DeleteResult& res : results) {
+            Json::Value item;
+            item["ID_F"] = res.ID_F;
+            item["ok"] = res.success;
+            if (res.success) {
+                deleted++;
+            } else {
+                item["error"] = res.error;
+            }
+            items.append(item);
+        }
+        result["deleted"] = deleted;
+        result["failed"] = static_cast<Json::UInt64>(results.size() - deleted);
+        result["results"] = items;
+        response["ok"] = true;
+
+    } else if (op == "compact") {
+        CompactionStats run;
+        if (!node_->compact_deleted_files(&run)) {
+            return error_response(id, "回收失败");
+        }
+        result = compaction_json(run);
+        response["ok"] = true;
+
+    } else if (op == "search") {
+        SearchProofResult proof = node_->ComputeSearchProof(request["params"]);
+        if (!proof.success) {
+            return error_response(id, "搜索证明生成失败");
+        }
+        result = proof.to_json();
+        response["ok"] = true;
+
+    } else if (op == "file_proof") {
+        FileProofResult proof = node_->ComputeFileProof(request.get("ID_F", "").asString());
+        if (!proof.success) {
+            return error_response(id, "文件证明生成失败");
+        }
+        result = proof.to_json();
+        response["ok"] = true;
+
+    } else if (op == "verify_search") {
+        SearchProofResult proof = SearchProofResult::from_json(request["proof"]);
+        if (!proof.success) {
+            return error_response(id, "搜索证明格式错误");
+        }
+        result["valid"] = node_->VerifySearchProof(proof);
+        response["ok"] = true;
+
+    } else if (op == "verify_file") {
+        FileProofResult proof = FileProofResult::from_json(request["proof"]);
+        if (!proof.success) {
+            return error_response(id, "文件证明格式错误");
+        }
+        result["valid"] = node_->VerifyFileProof(proof);
+        response["ok"] = true;
+
+    } else if (op == "retrieve") {
+        std::string ID_F = request.get("ID_F", "").asString();
+        if (!node_->has_file(ID_F) || !node_->load_encrypted_file(ID_F, response_payload)) {
+            return error_response(id, "文件不存在: " + ID_F);
+        }
+        result["ID_F"] = ID_F;
+        result["size"] = static_cast<Json::UInt64>(response_payload.size());
+        response["ok"] = true;
+
+    } else {
+        return error_response(id, "未知操作: " + op);
+    }
+
+    response["result"] = result;
+    return response;
+}
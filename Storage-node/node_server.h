@@ -0,0 +1,201 @@
+#ifndef NODE_SERVER_H
+#define NODE_SERVER_H
+
+#include "storage_node.h"
+#include "../common/node_protocol.h"
+#include "../common/perf_metrics.h"
+#include "../common/op_trace.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// ==================== 存储节点TCP服务 ====================
+/**
+ * @brief 基于 epoll 的存储节点服务（协议见 common/node_protocol.h）
+ *
+ * 线程模型：
+ *   - 事件循环线程：accept、非阻塞读写、切分请求帧
+ *   - 工作线程池：执行插入/删除/搜索/证明/验证，结果放入完成队列
+ *   - 完成队列通过 eventfd 唤醒事件循环，由事件循环写回响应
+ * 并发由 StorageNode 的读写锁保证：搜索/证明/验证在工作线程间并行，插入/删除串行。
+ */
+class NodeServer {
+public:
+    struct Stats {
+        uint64_t connections_accepted = 0;
+        uint64_t connections_open = 0;
+        uint64_t requests = 0;
+        uint64_t failed_requests = 0;
+        uint64_t bytes_in = 0;
+        uint64_t bytes_out = 0;
+    };
+
+    /**
+     * @param node 已完成初始化的存储节点（不转移所有权）
+     * @param port 监听端口（0 表示由系统分配，启动后用 port() 查询）
+     * @param num_workers 工作线程数（<=0 表示使用硬件并发数）
+     * @param bind_address 监听地址（默认只监听本机：协议中的删除、回收、上传与取回都不需要认证）
+     */
+    NodeServer(StorageNode* node, int port, int num_workers = 0,
+               const std::string& bind_address = "127.0.0.1");
+    ~NodeServer();
+
+    NodeServer(const NodeServer&) = delete;
+    NodeServer& operator=(const NodeServer&) = delete;
+
+    /**
+     * start() - 绑定端口并启动事件循环与工作线程（立即返回）
+     * @return 成功返回true，失败返回false
+     */
+    bool start();
+
+    /**
+     * request_stop() - 请求停止服务（只写原子变量与eventfd，可在信号处理函数中调用）
+     */
+    void request_stop();
+
+    /**
+     * wait() - 等待事件循环退出并回收工作线程
+     */
+    void wait();
+
+    /**
+     * stop() - request_stop() + wait()
+     */
+    void stop();
+
+    int port() const { return port_; }
+    bool running() const { return running_.load(); }
+    Stats stats() const;
+
+    /**
+     * latency() - 按操作名汇总的请求处理延迟直方图（工作线程内 handle_request 的耗时）
+     */
+    const perf_metrics::Registry& latency() const { return latency_; }
+
+    /**
+     * start_recording() - 把之后的每个请求录制到 trace_dir（格式见 common/op_trace.h），须在 start() 之前调用
+     * @param trace_dir 录制目录（requests.jsonl + payloads/）
+     * @param error 失败时的错误描述
+     * @return 成功返回true
+     */
+    bool start_recording(const std::string& trace_dir, std::string& error);
+
+    /**
+     * recorded_requests() - 已录制的请求数（未开启录制时为0）
+     */
+    uint64_t recorded_requests() const { return recorder_ ? recorder_->count() : 0; }
+
+    /**
+     * handle_request() - 执行单个请求（工作线程调用）
+     * @param request 请求JSON
+     * @param payload 请求负载
+     * @param response_payload 输出的响应负载
+     * @param conn_id 发起请求的连接ID（upload_begin 记录为会话所有者，0 表示不属于任何连接）
+     * @return 响应JSON
+     */
+    Json::Value handle_request(const Json::Value& request, const std::string& payload,
+                               std::string& response_payload, uint64_t conn_id = 0);
+
+    // 单连接最多同时执行的请求数，超出后暂停读取该连接（背压）
+    static constexpr size_t kMaxInFlightPerConnection = 64;
+
+private:
+    struct Connection {
+        int fd = -1;
+        uint64_t id = 0;
+        std::string in;            // 未处理的输入字节
+        std::string out;           // 待发送的响应字节
+        size_t out_offset = 0;
+        size_t in_flight = 0;      // 已交给工作线程、尚未返回的请求数
+        bool reading = true;       // 是否监听 EPOLLIN
+        bool writing = false;      // 是否监听 EPOLLOUT
+        bool peer_closed = false;  // 对端已关闭写端，发完响应后关闭
+    };
+
+    struct Task {
+        // 请求任务产生响应；维护任务只调用存储节点，不产生响应。
+        // 维护任务会争用上传会话锁，须在工作线程执行，避免阻塞事件循环
+        enum class Kind { Request, AbortUploads, ReapUploads };
+        Kind kind = Kind::Request;
+        uint64_t conn_id;
+        uint64_t received_ns = 0;  // 请求帧切分出来的时刻（用于录制）
+        std::string json;
+        std::string payload;
+    };
+
+    struct Completion {
+        uint64_t conn_id;
+        std::string frame;
+    };
+
+    // epoll data.u64 的保留值，连接ID从 kFirstConnectionId 开始分配
+    static constexpr uint64_t kListenerId = 0;
+    static constexpr uint64_t kWakeupId = 1;
+    static constexpr uint64_t kFirstConnectionId = 2;
+
+    void event_loop();
+    void worker_loop();
+
+    void accept_connections();
+    void handle_readable(Connection& conn);
+    void dispatch_frames(Connection& conn);
+    bool flush(Connection& conn);
+    void update_interest(Connection& conn);
+    void close_connection(uint64_t conn_id);
+    void drain_completions();
+    void post_maintenance(Task::Kind kind, uint64_t conn_id);
+    void run_maintenance(const Task& task);
+    void wake();
+
+    StorageNode* node_;
+    int requested_port_;
+    int port_;
+    int num_workers_;
+    std::string bind_address_;
+
+    int listen_fd_;
+    int epoll_fd_;
+    int wakeup_fd_;
+
+    std::atomic<bool> running_;
+    std::atomic<bool> stopping_;
+    std::thread loop_thread_;
+    std::vector<std::thread> workers_;
+
+    // 事件循环线程独占
+    std::unordered_map<uint64_t, Connection> connections_;
+    uint64_t next_conn_id_;
+
+    // 任务队列（事件循环 -> 工作线程）
+    std::mutex task_mutex_;
+    std::condition_variable task_cv_;
+    std::deque<Task> tasks_;
+    std::atomic<bool> reap_queued_;  // 已有空闲上传回收任务在排队或执行
+
+    // 完成队列（工作线程 -> 事件循环）
+    std::mutex completion_mutex_;
+    std::vector<Completion> completions_;
+
+    // 统计
+    std::atomic<uint64_t> connections_accepted_;
+    std::atomic<uint64_t> connections_open_;
+    std::atomic<uint64_t> requests_;
+    std::atomic<uint64_t> failed_requests_;
+    std::atomic<uint64_t> bytes_in_;
+    std::atomic<uint64_t> bytes_out_;
+    perf_metrics::Registry latency_;
+
+    // 请求录制（start() 之前设置，之后只读）
+    std::unique_ptr<op_trace::Recorder> recorder_;
+};
+
+#endif // NODE_SERVER_H
@@ -5,32 +5,156 @@
 #include <chrono>
 #include <algorithm>
 #include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <thread>
+#include <atomic>
 
 namespace {
+
+inline PerformanceCallback_s* tracing(PerformanceCallback_s* cb) {
+    return (cb != nullptr && (cb->on_phase_complete || cb->on_span)) ? cb : nullptr;
+}
+
+void report_span(PerformanceCallback_s* cb, const perf_trace::Frame& frame,
+                 double start_us, double dur_us, uint64_t calls) {
+    if (cb->on_phase_complete) {
+        cb->on_phase_complete(frame.name, dur_us / 1000.0);
+    }
+    if (cb->on_span) {
+        perf_trace::Span span;
+        span.name = frame.name;
+        span.parent = frame.parent ? frame.parent->name : "";
+        span.depth = frame.depth;
+        span.start_us = start_us;
+        span.dur_us = dur_us;
+        span.tid = perf_trace::thread_index();
+        span.calls = calls;
+        cb->on_span(span);
+    }
+}
+
+/**
+ * @brief 阶段计时器：构造时压入线程阶段栈，析构（或 stop()）时上报
+ * 未设置回调时不读时钟、不改动阶段栈
+ */
 class ScopedTimerServer {
 public:
-    ScopedTimerServer(PerformanceCallback_s* cb, const std::string& name)
-        : cb_(cb), name_(name), active_(cb != nullptr),
-          start_(std::chrono::high_resolution_clock::now()) {}
+    ScopedTimerServer(PerformanceCallback_s* cb, const char* name)
+        : cb_(tracing(cb)), start_us_(0) {
+        if (cb_) {
+            frame_.name = name;
+            frame_.parent = perf_trace::current_frame();
+            frame_.depth = frame_.parent ? frame_.parent->depth + 1 : 0;
+            perf_trace::current_frame() = &frame_;
+            start_us_ = perf_trace::now_us();
+        }
+    }
     ~ScopedTimerServer() {
-        if (active_) {
-            auto end = std::chrono::high_resolution_clock::now();
-            double ms = std::chrono::duration<double, std::milli>(end - start_).count();
-            cb_->on_phase_complete(name_, ms);
+        stop();
+    }
+    void stop() {
+        if (cb_) {
+            double end_us = perf_trace::now_us();
+            perf_trace::current_frame() = frame_.parent;
+            report_span(cb_, frame_, start_us_, end_us - start_us_, 1);
+            cb_ = nullptr;
+        }
+    }
+    ScopedTimerServer(const ScopedTimerServer&) = delete;
+    ScopedTimerServer& operator=(const ScopedTimerServer&) = delete;
+private:
+    PerformanceCallback_s* cb_;
+    perf_trace::Frame frame_;
+    double start_us_;
+};
+
+/**
+ * @brief 累计计时器：循环内反复 begin()/end()，析构时作为当前阶段的子阶段上报一次
+ */
+class AccumTimerServer {
+public:
+    AccumTimerServer(PerformanceCallback_s* cb, const char* name)
+        : cb_(tracing(cb)), first_us_(0), begin_us_(0), total_us_(0), calls_(0) {
+        if (cb_) {
+            frame_.name = name;
+            frame_.parent = perf_trace::current_frame();
+            frame_.depth = frame_.parent ? frame_.parent->depth + 1 : 0;
+        }
+    }
+    ~AccumTimerServer() {
+        if (cb_ && calls_ > 0) {
+            report_span(cb_, frame_, first_us_, total_us_, calls_);
+        }
+    }
+    void begin() {
+        if (cb_) {
+            begin_us_ = perf_trace::now_us();
+            if (calls_ == 0) {
+                first_us_ = begin_us_;
+            }
+        }
+    }
+    void end() {
+        if (cb_) {
+            total_us_ += perf_trace::now_us() - begin_us_;
+            calls_++;
+        }
+    }
+    AccumTimerServer(const AccumTimerServer&) = delete;
+    AccumTimerServer& operator=(const AccumTimerServer&) = delete;
+private:
+    PerformanceCallback_s* cb_;
+    perf_trace::Frame frame_;
+    double first_us_;
+    double begin_us_;
+    double total_us_;
+    uint64_t calls_;
+};
+
+/**
+ * @brief 请求级操作计数：构造时把本线程的计数指向本请求，析构时上报并并入外层范围
+ * 未设置 on_op_counters 时不启用计数
+ */
+class CounterScope {
+public:
+    CounterScope(PerformanceCallback_s* cb, const char* name)
+        : cb_((cb != nullptr && cb->on_op_counters) ? cb : nullptr), name_(name), parent_(nullptr) {
+        if (cb_) {
+            parent_ = perf_metrics::active_counters();
+            perf_metrics::active_counters() = &counters_;
+        }
+    }
+    ~CounterScope() {
+        if (cb_) {
+            perf_metrics::active_counters() = parent_;
+            if (parent_) {
+                *parent_ += counters_;
+            }
+            cb_->on_op_counters(name_, counters_);
         }
     }
+    CounterScope(const CounterScope&) = delete;
+    CounterScope& operator=(const CounterScope&) = delete;
 private:
     PerformanceCallback_s* cb_;
-    std::string name_;
-    bool active_;
-    std::chrono::high_resolution_clock::time_point start_;
+    const char* name_;
+    perf_metrics::OpCounters counters_;
+    perf_metrics::OpCounters* parent_;
 };
+
+using perf_metrics::OpCounters;
+
 } // namespace
 
 // ==================== 构造函数和析构函数 ====================
 
 StorageNode::StorageNode(const std::string& data_directory, int port) 
-    : data_dir(data_directory), server_port(port), crypto_initialized(false) {
+    : data_dir(data_directory), server_port(port), crypto_initialized(false),
+      element_format(ElementFormat::CompressedBase64),
+      default_element_format(ElementFormat::CompressedBase64),
+      perf_callback_s(nullptr) {
     
     files_dir = data_dir + "/EncFiles";
     metadata_dir = data_dir + "/metadata";
@@ -45,6 +169,8 @@ StorageNode::StorageNode(const std::string& data_directory, int port)
 }
 
 StorageNode::~StorageNode() {
+    stop_compactor();
+    scratch_pool.clear();  // 临时变量依赖pairing，先于pairing_clear释放
     if (crypto_initialized) {
         element_clear(g);
         element_clear(mu);
@@ -72,6 +198,7 @@ bool StorageNode::setup_cryptography(int security_param,
         "sign1 1\n"
         "sign0 1\n";
     
+    scratch_pool.clear();  // 已有的临时变量属于旧的pairing
     if (pairing_init_set_buf(pairing, param_str, strlen(param_str)) != 0) {
         std::cerr << "❌ 配对参数初始化失败" << std::endl;
         return false;
@@ -255,6 +382,7 @@ bool StorageNode::load_public_params(const std::string& filepath) {
         "sign1 1\n"
         "sign0 1\n";
     
+    scratch_pool.clear();  // 已有的临时变量属于旧的pairing
     if (pairing_init_set_buf(pairing, param_str, strlen(param_str)) != 0) {
         std::cerr << "❌ 配对参数初始化失败" << std::endl;
         return false;
@@ -435,16 +563,30 @@ void StorageNode::computeHashH1(const std::string& input, mpz_t result) {
     unsigned char hash[SHA256_DIGEST_LENGTH];
     SHA256(reinterpret_cast<const unsigned char*>(input.c_str()),
            input.length(), hash);
+    perf_metrics::count(&OpCounters::sha256);
     
     mpz_import(result, SHA256_DIGEST_LENGTH, 1, 1, 0, 0, hash);
     mpz_mod(result, result, N);
 }
 
+std::string StorageNode::file_id_from_digest(const unsigned char* digest) {
+    mpz_t id;
+    mpz_init(id);
+    mpz_import(id, SHA256_DIGEST_LENGTH, 1, 1, 0, 0, digest);
+    mpz_mod(id, id, N);
+    char* id_str = mpz_get_str(nullptr, 10, id);
+    std::string result(id_str);
+    free(id_str);
+    mpz_clear(id);
+    return result;
+}
+
 // ✅ 新增：hashToScalar - 将字符串哈希到Zᵣ中（用于所有标量运算）
 void StorageNode::hashToScalar(const std::string& input, mpz_t result) {
     unsigned char hash[SHA256_DIGEST_LENGTH];
     SHA256(reinterpret_cast<const unsigned char*>(input.c_str()),
            input.length(), hash);
+    perf_metrics::count(&OpCounters::sha256);
     
     mpz_import(result, SHA256_DIGEST_LENGTH, 1, 1, 0, 0, hash);
     mpz_mod(result, result, r);  // ✅ 关键：模r而不是模N
@@ -454,30 +596,38 @@ void StorageNode::computeHashH2(const std::string& input, element_t result) {
     unsigned char hash[SHA256_DIGEST_LENGTH];
     SHA256(reinterpret_cast<const unsigned char*>(input.c_str()),
            input.length(), hash);
+    perf_metrics::count(&OpCounters::sha256);
     
     element_from_hash(result, hash, SHA256_DIGEST_LENGTH);
+    perf_metrics::count(&OpCounters::hash_to_curve);
 }
 
 std::string StorageNode::computeHashH3(const std::string& input) {
     unsigned char hash[SHA256_DIGEST_LENGTH];
     SHA256(reinterpret_cast<const unsigned char*>(input.c_str()),
            input.length(), hash);
+    perf_metrics::count(&OpCounters::sha256);
     
-    std::ostringstream oss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; ++i) {
-        oss << std::hex << std::setw(2) << std::setfill('0')
-            << static_cast<int>(hash[i]);
-    }
-    return oss.str();
+    return hex_codec::encode(hash, SHA256_DIGEST_LENGTH);
 }
 
 // ✅ 修改后的compute_prf函数 - 现在使用hashToScalar（输出在Zᵣ中）
 void StorageNode::compute_prf(mpz_t result, const std::string& seed, const std::string& ID_F, int index) {
-    // 组合输入：seed + ID_F + index
-    std::string combined = seed + ID_F + std::to_string(index);
+    std::string combined;
+    compute_prf(result, seed, ID_F, index, combined);
+}
+
+void StorageNode::compute_prf(mpz_t result, const std::string& seed, const std::string& ID_F, int index,
+                              std::string& buf) {
+    // 组合输入：seed + ID_F + index（在buf中原地拼接，复用已有容量）
+    buf.assign(seed);
+    buf.append(ID_F);
+    char index_str[16];
+    int index_len = snprintf(index_str, sizeof(index_str), "%d", index);
+    buf.append(index_str, index_len);
     
     // ✅ 使用hashToScalar计算哈希（自动模r）
-    hashToScalar(combined, result);
+    hashToScalar(buf, result);
 }
 
 std::string StorageNode::decrypt_pointer(const std::string& current_state_hash, const std::string& encrypted_pointer) {
@@ -496,9 +646,10 @@ std::string StorageNode::decrypt_pointer(const std::string& current_state_hash,
     }
 
     unsigned char key[32] = {0};
-    for (size_t i = 0; i < 32 && i * 2 < current_state_hash.length(); ++i) {
-        std::string byte_str = current_state_hash.substr(i * 2, 2);
-        key[i] = static_cast<unsigned char>(std::stoi(byte_str, nullptr, 16));
+    size_t key_hex_len = std::min<size_t>(current_state_hash.length(), 64) & ~static_cast<size_t>(1);
+    if (!hex_codec::decode(current_state_hash.data(), key_hex_len, key)) {
+        EVP_CIPHER_CTX_free(ctx);
+        return "";
     }
 
     unsigned char iv[16] = {0};
@@ -528,6 +679,7 @@ std::string StorageNode::decrypt_pointer(const std::string& current_state_hash,
 
     plaintext.resize(total_len);
     EVP_CIPHER_CTX_free(ctx);
+    perf_metrics::count(&OpCounters::aes_decryptions);
 
     return std::string(plaintext.begin(), plaintext.end());
 }
@@ -547,13 +699,19 @@ bool StorageNode::verify_pk_format(const std::string& pk) {
         return false;
     }
     
+    // 未压缩hex或压缩base64
+    bool all_hex = true;
+    bool all_base64 = true;
     for (char c : pk) {
-        if (!isxdigit(c)) {
-            return false;
+        if (!isxdigit(static_cast<unsigned char>(c))) {
+            all_hex = false;
+        }
+        if (!isalnum(static_cast<unsigned char>(c)) && c != '+' && c != '/' && c != '=') {
+            all_base64 = false;
         }
     }
     
-    return true;
+    return all_hex || all_base64;
 }
 
 
@@ -571,6 +729,12 @@ Json::Value StorageNode::load_json_from_file(const std::string& filepath) {
     Json::CharReaderBuilder builder;
     std::string errs;
     
+    if (perf_metrics::active_counters()) {
+        file.seekg(0, std::ios::end);
+        perf_metrics::count(&OpCounters::json_bytes, static_cast<uint64_t>(file.tellg()));
+        file.seekg(0);
+    }
+    
     if (!Json::parseFromStream(builder, file, &root, &errs)) {
         std::cerr << "❌ JSON解析失败: " << errs << std::endl;
     }
@@ -648,24 +812,20 @@ std::string StorageNode::get_current_timestamp() {
 // ==================== 辅助函数 ====================
 
 std::string StorageNode::bytesToHex(const unsigned char* data, size_t len) {
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
-    for (size_t i = 0; i < len; ++i) {
-        ss << std::setw(2) << static_cast<int>(data[i]);
-    }
-    return ss.str();
+    return hex_codec::encode(data, len);
 }
 
 std::vector<unsigned char> StorageNode::hexToBytes(const std::string& hex) {
     std::vector<unsigned char> bytes;
-    for (size_t i = 0; i < hex.length(); i += 2) {
-        std::string byte_str = hex.substr(i, 2);
-        unsigned char byte = static_cast<unsigned char>(std::stoi(byte_str, nullptr, 16));
-        bytes.push_back(byte);
-    }
+    hexToBytes(hex, bytes);
     return bytes;
 }
 
+void StorageNode::hexToBytes(const std::string& hex, std::vector<unsigned char>& out) {
+    // 非法输入（奇数长度或非hex字符）返回空
+    hex_codec::decode(hex, out);
+}
+
 
 // ==================== 序列化辅助函数（方案A：与client.cpp统一）====================
 
@@ -675,10 +835,13 @@ std::vector<unsigned char> StorageNode::hexToBytes(const std::string& hex) {
  * @return hex字符串
  */
 std::string StorageNode::serializeElement(element_t elem) {
-    int len = element_length_in_bytes(elem);
-    std::vector<unsigned char> buf(len);
-    element_to_bytes(buf.data(), elem);
-    return bytesToHex(buf.data(), len);
+    std::vector<unsigned char> buf;
+    return serializeElement(elem, buf);
+}
+
+std::string StorageNode::serializeElement(element_t elem, std::vector<unsigned char>& buf) {
+    // 按数据库记录的格式编码（未压缩hex或压缩base64）
+    return element_codec::encode(elem, element_format, buf);
 }
 
 /**
@@ -688,17 +851,50 @@ std::string StorageNode::serializeElement(element_t elem) {
  * @return 成功返回true，失败返回false
  */
 bool StorageNode::deserializeElement(const std::string& hex_str, element_t elem) {
-    if (hex_str.length() % 2 != 0) {
+    std::vector<unsigned char> bytes;
+    return deserializeElement(hex_str, elem, bytes);
+}
+
+bool StorageNode::deserializeElement(const std::string& hex_str, element_t elem,
+                                     std::vector<unsigned char>& buf) {
+    // 按长度自动识别格式，兼容旧版hex数据
+    return element_codec::decode(hex_str, elem, buf);
+}
+
+bool StorageNode::canonicalize_element(std::string& text) {
+    if (element_codec::is_format(pairing, text, element_format)) {
+        return true;
+    }
+    PbcScratchPool::Lease scratch = scratch_pool.acquire(pairing);
+    if (!deserializeElement(text, scratch->aux, scratch->bytes)) {
         return false;
     }
-    
-    std::vector<unsigned char> bytes;
-    bytes = hexToBytes(hex_str);
-    int bytes_read = element_from_bytes(elem, bytes.data());
-    if (bytes_read <= 0) {
+    text = serializeElement(scratch->aux, scratch->bytes);
+    return true;
+}
+
+bool StorageNode::bundle_element_to_text(const unsigned char* data, size_t len, bool compressed,
+                                         std::string& out) {
+    size_t expected = compressed ? pairing_length_in_bytes_compressed_G1(pairing)
+                                 : pairing_length_in_bytes_G1(pairing);
+    if (len != expected) {
+        return false;
+    }
+    // 字节形式与数据库格式一致时只做文本编码，无需曲线运算
+    bool db_compressed = (element_format == ElementFormat::CompressedBase64);
+    if (compressed == db_compressed) {
+        element_codec::from_bytes(data, len, element_format, out);
+        return true;
+    }
+    PbcScratchPool::Lease scratch = scratch_pool.acquire(pairing);
+    scratch->bytes.assign(data, data + len);
+    int read = compressed ? element_from_bytes_compressed(scratch->aux, scratch->bytes.data())
+                          : element_from_bytes(scratch->aux, scratch->bytes.data());
+    if (read <= 0) {
         return false;
     }
-    return true;  
+    out = serializeElement(scratch->aux, scratch->bytes);
+    return true;
 }
 // ==================== 初始化函数 ====================
 
@@ -734,10 +930,17 @@ bool StorageNode::create_default_config() {
     config["paths"]["public_params"] = data_dir + "/public_params.json";
     
     config["server"]["port"] = server_port;
+    config["server"]["bind_address"] = bind_address;
     config["server"]["enable_server"] = false;
     
     config["storage"]["max_file_size_mb"] = 100;
     config["storage"]["enable_compression"] = false;
+    config["storage"]["element_format"] = element_codec::format_name(default_element_format);
+    config["storage"]["compaction_interval_sec"] = compaction_interval_sec;
+    config["storage"]["compaction_min_files"] = static_cast<Json::UInt64>(compaction_min_files);
+    config["storage"]["max_upload_sessions"] = static_cast<Json::UInt64>(max_upload_sessions);
+    config["storage"]["upload_idle_timeout_sec"] = upload_idle_timeout_sec;
+    config["storage"]["search_cache_budget_mb"] = static_cast<Json::UInt64>(search_cache_budget_mb);
     
     std::string config_path = data_dir + "/config.json";
     return save_json_to_file(config, config_path);
@@ -757,6 +960,31 @@ bool StorageNode::load_config() {
         node_id = config["node"]["node_id"].asString();
     }
     
+    if (config.isMember("server")) {
+        bind_address = config["server"].get("bind_address", bind_address).asString();
+    }
+    
+    // 新建数据库时使用的元素格式（已有数据库以其记录的格式为准）
+    if (config.isMember("storage") && config["storage"].isMember("element_format")) {
+        std::string format_name = config["storage"]["element_format"].asString();
+        if (!element_codec::parse_format(format_name, default_element_format)) {
+            std::cerr << "⚠️  未知的 element_format: " << format_name << "，使用默认格式" << std::endl;
+        }
+    }
+    
+    // 已删除文件的后台回收
+    if (config.isMember("storage")) {
+        const Json::Value& storage = config["storage"];
+        compaction_interval_sec = storage.get("compaction_interval_sec", compaction_interval_sec).asInt();
+        compaction_min_files = storage.get("compaction_min_files",
+                                           static_cast<Json::UInt64>(compaction_min_files)).asUInt64();
+        max_upload_sessions = storage.get("max_upload_sessions",
+                                          static_cast<Json::UInt64>(max_upload_sessions)).asUInt64();
+        upload_idle_timeout_sec = storage.get("upload_idle_timeout_sec", upload_idle_timeout_sec).asInt();
+        search_cache_budget_mb = storage.get("search_cache_budget_mb",
+                                             static_cast<Json::UInt64>(search_cache_budget_mb)).asUInt64();
+    }
+    
     std::cout << "✅ 配置加载成功" << std::endl;
     return true;
 }
@@ -773,6 +1001,7 @@ bool StorageNode::save_config() {
     config["paths"]["metadata_dir"] = metadata_dir;
     
     config["server"]["port"] = server_port;
+    config["server"]["bind_address"] = bind_address;
     
     std::string config_path = data_dir + "/config.json";
     return save_json_to_file(config, config_path);
@@ -781,18 +1010,33 @@ bool StorageNode::save_config() {
 // ==================== 索引数据库操作 ====================
 
 bool StorageNode::load_index_database() {
+    ScopedTimerServer timer(perf_callback_s, "db_load_index");
     std::string index_path = data_dir + "/index_db.json";
     
+    // 加载属于写操作：与插入/删除串行，解析完成后在独占锁内一次性替换
+    std::lock_guard<std::mutex> writer(writer_mutex);
+    
     if (!file_exists(index_path)) {
         std::cout << "⚠️  索引数据库不存在,将创建新数据库" << std::endl;
+        {
+            auto lock = write_lock();
+            element_format = default_element_format;
+        }
         return save_index_database();
     }
     
     Json::Value root = load_json_from_file(index_path);
     
+    // 数据库记录的元素格式优先（无该字段为旧版未压缩hex）
+    ElementFormat loaded_format;
+    std::string format_name = root.get("element_format", "").asString();
+    if (!element_codec::parse_format(format_name, loaded_format)) {
+        std::cerr << "❌ 索引数据库的 element_format 无法识别: " << format_name << std::endl;
+        return false;
+    }
+    
+    std::map<std::string, IndexEntry> loaded;
     if (root.isMember("database") && root["database"].isArray()) {
-        index_database.clear();
-        
         for (const auto& entry_json : root["database"]) {
             IndexEntry entry;
             entry.ID_F = entry_json["ID_F"].asString();
@@ -816,14 +1060,13 @@ bool StorageNode::load_index_database() {
                 }
             }
             
-            index_database[entry.ID_F] = entry;
+            loaded[entry.ID_F] = entry;
         }
         
-        std::cout << "✅ 索引数据库加载成功 (新格式，共 " << index_database.size() << " 个文件)" << std::endl;
+        std::cout << "✅ 索引数据库加载成功 (新格式，共 " << loaded.size() << " 个文件)" << std::endl;
         
     } else if (root.isMember("indices")) {
         std::cout << "⚠️  检测到旧格式数据库，正在转换..." << std::endl;
-        index_database.clear();
         
         for (const auto& token : root["indices"].getMemberNames()) {
             for (const auto& entry_json : root["indices"][token]) {
@@ -849,13 +1092,13 @@ bool StorageNode::load_index_database() {
                     }
                 }
                 
-                if (index_database.find(entry.ID_F) == index_database.end()) {
-                    index_database[entry.ID_F] = entry;
+                if (loaded.find(entry.ID_F) == loaded.end()) {
+                    loaded[entry.ID_F] = entry;
                 }
             }
         }
         
-        std::cout << "✅ 索引数据库加载成功 (旧格式已转换，共 " << index_database.size() << " 个文件)" << std::endl;
+        std::cout << "✅ 索引数据库加载成功 (旧格式已转换，共 " << loaded.size() << " 个文件)" << std::endl;
         std::cout << "💡 建议：下次保存时将自动更新为新格式" << std::endl;
         
     } else {
@@ -863,13 +1106,28 @@ bool StorageNode::load_index_database() {
         return false;
     }
     
+    size_t pending = 0;
+    for (const auto& pair : loaded) {
+        if (pair.second.state == "invalid" && !is_compacted(pair.second)) {
+            pending++;
+        }
+    }
+    
+    auto lock = write_lock();
+    index_database.swap(loaded);
+    element_format = loaded_format;
+    pending_compaction = pending;
     return true;
 }
 
 bool StorageNode::save_index_database() {
+    ScopedTimerServer timer(perf_callback_s, "persist_index_db");
+    // 共享锁内生成快照，写文件时不阻塞其他读者与写者的内存修改
+    auto lock = read_lock();
     Json::Value root;
     root["version"] = "3.5";
     root["last_update"] = get_current_timestamp();
+    root["element_format"] = element_codec::format_name(element_format);
     
     root["file_count"] = static_cast<int>(index_database.size());
     
@@ -908,6 +1166,7 @@ bool StorageNode::save_index_database() {
         database_array.append(entry_json);
     }
     root["database"] = database_array;
+    lock.unlock();
     
     std::string index_path = data_dir + "/index_db.json";
     return save_json_to_file(root, index_path);
@@ -934,8 +1193,9 @@ bool StorageNode::save_node_info() {
     info["node_id"] = node_id;
     info["version"] = "3.5";
     info["last_update"] = get_current_timestamp();
-    info["statistics"]["total_files"] = static_cast<int>(index_database.size());
-    info["statistics"]["total_indices"] = static_cast<int>(index_database.size());
+    size_t file_count = get_file_count();
+    info["statistics"]["total_files"] = static_cast<int>(file_count);
+    info["statistics"]["total_indices"] = static_cast<int>(file_count);
     
     std::string info_path = data_dir + "/node_info.json";
     return save_json_to_file(info, info_path);
@@ -949,6 +1209,7 @@ void StorageNode::update_statistics(const std::string& operation) {
 
 bool StorageNode::insert_file(const std::string& param_json_path, const std::string& enc_file_path) {
     ScopedTimerServer timer(perf_callback_s, "server_insert_total");
+    CounterScope counters(perf_callback_s, "server_insert_total");
     std::cout << "\n📤 插入文件..." << std::endl;
     std::cout << "   参数文件: " << param_json_path << std::endl;
     std::cout << "   加密文件: " << enc_file_path << std::endl;
@@ -960,6 +1221,53 @@ bool StorageNode::insert_file(const std::string& param_json_path, const std::str
     
     Json::Value params = load_json_from_file(param_json_path);
     
+    // 密文按块流式写入EncFiles并增量哈希，不再整体读入内存
+    std::ifstream in(enc_file_path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        std::cerr << "❌ 加密文件读取失败" << std::endl;
+        return false;
+    }
+    uint64_t total_size = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+    
+    std::string upload_id;
+    if (!begin_upload(params, total_size, upload_id)) {
+        return false;
+    }
+    
+    std::vector<char> chunk(static_cast<size_t>(std::min<uint64_t>(UPLOAD_CHUNK_SIZE, total_size)));
+    uint64_t offset = 0;
+    while (offset < total_size) {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(chunk.size(), total_size - offset));
+        if (!in.read(chunk.data(), static_cast<std::streamsize>(n)) ||
+            !append_upload(upload_id, offset, chunk.data(), n)) {
+            std::cerr << "❌ 加密文件读取失败" << std::endl;
+            abort_upload(upload_id);
+            return false;
+        }
+        offset += n;
+    }
+    perf_metrics::count(&OpCounters::ciphertext_bytes, total_size);
+    
+    return commit_upload(upload_id);
+}
+
+bool StorageNode::insert_from_params(const Json::Value& params, const std::string& ciphertext) {
+    CounterScope counters(perf_callback_s, "server_insert_total");
+    IndexEntry entry;
+    if (!build_entry_from_params(params, entry)) {
+        return false;
+    }
+    
+    if (ciphertext.empty()) {
+        std::cerr << "❌ 密文为空" << std::endl;
+        return false;
+    }
+    
+    return commit_insert(entry, ciphertext);
+}
+
+bool StorageNode::build_entry_from_params(const Json::Value& params, IndexEntry& entry) {
     if (!params.isMember("PK") || !params.isMember("ID_F") || 
         !params.isMember("TS_F") || !params.isMember("state") || 
         !params.isMember("keywords")) {
@@ -979,18 +1287,25 @@ bool StorageNode::insert_file(const std::string& param_json_path, const std::str
         return false;
     }
     
-    if (has_file(ID_F)) {
-        std::cerr << "❌ 文件ID已存在" << std::endl;
+    // 请求声明的元素格式（缺省为旧版未压缩hex），与数据库格式不同时逐项转换
+    ElementFormat request_format;
+    std::string request_format_name = params.get("element_format", "").asString();
+    if (!element_codec::parse_format(request_format_name, request_format)) {
+        std::cerr << "❌ 不支持的 element_format: " << request_format_name << std::endl;
+        return false;
+    }
+    bool transcode = (request_format != element_format);
+    if (transcode && !canonicalize_element(PK)) {
+        std::cerr << "❌ PK解码失败" << std::endl;
         return false;
     }
     
-    std::string ciphertext = read_file_content(enc_file_path);
-    if (ciphertext.empty()) {
-        std::cerr << "❌ 加密文件读取失败" << std::endl;
+    if (has_file(ID_F)) {
+        std::cerr << "❌ 文件ID已存在" << std::endl;
         return false;
     }
     
-    IndexEntry entry;
+    entry = IndexEntry();
     entry.ID_F = ID_F;
     entry.PK = PK;
     entry.state = state;
@@ -1005,6 +1320,15 @@ bool StorageNode::insert_file(const std::string& param_json_path, const std::str
         entry.TS_F.push_back(ts_f_array.asString());
     }
     
+    if (transcode) {
+        for (auto& tag : entry.TS_F) {
+            if (!canonicalize_element(tag)) {
+                std::cerr << "❌ 认证标签解码失败" << std::endl;
+                return false;
+            }
+        }
+    }
+    
     std::cout << "   认证标签数量: " << entry.TS_F.size() << std::endl;
     
     Json::Value keywords_array = params["keywords"];
@@ -1023,6 +1347,10 @@ bool StorageNode::insert_file(const std::string& param_json_path, const std::str
         
         std::string Ti_bar = kw["Ti_bar"].asString();
         std::string kt_wi = kw["kt_wi"].asString();
+        if (transcode && (!canonicalize_element(Ti_bar) || !canonicalize_element(kt_wi))) {
+            std::cerr << "❌ 关键词标签解码失败" << std::endl;
+            return false;
+        }
         
         std::string ptr_i = ID_F;
         if (kw.isMember("ptr_i")) {
@@ -1039,19 +1367,144 @@ bool StorageNode::insert_file(const std::string& param_json_path, const std::str
         std::cout << "   ✅ 已添加关键词索引: " << Ti_bar.substr(0, 16) << "..." << std::endl;
     }
     
-    index_database[ID_F] = entry;
+    return true;
+}
+
+bool StorageNode::insert_bundle(const std::string& bundle_path) {
+    ScopedTimerServer timer(perf_callback_s, "server_insert_total");
+    std::cout << "\n📤 插入文件（请求包）..." << std::endl;
+    std::cout << "   请求包: " << bundle_path << std::endl;
+    
+    insert_bundle::Bundle bundle;
+    std::string error;
+    if (!insert_bundle::read(bundle_path, bundle, error)) {
+        std::cerr << "❌ 请求包读取失败: " << error << std::endl;
+        return false;
+    }
+    perf_metrics::count(&OpCounters::ciphertext_bytes, bundle.ciphertext.size());
+    
+    return insert_from_bundle(bundle);
+}
+
+bool StorageNode::insert_from_bundle(const insert_bundle::Bundle& bundle) {
+    CounterScope counters(perf_callback_s, "server_insert_total");
+    if (bundle.ciphertext.empty()) {
+        std::cerr << "❌ 请求包缺少密文" << std::endl;
+        return false;
+    }
+    
+    IndexEntry entry;
+    if (!build_entry_from_bundle(bundle, entry)) {
+        return false;
+    }
+    
+    return commit_insert(entry, bundle.ciphertext);
+}
+
+bool StorageNode::build_entry_from_bundle(const insert_bundle::Bundle& bundle, IndexEntry& entry) {
+    std::cout << "   文件ID: " << bundle.ID_F << std::endl;
+    std::cout << "   状态: " << bundle.state << std::endl;
+    
+    if (bundle.ID_F.empty()) {
+        std::cerr << "❌ 请求包缺少文件ID" << std::endl;
+        return false;
+    }
+    
+    if (has_file(bundle.ID_F)) {
+        std::cerr << "❌ 文件ID已存在" << std::endl;
+        return false;
+    }
+    
+    entry = IndexEntry();
+    entry.ID_F = bundle.ID_F;
+    entry.state = bundle.state;
+    entry.file_path = files_dir + "/" + bundle.ID_F + ".enc";
+    
+    if (!bundle_element_to_text(bundle.PK.data(), bundle.PK.size(), bundle.compressed, entry.PK) ||
+        !verify_pk_format(entry.PK)) {
+        std::cerr << "❌ PK格式无效" << std::endl;
+        return false;
+    }
+    
+    entry.TS_F.resize(bundle.tag_count());
+    for (size_t i = 0; i < entry.TS_F.size(); ++i) {
+        if (!bundle_element_to_text(bundle.tag(i), bundle.tag_len, bundle.compressed, entry.TS_F[i])) {
+            std::cerr << "❌ 认证标签解码失败" << std::endl;
+            return false;
+        }
+    }
+    
+    std::cout << "   认证标签数量: " << entry.TS_F.size() << std::endl;
+    std::cout << "   关键词数量: " << bundle.keywords.size() << std::endl;
+    
+    for (const auto& kw : bundle.keywords) {
+        IndexKeywords idx_kw;
+        if (!bundle_element_to_text(kw.Ti_bar.data(), kw.Ti_bar.size(), bundle.compressed, idx_kw.Ti_bar) ||
+            !bundle_element_to_text(kw.kt_wi.data(), kw.kt_wi.size(), bundle.compressed, idx_kw.kt_wi)) {
+            std::cerr << "❌ 关键词标签解码失败" << std::endl;
+            return false;
+        }
+        idx_kw.ptr_i = kw.ptr_i.empty() ? bundle.ID_F : kw.ptr_i;
+        entry.keywords.push_back(idx_kw);
+    }
+    
+    return true;
+}
+
+bool StorageNode::commit_insert(const IndexEntry& entry, const std::string& ciphertext) {
+    ScopedTimerServer timer(perf_callback_s, "insert_commit");
+    // 服务端核对 ID_F = H1(C)，拒绝与密文不符的插入请求
+    ScopedTimerServer hash_timer(perf_callback_s, "verify_file_id");
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const unsigned char*>(ciphertext.data()), ciphertext.size(), digest);
+    perf_metrics::count(&OpCounters::sha256);
+    if (file_id_from_digest(digest) != entry.ID_F) {
+        std::cerr << "❌ 文件ID与密文哈希不一致 (ID_F != H1(C))" << std::endl;
+        return false;
+    }
+    hash_timer.stop();
+    
+    // 密文先写入临时文件（不持锁），发布时在写者锁内改名
+    ScopedTimerServer io_timer(perf_callback_s, "ciphertext_io");
+    std::string part_path = entry.file_path + ".part." + generate_random_seed().substr(0, 16);
+    if (!write_file_content(part_path, ciphertext)) {
+        std::cerr << "❌ 加密文件保存失败" << std::endl;
+        std::remove(part_path.c_str());
+        return false;
+    }
+    io_timer.stop();
+    
+    // 单写者：插入/删除串行执行，读者只在修改内存数据库时短暂等待
+    std::lock_guard<std::mutex> writer(writer_mutex);
+    return publish_insert(entry, part_path, ciphertext.size());
+}
+
+bool StorageNode::publish_insert(const IndexEntry& entry, const std::string& part_path,
+                                 uint64_t ciphertext_size) {
+    ScopedTimerServer timer(perf_callback_s, "insert_publish");
+    const std::string& ID_F = entry.ID_F;
+    
+    // 并发插入同一ID_F时，前置检查可能都已通过，这里在写者锁内复查
+    if (index_database.count(ID_F)) {
+        std::cerr << "❌ 文件ID已存在" << std::endl;
+        std::remove(part_path.c_str());
+        return false;
+    }
     
-    if (!save_encrypted_file(ID_F, enc_file_path)) {
-        std::cerr << "⚠️  加密文件保存失败" << std::endl;
+    // 先落盘密文与元数据，再发布索引项：读者看到索引时密文一定已就绪
+    if (std::rename(part_path.c_str(), entry.file_path.c_str()) != 0) {
+        std::cerr << "❌ 加密文件改名失败: " << part_path << std::endl;
+        std::remove(part_path.c_str());
+        return false;
     }
     
     Json::Value metadata;
     metadata["ID_F"] = ID_F;
-    metadata["PK"] = PK;
-    metadata["state"] = state;
+    metadata["PK"] = entry.PK;
+    metadata["state"] = entry.state;
     metadata["file_path"] = entry.file_path;
     metadata["inserted_at"] = get_current_timestamp();
-    metadata["ciphertext_size"] = (Json::UInt64)ciphertext.size();
+    metadata["ciphertext_size"] = (Json::UInt64)ciphertext_size;
     
     Json::Value ts_f_json(Json::arrayValue);
     for (const auto& tag : entry.TS_F) {
@@ -1074,20 +1527,28 @@ bool StorageNode::insert_file(const std::string& param_json_path, const std::str
     
     std::cout << "\n🔍 更新搜索数据库..." << std::endl;
     
-    for (const auto& kw : entry.keywords) {
-        IndexSearchEntry search_entry;
-        search_entry.Ti_bar = kw.Ti_bar;
-        search_entry.ID_F = ID_F;
-        search_entry.ptr_i = kw.ptr_i;
-        search_entry.state = entry.state;
-        search_entry.kt_wi = kw.kt_wi;
-        
-        search_database[search_entry.Ti_bar] = search_entry;
+    size_t search_index_count;
+    {
+        auto lock = write_lock();
+        index_database[ID_F] = entry;
         
-        std::cout << "   ✅ 添加搜索索引: Ti_bar=" << kw.Ti_bar.substr(0, 16) << "..." << std::endl;
+        for (const auto& kw : entry.keywords) {
+            IndexSearchEntry search_entry;
+            search_entry.Ti_bar = kw.Ti_bar;
+            search_entry.ID_F = ID_F;
+            search_entry.ptr_i = kw.ptr_i;
+            search_entry.state = entry.state;
+            search_entry.kt_wi = kw.kt_wi;
+            
+            search_database[search_entry.Ti_bar] = search_entry;
+        }
+        search_index_count = search_database.size();
     }
     
-    std::cout << "   📊 当前搜索索引总数: " << search_database.size() << std::endl;
+    for (const auto& kw : entry.keywords) {
+        std::cout << "   ✅ 添加搜索索引: Ti_bar=" << kw.Ti_bar.substr(0, 16) << "..." << std::endl;
+    }
+    std::cout << "   📊 当前搜索索引总数: " << search_index_count << std::endl;
     
     save_search_database();
     save_index_database();
@@ -1098,174 +1559,690 @@ bool StorageNode::insert_file(const std::string& param_json_path, const std::str
 }
 
 
-// ==================== 新增功能实现 ====================
+// ==================== 分块上传 ====================
 
-bool StorageNode::delete_file_from_json(const std::string& delete_json_path) {
-    std::cout << "\n🗑️  执行文件删除操作..." << std::endl;
-    
-    // 步骤1: 加载JSON文件
-    if (!file_exists(delete_json_path)) {
-        std::cerr << "❌ 删除参数文件不存在: " << delete_json_path << std::endl;
+bool StorageNode::begin_upload(const Json::Value& params, uint64_t total_size, std::string& upload_id,
+                               uint64_t owner) {
+    std::cout << "\n📤 开始分块上传..." << std::endl;
+    IndexEntry entry;
+    if (!build_entry_from_params(params, entry)) {
         return false;
     }
-    
-    Json::Value delete_params = load_json_from_file(delete_json_path);
-    
-    // 步骤2: 提取参数
-    if (!delete_params.isMember("ID_F") || !delete_params.isMember("PK") || 
-        !delete_params.isMember("del")) {
-        std::cerr << "❌ JSON文件缺少必需字段" << std::endl;
+    return open_upload(std::move(entry), total_size, upload_id, owner);
+}
+
+bool StorageNode::begin_upload(const insert_bundle::Bundle& header, uint64_t total_size,
+                               std::string& upload_id, uint64_t owner) {
+    std::cout << "\n📤 开始分块上传（请求包）..." << std::endl;
+    IndexEntry entry;
+    if (!build_entry_from_bundle(header, entry)) {
         return false;
     }
-    
-    std::string ID_F = delete_params["ID_F"].asString();
-    std::string PK = delete_params["PK"].asString();
-    std::string del = delete_params["del"].asString();
-    
-    std::cout << "   文件ID: " << ID_F << std::endl;
-    std::cout << "   公钥: " << PK.substr(0, 16) << "..." << std::endl;
-    
-    // 步骤3: 加载数据库
-    if (!load_index_database()) {
-        std::cerr << "❌ 索引数据库加载失败" << std::endl;
+    return open_upload(std::move(entry), total_size, upload_id, owner);
+}
+
+bool StorageNode::open_upload(IndexEntry entry, uint64_t total_size, std::string& upload_id, uint64_t owner) {
+    if (total_size == 0) {
+        std::cerr << "❌ 密文为空" << std::endl;
         return false;
     }
     
-    if (!load_search_database()) {
-        std::cerr << "❌ 搜索数据库加载失败" << std::endl;
+    // 先回收空闲会话，避免已断开的客户端占满会话上限
+    reap_idle_uploads();
+    
+    auto session = std::make_shared<UploadSession>();
+    session->upload_id = generate_random_seed().substr(0, 32);
+    session->part_path = entry.file_path + ".part." + session->upload_id.substr(0, 16);
+    session->entry = std::move(entry);
+    session->expected_size = total_size;
+    session->owner = owner;
+    session->last_active_ns = perf_metrics::now_ns();
+    
+    session->out.open(session->part_path, std::ios::binary | std::ios::trunc);
+    session->sha = EVP_MD_CTX_new();
+    if (!session->out.is_open() || !session->sha ||
+        EVP_DigestInit_ex(session->sha, EVP_sha256(), nullptr) != 1) {
+        std::cerr << "❌ 无法创建上传临时文件: " << session->part_path << std::endl;
+        session->out.close();
+        std::remove(session->part_path.c_str());
         return false;
     }
+    perf_metrics::count(&OpCounters::sha256);  // 增量哈希：整段密文计一次 H1(C)
+    
+    {
+        std::lock_guard<std::mutex> lock(upload_mutex);
+        if (max_upload_sessions > 0 && upload_sessions.size() >= max_upload_sessions) {
+            std::cerr << "❌ 进行中的上传已达上限 (" << max_upload_sessions << ")" << std::endl;
+            session->out.close();
+            std::remove(session->part_path.c_str());
+            return false;
+        }
+        for (const auto& pair : upload_sessions) {
+            if (pair.second->entry.ID_F == session->entry.ID_F) {
+                std::cerr << "❌ 该文件已有进行中的上传: " << session->entry.ID_F << std::endl;
+                session->out.close();
+                std::remove(session->part_path.c_str());
+                return false;
+            }
+        }
+        upload_sessions[session->upload_id] = session;
+    }
     
-    // 步骤4: 查找文件
-    auto it = index_database.find(ID_F);
-    if (it == index_database.end()) {
-        std::cerr << "❌ 文件不存在: " << ID_F << std::endl;
+    upload_id = session->upload_id;
+    std::cout << "   上传会话: " << upload_id << " (密文 " << total_size << " 字节)" << std::endl;
+    return true;
+}
+
+std::shared_ptr<UploadSession> StorageNode::find_upload(const std::string& upload_id) {
+    std::lock_guard<std::mutex> lock(upload_mutex);
+    auto it = upload_sessions.find(upload_id);
+    return it == upload_sessions.end() ? nullptr : it->second;
+}
+
+bool StorageNode::append_upload(const std::string& upload_id, uint64_t offset, const char* data,
+                                size_t len) {
+    std::shared_ptr<UploadSession> session = find_upload(upload_id);
+    if (!session) {
+        std::cerr << "❌ 上传会话不存在: " << upload_id << std::endl;
         return false;
     }
     
-    IndexEntry& entry = it->second;
-    
-    // 步骤5: 验证公钥
-    if (entry.PK != PK) {
-        std::cerr << "❌ 公钥验证失败，无权删除此文件" << std::endl;
+    std::lock_guard<std::mutex> lock(session->mutex);
+    if (session->closed) {
+        std::cerr << "❌ 上传会话已结束: " << upload_id << std::endl;
+        return false;
+    }
+    if (offset != session->received) {
+        std::cerr << "❌ 分块乱序: 期望偏移 " << session->received << ", 收到 " << offset << std::endl;
+        return false;
+    }
+    if (len > session->expected_size - session->received) {
+        std::cerr << "❌ 分块超出声明的密文长度" << std::endl;
         return false;
     }
     
-    // 步骤6: 收集所有Ti_bar并更新索引数据库
-    std::vector<std::string> Ti_bars;
+    ScopedTimerServer timer(perf_callback_s, "upload_append");
+    session->out.write(data, static_cast<std::streamsize>(len));
+    if (!session->out || EVP_DigestUpdate(session->sha, data, len) != 1) {
+        std::cerr << "❌ 分块写入失败: " << session->part_path << std::endl;
+        return false;
+    }
+    session->received += len;
+    session->last_active_ns = perf_metrics::now_ns();
+    return true;
+}
+
+bool StorageNode::commit_upload(const std::string& upload_id) {
+    ScopedTimerServer timer(perf_callback_s, "server_upload_commit");
+    std::shared_ptr<UploadSession> session = find_upload(upload_id);
+    if (!session) {
+        std::cerr << "❌ 上传会话不存在: " << upload_id << std::endl;
+        return false;
+    }
     
-    std::cout << "   更新关键词标签..." << std::endl;
-    for (auto& keyword : entry.keywords) {
-        Ti_bars.push_back(keyword.Ti_bar);
-        
-        // 更新kt_wi = kt_wi / del（大整数除法）
-        mpz_t kt_wi_mpz, del_mpz, result_mpz;
-        mpz_init(kt_wi_mpz);
-        mpz_init(del_mpz);
-        mpz_init(result_mpz);
-        
-        // 将hex字符串转换为mpz_t
-        if (mpz_set_str(kt_wi_mpz, keyword.kt_wi.c_str(), 16) != 0) {
-            std::cerr << "   ⚠️  kt_wi格式错误，跳过" << std::endl;
-            mpz_clear(kt_wi_mpz);
-            mpz_clear(del_mpz);
-            mpz_clear(result_mpz);
-            continue;
+    bool ok = false;
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        if (session->closed) {
+            std::cerr << "❌ 上传会话已结束: " << upload_id << std::endl;
+            return false;
         }
+        session->closed = true;
+        session->out.flush();
+        bool written = static_cast<bool>(session->out);
+        session->out.close();
         
-        if (mpz_set_str(del_mpz, del.c_str(), 16) != 0) {
-            std::cerr << "   ⚠️  del格式错误" << std::endl;
-            mpz_clear(kt_wi_mpz);
-            mpz_clear(del_mpz);
-            mpz_clear(result_mpz);
-            continue;
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int digest_len = 0;
+        if (session->received != session->expected_size) {
+            std::cerr << "❌ 上传未完成: " << session->received << " / " << session->expected_size
+                      << " 字节" << std::endl;
+        } else if (!written) {
+            std::cerr << "❌ 临时文件写入失败: " << session->part_path << std::endl;
+        } else if (EVP_DigestFinal_ex(session->sha, digest, &digest_len) != 1 ||
+                   file_id_from_digest(digest) != session->entry.ID_F) {
+            // 哈希在接收过程中已增量完成，这里无需重读密文
+            std::cerr << "❌ 文件ID与密文哈希不一致 (ID_F != H1(C))" << std::endl;
+        } else {
+            std::lock_guard<std::mutex> writer(writer_mutex);
+            ok = publish_insert(session->entry, session->part_path, session->received);
         }
         
-        // 检查除数是否为0
-        if (mpz_cmp_ui(del_mpz, 0) == 0) {
-            std::cerr << "   ⚠️  del为0，无法执行除法" << std::endl;
-            mpz_clear(kt_wi_mpz);
-            mpz_clear(del_mpz);
-            mpz_clear(result_mpz);
+        if (!ok) {
+            std::remove(session->part_path.c_str());
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(upload_mutex);
+    upload_sessions.erase(upload_id);
+    return ok;
+}
+
+void StorageNode::abort_upload(const std::string& upload_id) {
+    std::shared_ptr<UploadSession> session = find_upload(upload_id);
+    if (!session) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        if (!session->closed) {
+            session->closed = true;
+            session->out.close();
+            std::remove(session->part_path.c_str());
+            std::cout << "   🗑️  已放弃上传: " << upload_id << std::endl;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(upload_mutex);
+    upload_sessions.erase(upload_id);
+}
+
+size_t StorageNode::abort_uploads_of(uint64_t owner) {
+    if (owner == 0) {
+        return 0;
+    }
+    std::vector<std::string> ids;
+    {
+        std::lock_guard<std::mutex> lock(upload_mutex);
+        for (const auto& pair : upload_sessions) {
+            if (pair.second->owner == owner) {
+                ids.push_back(pair.first);
+            }
+        }
+    }
+    for (const auto& id : ids) {
+        abort_upload(id);
+    }
+    return ids.size();
+}
+
+size_t StorageNode::reap_idle_uploads() {
+    if (upload_idle_timeout_sec <= 0) {
+        return 0;
+    }
+    uint64_t now = perf_metrics::now_ns();
+    uint64_t timeout_ns = static_cast<uint64_t>(upload_idle_timeout_sec) * 1000000000ull;
+    std::vector<std::string> ids;
+    {
+        std::lock_guard<std::mutex> lock(upload_mutex);
+        for (const auto& pair : upload_sessions) {
+            uint64_t last = pair.second->last_active_ns.load();
+            if (now > last && now - last > timeout_ns) {
+                ids.push_back(pair.first);
+            }
+        }
+    }
+    for (const auto& id : ids) {
+        std::cout << "   ⏱️  上传空闲超时: " << id << std::endl;
+        abort_upload(id);
+    }
+    return ids.size();
+}
+
+// ==================== 新增功能实现 ====================
+
+bool StorageNode::delete_file_from_json(const std::string& delete_json_path) {
+    std::cout << "\n🗑️  执行文件删除操作..." << std::endl;
+    return delete_files_from_json(std::vector<std::string>{delete_json_path});
+}
+
+bool StorageNode::delete_files_from_json(const std::vector<std::string>& delete_json_paths,
+                                         std::vector<DeleteResult>* results) {
+    // 步骤1: 加载全部JSON文件
+    std::vector<DeleteResult> load_failures;
+    std::vector<Json::Value> params_list;
+    params_list.reserve(delete_json_paths.size());
+    
+    for (const std::string& path : delete_json_paths) {
+        if (!file_exists(path)) {
+            std::cerr << "❌ 删除参数文件不存在: " << path << std::endl;
+            DeleteResult failure;
+            failure.error = "删除参数文件不存在: " + path;
+            load_failures.push_back(failure);
             continue;
         }
+        params_list.push_back(load_json_from_file(path));
+    }
+    
+    // 步骤2: 加载数据库（菜单模式下以磁盘为准，整批只加载一次）
+    if (!load_index_database()) {
+        std::cerr << "❌ 索引数据库加载失败" << std::endl;
+        return false;
+    }
+    
+    if (!load_search_database()) {
+        std::cerr << "❌ 搜索数据库加载失败" << std::endl;
+        return false;
+    }
+    
+    std::vector<DeleteResult> batch_results;
+    bool ok = delete_files_batch(params_list, &batch_results) && load_failures.empty();
+    
+    if (results) {
+        *results = std::move(load_failures);
+        results->insert(results->end(), batch_results.begin(), batch_results.end());
+    }
+    return ok;
+}
+
+bool StorageNode::delete_files_from_dir(const std::string& delete_dir) {
+    DIR* dir = opendir(delete_dir.c_str());
+    if (!dir) {
+        std::cerr << "❌ 无法打开删除参数目录: " << delete_dir << std::endl;
+        return false;
+    }
+    
+    std::vector<std::string> paths;
+    while (struct dirent* ent = readdir(dir)) {
+        std::string name = ent->d_name;
+        if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0) {
+            paths.push_back(delete_dir + "/" + name);
+        }
+    }
+    closedir(dir);
+    
+    if (paths.empty()) {
+        std::cerr << "❌ 目录中没有删除参数文件: " << delete_dir << std::endl;
+        return false;
+    }
+    
+    std::sort(paths.begin(), paths.end());
+    return delete_files_from_json(paths);
+}
+
+bool StorageNode::delete_file(const Json::Value& delete_params) {
+    std::vector<DeleteResult> results;
+    bool ok = delete_files_batch(std::vector<Json::Value>{delete_params}, &results);
+    
+    if (ok) {
+        std::cout << "✅ 文件删除成功" << std::endl;
+        std::cout << "   文件ID: " << results[0].ID_F << std::endl;
+        std::cout << "   更新的Ti_bar数量: " << results[0].keywords << std::endl;
+    }
+    return ok;
+}
+
+bool StorageNode::delete_files_batch(const std::vector<Json::Value>& delete_params_list,
+                                     std::vector<DeleteResult>* results) {
+    ScopedTimerServer timer(perf_callback_s, "server_delete_total");
+    const size_t count = delete_params_list.size();
+    std::vector<DeleteResult> outcome(count);
+    
+    std::cout << "\n🗑️  批量删除: " << count << " 个请求" << std::endl;
+    
+    // 步骤1: 提取参数（请求中的元素可能与数据库格式不同，统一转换后再比较/运算）
+    std::vector<std::string> PKs(count);
+    std::vector<std::string> dels(count);
+    std::vector<bool> parsed(count, false);
+    
+    for (size_t i = 0; i < count; ++i) {
+        const Json::Value& params = delete_params_list[i];
+        DeleteResult& res = outcome[i];
         
-        // 执行除法：result = kt_wi / del
-        mpz_fdiv_q(result_mpz, kt_wi_mpz, del_mpz);
+        if (!params.isObject() || !params.isMember("ID_F") ||
+            !params.isMember("PK") || !params.isMember("del")) {
+            res.error = "缺少必需字段 (ID_F, PK, del)";
+            continue;
+        }
         
-        // 转换回hex字符串
-        char* result_str = mpz_get_str(NULL, 16, result_mpz);
-        keyword.kt_wi = std::string(result_str);
-        free(result_str);
+        res.ID_F = params["ID_F"].asString();
+        PKs[i] = params["PK"].asString();
+        dels[i] = params["del"].asString();
         
-        mpz_clear(kt_wi_mpz);
-        mpz_clear(del_mpz);
-        mpz_clear(result_mpz);
+        if (!canonicalize_element(PKs[i]) || !canonicalize_element(dels[i])) {
+            res.error = "PK或del解码失败";
+            continue;
+        }
+        parsed[i] = true;
     }
     
-    // 步骤7: 设置文件状态为invalid
-    entry.state = "invalid";
-    std::cout << "   ✅ 文件状态已设置为 invalid" << std::endl;
+    // 校验通过、等待提交的删除项
+    struct PendingDelete {
+        size_t index;                     // 在 outcome 中的位置
+        IndexEntry* entry;
+        std::vector<std::string> kt_wi;   // 除去 del 后的新标签，与 entry->keywords 一一对应
+    };
+    std::vector<PendingDelete> pending;
+    std::map<std::string, size_t> seen;   // 批内去重：ID_F -> 请求序号
+    
+    // 单写者：持有 writer_mutex 期间索引项不会被其他写者修改或移除，
+    // 因此下面的校验与群运算无需独占锁，读者仍可并发搜索
+    std::lock_guard<std::mutex> writer(writer_mutex);
+    
+    // 步骤2: 查找文件、验证公钥与删除令牌并计算新的 kt_wi
+    ScopedTimerServer update_timer(perf_callback_s, "delete_kt_update");
+    PbcScratchPool::Lease scratch = scratch_pool.acquire(pairing);
+    element_t del_pairing, expected_pairing;
+    element_init_GT(del_pairing, pairing);
+    element_init_GT(expected_pairing, pairing);
+    
+    for (size_t i = 0; i < count; ++i) {
+        if (!parsed[i]) {
+            continue;
+        }
+        DeleteResult& res = outcome[i];
+        
+        auto it = index_database.find(res.ID_F);
+        if (it == index_database.end()) {
+            res.error = "文件不存在";
+            continue;
+        }
+        
+        IndexEntry& entry = it->second;
+        if (entry.PK != PKs[i]) {
+            res.error = "公钥验证失败，无权删除此文件";
+            continue;
+        }
+        
+        // 已删除的文件不能再次除以 del，否则链上 kt_wi 的伸缩乘积被破坏
+        if (entry.state == "invalid") {
+            res.error = "文件已删除";
+            continue;
+        }
+        
+        if (!seen.emplace(res.ID_F, i).second) {
+            res.error = "批内重复的删除请求";
+            continue;
+        }
+        
+        if (!deserializeElement(dels[i], scratch->hash, scratch->bytes)) {
+            res.error = "del反序列化失败";
+            continue;
+        }
+        
+        // PK 公开且删除请求无需认证：必须确认 del = H2(ID_F)^sk，即 e(del, g) == e(H2(ID_F), PK)，
+        // 否则伪造的 del 会永久破坏该文件所在的每条搜索链
+        if (!deserializeElement(entry.PK, scratch->aux, scratch->bytes)) {
+            res.error = "PK反序列化失败";
+            continue;
+        }
+        computeHashH2(res.ID_F, scratch->pow);
+        pairing_apply(del_pairing, scratch->hash, g, pairing);
+        pairing_apply(expected_pairing, scratch->pow, scratch->aux, pairing);
+        perf_metrics::count(&OpCounters::pairings, 2);
+        if (element_cmp(del_pairing, expected_pairing) != 0) {
+            res.error = "删除令牌验证失败 (e(del, g) != e(H2(ID_F), PK))";
+            continue;
+        }
+        
+        // kt_wi = [H2(ID_F)·H2(st_d||Ti)/H2(st_{d-1}||Ti)]^sk，del = H2(ID_F)^sk
+        // kt_wi · del^{-1} 只剩相邻状态的比值，搜索时仍与链上其他标签伸缩相消
+        PendingDelete item;
+        item.index = i;
+        item.entry = &entry;
+        item.kt_wi.reserve(entry.keywords.size());
+        
+        bool decoded = true;
+        for (const auto& keyword : entry.keywords) {
+            if (!deserializeElement(keyword.kt_wi, scratch->aux, scratch->bytes)) {
+                decoded = false;
+                break;
+            }
+            element_div(scratch->aux, scratch->aux, scratch->hash);
+            perf_metrics::count(&OpCounters::g1_multiplications);
+            item.kt_wi.push_back(serializeElement(scratch->aux, scratch->bytes));
+        }
+        
+        if (!decoded) {
+            res.error = "kt_wi反序列化失败";
+            continue;
+        }
+        
+        pending.push_back(std::move(item));
+    }
+    element_clear(del_pairing);
+    element_clear(expected_pairing);
+    update_timer.stop();
     
-    // 步骤7.5: 清空认证标签（方案A：防止已删除文件被误验证）
-    int original_ts_f_count = entry.TS_F.size();
-    entry.TS_F.clear();
-    std::cout << "   ✅ 已清空认证标签 (原有 " << original_ts_f_count << " 个标签)" << std::endl;
+    // 步骤3: 一次写锁内提交全部修改（读者只在这一段等待）
+    size_t updated_tags = 0;
+    size_t cleared_tags = 0;
     
-    // 步骤8: 更新搜索数据库
-    std::cout << "   更新搜索数据库..." << std::endl;
-    for (const std::string& Ti_bar : Ti_bars) {
-        auto search_it = search_database.find(Ti_bar);
-        if (search_it != search_database.end()) {
-            IndexSearchEntry& search_entry = search_it->second;
+    if (!pending.empty()) {
+        ScopedTimerServer apply_timer(perf_callback_s, "delete_apply");
+        auto db_lock = write_lock();
+        
+        for (PendingDelete& item : pending) {
+            IndexEntry& entry = *item.entry;
             
-            // 更新状态
-            search_entry.state = "invalid";
+            for (size_t k = 0; k < entry.keywords.size(); ++k) {
+                IndexKeywords& keyword = entry.keywords[k];
+                keyword.kt_wi = item.kt_wi[k];
+                
+                auto search_it = search_database.find(keyword.Ti_bar);
+                if (search_it != search_database.end()) {
+                    search_it->second.state = "invalid";
+                    search_it->second.kt_wi = item.kt_wi[k];
+                }
+            }
             
-            // 更新kt_wi = kt_wi / del
-            mpz_t kt_wi_mpz, del_mpz, result_mpz;
-            mpz_init(kt_wi_mpz);
-            mpz_init(del_mpz);
-            mpz_init(result_mpz);
+            entry.state = "invalid";
             
-            if (mpz_set_str(kt_wi_mpz, search_entry.kt_wi.c_str(), 16) == 0 &&
-                mpz_set_str(del_mpz, del.c_str(), 16) == 0 &&
-                mpz_cmp_ui(del_mpz, 0) != 0) {
-                
-                mpz_fdiv_q(result_mpz, kt_wi_mpz, del_mpz);
-                
-                char* result_str = mpz_get_str(NULL, 16, result_mpz);
-                search_entry.kt_wi = std::string(result_str);
-                free(result_str);
+            // 清空认证标签（方案A：防止已删除文件被误验证）
+            cleared_tags += entry.TS_F.size();
+            entry.TS_F.clear();
+            
+            updated_tags += item.kt_wi.size();
+            outcome[item.index].success = true;
+            outcome[item.index].keywords = item.kt_wi.size();
+        }
+        pending_compaction += pending.size();
+    }
+    
+    // 步骤4: 保存数据库（整批各保存一次）
+    if (!pending.empty()) {
+        bool saved = save_index_database();
+        if (!saved) {
+            std::cerr << "❌ 索引数据库保存失败" << std::endl;
+        } else if (!(saved = save_search_database())) {
+            std::cerr << "❌ 搜索数据库保存失败" << std::endl;
+        }
+        
+        if (!saved) {
+            for (const PendingDelete& item : pending) {
+                outcome[item.index].success = false;
+                outcome[item.index].error = "数据库保存失败";
+            }
+        }
+    }
+    
+    // 步骤5: 汇总
+    size_t succeeded = 0;
+    for (const DeleteResult& res : outcome) {
+        if (res.success) {
+            succeeded++;
+        } else {
+            std::cerr << "   ❌ " << (res.ID_F.empty() ? std::string("(无ID_F)") : res.ID_F.substr(0, 16))
+                      << ": " << res.error << std::endl;
+        }
+    }
+    
+    std::cout << "   ✅ 已删除: " << succeeded << "/" << count << std::endl;
+    std::cout << "   更新的kt_wi数量: " << updated_tags << std::endl;
+    std::cout << "   清空的认证标签数量: " << cleared_tags << std::endl;
+    
+    if (results) {
+        *results = std::move(outcome);
+    }
+    return succeeded == count;
+}
+
+// ==================== 已删除文件回收 ====================
+
+namespace {
+
+uint64_t file_size_or_zero(const std::string& path) {
+    struct stat buffer;
+    if (stat(path.c_str(), &buffer) != 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(buffer.st_size);
+}
+
+} // namespace
+
+size_t StorageNode::get_pending_compaction_count() const {
+    return pending_compaction.load();
+}
+
+bool StorageNode::compact_deleted_files(CompactionStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    CompactionStats run;
+    run.runs = 1;
+    
+    // 与插入/删除串行：持有 writer_mutex 期间索引项不会被其他写者修改，
+    // 收集与删盘阶段只读取索引，不阻塞读者
+    std::lock_guard<std::mutex> writer(writer_mutex);
+    
+    // 步骤1: 收集已删除但尚未回收的文件
+    std::vector<IndexEntry*> victims;
+    for (auto& pair : index_database) {
+        if (pair.second.state == "invalid" && !is_compacted(pair.second)) {
+            victims.push_back(&pair.second);
+        }
+    }
+    
+    bool saved = true;
+    if (!victims.empty()) {
+        ScopedTimerServer timer(perf_callback_s, "server_compaction_total");
+        std::cout << "\n🧹 回收已删除文件: " << victims.size() << " 个" << std::endl;
+        
+        std::string index_path = data_dir + "/index_db.json";
+        uint64_t index_before = file_size_or_zero(index_path);
+        
+        // 步骤2: 删除密文，元数据缩减为墓碑记录
+        // （正在读取该文件的读者持有已打开的描述符，不受 unlink 影响）
+        for (IndexEntry* entry : victims) {
+            std::string enc_path = entry->file_path.empty()
+                ? files_dir + "/" + entry->ID_F + ".enc" : entry->file_path;
+            uint64_t enc_size = file_size_or_zero(enc_path);
+            if (enc_size > 0 && std::remove(enc_path.c_str()) == 0) {
+                run.ciphertext_bytes += enc_size;
             }
             
-            mpz_clear(kt_wi_mpz);
-            mpz_clear(del_mpz);
-            mpz_clear(result_mpz);
+            std::string metadata_path = metadata_dir + "/" + entry->ID_F + ".json";
+            uint64_t metadata_before = file_size_or_zero(metadata_path);
+            
+            Json::Value tombstone;
+            tombstone["ID_F"] = entry->ID_F;
+            tombstone["PK"] = entry->PK;
+            tombstone["state"] = entry->state;
+            tombstone["compacted_at"] = get_current_timestamp();
+            tombstone["reclaimed_bytes"] = static_cast<Json::UInt64>(enc_size);
+            if (save_json_to_file(tombstone, metadata_path)) {
+                uint64_t metadata_after = file_size_or_zero(metadata_path);
+                if (metadata_before > metadata_after) {
+                    run.metadata_bytes += metadata_before - metadata_after;
+                }
+            }
+        }
+        
+        // 步骤3: 索引项只保留 ID_F/PK/state（链节点在搜索数据库中）
+        {
+            auto db_lock = write_lock();
+            for (IndexEntry* entry : victims) {
+                entry->file_path.clear();
+                entry->TS_F.clear();
+                std::vector<IndexKeywords>().swap(entry->keywords);
+            }
+            pending_compaction -= victims.size();
+        }
+        
+        // 步骤4: 保存索引数据库（整轮一次）
+        saved = save_index_database();
+        if (!saved) {
+            std::cerr << "❌ 索引数据库保存失败" << std::endl;
         }
+        
+        uint64_t index_after = file_size_or_zero(index_path);
+        if (index_before > index_after) {
+            run.index_bytes = index_before - index_after;
+        }
+        run.files = victims.size();
     }
     
-    // 步骤9: 保存数据库
-    if (!save_index_database()) {
-        std::cerr << "❌ 索引数据库保存失败" << std::endl;
-        return false;
+    run.elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    
+    {
+        std::lock_guard<std::mutex> lock(compaction_mutex);
+        compaction_totals.runs += run.runs;
+        compaction_totals.files += run.files;
+        compaction_totals.ciphertext_bytes += run.ciphertext_bytes;
+        compaction_totals.metadata_bytes += run.metadata_bytes;
+        compaction_totals.index_bytes += run.index_bytes;
+        compaction_totals.elapsed_ms += run.elapsed_ms;
     }
     
-    if (!save_search_database()) {
-        std::cerr << "❌ 搜索数据库保存失败" << std::endl;
+    if (run.files > 0) {
+        if (perf_callback_s && perf_callback_s->on_data_size_recorded) {
+            perf_callback_s->on_data_size_recorded("server_compaction_reclaimed", run.total_bytes());
+        }
+        
+        std::cout << "   ✅ 回收完成: " << run.files << " 个文件, 共 " << run.total_bytes() << " 字节" << std::endl;
+        std::cout << "   ├─ 密文:     " << run.ciphertext_bytes << " 字节" << std::endl;
+        std::cout << "   ├─ 元数据:   " << run.metadata_bytes << " 字节" << std::endl;
+        std::cout << "   ├─ 索引库:   " << run.index_bytes << " 字节" << std::endl;
+        std::cout << "   └─ 耗时:     " << run.elapsed_ms << " ms" << std::endl;
+    }
+    
+    if (stats) {
+        *stats = run;
+    }
+    return saved;
+}
+
+bool StorageNode::start_compactor() {
+    if (compaction_interval_sec <= 0) {
         return false;
     }
     
-    std::cout << "✅ 文件删除成功" << std::endl;
-    std::cout << "   文件ID: " << ID_F << std::endl;
-    std::cout << "   更新的Ti_bar数量: " << Ti_bars.size() << std::endl;
-    std::cout << "   清空的认证标签数量: " << original_ts_f_count << std::endl;
+    std::lock_guard<std::mutex> lock(compaction_mutex);
+    if (compaction_thread.joinable()) {
+        return true;
+    }
+    compaction_stop = false;
+    
+    compaction_thread = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(compaction_mutex);
+        while (!compaction_stop) {
+            compaction_cv.wait_for(lock, std::chrono::seconds(compaction_interval_sec),
+                                   [this]() { return compaction_stop; });
+            if (compaction_stop) {
+                break;
+            }
+            
+            // 回收过程会再次获取 compaction_mutex 以更新统计
+            lock.unlock();
+            size_t pending = get_pending_compaction_count();
+            if (pending > 0 && pending >= compaction_min_files) {
+                compact_deleted_files();
+            }
+            lock.lock();
+        }
+    });
     
+    std::cout << "🧹 后台回收已启动 (间隔 " << compaction_interval_sec << " 秒, 阈值 "
+              << compaction_min_files << " 个文件)" << std::endl;
     return true;
 }
 
+void StorageNode::stop_compactor() {
+    {
+        std::lock_guard<std::mutex> lock(compaction_mutex);
+        if (!compaction_thread.joinable()) {
+            return;
+        }
+        compaction_stop = true;
+    }
+    compaction_cv.notify_all();
+    compaction_thread.join();
+}
+
 bool StorageNode::SearchKeywordsAssociatedFilesProof(const std::string& search_json_path) {
     ScopedTimerServer timer(perf_callback_s, "server_search_total");
+    CounterScope counters(perf_callback_s, "server_search_total");
     std::cout << "\n🔍 执行关键词关联文件证明搜索..." << std::endl;
     
     // ========== 步骤1: 系统初始化 ==========
@@ -1285,6 +2262,67 @@ bool StorageNode::SearchKeywordsAssociatedFilesProof(const std::string& search_j
     
     Json::Value search_params = load_json_from_file(search_json_path);
     
+    // ========== 步骤2: 加载数据库 ==========
+    
+    if (!load_index_database()) {
+        std::cerr << "❌ 索引数据库加载失败" << std::endl;
+        return false;
+    }
+    
+    if (!load_search_database()) {
+        std::cerr << "❌ 搜索数据库加载失败" << std::endl;
+        return false;
+    }
+    
+    // ========== 步骤3-5: 计算搜索证明 ==========
+    
+    SearchProofResult output;
+    if (!build_search_proof(search_params, output, nullptr, true)) {
+        return false;
+    }
+    
+    // ========== 步骤6: 保存结果文件 ==========
+    
+    std::string output_path = search_proof_output_path(output);
+    ScopedTimerServer write_timer(perf_callback_s, "proof_write");
+    if (!save_json_to_file(output.to_json(), output_path)) {
+        std::cerr << "❌ 搜索结果保存失败" << std::endl;
+        return false;
+    }
+    write_timer.stop();
+    
+    if (!output.complete) {
+        std::cout << "⏱️  搜索预算已用尽，已返回部分证明" << std::endl;
+        std::cout << "   续传: 将 continuation 字段加入搜索参数后再次调用" << std::endl;
+    }
+    std::cout << "✅ 搜索证明生成成功" << std::endl;
+    std::cout << "   输出文件: " << output_path << std::endl;
+    std::cout << "   涉及文件数: " << output.AS.size() << std::endl;
+    std::cout << "   有效证明数: " << output.PS.size() << std::endl;
+    
+    return true;
+}
+
+void StorageNode::load_cached_search_file(const IndexEntry& entry, CachedSearchFile& out) {
+    if (!load_encrypted_file(entry.ID_F, out.ciphertext)) {
+        out.loaded = false;
+        return;
+    }
+    
+    // 一次性解码全部TS_F，空标签按单位元处理（对累乘无贡献）
+    PbcScratchPool::Lease scratch = scratch_pool.acquire(pairing);
+    out.tags.resize(entry.TS_F.size());
+    for (size_t i = 0; i < entry.TS_F.size(); ++i) {
+        element_init_G1(&out.tags[i], pairing);
+        if (!deserializeElement(entry.TS_F[i], &out.tags[i], scratch->bytes)) {
+            element_set1(&out.tags[i]);
+        }
+    }
+    out.loaded = true;
+}
+
+bool StorageNode::build_search_proof(const Json::Value& search_params, SearchProofResult& output,
+                                     SearchFileCache* cache, bool verbose) {
     // 验证必需字段
     if (!search_params.isMember("PK") || !search_params.isMember("T") || 
         !search_params.isMember("std")) {
@@ -1296,21 +2334,59 @@ bool StorageNode::SearchKeywordsAssociatedFilesProof(const std::string& search_j
     std::string T = search_params["T"].asString();
     std::string std_input = search_params["std"].asString();
     
-    std::cout << "   公钥: " << PK.substr(0, 16) << "..." << std::endl;
-    std::cout << "   搜索令牌: " << T << std::endl;
-    
-    // ========== 步骤2: 加载数据库 ==========
-    
-    if (!load_index_database()) {
-        std::cerr << "❌ 索引数据库加载失败" << std::endl;
+    // 公钥转换为数据库格式后与索引中的PK比较
+    if (!canonicalize_element(PK)) {
+        std::cerr << "❌ PK解码失败" << std::endl;
         return false;
     }
     
-    if (!load_search_database()) {
-        std::cerr << "❌ 搜索数据库加载失败" << std::endl;
+    // 预算参数：budget_ms 为时间预算，max_hops 为单次调用的最大跳数（0 表示不限制）
+    double budget_ms = search_params.get("budget_ms", 0.0).asDouble();
+    int max_hops = search_params.get("max_hops", 0).asInt();
+    
+    // 分页参数：limit 为本页最多返回的有效文件数，cursor 为上一页返回的链上状态，
+    // page 为页序号（第一页为0，续页由调用方递增），用于区分各页的证明文件
+    int limit = search_params.get("limit", 0).asInt();
+    std::string cursor = search_params.get("cursor", "").asString();
+    int page = search_params.get("page", 0).asInt();
+    if (!cursor.empty() && page <= 0) {
+        std::cerr << "❌ 续页请求缺少 page（应为上一页的 page + 1）" << std::endl;
         return false;
     }
     
+    // 续传令牌：从上一段证明返回的 st_alpha 继续搜索链
+    Json::Value prev_cont = search_params.get("continuation", Json::Value());
+    int segment = 0;
+    int hops_before = 0;
+    int files_before = 0;
+    if (prev_cont.isObject() && prev_cont.isMember("st_alpha")) {
+        if (prev_cont.get("T", T).asString() != T) {
+            std::cerr << "❌ 续传令牌与搜索令牌不匹配" << std::endl;
+            return false;
+        }
+        std_input = prev_cont["st_alpha"].asString();
+        page = prev_cont.get("page", page).asInt();
+        segment = prev_cont.get("segment", 0).asInt() + 1;
+        hops_before = prev_cont.get("hops_done", 0).asInt();
+        files_before = prev_cont.get("files_done", 0).asInt();
+    } else if (!cursor.empty()) {
+        // 续页：证明写入 [T]_page[k].json
+        std_input = cursor;
+    }
+    
+    if (verbose) {
+        std::cout << "   公钥: " << PK.substr(0, 16) << "..." << std::endl;
+        std::cout << "   搜索令牌: " << T << std::endl;
+        if (page > 0) {
+            std::cout << "   分页: 第 " << page + 1 << " 页" << std::endl;
+        }
+        if (segment > 0) {
+            std::cout << "   续传分段: " << segment << " (已完成 " << hops_before << " 跳)" << std::endl;
+        }
+    }
+    
+    auto search_start = std::chrono::steady_clock::now();
+    
     // ========== 步骤3: 初始化结果容器 ==========
     
     std::vector<std::string> AS;  // 涉及的所有文件ID
@@ -1319,6 +2395,9 @@ bool StorageNode::SearchKeywordsAssociatedFilesProof(const std::string& search_j
     std::string st_alpha = std_input;  // 当前状态
     std::string st_alpha_next;         // 下一个状态
     
+    // 本次请求复用的临时变量（Ti_bar / kt_wi / 逐块内核）
+    PbcScratchPool::Lease scratch = scratch_pool.acquire(pairing);
+    
     // 新增：初始化全局phi变量（操作1使用）
     element_t global_phi;
     element_init_G1(global_phi, pairing);
@@ -1326,102 +2405,172 @@ bool StorageNode::SearchKeywordsAssociatedFilesProof(const std::string& search_j
     
     // 新增：生成随机种子（在循环开始前生成一次）
     std::string search_seed = generate_random_seed();
-    std::cout << "   生成搜索种子: " << search_seed.substr(0, 16) << "..." << std::endl;
+    if (verbose) {
+        std::cout << "   生成搜索种子: " << search_seed.substr(0, 16) << "..." << std::endl;
+    }
     
     // ========== 步骤4: 主搜索循环 ==========
     
-    std::cout << "   开始搜索链..." << std::endl;
-    int loop_count = 0;
-    const int MAX_LOOPS = 1000;  // 防止无限循环
+    // 共享锁：与其他搜索/证明并行，插入/删除修改数据库期间等待
+    auto db_lock = read_lock();
     
-    while (loop_count < MAX_LOOPS) {
+    if (verbose) {
+        std::cout << "   开始搜索链..." << std::endl;
+    }
+    int loop_count = 0;
+    const int MAX_LOOPS = 1000;  // 单段最大跳数，超出后以续传令牌返回
+    bool chain_complete = false;
+    bool page_full = false;      // 本页已满：以 cursor 翻页，不再返回续传令牌
+    
+    // 链遍历及其子阶段（逐跳/逐块累计）
+    ScopedTimerServer chain_timer(perf_callback_s, "chain_walk");
+    AccumTimerServer hash_timer(perf_callback_s, "hash_to_g1");
+    AccumTimerServer pointer_timer(perf_callback_s, "pointer_decrypt");
+    AccumTimerServer io_timer(perf_callback_s, "ciphertext_io");
+    AccumTimerServer prf_timer(perf_callback_s, "prf");
+    AccumTimerServer psi_timer(perf_callback_s, "psi_kernel");
+    AccumTimerServer phi_timer(perf_callback_s, "phi_exponentiation");
+    AccumTimerServer codec_timer(perf_callback_s, "serialization");
+    
+    while (true) {
+        // 预算检查：每段至少推进一跳，保证续传调用总有进展
+        if (loop_count > 0) {
+            double elapsed_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - search_start).count();
+            if (loop_count >= MAX_LOOPS ||
+                (max_hops > 0 && loop_count >= max_hops) ||
+                (budget_ms > 0 && elapsed_ms >= budget_ms)) {
+                break;
+            }
+        }
         loop_count++;
         
         // --- 操作1: 计算Ti_bar并查找 ---
         
-        element_t Ti_bar_elem;
-        element_init_G1(Ti_bar_elem, pairing);
-        computeHashH2(T + st_alpha , Ti_bar_elem);
+        scratch->text.assign(T);
+        scratch->text.append(st_alpha);
+        hash_timer.begin();
+        computeHashH2(scratch->text, scratch->aux);
+        hash_timer.end();
+        codec_timer.begin();
+        std::string Ti_bar = serializeElement(scratch->aux, scratch->bytes);
+        codec_timer.end();
         
-        // 将element转换为hex字符串
-        int Ti_bar_len = element_length_in_bytes(Ti_bar_elem);
-        unsigned char* Ti_bar_bytes = new unsigned char[Ti_bar_len];
-        element_to_bytes(Ti_bar_bytes, Ti_bar_elem);
-        std::string Ti_bar = bytesToHex(Ti_bar_bytes, Ti_bar_len);
-        delete[] Ti_bar_bytes;
-        element_clear(Ti_bar_elem);
-        
-        std::cout << "   [" << loop_count << "] 查找 Ti_bar: " << Ti_bar.substr(0, 16) << "..." << std::endl;
+        if (verbose) {
+            std::cout << "   [" << loop_count << "] 查找 Ti_bar: " << Ti_bar.substr(0, 16) << "..." << std::endl;
+        }
         
         auto search_it = search_database.find(Ti_bar);
         if (search_it == search_database.end()) {
-            std::cout << "   ⚠️  未找到Ti_bar，搜索结束" << std::endl;
+            if (verbose) {
+                std::cout << "   ⚠️  未找到Ti_bar，搜索结束" << std::endl;
+            }
+            chain_complete = true;
             break;
         }
         
-        IndexSearchEntry& search_entry = search_it->second;
-        std::string ID_F = search_entry.ID_F;
+        // 本页已满：在查找之后判断，最后一个有效文件恰为链尾时本页即完整，不返回空页游标。
+        // 预算分段时本页的文件分布在多段中，须计入之前各段已返回的文件数
+        if (limit > 0 && files_before + static_cast<int>(AS.size()) >= limit) {
+            loop_count--;  // 该条目留给下一页，不计入本页跳数
+            page_full = true;
+            break;
+        }
         
-        std::cout << "   ✅ 找到文件: " << ID_F << std::endl;
+        const IndexSearchEntry& search_entry = search_it->second;
+        const std::string& ID_F = search_entry.ID_F;
+        
+        if (verbose) {
+            std::cout << "   ✅ 找到文件: " << ID_F << std::endl;
+        }
         
         // 查找文件
         auto index_it = index_database.find(ID_F);
         if (index_it == index_database.end()) {
             std::cerr << "❌ 文件不存在: " << ID_F << std::endl;
+            chain_complete = true;
             break;
         }
         
-        IndexEntry& file_entry = index_it->second;
+        const IndexEntry& file_entry = index_it->second;
         
         // 验证公钥
         if (file_entry.PK != PK) {
             std::cerr << "❌ 公钥验证失败" << std::endl;
+            element_clear(global_phi);
             return false;
         }
         
         // 解密指针获取下一个状态
+        pointer_timer.begin();
         std::string st_alpha_hash = computeHashH3(st_alpha);
         st_alpha_next = decrypt_pointer(st_alpha_hash, search_entry.ptr_i);
+        pointer_timer.end();
         
         
         // --- 操作2: 计算证明（仅当state为valid时） ---
         
+        // 更新全局phi变量：已删除文件的 kt_wi 已除去 H2(ID_F)^sk，仍需累乘以保持链上伸缩相消
+        codec_timer.begin();
+        bool kt_decoded = deserializeElement(search_entry.kt_wi, scratch->aux, scratch->bytes);
+        codec_timer.end();
+        if (kt_decoded) {
+            element_mul(global_phi, global_phi, scratch->aux);
+            perf_metrics::count(&OpCounters::g1_multiplications);
+        } else if (search_entry.state == "valid") {
+            std::cerr << "❌ kt_wi 反序列化失败: " << ID_F << std::endl;
+            element_clear(global_phi);
+            return false;
+        } else {
+            // 旧版本按大整数除法删除的条目无法解码，该链的证明将无法通过验证
+            std::cerr << "⚠️  已删除文件的 kt_wi 无法解码: " << ID_F << std::endl;
+        }
+        
         if (search_entry.state == "valid") {
             // 记录文件ID，有效文件ID集合
             AS.push_back(ID_F);
             
-            // 更新全局phi变量
-            element_t kt_wi_elem;
-            element_init_G1(kt_wi_elem, pairing);
-        
-            std::vector<unsigned char> kt_wi_bytes = hexToBytes(search_entry.kt_wi);
-            element_from_bytes(kt_wi_elem, kt_wi_bytes.data());
-        
-            element_mul(global_phi, global_phi, kt_wi_elem);
-            element_clear(kt_wi_elem);
-            
-            std::cout << "   生成证明..." << std::endl;
+            if (verbose) {
+                std::cout << "   生成证明..." << std::endl;
+            }
             
             SearchResult temp_result;
             temp_result.ID_F = ID_F;
             
-            // 获取TS_F集合
-            const std::vector<std::string>& TS_F = file_entry.TS_F;
-            int n = TS_F.size();  // 块数量
+            // 获取密文与已解码的TS_F（批量模式下由缓存共享）
+            std::shared_ptr<const CachedSearchFile> file_data;
+            io_timer.begin();
+            if (cache) {
+                file_data = cache->get_or_load(ID_F, [this, &file_entry](CachedSearchFile& out) {
+                    load_cached_search_file(file_entry, out);
+                });
+            } else {
+                auto local = std::make_shared<CachedSearchFile>();
+                load_cached_search_file(file_entry, *local);
+                file_data = local;
+            }
+            io_timer.end();
             
-            std::cout << "   块数量: " << n << std::endl;
+            // 该文件的 kt_wi 已乘入 global_phi，跳过它会破坏伸缩相消，
+            // 只保留 AS 又会使 AS/PS 错位，因此整个搜索失败
+            if (!file_data->loaded) {
+                std::cerr << "❌ 无法加载密文文件，搜索失败: " << ID_F << std::endl;
+                element_clear(global_phi);
+                return false;
+            }
             
-            // 加载密文文件
-            std::string ciphertext;
-            if (!load_encrypted_file(ID_F, ciphertext)) {
-                std::cerr << "❌ 无法加载密文文件: " << ID_F << std::endl;
-                st_alpha = st_alpha_next;
-                continue;
+            const std::string& ciphertext = file_data->ciphertext;
+            int n = file_data->tags.size();  // 块数量
+            
+            if (verbose) {
+                std::cout << "   块数量: " << n << std::endl;
             }
             
             // 使用在步骤3中生成的search_seed
-            std::string seed = search_seed;
-            std::cout << "   使用种子: " << seed << "..." << std::endl;
+            const std::string& seed = search_seed;
+            if (verbose) {
+                std::cout << "   使用种子: " << seed << "..." << std::endl;
+            }
             
             // 初始化累积变量
             mpz_t psi_alpha;
@@ -1431,94 +2580,51 @@ bool StorageNode::SearchKeywordsAssociatedFilesProof(const std::string& search_j
             element_init_G1(phi_element, pairing);
             element_set1(phi_element);  // 初始化为单位元
             
-            // 遍历每个块（统一改为从0开始）
+            // 遍历每个块（统一改为从0开始），临时变量全部来自scratch
+            const unsigned char* cipher_bytes = reinterpret_cast<const unsigned char*>(ciphertext.data());
             for (int i = 0; i < n; ++i) {
-                // 计算PRF值（保持PRF使用1-based索引以兼容已有数据）
-                mpz_t prf_temp;
-                mpz_init(prf_temp);
-                compute_prf(prf_temp, seed, ID_F, i);
+                // 计算PRF值
+                prf_timer.begin();
+                compute_prf(scratch->prf, seed, ID_F, i, scratch->text);
+                prf_timer.end();
                 
-                // 获取第i块的数据
-                size_t block_start = i * BLOCK_SIZE;
-                size_t block_end = std::min(block_start + BLOCK_SIZE, ciphertext.size());
-                std::vector<unsigned char> current_block;
-                if (block_end > block_start) {
-                    current_block.assign(
-                    ciphertext.begin() + block_start,
-                    ciphertext.begin() + block_end
-                    );
-                if (current_block.size() < BLOCK_SIZE) {
-                    current_block.resize(BLOCK_SIZE, 0);
-                    }
-                }
-                // 遍历该块的每个扇区
+                // 获取第i块的数据（末块补零）
+                psi_timer.begin();
+                const unsigned char* block = scratch->padded_block(
+                    cipher_bytes, ciphertext.size(), i, BLOCK_SIZE);
+                
+                // 遍历该块的每个扇区，直接从块内存导入 c_ij
                 for (size_t j = 0; j < SECTORS_PER_BLOCK; j++) {
-                    size_t sector_start = j * SECTOR_SIZE;
-                    size_t sector_end = sector_start + SECTOR_SIZE;
-                    
-                    // 提取扇区数据
-                    std::vector<unsigned char> sector_data(
-                        current_block.begin() + sector_start,
-                        current_block.begin() + sector_end
-                    );
-                    
-                    // 将扇区数据转换为mpz_t
-                    mpz_t C_ij;
-                    mpz_init(C_ij);
-                    mpz_import(C_ij, sector_data.size(), 1, 1, 0, 0, sector_data.data());
+                    mpz_import(scratch->c_ij, SECTOR_SIZE, 1, 1, 0, 0, block + j * SECTOR_SIZE);
                     
                     // 计算 prf_temp * C_ij
-                    mpz_t product;
-                    mpz_init(product);
-                    mpz_mul(product, prf_temp, C_ij);
-                    mpz_mod(product, product, r);  // 防止溢出
-                
+                    mpz_mul(scratch->product, scratch->prf, scratch->c_ij);
+                    mpz_mod(scratch->product, scratch->product, r);  // 防止溢出
+                    
                     // ✅ 修改：累积并模r（而不是模N）
-                    mpz_add(psi_alpha, psi_alpha, product);
+                    mpz_add(psi_alpha, psi_alpha, scratch->product);
                     mpz_mod(psi_alpha, psi_alpha, r);  // ✅ 关键修改：使用r
-                    
-                    mpz_clear(C_ij);
-                    mpz_clear(product);
                 }
+                psi_timer.end();
                 
-                // 计算 sigma_i^prf_temp
-                if (i < (int)TS_F.size()) {
-                    element_t sigma_i;
-                    element_init_G1(sigma_i, pairing);
-                    
-                    // 将TS_F[i]转换为element_t
-                    std::vector<unsigned char> sigma_bytes = hexToBytes(TS_F[i]);
-                    if (!sigma_bytes.empty()) {
-                        element_from_bytes(sigma_i, sigma_bytes.data());
-                        
-                        // 计算 phi_temp = sigma_i^prf_temp
-                        element_t phi_temp;
-                        element_init_G1(phi_temp, pairing);
-                        element_pow_mpz(phi_temp, sigma_i, prf_temp);
-                        
-                        // 累积：phi_element *= phi_temp
-                        element_mul(phi_element, phi_element, phi_temp);
-                        
-                        element_clear(phi_temp);
-                    }
-                    
-                    element_clear(sigma_i);
-                }
-                
-                mpz_clear(prf_temp);
+                // 计算 sigma_i^prf_temp 并累积：phi_element *= phi_temp
+                phi_timer.begin();
+                element_pow_mpz(scratch->pow, const_cast<element_ptr>(&file_data->tags[i]), scratch->prf);
+                element_mul(phi_element, phi_element, scratch->pow);
+                perf_metrics::count(&OpCounters::g1_exponentiations);
+                perf_metrics::count(&OpCounters::g1_multiplications);
+                phi_timer.end();
             }
             
             // 转换结果为字符串
+            codec_timer.begin();
             char* psi_str = mpz_get_str(NULL, 16, psi_alpha);
             temp_result.psi = std::string(psi_str);
             free(psi_str);
             
             // 将phi_element转换为hex字符串
-            int phi_len = element_length_in_bytes(phi_element);
-            unsigned char* phi_bytes = new unsigned char[phi_len];
-            element_to_bytes(phi_bytes, phi_element);
-            temp_result.phi = bytesToHex(phi_bytes, phi_len);
-            delete[] phi_bytes;
+            temp_result.phi = serializeElement(phi_element, scratch->bytes);
+            codec_timer.end();
             
             mpz_clear(psi_alpha);
             element_clear(phi_element);
@@ -1526,76 +2632,468 @@ bool StorageNode::SearchKeywordsAssociatedFilesProof(const std::string& search_j
             // 添加到PS
             PS.push_back(temp_result);
             
-            std::cout << "   ✅ 证明生成完成" << std::endl;
-        } else {
+            if (verbose) {
+                std::cout << "   ✅ 证明生成完成" << std::endl;
+            }
+        } else if (verbose) {
             std::cout << "   ⚠️  文件状态为 invalid，跳过证明生成" << std::endl;
         }
         
         // --- 操作3: 检查是否继续循环 ---
         
         if (st_alpha == st_alpha_next || st_alpha_next.empty()) {
-            std::cout << "   到达链表末尾" << std::endl;
+            if (verbose) {
+                std::cout << "   到达链表末尾" << std::endl;
+            }
+            chain_complete = true;
             break;
         }
         
         st_alpha = st_alpha_next;
     }
     
-    if (loop_count >= MAX_LOOPS) {
-        std::cerr << "⚠️  达到最大循环次数，强制退出" << std::endl;
+    chain_timer.stop();
+    
+    if (!chain_complete && !page_full && verbose) {
+        std::cout << "   ⏱️  达到搜索预算，返回部分证明与续传令牌 (本段 "
+                  << loop_count << " 跳)" << std::endl;
+    }
+    
+    // ========== 步骤5: 生成输出JSON ==========
+    
+    if (verbose) {
+        std::cout << "   生成输出文件..." << std::endl;
+    }
+    
+    output = SearchProofResult();
+    output.T = T;
+    output.std_state = std_input;   // 本段起始状态
+    
+    // 部分证明：next_std 为本段之后的状态，验证时用于消去链尾的状态项
+    output.complete = chain_complete;
+    output.next_std = chain_complete ? "" : st_alpha;
+    output.segment = segment;
+    output.page = page;
+    output.hops = loop_count;
+    output.limit = limit;
+    
+    // 分页游标：非空表示还有更早的文件，作为下一页请求的 cursor。
+    // 续传令牌只在预算截断、本页未满时返回：调用方有 continuation 时续传本页，否则按 cursor 翻页
+    output.cursor = output.next_std;
+    if (!chain_complete && !page_full) {
+        Json::Value cont;
+        cont["T"] = T;
+        cont["st_alpha"] = st_alpha;
+        cont["segment"] = segment;
+        cont["page"] = page;
+        cont["hops_done"] = hops_before + loop_count;
+        cont["files_done"] = files_before + static_cast<int>(AS.size());
+        output.continuation = cont;
+    }
+    
+    // 新增：添加 seed 与 phi 字段
+    output.PK = PK;
+    output.seed = search_seed;
+    output.phi = serializeElement(global_phi, scratch->bytes);
+    output.element_format = element_codec::format_name(element_format);
+    output.AS = std::move(AS);
+    output.PS = std::move(PS);
+    output.success = true;
+    
+    // 新增：清理资源
+    element_clear(global_phi);
+    
+    return true;
+}
+
+std::string StorageNode::search_proof_output_path(const SearchProofResult& proof) const {
+    // 续页写入 [T]_page[k].json，续传分段再追加 _seg[k]，避免覆盖前一页/前一段的证明
+    std::string path = data_dir + "/SearchProof/" + proof.T;
+    if (proof.page > 0) {
+        path += "_page" + std::to_string(proof.page);
+    }
+    if (proof.segment > 0) {
+        path += "_seg" + std::to_string(proof.segment);
+    }
+    return path + ".json";
+}
+
+SearchProofResult StorageNode::ComputeSearchProof(const Json::Value& search_params,
+                                                  SearchFileCache* cache) {
+    ScopedTimerServer timer(perf_callback_s, "server_search_compute");
+    CounterScope counters(perf_callback_s, "server_search_compute");
+    SearchProofResult result;
+    if (!build_search_proof(search_params, result, cache, false)) {
+        result.success = false;
+    }
+    return result;
+}
+
+// ==================== 证明对象序列化 ====================
+
+Json::Value SearchProofResult::to_json() const {
+    Json::Value output;
+    output["T"] = T;
+    output["std"] = std_state;
+    output["complete"] = complete;
+    output["next_std"] = next_std;
+    output["segment"] = segment;
+    output["hops"] = hops;
+    if (limit > 0) {
+        output["limit"] = limit;
+    }
+    if (page > 0) {
+        output["page"] = page;
+    }
+    output["cursor"] = cursor;
+    if (!complete && continuation.isObject()) {
+        output["continuation"] = continuation;
+    }
+    if (!PK.empty()) {
+        output["PK"] = PK;
+    }
+    output["seed"] = seed;
+    output["phi"] = phi;
+    output["element_format"] = element_format;
+    
+    Json::Value as_array(Json::arrayValue);
+    for (const std::string& id : AS) {
+        as_array.append(id);
+    }
+    output["AS"] = as_array;
+    
+    Json::Value ps_array(Json::arrayValue);
+    for (const SearchResult& item : PS) {
+        Json::Value ps_item;
+        ps_item["ID_F"] = item.ID_F;
+        ps_item["psi_alpha"] = item.psi;
+        ps_item["phi_alpha"] = item.phi;
+        ps_array.append(ps_item);
+    }
+    output["PS"] = ps_array;
+    return output;
+}
+
+SearchProofResult SearchProofResult::from_json(const Json::Value& root) {
+    SearchProofResult proof;
+    if (!root.isMember("AS") || !root.isMember("PS") ||
+        !root.isMember("T") || !root.isMember("std") ||
+        !root.isMember("seed") || !root.isMember("phi")) {
+        return proof;
+    }
+    
+    proof.T = root["T"].asString();
+    proof.std_state = root["std"].asString();
+    proof.next_std = root.get("next_std", "").asString();
+    proof.cursor = root.get("cursor", "").asString();
+    proof.complete = root.get("complete", true).asBool();
+    proof.segment = root.get("segment", 0).asInt();
+    proof.hops = root.get("hops", 0).asInt();
+    proof.limit = root.get("limit", 0).asInt();
+    proof.page = root.get("page", 0).asInt();
+    proof.continuation = root.get("continuation", Json::Value());
+    proof.PK = root.get("PK", "").asString();
+    proof.seed = root["seed"].asString();
+    proof.phi = root["phi"].asString();
+    proof.element_format = root.get("element_format", "uncompressed_hex").asString();
+    
+    for (const auto& id : root["AS"]) {
+        proof.AS.push_back(id.asString());
+    }
+    for (const auto& ps_item : root["PS"]) {
+        SearchResult item;
+        item.ID_F = ps_item["ID_F"].asString();
+        item.psi = ps_item["psi_alpha"].asString();
+        item.phi = ps_item["phi_alpha"].asString();
+        proof.PS.push_back(item);
+    }
+    proof.success = true;
+    return proof;
+}
+
+Json::Value FileProofResult::to_json() const {
+    Json::Value output;
+    output["ID_F"] = ID_F;
+    
+    Json::Value fileproof_json;
+    fileproof_json["psi"] = proof.psi;
+    fileproof_json["phi"] = proof.phi;
+    output["FileProof"] = fileproof_json;
+    
+    output["seed"] = seed;
+    output["element_format"] = element_format;
+    return output;
+}
+
+FileProofResult FileProofResult::from_json(const Json::Value& root) {
+    FileProofResult result;
+    if (!root.isMember("ID_F") || !root.isMember("FileProof") ||
+        !root.isMember("seed")) {
+        return result;
+    }
+    
+    result.ID_F = root["ID_F"].asString();
+    result.seed = root["seed"].asString();
+    result.proof.psi = root["FileProof"]["psi"].asString();
+    result.proof.phi = root["FileProof"]["phi"].asString();
+    result.element_format = root.get("element_format", "uncompressed_hex").asString();
+    result.success = true;
+    return result;
+}
+
+// ==================== 批量搜索 ====================
+
+namespace {
+
+/**
+ * g1_element_heap_bytes() - 单个已初始化G1元素的估算堆占用
+ * 按A类配对的布局：element->data 指向点结构 {x, y, inf_flag}，
+ * 坐标各为一个 mpz（结构体 + limb 数组），limb 长度取坐标序列化长度
+ */
+uint64_t g1_element_heap_bytes(pairing_t pairing) {
+    size_t coord_bytes = static_cast<size_t>(pairing_length_in_bytes_G1(pairing)) / 2;
+    return mem_stats::heap_block(2 * sizeof(element_s) + sizeof(int)) +
+           2 * (mem_stats::heap_block(sizeof(__mpz_struct)) + mem_stats::heap_block(coord_bytes));
+}
+
+} // namespace
+
+SearchFileCache::SearchFileCache(uint64_t budget_bytes, uint64_t element_bytes)
+    : budget_bytes_(budget_bytes), element_bytes_(element_bytes) {}
+
+std::shared_ptr<const CachedSearchFile> SearchFileCache::get_or_load(
+    const std::string& ID_F,
+    const std::function<void(CachedSearchFile&)>& loader) {
+    std::shared_ptr<Slot> slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& entry = slots_[ID_F];
+        if (!entry) {
+            entry = std::make_shared<Slot>();
+        } else if (entry->resident) {
+            lru_.splice(lru_.begin(), lru_, entry->lru_pos);
+        }
+        slot = entry;
+    }
+    
+    // 加载在锁外进行，其他线程请求同一ID_F时在call_once上等待
+    bool loaded_here = false;
+    std::call_once(slot->once, [&slot, &loader, &loaded_here]() {
+        auto data = std::make_shared<CachedSearchFile>();
+        loader(*data);
+        slot->data = data;
+        loaded_here = true;
+    });
+    
+    // 由加载者计入预算；返回的 shared_ptr 使本次使用不受随后淘汰的影响
+    std::shared_ptr<const CachedSearchFile> data = slot->data;
+    if (loaded_here) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slot->bytes = entry_bytes(ID_F, *data);
+        slot->lru_pos = lru_.insert(lru_.begin(), ID_F);
+        slot->resident = true;
+        bytes_ += slot->bytes;
+        loads_++;
+        evict_locked(ID_F);
+        peak_bytes_ = std::max(peak_bytes_, bytes_);
+    }
+    return data;
+}
+
+uint64_t SearchFileCache::entry_bytes(const std::string& ID_F, const CachedSearchFile& data) const {
+    uint64_t bytes = mem_stats::map_node<std::string, std::shared_ptr<Slot>>() + mem_stats::string_heap(ID_F);
+    bytes += mem_stats::heap_block(sizeof(Slot) + 16);                  // make_shared 控制块
+    bytes += mem_stats::heap_block(2 * sizeof(void*) + sizeof(std::string)) + mem_stats::string_heap(ID_F);  // LRU 节点
+    bytes += mem_stats::heap_block(sizeof(CachedSearchFile) + 16);
+    bytes += mem_stats::string_heap(data.ciphertext);
+    bytes += mem_stats::vector_heap(data.tags) + data.tags.size() * element_bytes_;
+    return bytes;
+}
+
+void SearchFileCache::evict_locked(const std::string& keep) {
+    if (budget_bytes_ == 0) {
+        return;
+    }
+    // 从最久未用的条目开始淘汰，刚加载的条目保留（单个文件超过预算时也能完成本次请求）
+    while (bytes_ > budget_bytes_ && !lru_.empty() && lru_.back() != keep) {
+        auto it = slots_.find(lru_.back());
+        bytes_ -= it->second->bytes;
+        lru_.pop_back();
+        slots_.erase(it);
+        evictions_++;
+    }
+}
+
+size_t SearchFileCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+size_t SearchFileCache::loads() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loads_;
+}
+
+size_t SearchFileCache::evictions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evictions_;
+}
+
+uint64_t SearchFileCache::memory_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+uint64_t SearchFileCache::peak_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_bytes_;
+}
+
+bool StorageNode::SearchKeywordsBatchProof(const std::vector<std::string>& search_json_paths,
+                                           int num_threads,
+                                           std::vector<std::string>* failed_paths) {
+    ScopedTimerServer timer(perf_callback_s, "server_search_batch_total");
+    std::cout << "\n🔍 执行批量关键词搜索证明..." << std::endl;
+    std::cout << "   请求数量: " << search_json_paths.size() << std::endl;
+    
+    if (search_json_paths.empty()) {
+        return true;
+    }
+    
+    // ========== 步骤1: 一次性初始化（目录 + 数据库） ==========
+    
+    std::string search_proof_dir = data_dir + "/SearchProof";
+    if (!create_directory(search_proof_dir)) {
+        std::cerr << "❌ 无法创建SearchProof目录" << std::endl;
+        return false;
     }
     
-    // ========== 步骤5: 生成输出JSON ==========
+    if (!load_index_database()) {
+        std::cerr << "❌ 索引数据库加载失败" << std::endl;
+        return false;
+    }
     
-    std::cout << "   生成输出文件..." << std::endl;
+    if (!load_search_database()) {
+        std::cerr << "❌ 搜索数据库加载失败" << std::endl;
+        return false;
+    }
     
-    Json::Value output;
-    output["T"] = T;
-    output["std"] = std_input;
+    // ========== 步骤2: 预先解析全部请求 ==========
     
-    // 新增：添加 seed 字段
-    output["seed"] = search_seed;
+    std::vector<Json::Value> requests(search_json_paths.size());
+    std::vector<char> ok(search_json_paths.size(), 0);
+    for (size_t k = 0; k < search_json_paths.size(); ++k) {
+        if (!file_exists(search_json_paths[k])) {
+            std::cerr << "❌ 搜索参数文件不存在: " << search_json_paths[k] << std::endl;
+            continue;
+        }
+        requests[k] = load_json_from_file(search_json_paths[k]);
+        ok[k] = 1;
+    }
     
-    // 新增：添加 phi 字段
-    int phi_len = element_length_in_bytes(global_phi);
-    unsigned char* phi_bytes = new unsigned char[phi_len];
-    element_to_bytes(phi_bytes, global_phi);
-    output["phi"] = bytesToHex(phi_bytes, phi_len);
-    delete[] phi_bytes;
+    // ========== 步骤3: 线程池执行 ==========
     
-    Json::Value as_array(Json::arrayValue);
-    for (const std::string& id : AS) {
-        as_array.append(id);
+    if (num_threads <= 0) {
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (num_threads <= 0) {
+            num_threads = 1;
+        }
     }
-    output["AS"] = as_array;   
+    num_threads = std::min<int>(num_threads, static_cast<int>(search_json_paths.size()));
+    std::cout << "   工作线程数: " << num_threads << std::endl;
+    
+    uint64_t element_bytes = crypto_initialized ? g1_element_heap_bytes(pairing) : 0;
+    SearchFileCache cache(search_cache_budget_mb * 1024 * 1024, element_bytes);
+    std::atomic<size_t> next_index(0);
+    std::atomic<size_t> done_count(0);
+    
+    auto worker = [&]() {
+        for (;;) {
+            size_t k = next_index.fetch_add(1);
+            if (k >= requests.size()) {
+                break;
+            }
+            if (!ok[k]) {
+                continue;
+            }
+            
+            // 每个请求单独计数（计数器是线程局部的，各工作线程互不干扰）
+            SearchProofResult output;
+            bool built;
+            {
+                CounterScope counters(perf_callback_s, "server_search_compute");
+                built = build_search_proof(requests[k], output, &cache, false);
+            }
+            if (!built) {
+                ok[k] = 0;
+                continue;
+            }
+            
+            std::string output_path = search_proof_output_path(output);
+            if (!save_json_to_file(output.to_json(), output_path)) {
+                ok[k] = 0;
+                continue;
+            }
+            done_count.fetch_add(1);
+        }
+    };
     
-    Json::Value ps_array(Json::arrayValue);
-    for (const SearchResult& result : PS) {
-        Json::Value ps_item;
-        ps_item["ID_F"] = result.ID_F;
-        ps_item["psi_alpha"] = result.psi;
-        ps_item["phi_alpha"] = result.phi;
-        ps_array.append(ps_item);
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+        workers.emplace_back(worker);
+    }
+    for (auto& th : workers) {
+        th.join();
     }
-    output["PS"] = ps_array;
     
-    // ========== 步骤6: 保存结果文件 ==========
+    // ========== 步骤4: 汇总 ==========
     
-    std::string output_path = search_proof_dir + "/" + T + ".json";
-    if (!save_json_to_file(output, output_path)) {
-        std::cerr << "❌ 搜索结果保存失败" << std::endl;
-        return false;
+    size_t failed = 0;
+    for (size_t k = 0; k < search_json_paths.size(); ++k) {
+        if (!ok[k]) {
+            failed++;
+            if (failed_paths) {
+                failed_paths->push_back(search_json_paths[k]);
+            }
+        }
     }
     
-    std::cout << "✅ 搜索证明生成成功" << std::endl;
-    std::cout << "   输出文件: " << output_path << std::endl;
-    std::cout << "   涉及文件数: " << AS.size() << std::endl;
-    std::cout << "   有效证明数: " << PS.size() << std::endl;
+    std::cout << "✅ 批量搜索完成" << std::endl;
+    std::cout << "   成功: " << done_count.load() << "  失败: " << failed << std::endl;
+    std::cout << "   共享缓存加载数: " << cache.loads() << "  淘汰数: " << cache.evictions() << std::endl;
     
-    // 新增：清理资源
-    element_clear(global_phi);
+    uint64_t cache_bytes = cache.peak_bytes();
+    std::cout << "   共享缓存峰值:   " << cache_bytes << " 字节";
+    if (search_cache_budget_mb > 0) {
+        std::cout << "（预算 " << search_cache_budget_mb << " MB）";
+    }
+    std::cout << std::endl;
+    if (perf_callback_s && perf_callback_s->on_data_size_recorded) {
+        perf_callback_s->on_data_size_recorded("server_search_cache_bytes", cache_bytes);
+    }
     
-    return true;
+    return failed == 0;
+}
+
+bool StorageNode::SearchKeywordsBatchProofFromDir(const std::string& search_dir, int num_threads) {
+    DIR* dir = opendir(search_dir.c_str());
+    if (!dir) {
+        std::cerr << "❌ 无法打开搜索请求目录: " << search_dir << std::endl;
+        return false;
+    }
+    
+    std::vector<std::string> paths;
+    while (struct dirent* ent = readdir(dir)) {
+        std::string name = ent->d_name;
+        if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0) {
+            paths.push_back(search_dir + "/" + name);
+        }
+    }
+    closedir(dir);
+    
+    std::sort(paths.begin(), paths.end());
+    return SearchKeywordsBatchProof(paths, num_threads);
 }
 
 // 生成文件证明
@@ -1612,7 +3110,7 @@ bool StorageNode::GetFileProof(const std::string& ID_F) {
         return false;
     }
     
-    // ========== 步骤2：加载索引数据库并查找文件 ==========
+    // ========== 步骤2：加载索引数据库 ==========
     
     // 加载索引数据库
     if (!load_index_database()) {
@@ -1620,32 +3118,61 @@ bool StorageNode::GetFileProof(const std::string& ID_F) {
         return false;
     }
     
+    // ========== 步骤3-7：计算证明 ==========
+    
+    FileProofResult result = ComputeFileProof(ID_F);
+    if (!result.success) {
+        return false;
+    }
+    
+    // ========== 步骤8：生成输出JSON文件 ==========
+    
+    // 保存到文件
+    std::string output_path = file_proofs_dir + "/" + ID_F + ".json";
+    if (!save_json_to_file(result.to_json(), output_path)) {
+        std::cerr << "❌ 文件证明保存失败" << std::endl;
+        return false;
+    }
+    
+    std::cout << "✅ 文件证明生成成功" << std::endl;
+    std::cout << "   输出文件: " << output_path << std::endl;
+    
+    return true;
+}
+
+FileProofResult StorageNode::ComputeFileProof(const std::string& ID_F) {
+    ScopedTimerServer timer(perf_callback_s, "server_file_proof_total");
+    CounterScope counters(perf_callback_s, "server_file_proof_total");
+    FileProofResult result;
+    result.ID_F = ID_F;
+    
+    auto db_lock = read_lock();
+    
     // 查找文件
     auto it = index_database.find(ID_F);
     if (it == index_database.end()) {
         std::cerr << "❌ 文件不存在: " << ID_F << std::endl;
-        return false;
+        return result;
     }
     
     const IndexEntry& entry = it->second;
     std::cout << "   ✅ 找到文件" << std::endl;
     
-    // ========== 步骤2.5：检查文件状态（防止为已删除文件生成证明）==========
+    // ========== 检查文件状态（防止为已删除文件生成证明）==========
     if (entry.state != "valid") {
         std::cerr << "❌ 文件状态为 " << entry.state << "，无法生成证明" << std::endl;
-        return false;
+        return result;
     }
     
     if (entry.TS_F.empty()) {
         std::cerr << "❌ 文件无认证标签，无法生成证明" << std::endl;
-        return false;
+        return result;
     }
     // ===================================================================
     
-    // 获取TS_F和公钥
+    // 获取TS_F
     const std::vector<std::string>& TS_F = entry.TS_F;
     int n = TS_F.size();  // 块数量
-    std::string PK = entry.PK;
     
     std::cout << "   块数量: " << n << std::endl;
     
@@ -1653,10 +3180,12 @@ bool StorageNode::GetFileProof(const std::string& ID_F) {
     
     // 加载密文内容
     std::string ciphertext;
+    ScopedTimerServer io_timer(perf_callback_s, "ciphertext_io");
     if (!load_encrypted_file(ID_F, ciphertext)) {
         std::cerr << "❌ 无法加载密文文件: " << ID_F << std::endl;
-        return false;
+        return result;
     }
+    io_timer.stop();
     
     std::cout << "   密文大小: " << ciphertext.size() << " bytes" << std::endl;
     
@@ -1668,8 +3197,8 @@ bool StorageNode::GetFileProof(const std::string& ID_F) {
     
     // ========== 步骤5：初始化累积变量 ==========
     
-    // 初始化FileProof结构
-    FileProof fileproof;
+    // 逐块内核复用的临时变量
+    PbcScratchPool::Lease scratch = scratch_pool.acquire(pairing);
     
     // 初始化phi（G1元素，初始值为1）
     element_t phi_element;
@@ -1682,129 +3211,78 @@ bool StorageNode::GetFileProof(const std::string& ID_F) {
     
     // ========== 步骤6：主循环 - 遍历所有块 ==========
     
+    const unsigned char* cipher_bytes = reinterpret_cast<const unsigned char*>(ciphertext.data());
+    
+    ScopedTimerServer kernel_timer(perf_callback_s, "proof_kernel");
+    AccumTimerServer prf_timer(perf_callback_s, "prf");
+    AccumTimerServer psi_timer(perf_callback_s, "psi_kernel");
+    AccumTimerServer phi_timer(perf_callback_s, "phi_exponentiation");
+    
     // 遍历每个块（统一改为从0开始）
     for (int i = 0; i < n; ++i) {
         std::cout << "   处理块 " << (i) << "/" << n << std::endl;
         
-        // 步骤6.1：计算PRF值（保持PRF使用1-based索引以兼容已有数据）
-        mpz_t prf_result;
-        mpz_init(prf_result);
-        compute_prf(prf_result, seed, ID_F, i);
-        
-        // 步骤6.2：处理该块的所有扇区
-        size_t block_start = i * BLOCK_SIZE;
-        size_t block_end = std::min(block_start + BLOCK_SIZE, ciphertext.size());
-        std::vector<unsigned char> current_block;
-        if (block_end > block_start) {
-            current_block.assign(
-                ciphertext.begin() + block_start,
-                ciphertext.begin() + block_end
-            );
-            if (current_block.size() < BLOCK_SIZE) {
-                current_block.resize(BLOCK_SIZE, 0);
-            }
-        }
+        // 步骤6.1：计算PRF值
+        prf_timer.begin();
+        compute_prf(scratch->prf, seed, ID_F, i, scratch->text);
+        prf_timer.end();
+        
+        // 步骤6.2：处理该块的所有扇区（末块补零，其余直接读取密文内存）
+        psi_timer.begin();
+        const unsigned char* block = scratch->padded_block(
+            cipher_bytes, ciphertext.size(), i, BLOCK_SIZE);
 
         for (size_t j = 0; j < SECTORS_PER_BLOCK; j++) {
-            size_t sector_start = j * SECTOR_SIZE;
-            size_t sector_end = sector_start + SECTOR_SIZE;
-            
-            // 提取扇区数据 c_(i,j)
-            std::vector<unsigned char> sector_data(
-                current_block.begin() + sector_start,
-                current_block.begin() + sector_end
-            );
-            
-            // 将扇区数据转换为mpz_t
-            mpz_t C_ij;
-            mpz_init(C_ij);
-            mpz_import(C_ij, sector_data.size(), 1, 1, 0, 0, sector_data.data());
+            // 将扇区数据 c_(i,j) 转换为mpz_t
+            mpz_import(scratch->c_ij, SECTOR_SIZE, 1, 1, 0, 0, block + j * SECTOR_SIZE);
             
             // 计算 prf_result * C_ij
-            mpz_t product;
-            mpz_init(product);
-            mpz_mul(product, prf_result, C_ij);
+            mpz_mul(scratch->product, scratch->prf, scratch->c_ij);
             
             // ✅ 修改：累加并模r（而不是模N）
-            mpz_add(psi_mpz, psi_mpz, product);
+            mpz_add(psi_mpz, psi_mpz, scratch->product);
             // 换了模操作
             mpz_mod(psi_mpz, psi_mpz, r);  // ✅ 关键修改：使用r模
-            
-            mpz_clear(C_ij);
-            mpz_clear(product);
         }
+        psi_timer.end();
         
         // 步骤6.3：计算 phi *= (theta_i)^prf_result
-        if (i < (int)TS_F.size()) {
-            element_t theta_i;
-            element_init_G1(theta_i, pairing);
-            
-            // 将TS_F[i]转换为element_t
-            std::vector<unsigned char> theta_bytes = hexToBytes(TS_F[i]);
-            if (!theta_bytes.empty()) {
-                element_from_bytes(theta_i, theta_bytes.data());
-                
-                // 计算 theta_i^prf_result
-                element_t phi_temp;
-                element_init_G1(phi_temp, pairing);
-                element_pow_mpz(phi_temp, theta_i, prf_result);
-                
-                // 累乘：phi_element *= phi_temp
-                element_mul(phi_element, phi_element, phi_temp);
-                
-                element_clear(phi_temp);
-            }
-            
-            element_clear(theta_i);
+        phi_timer.begin();
+        if (deserializeElement(TS_F[i], scratch->aux, scratch->bytes)) {
+            // 计算 theta_i^prf_result 并累乘
+            element_pow_mpz(scratch->pow, scratch->aux, scratch->prf);
+            element_mul(phi_element, phi_element, scratch->pow);
+            perf_metrics::count(&OpCounters::g1_exponentiations);
+            perf_metrics::count(&OpCounters::g1_multiplications);
         }
-        
-        mpz_clear(prf_result);
+        phi_timer.end();
     }
+    kernel_timer.stop();
+    
+    // ========== 步骤7：转换结果 ==========
     
-    // ========== 步骤7：转换结果并构建JSON ==========
+    ScopedTimerServer codec_timer(perf_callback_s, "serialization");
     
     // 转换psi为十六进制字符串
     char* psi_str = mpz_get_str(NULL, 16, psi_mpz);
-    fileproof.psi = std::string(psi_str);
+    result.proof.psi = std::string(psi_str);
     free(psi_str);
     
     // 转换phi为十六进制字符串
-    int phi_len = element_length_in_bytes(phi_element);
-    unsigned char* phi_bytes = new unsigned char[phi_len];
-    element_to_bytes(phi_bytes, phi_element);
-    fileproof.phi = bytesToHex(phi_bytes, phi_len);
-    delete[] phi_bytes;
+    result.proof.phi = serializeElement(phi_element, scratch->bytes);
     
     // 清理资源
     mpz_clear(psi_mpz);
     element_clear(phi_element);
     
-    std::cout << "   ✅ 证明计算完成" << std::endl;
-    
-    // ========== 步骤8：生成输出JSON文件 ==========
-    
-    // 构建JSON输出
-    Json::Value output;
-    output["ID_F"] = ID_F;
-    
-    Json::Value fileproof_json;
-    fileproof_json["psi"] = fileproof.psi;
-    fileproof_json["phi"] = fileproof.phi;
-    output["FileProof"] = fileproof_json;
-    
-    output["seed"] = seed;
-    
-    // 保存到文件
-    std::string output_path = file_proofs_dir + "/" + ID_F + ".json";
-    if (!save_json_to_file(output, output_path)) {
-        std::cerr << "❌ 文件证明保存失败" << std::endl;
-        return false;
-    }
+    codec_timer.stop();
     
-    std::cout << "✅ 文件证明生成成功" << std::endl;
-    std::cout << "   输出文件: " << output_path << std::endl;
+    result.seed = seed;
+    result.element_format = element_codec::format_name(element_format);
+    result.success = true;
+    std::cout << "   ✅ 证明计算完成" << std::endl;
     
-    return true;
+    return result;
 }
 
 bool StorageNode::VerifySearchProof(const std::string& search_proof_json_path) {
@@ -1818,58 +3296,92 @@ bool StorageNode::VerifySearchProof(const std::string& search_proof_json_path) {
         return false;
     }
     
-    // 加载JSON文件
-    Json::Value proof_data = load_json_from_file(search_proof_json_path);
+    // 加载JSON文件并解析为证明对象
+    SearchProofResult proof = SearchProofResult::from_json(load_json_from_file(search_proof_json_path));
     
     // 验证必需字段
-    if (!proof_data.isMember("AS") || !proof_data.isMember("PS") ||
-        !proof_data.isMember("T") || !proof_data.isMember("std") ||
-        !proof_data.isMember("seed") || !proof_data.isMember("phi")) {
+    if (!proof.success) {
         std::cerr << "❌ 搜索证明文件缺少必需字段" << std::endl;
         return false;
     }
     
     std::cout << "   ✅ 证明文件加载成功" << std::endl;
     
+    // 加载索引数据库
+    if (!load_index_database()) {
+        std::cerr << "❌ 索引数据库加载失败" << std::endl;
+        return false;
+    }
+    
+    return VerifySearchProof(proof);
+}
+
+bool StorageNode::VerifySearchProof(const SearchProofResult& proof) {
+    ScopedTimerServer timer(perf_callback_s, "server_verify_search_total");
+    CounterScope counters(perf_callback_s, "server_verify_search_total");
+    AccumTimerServer pairing_timer(perf_callback_s, "pairing");
+    
     // ========== 步骤2：提取数据 ==========
     
-    // 提取数据
-    const Json::Value& AS = proof_data["AS"];
-    const Json::Value& PS = proof_data["PS"];
-    std::string T = proof_data["T"].asString();
-    std::string std_input = proof_data["std"].asString();
-    std::string seed = proof_data["seed"].asString();
-    std::string phi_input = proof_data["phi"].asString();
+    const std::vector<std::string>& AS = proof.AS;
+    const std::vector<SearchResult>& PS = proof.PS;
+    const std::string& T = proof.T;
+    const std::string& std_input = proof.std_state;
+    const std::string& seed = proof.seed;
+    const std::string& phi_input = proof.phi;
+    
+    // 部分证明（预算截断/续传分段）：next_std 非空表示本段在该状态之前结束
+    const std::string& next_std = proof.next_std;
     
     int file_nums = AS.size();
     
     std::cout << "   文件数量: " << file_nums << std::endl;
     std::cout << "   证明数量: " << PS.size() << std::endl;
-    std::cout << "   种子: " << seed.substr(0, 16) << "..." << std::endl;
     
-    // ========== 步骤3：加载索引数据库并获取参数 ==========
-    
-    // 加载索引数据库
-    if (!load_index_database()) {
-        std::cerr << "❌ 索引数据库加载失败" << std::endl;
+    // AS 与 PS 逐项对应
+    if (PS.size() != AS.size()) {
+        std::cerr << "❌ AS与PS数量不一致 (" << AS.size() << " != " << PS.size() << ")" << std::endl;
         return false;
     }
+    for (size_t t = 0; t < AS.size(); ++t) {
+        if (PS[t].ID_F != AS[t]) {
+            std::cerr << "❌ PS[" << t << "] 的文件ID与AS不一致" << std::endl;
+            return false;
+        }
+    }
+    std::cout << "   种子: " << seed.substr(0, 16) << "..." << std::endl;
+    if (!next_std.empty()) {
+        std::cout << "   部分证明: 链段 [std, next_std)" << std::endl;
+    }
     
-    // 获取第一个文件的索引信息（用于获取n和PK）
-    if (AS.empty()) {
-        std::cerr << "❌ AS数组为空" << std::endl;
-        return false;
+    // ========== 步骤3：获取参数 ==========
+    
+    // 共享锁：验证期间读取索引中的TS_F/PK
+    auto db_lock = read_lock();
+    
+    // 公钥取自证明；AS 为空（本段/本页的文件全部已删除，或关键词已无有效文件）时
+    // 验证等式只剩链上 kt_wi 的伸缩乘积，仍需验证。旧版证明不含 PK，从第一个文件的索引取
+    std::string PK = proof.PK;
+    std::map<std::string, IndexEntry>::const_iterator it;
+    if (!AS.empty()) {
+        it = index_database.find(AS[0]);
+        if (it == index_database.end()) {
+            std::cerr << "❌ 文件不存在: " << AS[0] << std::endl;
+            return false;
+        }
+        if (PK.empty()) {
+            PK = it->second.PK;
+        } else if (PK != it->second.PK) {
+            std::cerr << "❌ 证明中的公钥与文件所有者不符" << std::endl;
+            return false;
+        }
     }
-
-    std::string first_ID_F = AS[0].asString();
-    auto it = index_database.find(first_ID_F);
-    if (it == index_database.end()) {
-        std::cerr << "❌ 文件不存在: " << first_ID_F << std::endl;
+    if (PK.empty()) {
+        std::cerr << "❌ 证明缺少公钥且AS数组为空" << std::endl;
         return false;
     }
     
     int n;  // 块数量
-    std::string PK = it->second.PK;   // 公钥
     
     // ========== 步骤4：初始化变量 ==========
     
@@ -1895,10 +3407,19 @@ bool StorageNode::VerifySearchProof(const std::string& search_proof_json_path) {
     mpz_t pho;
     mpz_init_set_ui(pho, 0);
     
+    // 内循环复用的临时变量
+    PbcScratchPool::Lease scratch = scratch_pool.acquire(pairing);
+    
     // ========== 步骤5：主循环 - 遍历PS ==========
     
     std::cout << "   开始验证计算..." << std::endl;
     
+    ScopedTimerServer accumulate_timer(perf_callback_s, "verify_accumulate");
+    AccumTimerServer prf_timer(perf_callback_s, "prf");
+    AccumTimerServer hash_timer(perf_callback_s, "hash_to_g1");
+    AccumTimerServer pow_timer(perf_callback_s, "zeta_exponentiation");
+    AccumTimerServer codec_timer(perf_callback_s, "serialization");
+    
     // 遍历PS数组
     for (int t = 0; t < file_nums; t++) {
         if (t >= (int)PS.size()) {
@@ -1906,10 +3427,10 @@ bool StorageNode::VerifySearchProof(const std::string& search_proof_json_path) {
             break;
         }
         
-        const Json::Value& ps_item = PS[t];
-        std::string ID_F = ps_item["ID_F"].asString();
-        std::string phi_alpha = ps_item["phi_alpha"].asString();
-        std::string psi_alpha = ps_item["psi_alpha"].asString();
+        const SearchResult& ps_item = PS[t];
+        const std::string& ID_F = ps_item.ID_F;
+        const std::string& phi_alpha = ps_item.phi;
+        const std::string& psi_alpha = ps_item.psi;
         it = index_database.find(ID_F);
         if (it == index_database.end()) {
             std::cerr << "⚠️  文件不存在: " << ID_F << std::endl;
@@ -1922,59 +3443,54 @@ bool StorageNode::VerifySearchProof(const std::string& search_proof_json_path) {
                   << ID_F.substr(0, 16) << "..." << std::endl;
         
         // 步骤5.1：计算 h2_temp_2 = H2(ID_F)
-        element_t h2_temp_2;
-        element_init_G1(h2_temp_2, pairing);
-        computeHashH2(ID_F, h2_temp_2);
+        hash_timer.begin();
+        computeHashH2(ID_F, scratch->hash);
+        hash_timer.end();
         
         // 步骤5.2：累乘 zeta_2 *= h2_temp_2
-        element_mul(zeta_2, zeta_2, h2_temp_2);
-        element_clear(h2_temp_2);
+        element_mul(zeta_2, zeta_2, scratch->hash);
+        perf_metrics::count(&OpCounters::g1_multiplications);
         
         // 步骤5.3：累乘 zeta_3 *= phi_alpha
-        element_t phi_alpha_elem;
-        element_init_G1(phi_alpha_elem, pairing);
-        if (deserializeElement(phi_alpha, phi_alpha_elem)) {
-            element_mul(zeta_3, zeta_3, phi_alpha_elem);
+        codec_timer.begin();
+        bool phi_decoded = deserializeElement(phi_alpha, scratch->aux, scratch->bytes);
+        codec_timer.end();
+        if (phi_decoded) {
+            element_mul(zeta_3, zeta_3, scratch->aux);
+            perf_metrics::count(&OpCounters::g1_multiplications);
         } else {
             std::cerr << "⚠️  phi_alpha反序列化失败，跳过此项" << std::endl;
         }
-        element_clear(phi_alpha_elem);
         
         // 步骤5.4：累加 pho += psi_alpha
-        mpz_t psi_alpha_mpz;
-        mpz_init(psi_alpha_mpz);
-        if (mpz_set_str(psi_alpha_mpz, psi_alpha.c_str(), 16) == 0) {
-            mpz_add(pho, pho, psi_alpha_mpz);
+        if (mpz_set_str(scratch->product, psi_alpha.c_str(), 16) == 0) {
+            mpz_add(pho, pho, scratch->product);
             mpz_mod(pho, pho, r);  // ✅ 关键修改：使用r
         }
-        mpz_clear(psi_alpha_mpz);
         
         // 步骤5.5：内循环 - 遍历所有块（统一改为从0开始）
         for (int i = 0; i < n; ++i) {
-
-            mpz_t prf_temp;
-            mpz_init(prf_temp);
-            compute_prf(prf_temp, seed, ID_F, i);
+            prf_timer.begin();
+            compute_prf(scratch->prf, seed, ID_F, i, scratch->text);
+            prf_timer.end();
             
             // 计算 h2_temp_1 = H2(ID_F || i)
-            std::string id_with_index = ID_F + std::to_string(i);
-            element_t h2_temp_1;
-            element_init_G1(h2_temp_1, pairing);
-            computeHashH2(id_with_index, h2_temp_1);
-            
-            // 计算 h2_temp_1^prf_temp
-            element_t temp_pow;
-            element_init_G1(temp_pow, pairing);
-            element_pow_mpz(temp_pow, h2_temp_1, prf_temp);
+            hash_timer.begin();
+            scratch->text.assign(ID_F);
+            scratch->text.append(std::to_string(i));
+            computeHashH2(scratch->text, scratch->hash);
+            hash_timer.end();
             
-            // 累乘 zeta_1 *= temp_pow
-            element_mul(zeta_1, zeta_1, temp_pow);
-            
-            element_clear(h2_temp_1);
-            element_clear(temp_pow);
-            mpz_clear(prf_temp);
+            // 计算 h2_temp_1^prf_temp 并累乘 zeta_1 *= temp_pow
+            pow_timer.begin();
+            element_pow_mpz(scratch->pow, scratch->hash, scratch->prf);
+            element_mul(zeta_1, zeta_1, scratch->pow);
+            perf_metrics::count(&OpCounters::g1_exponentiations);
+            perf_metrics::count(&OpCounters::g1_multiplications);
+            pow_timer.end();
         }
     }
+    accumulate_timer.stop();
     
     std::cout << "   ✅ 计算完成" << std::endl;
     
@@ -1983,7 +3499,10 @@ bool StorageNode::VerifySearchProof(const std::string& search_proof_json_path) {
     // 步骤6.1：计算 left = e(zeta_3, g)
     element_t left_pairing;
     element_init_GT(left_pairing, pairing);
+    pairing_timer.begin();
     pairing_apply(left_pairing, zeta_3, g, pairing);
+    perf_metrics::count(&OpCounters::pairings);
+    pairing_timer.end();
     
     // 步骤6.2：计算 Ti_bar_temp = H2(T||std)
     element_t Ti_bar_temp;
@@ -1994,6 +3513,7 @@ bool StorageNode::VerifySearchProof(const std::string& search_proof_json_path) {
     element_t mu_pow_pho;
     element_init_G1(mu_pow_pho, pairing);
     element_pow_mpz(mu_pow_pho, mu, pho);
+    perf_metrics::count(&OpCounters::g1_exponentiations);
     
     // 步骤6.4：计算 right_g1 = zeta_1 * zeta_2 * Ti_bar_temp * mu^pho
     element_t right_g1;
@@ -2003,6 +3523,17 @@ bool StorageNode::VerifySearchProof(const std::string& search_proof_json_path) {
     element_mul(right_g1, right_g1, zeta_2);
     element_mul(right_g1, right_g1, Ti_bar_temp);
     element_mul(right_g1, right_g1, mu_pow_pho);
+    perf_metrics::count(&OpCounters::g1_multiplications, 4);
+    
+    // 步骤6.4.1：部分证明时 kt_wi 的累乘只伸缩到 H2(T||next_std)，需除去该项
+    if (!next_std.empty()) {
+        element_t Ti_bar_end;
+        element_init_G1(Ti_bar_end, pairing);
+        computeHashH2(T + next_std, Ti_bar_end);
+        element_div(right_g1, right_g1, Ti_bar_end);
+        perf_metrics::count(&OpCounters::g1_multiplications);
+        element_clear(Ti_bar_end);
+    }
     
     // 步骤6.5：将PK从hex转换为element_t
     element_t PK_elem;
@@ -2025,7 +3556,10 @@ bool StorageNode::VerifySearchProof(const std::string& search_proof_json_path) {
     // 步骤6.6：计算 right = e(right_g1, PK)
     element_t right_pairing;
     element_init_GT(right_pairing, pairing);
+    pairing_timer.begin();
     pairing_apply(right_pairing, right_g1, PK_elem, pairing);
+    perf_metrics::count(&OpCounters::pairings);
+    pairing_timer.end();
     
     // ========== 步骤7：验证等式 ==========
     
@@ -2072,38 +3606,44 @@ bool StorageNode::VerifyFileProof(const std::string& file_proof_json_path) {
         return false;
     }
     
-    // 加载JSON文件
-    Json::Value proof_data = load_json_from_file(file_proof_json_path);
+    // 加载JSON文件并解析为证明对象
+    FileProofResult proof = FileProofResult::from_json(load_json_from_file(file_proof_json_path));
     
     // 验证必需字段
-    if (!proof_data.isMember("ID_F") || !proof_data.isMember("FileProof") ||
-        !proof_data.isMember("seed")) {
+    if (!proof.success) {
         std::cerr << "❌ 文件证明缺少必需字段" << std::endl;
         return false;
     }
     
     std::cout << "   ✅ 证明文件加载成功" << std::endl;
     
-    // ========== 步骤2：提取数据 ==========
+    // 加载索引数据库
+    if (!load_index_database()) {
+        std::cerr << "❌ 索引数据库加载失败" << std::endl;
+        return false;
+    }
+    
+    return VerifyFileProof(proof);
+}
+
+bool StorageNode::VerifyFileProof(const FileProofResult& proof) {
+    ScopedTimerServer timer(perf_callback_s, "server_verify_file_total");
+    CounterScope counters(perf_callback_s, "server_verify_file_total");
+    AccumTimerServer pairing_timer(perf_callback_s, "pairing");
     
-    // 提取数据
-    std::string ID_F = proof_data["ID_F"].asString();
-    std::string seed = proof_data["seed"].asString();
+    // ========== 步骤2：提取数据 ==========
     
-    const Json::Value& fileproof_json = proof_data["FileProof"];
-    std::string psi = fileproof_json["psi"].asString();
-    std::string phi = fileproof_json["phi"].asString();
+    const std::string& ID_F = proof.ID_F;
+    const std::string& seed = proof.seed;
+    const std::string& psi = proof.proof.psi;
+    const std::string& phi = proof.proof.phi;
     
     std::cout << "   文件ID: " << ID_F << std::endl;
     std::cout << "   种子: " << seed << std::endl;
     
-    // ========== 步骤3：加载索引数据库并获取参数 ==========
+    // ========== 步骤3：获取参数 ==========
     
-    // 加载索引数据库
-    if (!load_index_database()) {
-        std::cerr << "❌ 索引数据库加载失败" << std::endl;
-        return false;
-    }
+    auto db_lock = read_lock();
     
     // 查找文件
     auto it = index_database.find(ID_F);
@@ -2126,31 +3666,34 @@ bool StorageNode::VerifyFileProof(const std::string& file_proof_json_path) {
     
     std::cout << "   计算zeta..." << std::endl;
     
-    // 循环计算zeta（统一改为从0开始）
-    for (int i = 0; i < n; ++i) {
-        // 计算prf_temp
-        mpz_t prf_temp;
-        mpz_init(prf_temp);
-        compute_prf(prf_temp, seed, ID_F, i);
-        
-        // 计算h2_temp = H2(ID_F || i)
-        std::string id_with_index = ID_F + std::to_string(i);
-        element_t h2_temp;
-        element_init_G1(h2_temp, pairing);
-        computeHashH2(id_with_index, h2_temp);
-        
-        // 计算h2_temp^prf_temp
-        element_t temp_pow;
-        element_init_G1(temp_pow, pairing);
-        element_pow_mpz(temp_pow, h2_temp, prf_temp);
-        
-        
-        // 累乘：zeta *= temp_pow
-        element_mul(zeta, zeta, temp_pow);
-        
-        element_clear(h2_temp);
-        element_clear(temp_pow);
-        mpz_clear(prf_temp);
+    // 循环计算zeta（统一改为从0开始），临时变量来自scratch
+    PbcScratchPool::Lease scratch = scratch_pool.acquire(pairing);
+    {
+        ScopedTimerServer zeta_timer(perf_callback_s, "verify_accumulate");
+        AccumTimerServer prf_timer(perf_callback_s, "prf");
+        AccumTimerServer hash_timer(perf_callback_s, "hash_to_g1");
+        AccumTimerServer pow_timer(perf_callback_s, "zeta_exponentiation");
+        for (int i = 0; i < n; ++i) {
+            // 计算prf_temp
+            prf_timer.begin();
+            compute_prf(scratch->prf, seed, ID_F, i, scratch->text);
+            prf_timer.end();
+            
+            // 计算h2_temp = H2(ID_F || i)
+            hash_timer.begin();
+            scratch->text.assign(ID_F);
+            scratch->text.append(std::to_string(i));
+            computeHashH2(scratch->text, scratch->hash);
+            hash_timer.end();
+            
+            // 计算h2_temp^prf_temp，累乘：zeta *= temp_pow
+            pow_timer.begin();
+            element_pow_mpz(scratch->pow, scratch->hash, scratch->prf);
+            element_mul(zeta, zeta, scratch->pow);
+            perf_metrics::count(&OpCounters::g1_exponentiations);
+            perf_metrics::count(&OpCounters::g1_multiplications);
+            pow_timer.end();
+        }
     }
     
     std::cout << "   ✅ zeta计算完成" << std::endl;
@@ -2175,17 +3718,22 @@ bool StorageNode::VerifyFileProof(const std::string& file_proof_json_path) {
     // 计算left = e(phi, g)
     element_t left_pairing;
     element_init_GT(left_pairing, pairing);
+    pairing_timer.begin();
     pairing_apply(left_pairing, phi_elem, g, pairing);
+    perf_metrics::count(&OpCounters::pairings);
+    pairing_timer.end();
     
     // 计算mu^psi
     element_t mu_pow_psi;
     element_init_G1(mu_pow_psi, pairing);
     element_pow_mpz(mu_pow_psi, mu, psi_mpz);
+    perf_metrics::count(&OpCounters::g1_exponentiations);
     
     // 计算right_g1 = zeta * mu^psi
     element_t right_g1;
     element_init_G1(right_g1, pairing);
     element_mul(right_g1, zeta, mu_pow_psi);
+    perf_metrics::count(&OpCounters::g1_multiplications);
     
     // 将PK从hex转换为element_t
     element_t PK_elem;
@@ -2206,7 +3754,10 @@ bool StorageNode::VerifyFileProof(const std::string& file_proof_json_path) {
     // 计算right = e(right_g1, PK)
     element_t right_pairing;
     element_init_GT(right_pairing, pairing);
+    pairing_timer.begin();
     pairing_apply(right_pairing, right_g1, PK_elem, pairing);
+    perf_metrics::count(&OpCounters::pairings);
+    pairing_timer.end();
     
     // ========== 步骤6：验证等式 ==========
     
@@ -2242,6 +3793,7 @@ Json::Value StorageNode::retrieve_file(const std::string& file_id) {
     
     std::cout << "\n📥 检索文件: " << file_id << std::endl;
     
+    auto db_lock = read_lock();
     auto it = index_database.find(file_id);
     if (it == index_database.end()) {
         std::cerr << "❌ 文件不存在" << std::endl;
@@ -2340,12 +3892,14 @@ bool StorageNode::load_encrypted_file(const std::string& file_id, std::string& c
     }
     
     ciphertext = read_file_content(file_path);
+    perf_metrics::count(&OpCounters::ciphertext_bytes, ciphertext.size());
     return !ciphertext.empty();
 }
 
 std::vector<std::string> StorageNode::list_all_files() {
     std::vector<std::string> file_list;
     
+    auto db_lock = read_lock();
     for (const auto& pair : index_database) {
         file_list.push_back(pair.first);
     }
@@ -2356,11 +3910,14 @@ std::vector<std::string> StorageNode::list_all_files() {
 // ==================== 搜索数据库操作 ====================
 
 bool StorageNode::load_search_database() {
+    ScopedTimerServer timer(perf_callback_s, "db_load_search");
     std::string search_db_path = data_dir + "/search_db.json";
     
     std::cout << "📥 加载搜索数据库..." << std::endl;
     std::cout << "   文件路径: " << search_db_path << std::endl;
     
+    std::lock_guard<std::mutex> writer(writer_mutex);
+    
     if (!file_exists(search_db_path)) {
         std::cout << "   ⚠️  搜索数据库文件不存在，创建新的空数据库" << std::endl;
         
@@ -2368,6 +3925,7 @@ bool StorageNode::load_search_database() {
         root["version"] = "1.0";
         root["created_at"] = get_current_timestamp();
         root["description"] = "Search Database for Quick Keyword Lookup";
+        root["element_format"] = element_codec::format_name(element_format);
         root["search_index_count"] = 0;
         root["search_database"] = Json::Value(Json::arrayValue);
         
@@ -2387,8 +3945,20 @@ bool StorageNode::load_search_database() {
         return false;
     }
     
-    search_database.clear();
+    // 与索引数据库格式不一致时（例如旧版hex搜索库），加载时转换Ti_bar与kt_wi
+    ElementFormat search_format = ElementFormat::UncompressedHex;
+    std::string format_name = root.get("element_format", "").asString();
+    if (!element_codec::parse_format(format_name, search_format)) {
+        std::cerr << "   ❌ 搜索数据库的 element_format 无法识别: " << format_name << std::endl;
+        return false;
+    }
+    bool transcode = (search_format != element_format);
+    if (transcode) {
+        std::cout << "   🔄 搜索数据库格式 " << element_codec::format_name(search_format)
+                  << " -> " << element_codec::format_name(element_format) << std::endl;
+    }
     
+    std::map<std::string, IndexSearchEntry> loaded;
     const Json::Value& search_db = root["search_database"];
     for (const auto& entry : search_db) {
         IndexSearchEntry search_entry;
@@ -2409,25 +3979,35 @@ bool StorageNode::load_search_database() {
             search_entry.kt_wi = entry["kt_wi"].asString();
         }
         
+        if (transcode) {
+            canonicalize_element(search_entry.Ti_bar);
+            canonicalize_element(search_entry.kt_wi);
+        }
+        
         if (!search_entry.Ti_bar.empty()) {
-            search_database[search_entry.Ti_bar] = search_entry;
+            loaded[search_entry.Ti_bar] = search_entry;
         }
     }
     
     std::cout << "   ✅ 搜索数据库加载成功" << std::endl;
-    std::cout << "   📊 搜索索引数量: " << search_database.size() << std::endl;
+    std::cout << "   📊 搜索索引数量: " << loaded.size() << std::endl;
     
+    auto lock = write_lock();
+    search_database.swap(loaded);
     return true;
 }
 
 bool StorageNode::save_search_database() {
+    ScopedTimerServer timer(perf_callback_s, "persist_search_db");
     std::string search_db_path = data_dir + "/search_db.json";
     
+    auto lock = read_lock();
     Json::Value root;
     
     root["version"] = "1.0";
     root["updated_at"] = get_current_timestamp();
     root["description"] = "Search Database for Quick Keyword Lookup";
+    root["element_format"] = element_codec::format_name(element_format);
     root["search_index_count"] = static_cast<int>(search_database.size());
     
     Json::Value search_db_array(Json::arrayValue);
@@ -2446,12 +4026,14 @@ bool StorageNode::save_search_database() {
     }
     
     root["search_database"] = search_db_array;
+    size_t search_index_count = search_database.size();
+    lock.unlock();
     
     bool success = save_json_to_file(root, search_db_path);
     
     if (success) {
         std::cout << "   💾 搜索数据库已保存: " << search_db_path << std::endl;
-        std::cout << "   📊 搜索索引数量: " << search_database.size() << std::endl;
+        std::cout << "   📊 搜索索引数量: " << search_index_count << std::endl;
     } else {
         std::cerr << "   ❌ 搜索数据库保存失败" << std::endl;
     }
@@ -2461,6 +4043,119 @@ bool StorageNode::save_search_database() {
 
 // ==================== 详细状态 ====================
 
+// ==================== 内存占用 ====================
+
+namespace {
+
+uint64_t index_entry_heap_bytes(const IndexEntry& entry, MemoryUsage& usage) {
+    uint64_t own = mem_stats::string_heap(entry.ID_F) + mem_stats::string_heap(entry.PK) +
+                   mem_stats::string_heap(entry.state) + mem_stats::string_heap(entry.file_path);
+    uint64_t strings = own;
+    
+    uint64_t tags = mem_stats::vector_heap(entry.TS_F);
+    for (const auto& tag : entry.TS_F) {
+        uint64_t b = mem_stats::string_heap(tag);
+        tags += b;
+        strings += b;
+    }
+    usage.index_tags.entries += entry.TS_F.size();
+    usage.index_tags.bytes += tags;
+    
+    uint64_t keywords = mem_stats::vector_heap(entry.keywords);
+    for (const auto& kw : entry.keywords) {
+        uint64_t b = mem_stats::string_heap(kw.ptr_i) + mem_stats::string_heap(kw.kt_wi) +
+                     mem_stats::string_heap(kw.Ti_bar);
+        keywords += b;
+        strings += b;
+    }
+    usage.index_keywords.entries += entry.keywords.size();
+    usage.index_keywords.bytes += keywords;
+    
+    usage.string_bytes += strings;
+    return own + tags + keywords;
+}
+
+Json::Value structure_json(const StructureMemory& s) {
+    Json::Value out;
+    out["entries"] = static_cast<Json::UInt64>(s.entries);
+    out["bytes"] = static_cast<Json::UInt64>(s.bytes);
+    out["bytes_per_entry"] = s.bytes_per_entry();
+    return out;
+}
+
+} // namespace
+
+Json::Value MemoryUsage::to_json() const {
+    Json::Value out;
+    out["total_bytes"] = static_cast<Json::UInt64>(total_bytes());
+    out["string_bytes"] = static_cast<Json::UInt64>(string_bytes);
+    out["element_bytes"] = static_cast<Json::UInt64>(element_bytes);
+    out["bytes_per_file"] = bytes_per_file();
+    out["files_per_gib"] = bytes_per_file() > 0 ? static_cast<double>(1ull << 30) / bytes_per_file() : 0.0;
+    
+    Json::Value structures;
+    structures["index_database"] = structure_json(index);
+    structures["index_tags"] = structure_json(index_tags);
+    structures["index_keywords"] = structure_json(index_keywords);
+    structures["search_database"] = structure_json(search);
+    structures["upload_sessions"] = structure_json(uploads);
+    structures["scratch_pool"] = structure_json(scratch);
+    out["structures"] = structures;
+    
+    out["process"] = process.to_json();
+    out["allocator"] = allocator.to_json();
+    return out;
+}
+
+MemoryUsage StorageNode::get_memory_usage() {
+    MemoryUsage usage;
+    if (crypto_initialized) {
+        usage.element_bytes = g1_element_heap_bytes(pairing);
+    }
+    
+    {
+        auto lock = read_lock();
+        usage.index.entries = index_database.size();
+        for (const auto& pair : index_database) {
+            usage.index.bytes += mem_stats::map_node<std::string, IndexEntry>() +
+                                 mem_stats::string_heap(pair.first) +
+                                 index_entry_heap_bytes(pair.second, usage);
+            usage.string_bytes += mem_stats::string_heap(pair.first);
+        }
+        
+        usage.search.entries = search_database.size();
+        for (const auto& pair : search_database) {
+            const IndexSearchEntry& entry = pair.second;
+            uint64_t strings = mem_stats::string_heap(pair.first) + mem_stats::string_heap(entry.Ti_bar) +
+                               mem_stats::string_heap(entry.ID_F) + mem_stats::string_heap(entry.ptr_i) +
+                               mem_stats::string_heap(entry.state) + mem_stats::string_heap(entry.kt_wi);
+            usage.search.bytes += mem_stats::map_node<std::string, IndexSearchEntry>() + strings;
+            usage.string_bytes += strings;
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(upload_mutex);
+        usage.uploads.entries = upload_sessions.size();
+        MemoryUsage ignored;   // 上传中的索引项不计入 index_tags / index_keywords
+        for (const auto& pair : upload_sessions) {
+            usage.uploads.bytes += mem_stats::map_node<std::string, std::shared_ptr<UploadSession>>() +
+                                   mem_stats::string_heap(pair.first) +
+                                   mem_stats::heap_block(sizeof(UploadSession) + 16) +
+                                   index_entry_heap_bytes(pair.second->entry, ignored);
+        }
+        usage.string_bytes += ignored.string_bytes;
+    }
+    
+    usage.scratch.entries = scratch_pool.idle_count();
+    usage.scratch.bytes = usage.scratch.entries *
+        (mem_stats::heap_block(sizeof(PbcScratch)) + 3 * usage.element_bytes);
+    
+    usage.process = mem_stats::read_process_memory();
+    usage.allocator = mem_stats::read_allocator_stats();
+    return usage;
+}
+
 void StorageNode::print_detailed_status() {
     std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
     std::cout << "📊 存储节点详细状态" << std::endl;
@@ -2472,9 +4167,13 @@ void StorageNode::print_detailed_status() {
     std::cout << "   端口:         " << server_port << std::endl;
     std::cout << "   版本:         v3.5 (新增删除和搜索证明功能)" << std::endl;
     
+    // 读锁不可重入，内存统计须在持锁前完成
+    MemoryUsage mem = get_memory_usage();
+    
     std::cout << "\n📦 存储统计:" << std::endl;
+    auto db_lock = read_lock();
     std::cout << "   文件总数:        " << index_database.size() << std::endl;
-    std::cout << "   索引总数:        " << get_index_count() << std::endl;
+    std::cout << "   索引总数:        " << index_database.size() << std::endl;
     std::cout << "   搜索索引总数:    " << search_database.size() << std::endl;
     
     int valid_count = 0;
@@ -2489,6 +4188,34 @@ void StorageNode::print_detailed_status() {
     std::cout << "   有效文件:     " << valid_count << std::endl;
     std::cout << "   无效文件:     " << invalid_count << std::endl;
     
+    int compacted_count = 0;
+    for (const auto& pair : index_database) {
+        if (is_compacted(pair.second)) {
+            compacted_count++;
+        }
+    }
+    CompactionStats totals = get_compaction_stats();
+    std::cout << "   已回收文件:   " << compacted_count << std::endl;
+    std::cout << "   累计回收字节: " << totals.total_bytes() << std::endl;
+    
+    std::cout << "\n💾 内存占用 (估算):" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "   索引数据库:   " << mem.index.bytes << " 字节 (平均 " << mem.index.bytes_per_entry() << " 字节/文件)" << std::endl;
+    std::cout << "   ├─ 认证标签:  " << mem.index_tags.bytes << " 字节 (" << mem.index_tags.entries << " 个)" << std::endl;
+    std::cout << "   └─ 关键词:    " << mem.index_keywords.bytes << " 字节 (" << mem.index_keywords.entries << " 个)" << std::endl;
+    std::cout << "   搜索数据库:   " << mem.search.bytes << " 字节 (平均 " << mem.search.bytes_per_entry() << " 字节/条)" << std::endl;
+    std::cout << "   上传会话:     " << mem.uploads.bytes << " 字节 (" << mem.uploads.entries << " 个)" << std::endl;
+    std::cout << "   临时变量池:   " << mem.scratch.bytes << " 字节 (" << mem.scratch.entries << " 个空闲)" << std::endl;
+    std::cout << "   字符串堆:     " << mem.string_bytes << " 字节" << std::endl;
+    std::cout << "   合计:         " << mem.total_bytes() << " 字节 (平均 " << mem.bytes_per_file() << " 字节/文件)" << std::endl;
+    std::cout << "   进程 RSS:     " << mem.process.rss_kb << " kB (峰值 " << mem.process.peak_rss_kb << " kB)" << std::endl;
+    if (mem.allocator.available) {
+        std::cout << "   分配器:       已用 " << mem.allocator.in_use_bytes << " 字节, 空闲 "
+                  << mem.allocator.free_bytes << " 字节, mmap " << mem.allocator.mmap_bytes << " 字节" << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+    
     std::cout << "\n🔐 密码学状态:" << std::endl;
     std::cout << "   初始化:       " << (crypto_initialized ? "✅ 是" : "❌ 否") << std::endl;
     
@@ -9,6 +9,7 @@
 #include <gmp.h>
 #include <string>
 #include <map>
+#include <list>
 #include <vector>
 #include <memory>
 #include <iomanip>
@@ -17,6 +18,18 @@
 #include <fstream>
 #include <jsoncpp/json/json.h>
 #include <functional>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <condition_variable>
+#include "../common/pbc_scratch.h"
+#include "../common/hex_codec.h"
+#include "../common/element_codec.h"
+#include "../common/insert_bundle.h"
+#include "../common/perf_metrics.h"
+#include "../common/perf_trace.h"
+#include "../common/mem_stats.h"
 
 // ==================== 性能监控回调结构体 ====================
 /**
@@ -28,6 +41,12 @@ struct PerformanceCallback_s {
     
     // 数据大小回调 (字节)
     std::function<void(const std::string& name, size_t size_bytes)> on_data_size_recorded;
+    
+    // 嵌套阶段回调（含父阶段/深度/起止时间，可交给 perf_trace::ChromeTraceWriter 导出）
+    std::function<void(const perf_trace::Span& span)> on_span;
+    
+    // 请求级密码学操作计数（插入/搜索/文件证明/两类验证各上报一次）
+    std::function<void(const std::string& name, const perf_metrics::OpCounters& counters)> on_op_counters;
 };
 
 struct IndexKeywords
@@ -70,6 +89,220 @@ struct FileProof {
     std::string psi;   // ψ值（累积证明）
     std::string phi;   // φ值（累积签名）
 };
+
+// ==================== 内存证明对象 ====================
+/**
+ * @brief 文件证明（内存对象），对应 FileProofs/[ID_F].json
+ */
+struct FileProofResult {
+    bool success = false;   // 生成/解析是否成功
+    std::string ID_F;       // 文件ID
+    std::string seed;       // 挑战种子
+    FileProof proof;        // {psi, phi}
+    std::string element_format = "uncompressed_hex";  // phi 的编码格式
+
+    Json::Value to_json() const;
+    static FileProofResult from_json(const Json::Value& root);
+};
+
+/**
+ * @brief 搜索证明（内存对象），对应 SearchProof/[T].json
+ */
+struct SearchProofResult {
+    bool success = false;            // 生成/解析是否成功
+    std::string T;                   // 搜索令牌
+    std::string std_state;           // 本段起始状态 (JSON字段 std)
+    std::string next_std;            // 本段结束后的状态（完整链为空）
+    std::string cursor;              // 分页游标（同 next_std）
+    bool complete = true;            // 是否已走到链尾
+    int segment = 0;                 // 续传分段序号
+    int hops = 0;                    // 本段跳数
+    int limit = 0;                   // 分页大小（0表示不限制）
+    int page = 0;                    // 页序号（第一页为0）
+    Json::Value continuation;        // 续传令牌（预算截断且本页未满时有效）
+    std::string PK;                  // 数据所有者公钥（AS 为空时验证仍需要）
+    std::string seed;                // 挑战种子
+    std::string phi;                 // 全局phi
+    std::vector<std::string> AS;     // 有效文件ID
+    std::vector<SearchResult> PS;    // 每个文件的 {ID_F, psi, phi}
+    std::string element_format = "uncompressed_hex";  // phi / phi_alpha 的编码格式
+
+    Json::Value to_json() const;
+    static SearchProofResult from_json(const Json::Value& root);
+};
+
+// ==================== 批量搜索共享缓存 ====================
+/**
+ * @brief 搜索证明所需的单个文件数据（密文 + 已解码的TS_F）
+ * 批量搜索时由多个请求共享，构造完成后只读
+ */
+struct CachedSearchFile {
+    bool loaded = false;                 // 密文与标签是否加载成功
+    std::string ciphertext;              // 密文内容
+    std::vector<element_s> tags;         // 已解码的认证标签（与TS_F一一对应）
+
+    CachedSearchFile() = default;
+    CachedSearchFile(const CachedSearchFile&) = delete;
+    CachedSearchFile& operator=(const CachedSearchFile&) = delete;
+    ~CachedSearchFile() {
+        for (auto& tag : tags) {
+            element_clear(&tag);
+        }
+    }
+};
+
+/**
+ * @brief 批量搜索的文件缓存：同一ID_F只读取/解码一次，线程安全
+ *
+ * 按字节预算做LRU淘汰：已加载条目的估算占用超过预算时从最久未用的条目开始移出缓存。
+ * get_or_load 返回 shared_ptr，被淘汰的条目在正在使用它的请求结束后才释放；
+ * 之后再次请求同一ID_F会重新加载。
+ */
+class SearchFileCache {
+public:
+    /**
+     * @param budget_bytes 已加载条目的字节预算（0 不限制）
+     * @param element_bytes 单个已解码G1元素的堆占用（见 MemoryUsage::element_bytes），用于估算条目大小
+     */
+    explicit SearchFileCache(uint64_t budget_bytes = 0, uint64_t element_bytes = 0);
+
+    /**
+     * get_or_load() - 获取缓存的文件数据，不存在时调用loader加载（缓存中的每个ID_F仅加载一次）
+     * @param ID_F 文件ID
+     * @param loader 加载函数，填充CachedSearchFile
+     * @return 共享的只读文件数据
+     */
+    std::shared_ptr<const CachedSearchFile> get_or_load(
+        const std::string& ID_F,
+        const std::function<void(CachedSearchFile&)>& loader);
+
+    size_t size() const;          // 当前缓存的条目数
+    size_t loads() const;         // 累计加载次数（含淘汰后的重新加载）
+    size_t evictions() const;     // 累计淘汰条目数
+    
+    /**
+     * memory_bytes() - 当前缓存的估算内存占用
+     * @return 字节数（密文 + 已解码标签 + 缓存节点）
+     */
+    uint64_t memory_bytes() const;
+    uint64_t peak_bytes() const;  // memory_bytes() 的峰值
+
+private:
+    struct Slot {
+        std::once_flag once;
+        std::shared_ptr<CachedSearchFile> data;
+        // 以下字段由 mutex_ 保护；加载完成前不在LRU中，也不会被淘汰
+        bool resident = false;
+        uint64_t bytes = 0;
+        std::list<std::string>::iterator lru_pos;
+    };
+    uint64_t entry_bytes(const std::string& ID_F, const CachedSearchFile& data) const;
+    void evict_locked(const std::string& keep);
+
+    uint64_t budget_bytes_;
+    uint64_t element_bytes_;
+    mutable std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<Slot>> slots_;
+    std::list<std::string> lru_;  // 已加载条目，最近使用的在前
+    uint64_t bytes_ = 0;
+    uint64_t peak_bytes_ = 0;
+    size_t loads_ = 0;
+    size_t evictions_ = 0;
+};
+// ==================== 分块上传会话 ====================
+/**
+ * @brief 一次分块上传的服务端状态
+ * 密文分块按顺序追加到 EncFiles/[ID_F].enc.part，同时增量计算 SHA-256，
+ * 提交时核对 H1(C) == ID_F 后改名为正式文件并写入索引（不再重读密文）
+ */
+struct UploadSession {
+    std::mutex mutex;                // 同一会话的追加/提交串行执行
+    std::string upload_id;
+    IndexEntry entry;                // 已转换为数据库格式的索引项
+    std::string part_path;           // 临时文件
+    std::ofstream out;
+    EVP_MD_CTX* sha = nullptr;       // 增量 SHA-256
+    uint64_t expected_size = 0;      // 声明的密文总长度
+    uint64_t received = 0;           // 已写入的字节数
+    bool closed = false;             // 已提交或已放弃
+    uint64_t owner = 0;              // 发起上传的服务连接ID（0 表示本地调用，不随连接回收）
+    std::atomic<uint64_t> last_active_ns{0};   // 最近一次开始/追加的时刻（perf_metrics::now_ns），用于空闲回收
+
+    UploadSession() = default;
+    UploadSession(const UploadSession&) = delete;
+    UploadSession& operator=(const UploadSession&) = delete;
+    ~UploadSession() {
+        if (sha) {
+            EVP_MD_CTX_free(sha);
+        }
+    }
+};
+
+/**
+ * @brief 批量删除中单个请求的处理结果
+ */
+struct DeleteResult {
+    std::string ID_F;
+    bool success = false;
+    std::string error;           // 失败原因（成功时为空）
+    size_t keywords = 0;         // 更新的 kt_wi 数量
+};
+
+/**
+ * @brief 已删除文件的回收统计（单次或累计）
+ */
+struct CompactionStats {
+    uint64_t runs = 0;                // 执行次数
+    uint64_t files = 0;               // 回收的已删除文件数
+    uint64_t ciphertext_bytes = 0;    // 删除的密文字节
+    uint64_t metadata_bytes = 0;      // metadata/[ID_F].json 缩减的字节
+    uint64_t index_bytes = 0;         // index_db.json 缩减的字节
+    double elapsed_ms = 0;            // 耗时（累计统计为总耗时）
+
+    uint64_t total_bytes() const {
+        return ciphertext_bytes + metadata_bytes + index_bytes;
+    }
+};
+
+/**
+ * @brief 单个内存结构的占用估算
+ */
+struct StructureMemory {
+    uint64_t entries = 0;   // 条目数
+    uint64_t bytes = 0;     // 估算字节数（容器节点 + 字符串/数组堆分配）
+
+    double bytes_per_entry() const {
+        return entries > 0 ? static_cast<double>(bytes) / entries : 0.0;
+    }
+};
+
+/**
+ * @brief 存储节点内存占用（按结构逐项估算，见 common/mem_stats.h）
+ */
+struct MemoryUsage {
+    StructureMemory index;            // index_database（含下面两项）
+    StructureMemory index_tags;       // 其中 TS_F 认证标签（条目为标签数）
+    StructureMemory index_keywords;   // 其中 keywords 关联信息（条目为关键词数）
+    StructureMemory search;           // search_database
+    StructureMemory uploads;          // upload_sessions（不含输出流缓冲）
+    StructureMemory scratch;          // scratch_pool 空闲临时变量（不含字节缓冲区，为下限）
+    uint64_t string_bytes = 0;        // 以上结构中字符串的堆分配合计
+    uint64_t element_bytes = 0;       // 单个已解码G1元素的估算堆占用（未初始化密码学时为0）
+    mem_stats::ProcessMemory process;
+    mem_stats::AllocatorStats allocator;
+
+    uint64_t total_bytes() const {
+        return index.bytes + search.bytes + uploads.bytes + scratch.bytes;
+    }
+    
+    // 每个文件的数据库内存（index + search 按文件数平均），用于估算单节点可容纳的文件数
+    double bytes_per_file() const {
+        return index.entries > 0 ? static_cast<double>(index.bytes + search.bytes) / index.entries : 0.0;
+    }
+
+    Json::Value to_json() const;
+};
+
 class StorageNode {
 public:
     // 文件分块常量
@@ -85,12 +318,61 @@ public:
     bool crypto_initialized;
     mpz_t r;
     
+    // G1元素编码格式：element_format 为当前数据库记录的格式（序列化时使用），
+    // default_element_format 为新建数据库时采用的格式（config.json storage.element_format）
+    ElementFormat element_format;
+    ElementFormat default_element_format;
+    
     // 存储（统一使用IndexEntry，以ID_F为键）
     std::map<std::string, IndexEntry> index_database;
     
     // 搜索索引数据库（以 Ti_bar 为键，用于快速搜索）
     std::map<std::string, IndexSearchEntry> search_database;
     
+    // ==================== 并发控制 ====================
+    // 读者（搜索/文件证明/验证/检索）持有 db_mutex 共享锁，可与其他读者并行；
+    // 写者（插入/删除/加载数据库）由 writer_mutex 串行化，只在修改内存数据库时
+    // 短暂持有 db_mutex 独占锁，持久化在独占锁释放后进行（读者不受阻塞）。
+    // db_gate 保证写者优先：写者等待独占锁期间新的读者在 gate 处排队，避免写者饥饿。
+    // 锁均不可重入：持锁的成员函数内部直接访问数据库，不调用下方加锁的 getter。
+    mutable std::shared_mutex db_mutex;
+    mutable std::mutex db_gate;
+    std::mutex writer_mutex;
+    
+    // 进行中的分块上传（upload_id -> 会话），由 upload_mutex 保护
+    std::map<std::string, std::shared_ptr<UploadSession>> upload_sessions;
+    mutable std::mutex upload_mutex;
+    
+    // 后台回收：compaction_mutex 保护累计统计与线程停止标志
+    CompactionStats compaction_totals;
+    // 已删除但尚未回收的文件数：删除提交时增加、回收时减少、加载索引时重算
+    // （在 write_lock 内修改，原子类型使 status 查询无需加锁遍历索引）
+    std::atomic<size_t> pending_compaction{0};
+    mutable std::mutex compaction_mutex;
+    std::condition_variable compaction_cv;
+    std::thread compaction_thread;
+    bool compaction_stop = false;
+    int compaction_interval_sec = 60; // config.json storage.compaction_interval_sec，<=0 关闭后台回收
+    size_t compaction_min_files = 1;  // 待回收文件达到该数量才执行（storage.compaction_min_files）
+    
+    // 上传会话上限：同时进行的会话数（storage.max_upload_sessions，0 不限制）
+    // 与空闲超时（storage.upload_idle_timeout_sec，<=0 不超时）
+    size_t max_upload_sessions = 64;
+    int upload_idle_timeout_sec = 300;
+    
+    // 批量搜索共享缓存的字节预算（storage.search_cache_budget_mb，0 不限制）
+    uint64_t search_cache_budget_mb = 256;
+    
+    std::shared_lock<std::shared_mutex> read_lock() const {
+        std::lock_guard<std::mutex> gate(db_gate);
+        return std::shared_lock<std::shared_mutex>(db_mutex);
+    }
+    
+    std::unique_lock<std::shared_mutex> write_lock() {
+        std::lock_guard<std::mutex> gate(db_gate);
+        return std::unique_lock<std::shared_mutex>(db_mutex);
+    }
+    
     // 配置
     std::string node_id;
     std::string data_dir;
@@ -99,10 +381,16 @@ public:
     std::string FileProofs_dir;
     std::string SearchProof_dir;
     int server_port;
+    // TCP 服务的监听地址（config.json server.bind_address）。协议没有认证，
+    // 默认只监听本机，监听外部网卡须显式配置（如 0.0.0.0）
+    std::string bind_address = "127.0.0.1";
     
     // 性能监控回调指针（默认nullptr）
     PerformanceCallback_s* perf_callback_s;
     
+    // 证明/验证内核的预初始化临时变量池（须在 pairing_clear 之前清空）
+    PbcScratchPool scratch_pool;
+    
     // 辅助函数
     std::string generate_random_seed();
     
@@ -158,6 +446,146 @@ public:
     
     bool insert_file(const std::string& param_json_path, const std::string& enc_file_path);
     
+    /**
+     * insert_from_params() - 从内存中的 insert.json 参数与密文插入文件
+     * @param params insert.json 内容（PK, ID_F, TS_F, state, keywords，可选 element_format）
+     * @param ciphertext 密文
+     * @return 成功返回true，失败返回false
+     */
+    bool insert_from_params(const Json::Value& params, const std::string& ciphertext);
+    
+    /**
+     * insert_bundle() - 从二进制插入请求包（.vdsb）插入文件
+     * @param bundle_path 客户端生成的请求包，一次顺序读入，只做长度校验
+     * @return 成功返回true，失败返回false
+     */
+    bool insert_bundle(const std::string& bundle_path);
+    
+    /**
+     * insert_from_bundle() - 从已解析的插入请求包插入文件（服务模式直接使用网络帧负载）
+     * @param bundle 插入请求包
+     * @return 成功返回true，失败返回false
+     */
+    bool insert_from_bundle(const insert_bundle::Bundle& bundle);
+    
+    /**
+     * build_entry_from_params() - 由 insert.json 参数构造数据库格式的索引项（不含密文）
+     * @param params insert.json 内容
+     * @param entry 输出的索引项
+     * @return 字段缺失、格式错误或ID_F已存在时返回false
+     */
+    bool build_entry_from_params(const Json::Value& params, IndexEntry& entry);
+    
+    /**
+     * build_entry_from_bundle() - 由插入请求包构造数据库格式的索引项（忽略其中的密文）
+     * @param bundle 插入请求包
+     * @param entry 输出的索引项
+     * @return 解码失败或ID_F已存在时返回false
+     */
+    bool build_entry_from_bundle(const insert_bundle::Bundle& bundle, IndexEntry& entry);
+    
+    /**
+     * commit_insert() - 插入的公共提交步骤
+     * 核对 H1(C) == ID_F，写入密文后发布索引项
+     * @param entry 已转换为数据库元素格式的索引项
+     * @param ciphertext 密文（直接从内存写入，不再重新读取源文件）
+     */
+    bool commit_insert(const IndexEntry& entry, const std::string& ciphertext);
+    
+    /**
+     * publish_insert() - 将 .part 临时密文改名为正式文件，写元数据并更新索引/搜索数据库
+     * 调用方须持有 writer_mutex
+     * @param entry 索引项
+     * @param part_path 已写完并校验过的临时密文文件
+     * @param ciphertext_size 密文长度
+     */
+    bool publish_insert(const IndexEntry& entry, const std::string& part_path, uint64_t ciphertext_size);
+    
+    // ========== 分块上传 ==========
+    
+    // insert_file 从磁盘流式上传时的分块大小
+    static constexpr size_t UPLOAD_CHUNK_SIZE = 1 << 20;
+    
+    /**
+     * begin_upload() - 以 insert.json 参数开始一次分块上传
+     * @param params insert.json 内容（不含密文）
+     * @param total_size 密文总长度
+     * @param upload_id 输出的会话ID
+     * @param owner 发起上传的服务连接ID（0 表示本地调用）
+     * @return 成功返回true，失败返回false
+     */
+    bool begin_upload(const Json::Value& params, uint64_t total_size, std::string& upload_id,
+                      uint64_t owner = 0);
+    
+    /**
+     * begin_upload() - 以仅含元数据的插入请求包开始一次分块上传
+     * @param header 插入请求包（密文部分被忽略）
+     * @param total_size 密文总长度
+     * @param upload_id 输出的会话ID
+     * @param owner 发起上传的服务连接ID（0 表示本地调用）
+     * @return 成功返回true，失败返回false
+     */
+    bool begin_upload(const insert_bundle::Bundle& header, uint64_t total_size, std::string& upload_id,
+                      uint64_t owner = 0);
+    
+    /**
+     * open_upload() - 为已构造的索引项创建上传会话与临时文件
+     * @param entry 索引项
+     * @param total_size 密文总长度
+     * @param upload_id 输出的会话ID
+     * @param owner 发起上传的服务连接ID（连接关闭时由 abort_uploads_of 回收）
+     * @return 同一ID_F已有进行中的上传、会话数达到 max_upload_sessions 或临时文件创建失败时返回false
+     */
+    bool open_upload(IndexEntry entry, uint64_t total_size, std::string& upload_id, uint64_t owner = 0);
+    
+    /**
+     * find_upload() - 查找上传会话
+     * @return 不存在时返回nullptr
+     */
+    std::shared_ptr<UploadSession> find_upload(const std::string& upload_id);
+    
+    /**
+     * append_upload() - 追加一个密文分块（写入临时文件并更新哈希）
+     * @param upload_id 会话ID
+     * @param offset 分块在密文中的偏移，必须等于已接收字节数（分块须按顺序到达）
+     * @param data 分块数据
+     * @param len 分块长度
+     * @return 成功返回true；会话不存在、乱序或超出声明长度时返回false
+     */
+    bool append_upload(const std::string& upload_id, uint64_t offset, const char* data, size_t len);
+    
+    /**
+     * commit_upload() - 完成分块上传：核对长度与 H1(C) == ID_F 后写入索引
+     * 校验失败时删除临时文件并结束会话
+     * @param upload_id 会话ID
+     * @return 成功返回true，失败返回false
+     */
+    bool commit_upload(const std::string& upload_id);
+    
+    /**
+     * abort_upload() - 放弃分块上传并删除临时文件
+     * @param upload_id 会话ID
+     */
+    void abort_upload(const std::string& upload_id);
+    
+    /**
+     * abort_uploads_of() - 放弃某个服务连接发起的全部上传（连接关闭时调用）
+     * @param owner 连接ID（0 不匹配任何会话）
+     * @return 放弃的会话数
+     */
+    size_t abort_uploads_of(uint64_t owner);
+    
+    /**
+     * reap_idle_uploads() - 放弃超过 upload_idle_timeout_sec 未追加数据的上传
+     * @return 放弃的会话数
+     */
+    size_t reap_idle_uploads();
+    
+    size_t get_upload_count() const {
+        std::lock_guard<std::mutex> lock(upload_mutex);
+        return upload_sessions.size();
+    }
+    
     // ========== 新增功能 ==========
     
     /**
@@ -167,6 +595,90 @@ public:
      */
     bool delete_file_from_json(const std::string& delete_json_path);
     
+    /**
+     * delete_file() - 按内存中的删除参数删除文件（使用已加载的数据库）
+     * @param delete_params 删除参数（ID_F, PK, del）
+     * @return 成功返回true，失败返回false
+     */
+    bool delete_file(const Json::Value& delete_params);
+    
+    /**
+     * delete_files_batch() - 批量删除文件，所有修改一次提交
+     * 先在独占锁外校验请求并计算 kt_wi <- kt_wi · del^{-1}（G1 群运算），
+     * 再在一次写锁内把通过校验的文件标记为 invalid，最后两个数据库各保存一次。
+     * 单个请求失败不影响其他请求。
+     * @param delete_params_list 删除参数列表（每项含 ID_F, PK, del）
+     * @param results 可选，输出每个请求的处理结果（与输入顺序一致）
+     * @return 全部成功返回true，任一失败返回false
+     */
+    bool delete_files_batch(const std::vector<Json::Value>& delete_params_list,
+                            std::vector<DeleteResult>* results = nullptr);
+    
+    /**
+     * delete_files_from_json() - 从多个删除参数JSON文件批量删除（数据库只加载一次）
+     * @param delete_json_paths 删除参数JSON文件路径列表
+     * @param results 可选，输出每个请求的处理结果
+     * @return 全部成功返回true，任一失败返回false
+     */
+    bool delete_files_from_json(const std::vector<std::string>& delete_json_paths,
+                                std::vector<DeleteResult>* results = nullptr);
+    
+    /**
+     * delete_files_from_dir() - 对目录下所有 *.json 删除参数执行批量删除
+     * @param delete_dir 删除参数目录（如 Deles/）
+     * @return 全部成功返回true，任一失败返回false
+     */
+    bool delete_files_from_dir(const std::string& delete_dir);
+    
+    // ========== 已删除文件回收 ==========
+    
+    /**
+     * is_compacted() - 已删除且已回收的索引项（只保留 ID_F/PK/state）
+     */
+    static bool is_compacted(const IndexEntry& entry) {
+        return entry.state == "invalid" && entry.file_path.empty() && entry.keywords.empty();
+    }
+    
+    /**
+     * compact_deleted_files() - 回收已删除文件占用的空间
+     * 删除 EncFiles/[ID_F].enc，把 metadata/[ID_F].json 缩减为墓碑记录，
+     * 索引项只保留 ID_F/PK/state。搜索数据库中的链节点（Ti_bar -> ptr_i, kt_wi）保持不变：
+     * 链指针由客户端状态加密，无法在节点侧跳过，kt_wi 也须参与证明中的伸缩相消。
+     * @param stats 可选，输出本次回收统计
+     * @return 成功返回true，索引数据库保存失败返回false
+     */
+    bool compact_deleted_files(CompactionStats* stats = nullptr);
+    
+    /**
+     * get_pending_compaction_count() - 已删除但尚未回收的文件数（O(1)，读取计数器）
+     */
+    size_t get_pending_compaction_count() const;
+    
+    /**
+     * get_compaction_stats() - 累计回收统计
+     */
+    CompactionStats get_compaction_stats() const {
+        std::lock_guard<std::mutex> lock(compaction_mutex);
+        return compaction_totals;
+    }
+    
+    /**
+     * get_memory_usage() - 遍历内存数据库估算各结构的内存占用，并读取进程与分配器统计
+     * 持有读锁遍历全部条目，耗时与文件数成正比，不应在热路径上调用
+     */
+    MemoryUsage get_memory_usage();
+    
+    /**
+     * start_compactor() - 启动后台回收线程（每 compaction_interval_sec 秒检查一次）
+     * @return 已启动或成功启动返回true，配置关闭时返回false
+     */
+    bool start_compactor();
+    
+    /**
+     * stop_compactor() - 停止后台回收线程并等待其退出
+     */
+    void stop_compactor();
+    
     /**
      * SearchKeywordsAssociatedFilesProof() - 搜索关键词关联文件证明
      * @param search_json_path 搜索参数JSON文件路径
@@ -174,6 +686,48 @@ public:
      */
     bool SearchKeywordsAssociatedFilesProof(const std::string& search_json_path);
     
+    /**
+     * SearchKeywordsBatchProof() - 批量执行关键词搜索证明
+     * 数据库只加载一次，请求分发到线程池，相同文件的密文与标签在请求间共享
+     * （共享缓存受 search_cache_budget_mb 限制，超出时按LRU淘汰）
+     * @param search_json_paths 搜索参数JSON文件路径列表
+     * @param num_threads 工作线程数（<=0 表示使用硬件并发数）
+     * @param failed_paths 可选，输出失败的请求路径
+     * @return 全部成功返回true，任一失败返回false
+     */
+    bool SearchKeywordsBatchProof(const std::vector<std::string>& search_json_paths,
+                                  int num_threads = 0,
+                                  std::vector<std::string>* failed_paths = nullptr);
+    
+    /**
+     * SearchKeywordsBatchProofFromDir() - 对目录下所有 *.json 搜索请求执行批量搜索
+     * @param search_dir 搜索请求目录
+     * @param num_threads 工作线程数（<=0 表示使用硬件并发数）
+     * @return 全部成功返回true，任一失败返回false
+     */
+    bool SearchKeywordsBatchProofFromDir(const std::string& search_dir, int num_threads = 0);
+    
+    /**
+     * build_search_proof() - 搜索证明核心计算（不加载数据库、不写文件）
+     * 可选预算字段 budget_ms / max_hops：超出后返回部分证明和 continuation 续传令牌，
+     * 将 continuation 放入下一次的搜索参数即可从断点继续。
+     * 分页时 limit 为整页（含各续传段）的文件数上限；本页已满时只返回 cursor，不返回 continuation
+     * @param search_params 搜索参数（PK, T, std，可选 budget_ms, max_hops, continuation, limit, cursor, page）
+     * @param output 输出的搜索证明
+     * @param cache 可选的共享文件缓存，nullptr表示不缓存
+     * @param verbose 是否打印逐跳日志
+     * @return 成功返回true，失败返回false
+     */
+    bool build_search_proof(const Json::Value& search_params, SearchProofResult& output,
+                            SearchFileCache* cache = nullptr, bool verbose = true);
+    
+    /**
+     * search_proof_output_path() - 搜索证明的保存路径（续页追加 _page[k]，续传分段追加 _seg[k] 后缀）
+     * @param proof 搜索证明
+     * @return SearchProof目录下的文件路径
+     */
+    std::string search_proof_output_path(const SearchProofResult& proof) const;
+    
     /**
      * GetFileProof() - 获取文件证明
      * @param ID_F 文件ID
@@ -181,6 +735,22 @@ public:
      */
     bool GetFileProof(const std::string& ID_F);
     
+    /**
+     * ComputeFileProof() - 在内存中生成文件证明（使用已加载的索引，不写文件）
+     * @param ID_F 文件ID
+     * @return 文件证明对象，失败时 success 为 false
+     */
+    FileProofResult ComputeFileProof(const std::string& ID_F);
+    
+    /**
+     * ComputeSearchProof() - 在内存中生成搜索证明（使用已加载的数据库，不写文件）
+     * @param search_params 搜索参数（同 build_search_proof）
+     * @param cache 可选的共享文件缓存
+     * @return 搜索证明对象，失败时 success 为 false
+     */
+    SearchProofResult ComputeSearchProof(const Json::Value& search_params,
+                                         SearchFileCache* cache = nullptr);
+    
     /**
      * VerifySearchProof() - 验证搜索证明
      * @param search_proof_json_path 搜索证明JSON文件路径
@@ -188,6 +758,13 @@ public:
      */
     bool VerifySearchProof(const std::string& search_proof_json_path);
     
+    /**
+     * VerifySearchProof() - 验证内存中的搜索证明（使用已加载的索引）
+     * @param proof 搜索证明对象
+     * @return 验证成功返回true，失败返回false
+     */
+    bool VerifySearchProof(const SearchProofResult& proof);
+    
     /**
      * VerifyFileProof() - 验证文件证明
      * @param file_proof_json_path 文件证明JSON文件路径
@@ -195,6 +772,13 @@ public:
      */
     bool VerifyFileProof(const std::string& file_proof_json_path);
     
+    /**
+     * VerifyFileProof() - 验证内存中的文件证明（使用已加载的索引）
+     * @param proof 文件证明对象
+     * @return 验证成功返回true，失败返回false
+     */
+    bool VerifyFileProof(const FileProofResult& proof);
+    
     // ========== 检索函数 ==========
     
     Json::Value retrieve_file(const std::string& file_id);
@@ -210,6 +794,7 @@ public:
     // 辅助函数（统一驼峰命名）
     std::string bytesToHex(const unsigned char* data, size_t len);
     std::vector<unsigned char> hexToBytes(const std::string& hex);
+    void hexToBytes(const std::string& hex, std::vector<unsigned char>& out);  // 复用out的容量
     
 
     // ========== Getters ==========
@@ -226,19 +811,27 @@ public:
         return server_port;
     }
     
+    std::string get_bind_address() const {
+        return bind_address;
+    }
+    
     size_t get_file_count() const {
+        auto lock = read_lock();
         return index_database.size();
     }
     
     size_t get_index_count() const {
+        auto lock = read_lock();
         return index_database.size();
     }
     
     size_t get_search_index_count() const {
+        auto lock = read_lock();
         return search_database.size();
     }
     
     bool has_file(const std::string& file_id) const {
+        auto lock = read_lock();
         return index_database.find(file_id) != index_database.end();
     }
     
@@ -276,14 +869,38 @@ public:
 
     // 密码学函数（修改为void返回值）
     void computeHashH1(const std::string& input, mpz_t result);
+    // SHA-256 摘要 -> ID_F（十进制，模N），与 computeHashH1 结果一致
+    std::string file_id_from_digest(const unsigned char* digest);
     void computeHashH2(const std::string& input, element_t result);
     std::string computeHashH3(const std::string& input);
     void compute_prf(mpz_t result, const std::string& seed, const std::string& ID_F, int index);
+    void compute_prf(mpz_t result, const std::string& seed, const std::string& ID_F, int index,
+                     std::string& buf);  // buf为复用的拼接缓冲
     std::string decrypt_pointer(const std::string& current_state_hash, const std::string& encrypted_pointer);
     
     // 序列化辅助函数（与client.cpp统一，方案A核心修改）
     std::string serializeElement(element_t elem);
     bool deserializeElement(const std::string& hex_str, element_t elem);
+    // 使用调用方提供的缓冲区（PbcScratch::bytes），热循环中避免重复分配
+    std::string serializeElement(element_t elem, std::vector<unsigned char>& buf);
+    bool deserializeElement(const std::string& hex_str, element_t elem, std::vector<unsigned char>& buf);
+    
+    /**
+     * canonicalize_element() - 将任意受支持格式的G1元素文本转换为数据库格式
+     * @param text 输入/输出，已是数据库格式时不做解码
+     * @return 解码失败返回false（text保持不变）
+     */
+    bool canonicalize_element(std::string& text);
+    
+    /**
+     * bundle_element_to_text() - 将请求包中的原始元素字节转换为数据库格式文本
+     * @param compressed 字节是否为 element_to_bytes_compressed 输出
+     * @return 长度不符或解码失败返回false
+     */
+    bool bundle_element_to_text(const unsigned char* data, size_t len, bool compressed, std::string& out);
+    
+    // 读取密文并一次性解码TS_F（搜索证明使用）
+    void load_cached_search_file(const IndexEntry& entry, CachedSearchFile& out);
 };
 
 #endif // STORAGE_NODE_H
\ No newline at end of file
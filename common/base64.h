@@ -0,0 +1,116 @@
+#ifndef VDS_BASE64_H
+#define VDS_BASE64_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ==================== Base64 编解码（标准字母表，带 '=' 填充） ====================
+//
+// 用于在 JSON 边界上传递压缩后的 G1 元素等二进制数据。
+
+namespace base64 {
+
+namespace detail {
+
+inline const char* alphabet() {
+    return "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+}
+
+// 字符 -> 6位值，非法字符为 0xFF
+struct DecodeTable {
+    unsigned char v[256];
+    DecodeTable() {
+        for (int i = 0; i < 256; ++i) v[i] = 0xFF;
+        const char* a = alphabet();
+        for (int i = 0; i < 64; ++i) v[static_cast<unsigned char>(a[i])] = static_cast<unsigned char>(i);
+    }
+};
+
+inline const unsigned char* decode_table() {
+    static const DecodeTable table;
+    return table.v;
+}
+
+} // namespace detail
+
+/**
+ * encoded_length() - len 字节编码后的字符数
+ */
+inline size_t encoded_length(size_t len) {
+    return (len + 2) / 3 * 4;
+}
+
+/**
+ * encode() - 编码到out（覆盖写入，复用容量）
+ */
+inline void encode(const unsigned char* data, size_t len, std::string& out) {
+    const char* a = detail::alphabet();
+    out.resize(encoded_length(len));
+    size_t o = 0;
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3) {
+        unsigned v = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+        out[o++] = a[(v >> 18) & 0x3F];
+        out[o++] = a[(v >> 12) & 0x3F];
+        out[o++] = a[(v >> 6) & 0x3F];
+        out[o++] = a[v & 0x3F];
+    }
+    if (i < len) {
+        unsigned v = data[i] << 16;
+        if (i + 1 < len) v |= data[i + 1] << 8;
+        out[o++] = a[(v >> 18) & 0x3F];
+        out[o++] = a[(v >> 12) & 0x3F];
+        out[o++] = (i + 1 < len) ? a[(v >> 6) & 0x3F] : '=';
+        out[o++] = '=';
+    }
+}
+
+inline std::string encode(const unsigned char* data, size_t len) {
+    std::string out;
+    encode(data, len, out);
+    return out;
+}
+
+/**
+ * decode() - 解码到out（覆盖写入，复用容量）
+ * @return 长度为4的倍数且字符合法时返回true，失败时out被清空
+ */
+inline bool decode(const std::string& text, std::vector<unsigned char>& out) {
+    out.clear();
+    if (text.size() % 4 != 0) {
+        return false;
+    }
+    size_t pad = 0;
+    if (!text.empty() && text[text.size() - 1] == '=') pad++;
+    if (text.size() > 1 && text[text.size() - 2] == '=') pad++;
+
+    const unsigned char* t = detail::decode_table();
+    out.resize(text.size() / 4 * 3 - pad);
+    size_t o = 0;
+    for (size_t i = 0; i < text.size(); i += 4) {
+        bool last = (i + 4 == text.size());
+        unsigned char c[4];
+        for (int k = 0; k < 4; ++k) {
+            char ch = text[i + k];
+            if (last && ch == '=' && k >= 4 - static_cast<int>(pad)) {
+                c[k] = 0;
+                continue;
+            }
+            c[k] = t[static_cast<unsigned char>(ch)];
+            if (c[k] == 0xFF) {
+                out.clear();
+                return false;
+            }
+        }
+        unsigned v = (c[0] << 18) | (c[1] << 12) | (c[2] << 6) | c[3];
+        if (o < out.size()) out[o++] = static_cast<unsigned char>(v >> 16);
+        if (o < out.size()) out[o++] = static_cast<unsigned char>(v >> 8);
+        if (o < out.size()) out[o++] = static_cast<unsigned char>(v);
+    }
+    return true;
+}
+
+} // namespace base64
+
+#endif // VDS_BASE64_H
@@ -0,0 +1,135 @@
+#ifndef VDS_ELEMENT_CODEC_H
+#define VDS_ELEMENT_CODEC_H
+
+#include <pbc/pbc.h>
+#include <string>
+#include <vector>
+
+#include "hex_codec.h"
+#include "base64.h"
+
+// ==================== G1 元素文本编码（客户端与存储节点共用） ====================
+//
+// 两种格式：
+//   uncompressed_hex  : element_to_bytes 的小写hex（Type A 下 128 字节 -> 256 字符），旧版默认
+//   compressed_base64 : element_to_bytes_compressed 的base64（65 字节 -> 88 字符）
+//
+// insert.json / index_db.json / search_db.json / 证明文件通过 "element_format" 字段
+// 声明所用格式，缺省视为 uncompressed_hex。解码时按长度自动识别，两种格式可混用。
+
+enum class ElementFormat {
+    UncompressedHex,
+    CompressedBase64
+};
+
+namespace element_codec {
+
+inline const char* format_name(ElementFormat format) {
+    return format == ElementFormat::CompressedBase64 ? "compressed_base64" : "uncompressed_hex";
+}
+
+/**
+ * parse_format() - 解析格式名，空字符串按旧版 uncompressed_hex 处理
+ * @return 无法识别时返回false
+ */
+inline bool parse_format(const std::string& name, ElementFormat& format) {
+    if (name.empty() || name == "uncompressed_hex") {
+        format = ElementFormat::UncompressedHex;
+        return true;
+    }
+    if (name == "compressed_base64") {
+        format = ElementFormat::CompressedBase64;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * text_length() - 给定格式下一个G1元素的文本长度
+ */
+inline size_t text_length(pairing_t pairing, ElementFormat format) {
+    if (format == ElementFormat::CompressedBase64) {
+        return base64::encoded_length(pairing_length_in_bytes_compressed_G1(pairing));
+    }
+    return 2 * static_cast<size_t>(pairing_length_in_bytes_G1(pairing));
+}
+
+/**
+ * encode() - 按指定格式编码G1元素
+ * @param buf 复用的字节缓冲区
+ */
+inline std::string encode(element_t elem, ElementFormat format, std::vector<unsigned char>& buf) {
+    std::string out;
+    if (format == ElementFormat::CompressedBase64) {
+        buf.resize(element_length_in_bytes_compressed(elem));
+        element_to_bytes_compressed(buf.data(), elem);
+        base64::encode(buf.data(), buf.size(), out);
+    } else {
+        buf.resize(element_length_in_bytes(elem));
+        element_to_bytes(buf.data(), elem);
+        hex_codec::encode(buf.data(), buf.size(), out);
+    }
+    return out;
+}
+
+/**
+ * decode() - 解码G1元素，按长度自动识别格式
+ * 支持：未压缩hex、压缩hex、压缩base64、未压缩base64
+ * @return 长度不匹配或内容非法时返回false
+ */
+inline bool decode(const std::string& text, element_t elem, std::vector<unsigned char>& buf) {
+    size_t raw_len = element_length_in_bytes(elem);
+    size_t comp_len = element_length_in_bytes_compressed(elem);
+
+    if (text.size() == 2 * raw_len || text.size() == 2 * comp_len) {
+        if (hex_codec::decode(text, buf)) {
+            int read = (buf.size() == raw_len) ? element_from_bytes(elem, buf.data())
+                                               : element_from_bytes_compressed(elem, buf.data());
+            return read > 0;
+        }
+    }
+    if (text.size() == base64::encoded_length(comp_len) ||
+        text.size() == base64::encoded_length(raw_len)) {
+        if (base64::decode(text, buf)) {
+            if (buf.size() == comp_len) {
+                return element_from_bytes_compressed(elem, buf.data()) > 0;
+            }
+            if (buf.size() == raw_len) {
+                return element_from_bytes(elem, buf.data()) > 0;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * to_bytes() - 将指定格式的元素文本还原为 element_to_bytes(_compressed) 的原始字节
+ * 只做hex/base64解码，不做曲线运算（用于写出二进制插入请求包）
+ * @return 文本非法时返回false
+ */
+inline bool to_bytes(const std::string& text, ElementFormat format, std::vector<unsigned char>& out) {
+    return format == ElementFormat::CompressedBase64 ? base64::decode(text, out)
+                                                     : hex_codec::decode(text, out);
+}
+
+/**
+ * from_bytes() - to_bytes() 的逆过程：原始字节按指定格式写为文本
+ */
+inline void from_bytes(const unsigned char* data, size_t len, ElementFormat format, std::string& out) {
+    if (format == ElementFormat::CompressedBase64) {
+        base64::encode(data, len, out);
+    } else {
+        hex_codec::encode(data, len, out);
+    }
+}
+
+/**
+ * is_format() - 文本是否已是指定格式（仅按长度判断，用于跳过无需转换的字段）
+ */
+inline bool is_format(pairing_t pairing, const std::string& text, ElementFormat format) {
+    return text.size() == text_length(pairing, format);
+}
+
+} // namespace element_codec
+
+#endif // VDS_ELEMENT_CODEC_H
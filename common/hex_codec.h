@@ -0,0 +1,266 @@
+#ifndef VDS_HEX_CODEC_H
+#define VDS_HEX_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define VDS_HEX_CODEC_X86 1
+#include <immintrin.h>
+#endif
+
+// ==================== Hex 编解码（客户端与存储节点共用） ====================
+//
+// 元素序列化（PK、TS_F、kt_wi、Ti_bar、phi、del）以及状态/指针都以小写hex存储，
+// 每次证明与每次加载索引都要进行成千上万次转换。本模块提供：
+//   - 查表实现的标量版本（任意平台）
+//   - SSSE3 / AVX2 向量化版本（x86，运行时检测CPU后选择）
+//   - 解码时完整校验输入（长度必须为偶数，只允许 [0-9a-fA-F]）
+// 输出写入调用方提供的缓冲区，便于在热循环中复用容量。
+
+namespace hex_codec {
+
+namespace detail {
+
+inline const char* digits() {
+    return "0123456789abcdef";
+}
+
+// 字符 -> 半字节，非法字符为 0xFF
+struct DecodeTable {
+    unsigned char v[256];
+    DecodeTable() {
+        for (int i = 0; i < 256; ++i) v[i] = 0xFF;
+        for (int i = 0; i < 10; ++i) v['0' + i] = static_cast<unsigned char>(i);
+        for (int i = 0; i < 6; ++i) {
+            v['a' + i] = static_cast<unsigned char>(10 + i);
+            v['A' + i] = static_cast<unsigned char>(10 + i);
+        }
+    }
+};
+
+inline const unsigned char* decode_table() {
+    static const DecodeTable table;
+    return table.v;
+}
+
+inline void encode_scalar(const unsigned char* data, size_t len, char* out) {
+    const char* d = digits();
+    for (size_t i = 0; i < len; ++i) {
+        out[2 * i] = d[data[i] >> 4];
+        out[2 * i + 1] = d[data[i] & 0x0F];
+    }
+}
+
+inline bool decode_scalar(const char* hex, size_t len, unsigned char* out) {
+    const unsigned char* t = decode_table();
+    unsigned char bad = 0;
+    for (size_t i = 0; i < len / 2; ++i) {
+        unsigned char hi = t[static_cast<unsigned char>(hex[2 * i])];
+        unsigned char lo = t[static_cast<unsigned char>(hex[2 * i + 1])];
+        bad |= (hi | lo) & 0xF0;
+        out[i] = static_cast<unsigned char>((hi << 4) | lo);
+    }
+    return bad == 0;
+}
+
+#ifdef VDS_HEX_CODEC_X86
+
+// ---------- SSSE3：每次 16 字节 <-> 32 字符 ----------
+
+__attribute__((target("ssse3")))
+inline void encode_ssse3(const unsigned char* data, size_t len, char* out) {
+    const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                      '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(x, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(x, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    encode_scalar(data + i, len - i, out + 2 * i);
+}
+
+// 16个字符 -> 16个半字节值，valid 中非法字符对应位为0
+__attribute__((target("ssse3")))
+inline __m128i nibbles_ssse3(__m128i c, __m128i& valid) {
+    const __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    const __m128i alpha = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    // 无符号比较 x <= k 等价于 min(x, k) == x
+    const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    const __m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+    valid = _mm_or_si128(is_digit, is_alpha);
+    return _mm_or_si128(_mm_and_si128(is_digit, digit),
+                        _mm_and_si128(is_alpha, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+}
+
+__attribute__((target("ssse3")))
+inline bool decode_ssse3(const char* hex, size_t len, unsigned char* out) {
+    const __m128i weights = _mm_set1_epi16(0x0110);  // 每对字符：hi*16 + lo*1
+    size_t n = len / 2;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v0, v1;
+        __m128i a = nibbles_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 2 * i)), v0);
+        __m128i b = nibbles_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 2 * i + 16)), v1);
+        if (_mm_movemask_epi8(_mm_and_si128(v0, v1)) != 0xFFFF) {
+            return false;
+        }
+        __m128i wa = _mm_maddubs_epi16(a, weights);
+        __m128i wb = _mm_maddubs_epi16(b, weights);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(wa, wb));
+    }
+    return decode_scalar(hex + 2 * i, len - 2 * i, out + i);
+}
+
+// ---------- AVX2：每次 32 字节 <-> 64 字符 ----------
+
+__attribute__((target("avx2")))
+inline void encode_avx2(const unsigned char* data, size_t len, char* out) {
+    const __m256i lut = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                         '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                         '0', '1', '2', '3', '4', '5', '6', '7',
+                                         '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(x, 4), mask));
+        __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(x, mask));
+        // unpack 按128位通道进行，需要交换通道恢复顺序
+        __m256i a = _mm256_unpacklo_epi8(hi, lo);   // 字节 0-7 | 16-23
+        __m256i b = _mm256_unpackhi_epi8(hi, lo);   // 字节 8-15 | 24-31
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i),
+                            _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32),
+                            _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    encode_ssse3(data + i, len - i, out + 2 * i);
+}
+
+__attribute__((target("avx2")))
+inline __m256i nibbles_avx2(__m256i c, __m256i& valid) {
+    const __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    const __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)),
+                                          _mm256_set1_epi8('a'));
+    const __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    const __m256i is_alpha = _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, _mm256_set1_epi8(5)), alpha);
+    valid = _mm256_or_si256(is_digit, is_alpha);
+    return _mm256_or_si256(_mm256_and_si256(is_digit, digit),
+                           _mm256_and_si256(is_alpha, _mm256_add_epi8(alpha, _mm256_set1_epi8(10))));
+}
+
+__attribute__((target("avx2")))
+inline bool decode_avx2(const char* hex, size_t len, unsigned char* out) {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    size_t n = len / 2;
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v0, v1;
+        __m256i a = nibbles_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + 2 * i)), v0);
+        __m256i b = nibbles_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + 2 * i + 32)), v1);
+        if (_mm256_movemask_epi8(_mm256_and_si256(v0, v1)) != -1) {
+            return false;
+        }
+        __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights),
+                                             _mm256_maddubs_epi16(b, weights));
+        // packus 同样按通道交错：a0 b0 | a1 b1 -> a0 a1 b0 b1
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    return decode_ssse3(hex + 2 * i, len - 2 * i, out + i);
+}
+
+#endif // VDS_HEX_CODEC_X86
+
+typedef void (*EncodeFn)(const unsigned char*, size_t, char*);
+typedef bool (*DecodeFn)(const char*, size_t, unsigned char*);
+
+struct Dispatch {
+    EncodeFn encode;
+    DecodeFn decode;
+    const char* name;
+    Dispatch() : encode(encode_scalar), decode(decode_scalar), name("scalar") {
+#ifdef VDS_HEX_CODEC_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            encode = encode_avx2;
+            decode = decode_avx2;
+            name = "avx2";
+        } else if (__builtin_cpu_supports("ssse3")) {
+            encode = encode_ssse3;
+            decode = decode_ssse3;
+            name = "ssse3";
+        }
+#endif
+    }
+};
+
+inline const Dispatch& dispatch() {
+    static const Dispatch d;
+    return d;
+}
+
+} // namespace detail
+
+/**
+ * implementation() - 当前CPU选用的实现名称（"avx2" / "ssse3" / "scalar"）
+ */
+inline const char* implementation() {
+    return detail::dispatch().name;
+}
+
+/**
+ * encode() - 编码为小写hex，写入 out[0 .. 2*len)
+ */
+inline void encode(const unsigned char* data, size_t len, char* out) {
+    detail::dispatch().encode(data, len, out);
+}
+
+/**
+ * encode() - 编码为小写hex，覆盖写入out（复用其容量）
+ */
+inline void encode(const unsigned char* data, size_t len, std::string& out) {
+    out.resize(2 * len);
+    if (len > 0) {
+        encode(data, len, &out[0]);
+    }
+}
+
+inline std::string encode(const unsigned char* data, size_t len) {
+    std::string out;
+    encode(data, len, out);
+    return out;
+}
+
+/**
+ * decode() - 解码 hex[0 .. len) 到 out[0 .. len/2)
+ * @return len为偶数且全部为合法hex字符时返回true
+ */
+inline bool decode(const char* hex, size_t len, unsigned char* out) {
+    if (len % 2 != 0) {
+        return false;
+    }
+    return detail::dispatch().decode(hex, len, out);
+}
+
+/**
+ * decode() - 解码到out（复用其容量），失败时out被清空
+ */
+inline bool decode(const std::string& hex, std::vector<unsigned char>& out) {
+    out.resize(hex.size() / 2);
+    if (!decode(hex.data(), hex.size(), out.data())) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+} // namespace hex_codec
+
+#endif // VDS_HEX_CODEC_H
@@ -0,0 +1,365 @@
+#ifndef VDS_INSERT_BUNDLE_H
+#define VDS_INSERT_BUNDLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// ==================== 二进制插入请求包（客户端与存储节点共用） ====================
+//
+// 将原先的 EncFiles/*.enc + Insert/*_insert.json 两个文件合并为一个 .vdsb 文件，
+// 客户端顺序写出，存储节点一次顺序读入，只做长度校验、不做JSON解析。
+// 所有整数均为小端序，G1 元素以原始字节存储（不经hex/base64）。
+//
+//   magic        "VDSB"                     4 字节
+//   version      u16                        当前为 1
+//   encoding     u8                         0 = element_to_bytes, 1 = element_to_bytes_compressed
+//   reserved     u8
+//   total_size   u64                        整个文件的字节数
+//   PK           u32 长度 + 字节
+//   ID_F         u32 长度 + 字节（十进制字符串）
+//   state        u32 长度 + 字节
+//   TS_F         u32 个数 + u32 单个长度 + 个数*长度 字节
+//   keywords     u32 个数，每项: Ti_bar(u32+字节) kt_wi(u32+字节) ptr_i(u32+字节)
+//   ciphertext   u64 长度 + 字节
+//
+// 同一格式既可作为文件读取（read），也可作为网络帧负载在内存中编码/解析（serialize/parse）。
+
+namespace insert_bundle {
+
+const char kMagic[4] = {'V', 'D', 'S', 'B'};
+const uint16_t kVersion = 1;
+const char* const kExtension = ".vdsb";
+
+// 单个G1元素的长度上限（Type A 未压缩为128字节），用于拒绝损坏的长度字段
+const uint32_t kMaxElementBytes = 1024;
+
+struct Keyword {
+    std::vector<unsigned char> Ti_bar;
+    std::vector<unsigned char> kt_wi;
+    std::string ptr_i;
+};
+
+struct Bundle {
+    bool compressed = false;
+    std::vector<unsigned char> PK;
+    std::string ID_F;
+    std::string state = "valid";
+    uint32_t tag_len = 0;
+    std::vector<unsigned char> tags;   // tag_count() * tag_len 字节，按块顺序排列
+    std::vector<Keyword> keywords;
+    std::string ciphertext;
+
+    size_t tag_count() const {
+        return tag_len == 0 ? 0 : tags.size() / tag_len;
+    }
+    const unsigned char* tag(size_t i) const {
+        return tags.data() + i * tag_len;
+    }
+};
+
+namespace detail {
+
+inline void put_u16(std::string& out, uint16_t v) {
+    out.push_back(static_cast<char>(v & 0xFF));
+    out.push_back(static_cast<char>(v >> 8));
+}
+
+inline void put_u32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+inline void put_u64(std::string& out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+inline void put_bytes(std::string& out, const void* data, size_t len) {
+    put_u32(out, static_cast<uint32_t>(len));
+    out.append(static_cast<const char*>(data), len);
+}
+
+inline uint64_t get_le(const unsigned char* p, int n) {
+    uint64_t v = 0;
+    for (int i = n - 1; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+// 数据源：文件流或内存缓冲区（服务模式下请求包随网络帧到达）
+struct StreamSource {
+    std::ifstream& in;
+    bool read(void* out, uint64_t len) {
+        return static_cast<bool>(in.read(static_cast<char*>(out), static_cast<std::streamsize>(len)));
+    }
+};
+
+struct MemorySource {
+    const char* data;
+    bool read(void* out, uint64_t len) {
+        std::memcpy(out, data, len);
+        data += len;
+        return true;
+    }
+};
+
+// 带边界检查的顺序读取器：每次读取前确认剩余字节足够
+template <typename Source>
+class Reader {
+public:
+    Reader(Source source, uint64_t size) : source_(source), remaining_(size) {}
+
+    uint64_t remaining() const { return remaining_; }
+
+    bool raw(void* out, uint64_t len) {
+        if (len > remaining_) return false;
+        if (len > 0 && !source_.read(out, len)) return false;
+        remaining_ -= len;
+        return true;
+    }
+
+    bool u16(uint16_t& v) {
+        unsigned char b[2];
+        if (!raw(b, 2)) return false;
+        v = static_cast<uint16_t>(get_le(b, 2));
+        return true;
+    }
+
+    bool u32(uint32_t& v) {
+        unsigned char b[4];
+        if (!raw(b, 4)) return false;
+        v = static_cast<uint32_t>(get_le(b, 4));
+        return true;
+    }
+
+    bool u64(uint64_t& v) {
+        unsigned char b[8];
+        if (!raw(b, 8)) return false;
+        v = get_le(b, 8);
+        return true;
+    }
+
+    bool bytes(std::vector<unsigned char>& out, uint32_t max_len) {
+        uint32_t len;
+        if (!u32(len) || len > max_len || len > remaining_) return false;
+        out.resize(len);
+        return raw(out.data(), len);
+    }
+
+    bool text(std::string& out) {
+        uint32_t len;
+        if (!u32(len) || len > remaining_) return false;
+        out.resize(len);
+        return len == 0 || raw(&out[0], len);
+    }
+
+private:
+    Source source_;
+    uint64_t remaining_;
+};
+
+} // namespace detail
+
+/**
+ * is_bundle() - 文件是否以 "VDSB" 开头
+ */
+inline bool is_bundle(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    return in.read(magic, 4) && std::memcmp(magic, kMagic, 4) == 0;
+}
+
+namespace detail {
+
+// 拼接头部与元数据（到 ciphertext 长度字段为止），total_size 已回填
+inline bool encode_head(const Bundle& bundle, std::string& head, std::string& error) {
+    if (bundle.tag_len != 0 && bundle.tags.size() % bundle.tag_len != 0) {
+        error = "认证标签总长度不是单个标签长度的整数倍";
+        return false;
+    }
+
+    head.clear();
+    head.reserve(64 + bundle.PK.size() + bundle.ID_F.size() + bundle.tags.size() +
+                 bundle.keywords.size() * 320);
+    head.append(kMagic, 4);
+    detail::put_u16(head, kVersion);
+    head.push_back(static_cast<char>(bundle.compressed ? 1 : 0));
+    head.push_back(0);
+    size_t total_size_offset = head.size();
+    detail::put_u64(head, 0);  // 稍后回填
+
+    detail::put_bytes(head, bundle.PK.data(), bundle.PK.size());
+    detail::put_bytes(head, bundle.ID_F.data(), bundle.ID_F.size());
+    detail::put_bytes(head, bundle.state.data(), bundle.state.size());
+
+    detail::put_u32(head, static_cast<uint32_t>(bundle.tag_count()));
+    detail::put_u32(head, bundle.tag_len);
+    head.append(reinterpret_cast<const char*>(bundle.tags.data()), bundle.tags.size());
+
+    detail::put_u32(head, static_cast<uint32_t>(bundle.keywords.size()));
+    for (const auto& kw : bundle.keywords) {
+        detail::put_bytes(head, kw.Ti_bar.data(), kw.Ti_bar.size());
+        detail::put_bytes(head, kw.kt_wi.data(), kw.kt_wi.size());
+        detail::put_bytes(head, kw.ptr_i.data(), kw.ptr_i.size());
+    }
+    detail::put_u64(head, bundle.ciphertext.size());
+
+    uint64_t total = head.size() + bundle.ciphertext.size();
+    std::string total_le;
+    detail::put_u64(total_le, total);
+    head.replace(total_size_offset, 8, total_le);
+    return true;
+}
+
+} // namespace detail
+
+/**
+ * write() - 写出插入请求包
+ * 头部与元数据先在内存中拼好，随后与密文各一次写入
+ * @param error 失败原因
+ * @return 成功返回true
+ */
+inline bool write(const std::string& path, const Bundle& bundle, std::string& error) {
+    std::string head;
+    if (!detail::encode_head(bundle, head, error)) {
+        return false;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        error = "无法创建文件: " + path;
+        return false;
+    }
+    out.write(head.data(), static_cast<std::streamsize>(head.size()));
+    out.write(bundle.ciphertext.data(), static_cast<std::streamsize>(bundle.ciphertext.size()));
+    if (!out) {
+        error = "写入失败: " + path;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * serialize() - 将插入请求包编码到内存（网络帧负载）
+ * 密文为空时即为分块上传使用的"仅元数据"请求包
+ * @param out 输出的请求包字节
+ * @param error 失败原因
+ * @return 成功返回true
+ */
+inline bool serialize(const Bundle& bundle, std::string& out, std::string& error) {
+    if (!detail::encode_head(bundle, out, error)) {
+        return false;
+    }
+    out.append(bundle.ciphertext);
+    return true;
+}
+
+namespace detail {
+
+// 解析请求包：所有长度字段都与剩余字节数比对，损坏或截断的输入会被拒绝
+template <typename Source>
+inline bool parse(Reader<Source>& r, uint64_t file_size, Bundle& bundle, std::string& error) {
+    char magic[4];
+    uint16_t version;
+    unsigned char encoding[2];
+    uint64_t total_size;
+    if (!r.raw(magic, 4) || std::memcmp(magic, kMagic, 4) != 0) {
+        error = "不是插入请求包（magic不匹配）";
+        return false;
+    }
+    if (!r.u16(version) || version != kVersion) {
+        error = "不支持的版本";
+        return false;
+    }
+    if (!r.raw(encoding, 2) || encoding[0] > 1 || !r.u64(total_size)) {
+        error = "头部损坏";
+        return false;
+    }
+    if (total_size != file_size) {
+        error = "文件长度与头部声明不一致（可能被截断）";
+        return false;
+    }
+    bundle.compressed = (encoding[0] == 1);
+
+    if (!r.bytes(bundle.PK, kMaxElementBytes) || !r.text(bundle.ID_F) || !r.text(bundle.state)) {
+        error = "PK/ID_F/state 字段损坏";
+        return false;
+    }
+
+    uint32_t tag_count, tag_len;
+    if (!r.u32(tag_count) || !r.u32(tag_len) || tag_len > kMaxElementBytes ||
+        static_cast<uint64_t>(tag_count) * tag_len > r.remaining()) {
+        error = "TS_F 字段损坏";
+        return false;
+    }
+    bundle.tag_len = tag_len;
+    bundle.tags.resize(static_cast<size_t>(tag_count) * tag_len);
+    if (!r.raw(bundle.tags.data(), bundle.tags.size())) {
+        error = "TS_F 字段损坏";
+        return false;
+    }
+
+    // 每条关键词记录至少包含三个长度字段
+    uint32_t kw_count;
+    if (!r.u32(kw_count) || static_cast<uint64_t>(kw_count) * 12 > r.remaining()) {
+        error = "keywords 字段损坏";
+        return false;
+    }
+    bundle.keywords.resize(kw_count);
+    for (auto& kw : bundle.keywords) {
+        if (!r.bytes(kw.Ti_bar, kMaxElementBytes) || !r.bytes(kw.kt_wi, kMaxElementBytes) ||
+            !r.text(kw.ptr_i)) {
+            error = "keywords 字段损坏";
+            return false;
+        }
+    }
+
+    uint64_t ct_len;
+    if (!r.u64(ct_len) || ct_len != r.remaining()) {
+        error = "密文长度与文件剩余字节不一致";
+        return false;
+    }
+    bundle.ciphertext.resize(static_cast<size_t>(ct_len));
+    if (ct_len > 0 && !r.raw(&bundle.ciphertext[0], ct_len)) {
+        error = "密文读取失败";
+        return false;
+    }
+    return true;
+}
+
+} // namespace detail
+
+/**
+ * read() - 一次顺序读取插入请求包
+ * 所有长度字段都与文件剩余字节数比对，损坏或截断的文件会被拒绝
+ * @param error 失败原因
+ * @return 成功返回true
+ */
+inline bool read(const std::string& path, Bundle& bundle, std::string& error) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        error = "无法打开文件: " + path;
+        return false;
+    }
+    uint64_t file_size = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+
+    detail::Reader<detail::StreamSource> r(detail::StreamSource{in}, file_size);
+    return detail::parse(r, file_size, bundle, error);
+}
+
+/**
+ * parse() - 从内存缓冲区解析插入请求包（服务模式使用）
+ * @param data 完整的请求包字节
+ * @param error 失败原因
+ * @return 成功返回true
+ */
+inline bool parse(const std::string& data, Bundle& bundle, std::string& error) {
+    detail::Reader<detail::MemorySource> r(detail::MemorySource{data.data()}, data.size());
+    return detail::parse(r, data.size(), bundle, error);
+}
+
+} // namespace insert_bundle
+
+#endif // VDS_INSERT_BUNDLE_H
@@ -0,0 +1,134 @@
+#ifndef VDS_MEM_STATS_H
+#define VDS_MEM_STATS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <jsoncpp/json/json.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// ==================== 内存占用估算（存储节点与测试工具共用） ====================
+//
+// 内存数据库各结构的占用按容器实际容量逐项累加（不是序列化后的 JSON 大小）：
+//   heap_block   - 一次堆分配占用的字节（glibc malloc：8 字节块头，16 字节对齐，最小 32 字节）
+//   string_heap  - std::string 超出 SSO 内联缓冲后的堆分配（含结尾 '\0'）
+//   vector_heap  - std::vector 按 capacity 计算的堆分配
+//   map_node     - std::map 每个节点（红黑树节点头 32 字节 + 键值对）
+// 对象本体（sizeof）计入其所在容器的节点或元素中，不重复计算。
+// 这些是按 libstdc++/glibc 布局的估算值；分配器碎片与空闲块由 AllocatorStats 反映，
+// 进程整体占用由 ProcessMemory（/proc/self/status）反映。
+
+namespace mem_stats {
+
+constexpr uint64_t kRbNodeHeader = 32;   // _Rb_tree_node_base：颜色 + 父/左/右指针
+
+inline uint64_t heap_block(size_t n) {
+    if (n == 0) {
+        return 0;
+    }
+    uint64_t chunk = (static_cast<uint64_t>(n) + 8 + 15) & ~static_cast<uint64_t>(15);
+    return std::max<uint64_t>(chunk, 32);
+}
+
+inline uint64_t string_heap(const std::string& s) {
+    static const size_t sso_capacity = std::string().capacity();
+    return s.capacity() > sso_capacity ? heap_block(s.capacity() + 1) : 0;
+}
+
+template <typename T>
+uint64_t vector_heap(const std::vector<T>& v) {
+    return heap_block(v.capacity() * sizeof(T));
+}
+
+template <typename K, typename V>
+uint64_t map_node() {
+    return heap_block(kRbNodeHeader + sizeof(std::pair<const K, V>));
+}
+
+/**
+ * @brief 进程内存（/proc/self/status，单位 kB，不可用时为0）
+ */
+struct ProcessMemory {
+    uint64_t rss_kb = 0;        // VmRSS   当前常驻内存
+    uint64_t peak_rss_kb = 0;   // VmHWM   常驻内存峰值
+    uint64_t vm_size_kb = 0;    // VmSize  虚拟地址空间
+
+    Json::Value to_json() const {
+        Json::Value out;
+        out["rss_kb"] = static_cast<Json::UInt64>(rss_kb);
+        out["peak_rss_kb"] = static_cast<Json::UInt64>(peak_rss_kb);
+        out["vm_size_kb"] = static_cast<Json::UInt64>(vm_size_kb);
+        return out;
+    }
+};
+
+inline ProcessMemory read_process_memory() {
+    ProcessMemory mem;
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    auto parse = [&line](const char* key, uint64_t& out) {
+        std::string prefix = std::string(key) + ":";
+        if (line.compare(0, prefix.size(), prefix) == 0) {
+            out = std::strtoull(line.c_str() + prefix.size(), nullptr, 10);
+        }
+    };
+    while (std::getline(in, line)) {
+        parse("VmRSS", mem.rss_kb);
+        parse("VmHWM", mem.peak_rss_kb);
+        parse("VmSize", mem.vm_size_kb);
+    }
+    return mem;
+}
+
+/**
+ * @brief 分配器统计（glibc mallinfo2 / mallinfo，单位字节；非 glibc 平台 available=false）
+ */
+struct AllocatorStats {
+    bool available = false;
+    uint64_t arena_bytes = 0;        // 主/线程 arena 从系统获取的字节（不含 mmap 大块）
+    uint64_t mmap_bytes = 0;         // 直接 mmap 的大块
+    uint64_t in_use_bytes = 0;       // 已分配给程序的字节
+    uint64_t free_bytes = 0;         // arena 内的空闲字节（碎片）
+    uint64_t releasable_bytes = 0;   // 堆顶可归还系统的字节
+
+    Json::Value to_json() const {
+        Json::Value out;
+        out["available"] = available;
+        out["arena_bytes"] = static_cast<Json::UInt64>(arena_bytes);
+        out["mmap_bytes"] = static_cast<Json::UInt64>(mmap_bytes);
+        out["in_use_bytes"] = static_cast<Json::UInt64>(in_use_bytes);
+        out["free_bytes"] = static_cast<Json::UInt64>(free_bytes);
+        out["releasable_bytes"] = static_cast<Json::UInt64>(releasable_bytes);
+        return out;
+    }
+};
+
+inline AllocatorStats read_allocator_stats() {
+    AllocatorStats stats;
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+#elif defined(__GLIBC__)
+    // 旧版 mallinfo 字段为 int，超过 2 GB 时会回绕
+    struct mallinfo info = mallinfo();
+#endif
+#if defined(__GLIBC__)
+    stats.available = true;
+    stats.arena_bytes = static_cast<uint64_t>(info.arena);
+    stats.mmap_bytes = static_cast<uint64_t>(info.hblkhd);
+    stats.in_use_bytes = static_cast<uint64_t>(info.uordblks) + static_cast<uint64_t>(info.hblkhd);
+    stats.free_bytes = static_cast<uint64_t>(info.fordblks);
+    stats.releasable_bytes = static_cast<uint64_t>(info.keepcost);
+#endif
+    return stats;
+}
+
+} // namespace mem_stats
+
+#endif // VDS_MEM_STATS_H
@@ -0,0 +1,292 @@
+#ifndef VDS_NODE_PROTOCOL_H
+#define VDS_NODE_PROTOCOL_H
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <jsoncpp/json/json.h>
+
+// ==================== 存储节点服务协议（客户端与存储节点共用） ====================
+//
+// 每个请求/响应为一帧，整数均为小端序：
+//
+//   body_len   u32   其后字节数 = 4 + json_len + payload_len
+//   json_len   u32
+//   json       json_len 字节，UTF-8 JSON 对象
+//   payload    其余字节，二进制负载（插入请求包、密文等）
+//
+// 请求 JSON：{"op": "...", "id": n, ...}，响应 JSON：{"id": n, "ok": bool, "error": "...", "result": {...}}
+// 同一连接可流水线发送多个请求，响应可能乱序，按 id 匹配。
+// 协议没有认证：节点默认只监听 127.0.0.1，监听外部地址须在 config.json 中设置 server.bind_address。
+//
+//   op              请求字段                         响应
+//   ping            -                                node_id
+//   status          -                                文件数 / 搜索索引数 / 进行中的上传数 / 回收统计 / 按操作的延迟分位数
+//   memory          -                                各内存结构的估算占用 / 进程与分配器统计（遍历数据库，O(N)）
+//   insert          payload = .vdsb 请求包            ID_F
+//                   或 params = insert.json, payload = 密文
+//   upload_begin    size = 密文总长度, params = insert.json   upload_id
+//                   或 payload = 密文为空的 .vdsb 请求包
+//   upload_append   upload_id, offset, payload = 密文分块    received
+//                   （分块须按顺序：等上一块的响应后再发下一块）
+//   upload_commit   upload_id                        ID_F（校验 H1(C) == ID_F）
+//   upload_abort    upload_id
+//   delete          params = 删除参数 (ID_F, PK, del)
+//   delete_batch    params = [删除参数, ...]         deleted / failed / results（整批一次提交）
+//   compact         -                                本次回收的文件数与字节数
+//   search          params = 搜索参数 (PK, T, std, ...)   result = 搜索证明
+//   file_proof      ID_F                             result = 文件证明
+//   verify_search   proof = 搜索证明                  result.valid
+//   verify_file     proof = 文件证明                  result.valid
+//   retrieve        ID_F                             payload = 密文
+//
+// 分块上传会话属于发起 upload_begin 的连接：连接关闭时未提交的会话被放弃；
+// 超过 storage.upload_idle_timeout_sec 未追加的会话被回收；同时进行的会话数
+// 达到 storage.max_upload_sessions 时 upload_begin 返回失败。
+
+namespace node_protocol {
+
+const uint32_t kPrefixBytes = 8;                        // body_len + json_len
+const uint32_t kDefaultMaxFrameBytes = 256u << 20;      // 单帧上限 256 MiB
+
+struct Message {
+    Json::Value header;
+    std::string payload;
+};
+
+namespace detail {
+
+inline void put_u32(char* out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out[i] = static_cast<char>((v >> (8 * i)) & 0xFF);
+}
+
+inline uint32_t get_u32(const char* p) {
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+    return u[0] | (u[1] << 8) | (u[2] << 16) | (static_cast<uint32_t>(u[3]) << 24);
+}
+
+} // namespace detail
+
+/**
+ * to_json_text() - 紧凑JSON序列化（无缩进）
+ */
+inline std::string to_json_text(const Json::Value& value) {
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    return Json::writeString(writer, value);
+}
+
+/**
+ * parse_json_text() - 解析JSON对象
+ * @return 非法JSON或非对象时返回false
+ */
+inline bool parse_json_text(const char* data, size_t len, Json::Value& out, std::string& error) {
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    if (!reader->parse(data, data + len, &out, &error)) {
+        return false;
+    }
+    if (!out.isObject()) {
+        error = "帧头不是JSON对象";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * append_frame() - 将一帧追加到out（复用其容量）
+ */
+inline void append_frame(const std::string& json, const char* payload, size_t payload_len,
+                         std::string& out) {
+    char prefix[kPrefixBytes];
+    detail::put_u32(prefix, static_cast<uint32_t>(4 + json.size() + payload_len));
+    detail::put_u32(prefix + 4, static_cast<uint32_t>(json.size()));
+    out.append(prefix, kPrefixBytes);
+    out.append(json);
+    out.append(payload, payload_len);
+}
+
+inline std::string encode_frame(const Json::Value& header, const std::string& payload = std::string()) {
+    std::string out;
+    append_frame(to_json_text(header), payload.data(), payload.size(), out);
+    return out;
+}
+
+enum class ParseStatus {
+    NeedMore,   // 数据不足一帧
+    Ok,         // 解析出一帧
+    Error       // 长度字段非法，连接应关闭
+};
+
+/**
+ * parse_frame() - 从缓冲区头部解析一帧（不拷贝负载以外的数据）
+ * @param consumed 解析成功时为该帧占用的字节数
+ * @param json_begin/json_len 帧头JSON在data中的位置
+ */
+inline ParseStatus parse_frame(const char* data, size_t len, uint32_t max_frame_bytes,
+                               size_t& consumed, size_t& json_begin, size_t& json_len,
+                               size_t& payload_len) {
+    if (len < kPrefixBytes) {
+        return ParseStatus::NeedMore;
+    }
+    uint32_t body_len = detail::get_u32(data);
+    uint32_t jlen = detail::get_u32(data + 4);
+    if (body_len < 4 || body_len > max_frame_bytes || jlen > body_len - 4) {
+        return ParseStatus::Error;
+    }
+    if (len < 4 + static_cast<size_t>(body_len)) {
+        return ParseStatus::NeedMore;
+    }
+    consumed = 4 + static_cast<size_t>(body_len);
+    json_begin = kPrefixBytes;
+    json_len = jlen;
+    payload_len = body_len - 4 - jlen;
+    return ParseStatus::Ok;
+}
+
+// ==================== 阻塞式客户端（回环测试与工具使用） ====================
+
+class Client {
+public:
+    Client() = default;
+    ~Client() { close(); }
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    /**
+     * connect() - 连接存储节点服务
+     * @return 失败返回false，原因见 last_error()
+     */
+    bool connect(const std::string& host, int port) {
+        close();
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* res = nullptr;
+        int rc = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res);
+        if (rc != 0) {
+            error_ = std::string("地址解析失败: ") + gai_strerror(rc);
+            return false;
+        }
+        for (addrinfo* ai = res; ai; ai = ai->ai_next) {
+            fd_ = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd_ < 0) continue;
+            if (::connect(fd_, ai->ai_addr, ai->ai_addrlen) == 0) break;
+            ::close(fd_);
+            fd_ = -1;
+        }
+        freeaddrinfo(res);
+        if (fd_ < 0) {
+            error_ = std::string("连接失败: ") + std::strerror(errno);
+            return false;
+        }
+        int one = 1;
+        setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        return true;
+    }
+
+    void close() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        buffer_.clear();
+    }
+
+    bool connected() const { return fd_ >= 0; }
+    const std::string& last_error() const { return error_; }
+
+    /**
+     * call() - 发送一个请求并等待对应id的响应
+     * @param request 请求JSON（自动分配id）
+     * @param payload 二进制负载
+     * @param response 输出的响应
+     * @return 通信失败返回false；业务失败看 response.header["ok"]
+     */
+    bool call(Json::Value request, const std::string& payload, Message& response) {
+        if (fd_ < 0) {
+            error_ = "未连接";
+            return false;
+        }
+        Json::UInt64 id = ++next_id_;
+        request["id"] = id;
+        std::string frame = encode_frame(request, payload);
+        if (!send_all(frame.data(), frame.size())) {
+            return false;
+        }
+        while (true) {
+            if (!read_frame(response)) {
+                return false;
+            }
+            if (response.header.get("id", 0).asUInt64() == id) {
+                return true;
+            }
+        }
+    }
+
+private:
+    bool send_all(const char* data, size_t len) {
+        while (len > 0) {
+            ssize_t n = ::send(fd_, data, len, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                error_ = std::string("发送失败: ") + std::strerror(errno);
+                return false;
+            }
+            data += n;
+            len -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool read_frame(Message& out) {
+        char chunk[64 * 1024];
+        while (true) {
+            size_t consumed, json_begin, json_len, payload_len;
+            ParseStatus st = parse_frame(buffer_.data(), buffer_.size(), kDefaultMaxFrameBytes,
+                                         consumed, json_begin, json_len, payload_len);
+            if (st == ParseStatus::Error) {
+                error_ = "响应帧长度非法";
+                return false;
+            }
+            if (st == ParseStatus::Ok) {
+                if (!parse_json_text(buffer_.data() + json_begin, json_len, out.header, error_)) {
+                    return false;
+                }
+                out.payload.assign(buffer_.data() + json_begin + json_len, payload_len);
+                buffer_.erase(0, consumed);
+                return true;
+            }
+            ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+            if (n == 0) {
+                error_ = "连接已被服务端关闭";
+                return false;
+            }
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                error_ = std::string("接收失败: ") + std::strerror(errno);
+                return false;
+            }
+            buffer_.append(chunk, static_cast<size_t>(n));
+        }
+    }
+
+    int fd_ = -1;
+    Json::UInt64 next_id_ = 0;
+    std::string buffer_;
+    std::string error_;
+};
+
+} // namespace node_protocol
+
+#endif // VDS_NODE_PROTOCOL_H
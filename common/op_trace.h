@@ -0,0 +1,212 @@
+#ifndef VDS_OP_TRACE_H
+#define VDS_OP_TRACE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <jsoncpp/json/json.h>
+#include "node_protocol.h"
+#include "perf_metrics.h"
+
+// ==================== 请求录制与回放格式（存储节点与回放工具共用） ====================
+//
+// 录制目录结构：
+//   <trace_dir>/requests.jsonl       每个请求一行 JSON（按完成顺序追加，每行写完即刷新）
+//   <trace_dir>/payloads/<seq>.bin   非空请求负载（插入请求包、上传分块）
+//
+// 每行字段：
+//   seq             录制序号（从0开始，按完成顺序分配）
+//   conn            服务端连接ID（回放时同一连接的请求在同一个客户端连接上按 received_ns 顺序发送）
+//   received_ns     请求帧到达时刻，相对录制开始
+//   queue_ns        在任务队列中等待工作线程的时间
+//   service_ns      handle_request 的执行时间
+//   op              请求类型
+//   request         请求JSON（去掉 id）
+//   payload         负载文件相对路径（无负载时省略），payload_bytes 为其长度
+//   ok / error      响应结果
+//   response_bytes  响应帧 JSON + 负载字节数
+//   upload_id       upload_begin 分配的上传ID（回放时映射到新的上传ID）
+
+namespace op_trace {
+
+constexpr const char* kTraceFile = "requests.jsonl";
+constexpr const char* kPayloadDir = "payloads";
+
+/**
+ * @brief 一条录制的请求
+ */
+struct Record {
+    uint64_t seq = 0;
+    uint64_t conn = 0;
+    uint64_t received_ns = 0;
+    uint64_t queue_ns = 0;
+    uint64_t service_ns = 0;
+    std::string op;
+    Json::Value request;
+    std::string payload_file;      // 相对 trace_dir，空表示无负载
+    uint64_t payload_bytes = 0;
+    bool ok = false;
+    std::string error;
+    uint64_t response_bytes = 0;
+    std::string upload_id;
+};
+
+/**
+ * @brief 线程安全的请求录制器（工作线程在写回响应前调用 record）
+ */
+class Recorder {
+public:
+    /**
+     * open() - 创建录制目录并截断 requests.jsonl，录制时间从此刻起算
+     */
+    bool open(const std::string& trace_dir, std::string& error) {
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(trace_dir) / kPayloadDir, ec);
+        if (ec) {
+            error = "无法创建录制目录: " + trace_dir + " (" + ec.message() + ")";
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        out_.open(trace_dir + "/" + kTraceFile, std::ios::trunc);
+        if (!out_.is_open()) {
+            error = "无法打开录制文件: " + trace_dir + "/" + kTraceFile;
+            return false;
+        }
+        dir_ = trace_dir;
+        origin_ns_ = perf_metrics::now_ns();
+        next_seq_ = 0;
+        return true;
+    }
+
+    uint64_t origin_ns() const { return origin_ns_; }
+    uint64_t count() const { return next_seq_.load(); }
+
+    /**
+     * record() - 追加一条请求
+     * @param received_ns 请求到达时刻（steady_clock 绝对值）
+     * @param start_ns 工作线程开始处理的时刻（steady_clock 绝对值）
+     * @param end_ns 处理完成的时刻（steady_clock 绝对值）
+     */
+    void record(uint64_t conn, uint64_t received_ns, uint64_t start_ns, uint64_t end_ns,
+                Json::Value request, const std::string& payload, const Json::Value& response,
+                size_t response_bytes) {
+        uint64_t seq = next_seq_++;
+        request.removeMember("id");
+
+        Json::Value line;
+        line["seq"] = static_cast<Json::UInt64>(seq);
+        line["conn"] = static_cast<Json::UInt64>(conn);
+        line["received_ns"] = static_cast<Json::UInt64>(received_ns > origin_ns_ ? received_ns - origin_ns_ : 0);
+        line["queue_ns"] = static_cast<Json::UInt64>(start_ns > received_ns ? start_ns - received_ns : 0);
+        line["service_ns"] = static_cast<Json::UInt64>(end_ns - start_ns);
+        line["op"] = request.get("op", "").asString();
+        line["request"] = request;
+        if (!payload.empty()) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%s/%010llu.bin", kPayloadDir,
+                          static_cast<unsigned long long>(seq));
+            std::ofstream blob(dir_ + "/" + name, std::ios::binary);
+            blob.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+            line["payload"] = name;
+            line["payload_bytes"] = static_cast<Json::UInt64>(payload.size());
+        }
+        line["ok"] = response.get("ok", false).asBool();
+        if (response.isMember("error")) {
+            line["error"] = response["error"];
+        }
+        line["response_bytes"] = static_cast<Json::UInt64>(response_bytes);
+        if (response.isMember("result") && response["result"].isMember("upload_id")) {
+            line["upload_id"] = response["result"]["upload_id"];
+        }
+
+        std::string text = node_protocol::to_json_text(line);
+        std::lock_guard<std::mutex> lock(mutex_);
+        out_ << text << '\n';
+        out_.flush();
+    }
+
+private:
+    std::mutex mutex_;
+    std::ofstream out_;
+    std::string dir_;
+    uint64_t origin_ns_ = 0;
+    std::atomic<uint64_t> next_seq_{0};
+};
+
+/**
+ * read_trace() - 读取 requests.jsonl（空行跳过），结果按 received_ns 排序
+ */
+inline bool read_trace(const std::string& trace_dir, std::vector<Record>& records, std::string& error) {
+    std::ifstream in(trace_dir + "/" + kTraceFile);
+    if (!in.is_open()) {
+        error = "无法打开录制文件: " + trace_dir + "/" + kTraceFile;
+        return false;
+    }
+    records.clear();
+    std::string text;
+    size_t line_no = 0;
+    while (std::getline(in, text)) {
+        line_no++;
+        if (text.empty()) {
+            continue;
+        }
+        Json::Value line;
+        std::string parse_error;
+        if (!node_protocol::parse_json_text(text.data(), text.size(), line, parse_error)) {
+            error = "第 " + std::to_string(line_no) + " 行解析失败: " + parse_error;
+            return false;
+        }
+        Record r;
+        r.seq = line.get("seq", 0).asUInt64();
+        r.conn = line.get("conn", 0).asUInt64();
+        r.received_ns = line.get("received_ns", 0).asUInt64();
+        r.queue_ns = line.get("queue_ns", 0).asUInt64();
+        r.service_ns = line.get("service_ns", 0).asUInt64();
+        r.op = line.get("op", "").asString();
+        r.request = line["request"];
+        r.payload_file = line.get("payload", "").asString();
+        r.payload_bytes = line.get("payload_bytes", 0).asUInt64();
+        r.ok = line.get("ok", false).asBool();
+        r.error = line.get("error", "").asString();
+        r.response_bytes = line.get("response_bytes", 0).asUInt64();
+        r.upload_id = line.get("upload_id", "").asString();
+        records.push_back(std::move(r));
+    }
+    std::stable_sort(records.begin(), records.end(), [](const Record& a, const Record& b) {
+        return a.received_ns < b.received_ns;
+    });
+    return true;
+}
+
+/**
+ * read_payload() - 读取一条记录的请求负载（无负载时返回空串）
+ */
+inline bool read_payload(const std::string& trace_dir, const Record& record, std::string& payload,
+                         std::string& error) {
+    payload.clear();
+    if (record.payload_file.empty()) {
+        return true;
+    }
+    std::ifstream in(trace_dir + "/" + record.payload_file, std::ios::binary);
+    if (!in.is_open()) {
+        error = "无法打开负载文件: " + record.payload_file;
+        return false;
+    }
+    payload.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (payload.size() != record.payload_bytes) {
+        error = "负载文件长度不符: " + record.payload_file;
+        return false;
+    }
+    return true;
+}
+
+} // namespace op_trace
+
+#endif // VDS_OP_TRACE_H
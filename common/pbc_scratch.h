@@ -0,0 +1,159 @@
+#ifndef VDS_PBC_SCRATCH_H
+#define VDS_PBC_SCRATCH_H
+
+#include <pbc/pbc.h>
+#include <gmp.h>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ==================== 证明内核临时变量池（客户端与存储节点共用） ====================
+
+/**
+ * @brief 预初始化的密码学临时变量
+ *
+ * 证明/验证的逐块循环原先每次迭代都要 element_init/element_clear、
+ * mpz_init/mpz_clear 以及分配字节缓冲区。PbcScratch 在首次使用时一次性
+ * 初始化这些变量，之后在迭代与请求之间复用（GMP/PBC 的内部 limb 空间也随之复用）。
+ *
+ * 一个 PbcScratch 同一时刻只能被一个线程使用，通过 PbcScratchPool::acquire() 获取。
+ */
+struct PbcScratch {
+    // G1 临时元素
+    element_t pow;     // 幂运算结果（phi_temp / temp_pow / mu_power）
+    element_t hash;    // H2 哈希结果（h2_temp / h2_result）
+    element_t aux;     // 其他中间值（sigma / Ti_bar / kt）
+
+    // Zr 标量临时变量
+    mpz_t prf;         // PRF 系数 v_i
+    mpz_t c_ij;        // 扇区数据 c_ij
+    mpz_t product;     // v_i * c_ij
+
+    // 字节缓冲区
+    std::vector<unsigned char> bytes;   // 元素序列化/反序列化缓冲
+    std::vector<unsigned char> block;   // 末块补零缓冲
+    std::string text;                   // 哈希输入拼接缓冲
+
+    explicit PbcScratch(pairing_t pairing) {
+        element_init_G1(pow, pairing);
+        element_init_G1(hash, pairing);
+        element_init_G1(aux, pairing);
+        mpz_init(prf);
+        mpz_init(c_ij);
+        mpz_init(product);
+    }
+
+    ~PbcScratch() {
+        element_clear(pow);
+        element_clear(hash);
+        element_clear(aux);
+        mpz_clear(prf);
+        mpz_clear(c_ij);
+        mpz_clear(product);
+    }
+
+    /**
+     * padded_block() - 取第index块的只读指针（无拷贝）
+     * 完整块直接指向原数据；末块不足block_size时复制到block缓冲并补零
+     * @param data 数据起始地址
+     * @param size 数据总长度
+     * @param index 块下标（从0开始）
+     * @param block_size 块大小
+     * @return 指向block_size字节的指针
+     */
+    const unsigned char* padded_block(const unsigned char* data, size_t size,
+                                      size_t index, size_t block_size) {
+        size_t start = index * block_size;
+        if (start + block_size <= size) {
+            return data + start;
+        }
+        block.assign(block_size, 0);
+        if (start < size) {
+            std::memcpy(block.data(), data + start, size - start);
+        }
+        return block.data();
+    }
+
+    PbcScratch(const PbcScratch&) = delete;
+    PbcScratch& operator=(const PbcScratch&) = delete;
+};
+
+/**
+ * @brief PbcScratch 对象池，线程安全
+ *
+ * 每个工作线程在一次请求内 acquire() 一个上下文，请求结束时自动归还，
+ * 因此池的大小等于历史最大并发数。池中元素依赖所属的 pairing，
+ * 必须在 pairing_clear() 之前调用 clear()。
+ */
+class PbcScratchPool {
+public:
+    class Lease {
+    public:
+        Lease(PbcScratchPool* pool, std::unique_ptr<PbcScratch> scratch)
+            : pool_(pool), scratch_(std::move(scratch)) {}
+        Lease(Lease&& other) noexcept = default;
+        Lease& operator=(Lease&&) = delete;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        ~Lease() {
+            if (pool_ && scratch_) {
+                pool_->release(std::move(scratch_));
+            }
+        }
+
+        PbcScratch& operator*() { return *scratch_; }
+        PbcScratch* operator->() { return scratch_.get(); }
+
+    private:
+        PbcScratchPool* pool_;
+        std::unique_ptr<PbcScratch> scratch_;
+    };
+
+    PbcScratchPool() = default;
+    PbcScratchPool(const PbcScratchPool&) = delete;
+    PbcScratchPool& operator=(const PbcScratchPool&) = delete;
+
+    /**
+     * acquire() - 取出一个空闲上下文，池为空时按 pairing 新建
+     * @param pairing 配对参数（必须与池中已有上下文一致）
+     * @return 租约，析构时归还上下文
+     */
+    Lease acquire(pairing_t pairing) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_.empty()) {
+                std::unique_ptr<PbcScratch> scratch = std::move(free_.back());
+                free_.pop_back();
+                return Lease(this, std::move(scratch));
+            }
+        }
+        return Lease(this, std::unique_ptr<PbcScratch>(new PbcScratch(pairing)));
+    }
+
+    /**
+     * clear() - 释放全部空闲上下文（重新初始化或清理 pairing 前调用）
+     */
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.clear();
+    }
+
+    size_t idle_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return free_.size();
+    }
+
+private:
+    void release(std::unique_ptr<PbcScratch> scratch) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(std::move(scratch));
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<PbcScratch>> free_;
+};
+
+#endif // VDS_PBC_SCRATCH_H
@@ -0,0 +1,314 @@
+#ifndef VDS_PERF_METRICS_H
+#define VDS_PERF_METRICS_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <jsoncpp/json/json.h>
+
+// ==================== 高精度计时与延迟直方图（客户端、存储节点与测试工具共用） ====================
+//
+// 计时统一使用 steady_clock 纳秒计数（now_ns），上报时转换为 double 毫秒，不再截断到整毫秒。
+// Histogram 为 HDR 风格的对数-线性桶：每个 2 的幂区间再均分 64 个子桶，
+// 任意取值的相对误差不超过 1/64（约 1.6%），内存固定（约 30 KB），记录为 O(1)。
+// Registry 按指标名称汇总多个直方图，可导出为 JSON 对象或 CSV 表格
+// （count / mean / p50 / p90 / p99 / p999 / min / max，单位毫秒）。
+// OpCounters 记录单个请求的密码学操作次数，用于解释延迟差异与容量规划。
+
+namespace perf_metrics {
+
+inline uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+inline double elapsed_ms(uint64_t start_ns) {
+    return static_cast<double>(now_ns() - start_ns) / 1e6;
+}
+
+/**
+ * @brief 对数-线性桶直方图（纳秒）
+ */
+class Histogram {
+public:
+    static constexpr int kSubBits = 7;                          // 0..127 精确记录
+    static constexpr uint64_t kSubCount = 1ull << kSubBits;     // 128
+    static constexpr uint64_t kHalf = kSubCount / 2;            // 每个 2 的幂区间的子桶数
+    static constexpr size_t kBuckets = kSubCount + (64 - kSubBits) * kHalf;
+
+    Histogram() : counts_(kBuckets, 0) {}
+
+    void record(uint64_t ns) {
+        counts_[index_of(ns)]++;
+        if (count_ == 0 || ns < min_) {
+            min_ = ns;
+        }
+        if (ns > max_) {
+            max_ = ns;
+        }
+        count_++;
+        sum_ += static_cast<double>(ns);
+    }
+
+    void merge(const Histogram& other) {
+        if (other.count_ == 0) {
+            return;
+        }
+        for (size_t i = 0; i < kBuckets; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        if (count_ == 0 || other.min_ < min_) {
+            min_ = other.min_;
+        }
+        if (other.max_ > max_) {
+            max_ = other.max_;
+        }
+        count_ += other.count_;
+        sum_ += other.sum_;
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t min_ns() const { return count_ ? min_ : 0; }
+    uint64_t max_ns() const { return max_; }
+    double mean_ns() const { return count_ ? sum_ / static_cast<double>(count_) : 0.0; }
+
+    /**
+     * percentile_ns() - 第 p 百分位（0 < p <= 100），返回所在桶的上界（不超过最大值）
+     */
+    uint64_t percentile_ns(double p) const {
+        if (count_ == 0) {
+            return 0;
+        }
+        double target = p / 100.0 * static_cast<double>(count_);
+        uint64_t rank = static_cast<uint64_t>(target);
+        if (static_cast<double>(rank) < target || rank == 0) {
+            rank++;
+        }
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                uint64_t upper = highest_in_bucket(i);
+                return upper < max_ ? upper : max_;
+            }
+        }
+        return max_;
+    }
+
+    double percentile_ms(double p) const {
+        return static_cast<double>(percentile_ns(p)) / 1e6;
+    }
+
+private:
+    static int msb(uint64_t v) {
+        return 63 - __builtin_clzll(v);
+    }
+
+    static size_t index_of(uint64_t v) {
+        if (v < kSubCount) {
+            return static_cast<size_t>(v);
+        }
+        int shift = msb(v) - (kSubBits - 1);    // v >> shift 落在 [64, 128)
+        return static_cast<size_t>(kSubCount + (shift - 1) * kHalf + ((v >> shift) - kHalf));
+    }
+
+    static uint64_t highest_in_bucket(size_t index) {
+        if (index < kSubCount) {
+            return index;
+        }
+        uint64_t rel = index - kSubCount;
+        int shift = static_cast<int>(rel / kHalf) + 1;
+        uint64_t sub = rel % kHalf + kHalf;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::vector<uint64_t> counts_;
+    uint64_t count_ = 0;
+    uint64_t min_ = 0;
+    uint64_t max_ = 0;
+    double sum_ = 0;
+};
+
+/**
+ * @brief 按指标名称汇总的直方图集合（线程安全）
+ */
+class Registry {
+public:
+    void record_ns(const std::string& name, uint64_t ns) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        histograms_[name].record(ns);
+    }
+
+    void record_ms(const std::string& name, double ms) {
+        record_ns(name, ms <= 0 ? 0 : static_cast<uint64_t>(ms * 1e6 + 0.5));
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        histograms_.clear();
+    }
+
+    bool empty() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return histograms_.empty();
+    }
+
+    std::map<std::string, Histogram> snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return histograms_;
+    }
+
+    /**
+     * to_json() - {指标名: {count, mean_ms, p50_ms, p90_ms, p99_ms, p999_ms, min_ms, max_ms}}
+     */
+    Json::Value to_json() const {
+        Json::Value root(Json::objectValue);
+        for (const auto& kv : snapshot()) {
+            const Histogram& h = kv.second;
+            Json::Value item;
+            item["count"] = static_cast<Json::UInt64>(h.count());
+            item["mean_ms"] = h.mean_ns() / 1e6;
+            item["p50_ms"] = h.percentile_ms(50);
+            item["p90_ms"] = h.percentile_ms(90);
+            item["p99_ms"] = h.percentile_ms(99);
+            item["p999_ms"] = h.percentile_ms(99.9);
+            item["min_ms"] = static_cast<double>(h.min_ns()) / 1e6;
+            item["max_ms"] = static_cast<double>(h.max_ns()) / 1e6;
+            root[kv.first] = item;
+        }
+        return root;
+    }
+
+    /**
+     * write_csv() - 每个指标一行：metric,count,mean_ms,p50_ms,p90_ms,p99_ms,p999_ms,min_ms,max_ms
+     */
+    void write_csv(std::ostream& out) const {
+        out << "metric,count,mean_ms,p50_ms,p90_ms,p99_ms,p999_ms,min_ms,max_ms\n";
+        for (const auto& kv : snapshot()) {
+            const Histogram& h = kv.second;
+            out << kv.first << "," << h.count() << "," << h.mean_ns() / 1e6 << ","
+                << h.percentile_ms(50) << "," << h.percentile_ms(90) << ","
+                << h.percentile_ms(99) << "," << h.percentile_ms(99.9) << ","
+                << static_cast<double>(h.min_ns()) / 1e6 << ","
+                << static_cast<double>(h.max_ns()) / 1e6 << "\n";
+        }
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, Histogram> histograms_;
+};
+
+// ==================== 密码学操作计数（按请求归属） ====================
+//
+// 各操作的内存实现（插入、搜索、证明、验证，见 storage_node.cpp）构造 CounterScope，
+// 文件接口、批量搜索的每个请求与 NodeServer 请求都经过它们；范围内本线程上的配对、G1 幂/乘、
+// hash-to-curve、SHA-256、指针解密与读取的密文/JSON 字节数累加到该请求的 OpCounters；
+// 没有活动计数器时 count() 只读一次线程局部指针。嵌套的计数范围在退出时并入外层。
+
+/**
+ * @brief 单个请求的密码学操作与数据量计数
+ */
+struct OpCounters {
+    uint64_t pairings = 0;             // 双线性配对
+    uint64_t g1_exponentiations = 0;   // G1 幂运算
+    uint64_t g1_multiplications = 0;   // G1 乘法（含除法）
+    uint64_t hash_to_curve = 0;        // H2 哈希到 G1
+    uint64_t sha256 = 0;               // SHA-256 调用（含 H1/H2/H3/PRF 内部）
+    uint64_t aes_decryptions = 0;      // AES 指针解密
+    uint64_t ciphertext_bytes = 0;     // 读取的密文字节
+    uint64_t json_bytes = 0;           // 解析的 JSON 字节
+
+    OpCounters& operator+=(const OpCounters& other) {
+        pairings += other.pairings;
+        g1_exponentiations += other.g1_exponentiations;
+        g1_multiplications += other.g1_multiplications;
+        hash_to_curve += other.hash_to_curve;
+        sha256 += other.sha256;
+        aes_decryptions += other.aes_decryptions;
+        ciphertext_bytes += other.ciphertext_bytes;
+        json_bytes += other.json_bytes;
+        return *this;
+    }
+
+    Json::Value to_json() const {
+        Json::Value out;
+        out["pairings"] = static_cast<Json::UInt64>(pairings);
+        out["g1_exponentiations"] = static_cast<Json::UInt64>(g1_exponentiations);
+        out["g1_multiplications"] = static_cast<Json::UInt64>(g1_multiplications);
+        out["hash_to_curve"] = static_cast<Json::UInt64>(hash_to_curve);
+        out["sha256"] = static_cast<Json::UInt64>(sha256);
+        out["aes_decryptions"] = static_cast<Json::UInt64>(aes_decryptions);
+        out["ciphertext_bytes"] = static_cast<Json::UInt64>(ciphertext_bytes);
+        out["json_bytes"] = static_cast<Json::UInt64>(json_bytes);
+        return out;
+    }
+};
+
+inline OpCounters*& active_counters() {
+    thread_local OpCounters* counters = nullptr;
+    return counters;
+}
+
+/**
+ * count() - 累加当前线程活动计数器的某一项，例如 count(&OpCounters::pairings)
+ */
+inline void count(uint64_t OpCounters::* field, uint64_t n = 1) {
+    if (OpCounters* counters = active_counters()) {
+        counters->*field += n;
+    }
+}
+
+/**
+ * @brief 按请求类型汇总的操作计数（线程安全），导出总量与单请求平均值
+ */
+class OpCounterSummary {
+public:
+    void record(const std::string& name, const OpCounters& counters) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = entries_[name];
+        entry.requests++;
+        entry.total += counters;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+    }
+
+    /**
+     * to_json() - {请求类型: {requests, total: {...}, per_request: {...}}}
+     */
+    Json::Value to_json() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Json::Value root(Json::objectValue);
+        for (const auto& kv : entries_) {
+            Json::Value total = kv.second.total.to_json();
+            Json::Value per_request(Json::objectValue);
+            for (const auto& key : total.getMemberNames()) {
+                per_request[key] = total[key].asDouble() / static_cast<double>(kv.second.requests);
+            }
+            root[kv.first]["requests"] = static_cast<Json::UInt64>(kv.second.requests);
+            root[kv.first]["total"] = total;
+            root[kv.first]["per_request"] = per_request;
+        }
+        return root;
+    }
+
+private:
+    struct Entry {
+        uint64_t requests = 0;
+        OpCounters total;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Entry> entries_;
+};
+
+} // namespace perf_metrics
+
+#endif // VDS_PERF_METRICS_H
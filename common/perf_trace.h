@@ -0,0 +1,148 @@
+#ifndef VDS_PERF_TRACE_H
+#define VDS_PERF_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "perf_metrics.h"
+
+// ==================== 嵌套阶段追踪（存储节点与测试工具共用） ====================
+//
+// 计时器在构造时压入线程局部的阶段栈，析构时弹出并上报 Span（含父阶段与深度），
+// 由此得到 search_total > chain_walk > pointer_decrypt 这样的嵌套结构。
+// 逐块循环内的短阶段（PRF、psi 累加、phi 幂运算）用累计计时器，退出时只上报一次
+// 合计耗时与调用次数。未设置回调时计时器只做一次空指针判断，不读时钟。
+//
+// ChromeTraceWriter 收集 Span 并导出为 Chrome trace-event JSON
+// （chrome://tracing 或 https://ui.perfetto.dev 打开）。
+
+namespace perf_trace {
+
+/**
+ * @brief 一次完成的阶段
+ */
+struct Span {
+    std::string name;
+    std::string parent;        // 父阶段名（顶层为空）
+    int depth = 0;             // 嵌套深度（顶层为0）
+    double start_us = 0;       // 开始时间（steady_clock，微秒）
+    double dur_us = 0;         // 耗时（累计计时器为合计耗时）
+    uint32_t tid = 0;          // 进程内线程序号
+    uint64_t calls = 1;        // 累计计时器的执行次数
+};
+
+/**
+ * @brief 线程上正在计时的阶段（栈帧链接在计时器对象内，不分配内存）
+ */
+struct Frame {
+    const char* name = nullptr;
+    const Frame* parent = nullptr;
+    int depth = 0;
+};
+
+inline double now_us() {
+    return static_cast<double>(perf_metrics::now_ns()) / 1e3;
+}
+
+inline uint32_t thread_index() {
+    static std::atomic<uint32_t> next{1};
+    thread_local uint32_t index = next.fetch_add(1);
+    return index;
+}
+
+inline const Frame*& current_frame() {
+    thread_local const Frame* frame = nullptr;
+    return frame;
+}
+
+/**
+ * @brief 线程安全的 Span 收集器与 Chrome trace-event 导出
+ */
+class ChromeTraceWriter {
+public:
+    void record(const Span& span) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        spans_.push_back(span);
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return spans_.size();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        spans_.clear();
+    }
+
+    std::vector<Span> snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return spans_;
+    }
+
+    /**
+     * write() - 写出 {"traceEvents": [...]}，每个 Span 为一个完整事件 (ph = "X")
+     * @param path 输出文件路径
+     * @param error 失败时的错误描述
+     * @return 成功返回true
+     */
+    bool write(const std::string& path, std::string& error) const {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            error = "无法打开输出文件: " + path;
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        for (size_t i = 0; i < spans_.size(); ++i) {
+            const Span& s = spans_[i];
+            out << (i == 0 ? "\n" : ",\n")
+                << "{\"name\":\"" << escape(s.name) << "\",\"cat\":\"vds\",\"ph\":\"X\""
+                << ",\"ts\":" << fixed(s.start_us) << ",\"dur\":" << fixed(s.dur_us)
+                << ",\"pid\":1,\"tid\":" << s.tid
+                << ",\"args\":{\"parent\":\"" << escape(s.parent) << "\",\"depth\":" << s.depth
+                << ",\"calls\":" << s.calls << "}}";
+        }
+        out << "\n]}\n";
+
+        if (!out.good()) {
+            error = "写入失败: " + path;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static std::string escape(const std::string& text) {
+        std::string out;
+        out.reserve(text.size());
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out.push_back('\\');
+                out.push_back(c);
+            } else if (static_cast<unsigned char>(c) >= 0x20) {
+                out.push_back(c);
+            }
+        }
+        return out;
+    }
+
+    static std::string fixed(double us) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.3f", us);
+        return buf;
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<Span> spans_;
+};
+
+} // namespace perf_trace
+
+#endif // VDS_PERF_TRACE_H
@@ -0,0 +1,687 @@
+#include "./audit_test.h"
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+#include <numeric>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// ==================== 构造函数和析构函数 ====================
+
+AuditPerformanceTest::AuditPerformanceTest()
+    : server_port_(9000),
+      max_files_(0),
+      rounds_(1),
+      tamper_check_(true),
+      keep_proofs_(false),
+      verbose_(false),
+      server_(nullptr) {
+
+    // 设置性能监控回调
+    callback_s.on_phase_complete = [this](const std::string& name, double time_ms) {
+        current_times_[name] = time_ms;
+        latency_.record_ms(name, time_ms);
+        if (verbose_) {
+            std::cout << "  [TIME] " << name << ": " << time_ms << " ms" << std::endl;
+        }
+    };
+    callback_s.on_op_counters = [this](const std::string& name, const perf_metrics::OpCounters& counters) {
+        op_summary_.record(name, counters);
+    };
+}
+
+AuditPerformanceTest::~AuditPerformanceTest() {
+    if (server_) delete server_;
+}
+
+// ==================== 配置加载 ====================
+
+bool AuditPerformanceTest::loadConfig(const std::string& config_file) {
+    std::cout << "\n[配置] 加载测试配置: " << config_file << std::endl;
+
+    std::ifstream ifs(config_file);
+    if (!ifs.is_open()) {
+        std::cerr << "[错误] 无法打开配置文件: " << config_file << std::endl;
+        return false;
+    }
+
+    Json::Value config;
+    Json::CharReaderBuilder reader;
+    std::string errs;
+
+    if (!Json::parseFromStream(reader, ifs, &config, &errs)) {
+        std::cerr << "[错误] JSON解析失败: " << errs << std::endl;
+        return false;
+    }
+
+    // 提取路径配置
+    const Json::Value& paths = config["paths"];
+    public_params_file_ = paths.get("public_params", "").asString();
+
+    const Json::Value& server_cfg = paths["server"];
+    server_data_dir_ = server_cfg.get("data_dir", "Storage-node/data").asString();
+    server_port_ = server_cfg.get("port", 9000).asInt();
+
+    // 提取选项
+    const Json::Value& options = config["options"];
+    max_files_ = options.get("max_files", 0).asInt();
+    rounds_ = options.get("rounds", 1).asInt();
+    tamper_check_ = options.get("tamper_check", true).asBool();
+    keep_proofs_ = options.get("keep_proofs", false).asBool();
+    verbose_ = options.get("verbose", false).asBool();
+
+    statistics_.test_name = config.get("test_name", "audit_performance").asString();
+
+    public_params_file_ = fs::path(public_params_file_).lexically_normal().string();
+    server_data_dir_ = fs::path(server_data_dir_).lexically_normal().string();
+
+    if (rounds_ < 1) {
+        std::cerr << "[错误] rounds 必须 >= 1" << std::endl;
+        return false;
+    }
+
+    std::cout << "[配置] 公共参数: " << public_params_file_ << std::endl;
+    std::cout << "[配置] 服务端数据目录: " << server_data_dir_ << std::endl;
+    std::cout << "[配置] 最大文件数: " << (max_files_ > 0 ? std::to_string(max_files_) : "全部") << std::endl;
+    std::cout << "[配置] 每文件轮数: " << rounds_ << std::endl;
+    std::cout << "[配置] 篡改检查: " << (tamper_check_ ? "开启" : "关闭") << std::endl;
+
+    if (!fs::exists(public_params_file_)) {
+        std::cerr << "[错误] 公共参数文件不存在: " << public_params_file_ << std::endl;
+        return false;
+    }
+    if (!fs::exists(server_data_dir_)) {
+        std::cerr << "[错误] 服务端数据目录不存在: " << server_data_dir_
+                  << "（请先运行插入测试生成数据）" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// ==================== 初始化 ====================
+
+bool AuditPerformanceTest::initialize() {
+    std::cout << "\n[初始化] 开始初始化测试环境..." << std::endl;
+
+    std::cout << "[初始化] 创建服务端..." << std::endl;
+    server_ = new StorageNode(server_data_dir_, server_port_);
+
+    if (!server_->load_public_params(public_params_file_)) {
+        std::cerr << "[错误] 服务端加载公共参数失败" << std::endl;
+        return false;
+    }
+
+    if (!server_->initialize_directories()) {
+        std::cerr << "[错误] 服务端目录初始化失败" << std::endl;
+        return false;
+    }
+
+    if (!server_->load_index_database()) {
+        std::cerr << "[错误] 索引数据库加载失败" << std::endl;
+        return false;
+    }
+    server_->load_search_database();
+
+    // 加载数据库之后再挂回调，避免加载耗时混入审计统计
+    server_->setPerformanceCallback_s(&callback_s);
+
+    if (!collectTargets()) {
+        return false;
+    }
+
+    std::cout << "[初始化] ✅ 初始化完成" << std::endl;
+
+    return true;
+}
+
+bool AuditPerformanceTest::collectTargets() {
+    std::cout << "\n[数据] 收集待审计文件..." << std::endl;
+
+    size_t skipped = 0;
+    {
+        auto db_lock = server_->read_lock();
+        for (const auto& pair : server_->index_database) {
+            const IndexEntry& entry = pair.second;
+            // 已删除或没有认证标签的文件无法生成证明
+            if (entry.state != "valid" || entry.TS_F.empty()) {
+                skipped++;
+                continue;
+            }
+
+            AuditTarget target;
+            target.file_id = entry.ID_F;
+            target.file_path = entry.file_path;
+            target.block_count = entry.TS_F.size();
+            std::error_code ec;
+            target.file_size = fs::file_size(entry.file_path, ec);
+            if (ec) {
+                target.file_size = 0;
+            }
+            targets_.push_back(target);
+        }
+    }
+
+    // 按块数排序，便于观察耗时随文件规模的变化
+    std::stable_sort(targets_.begin(), targets_.end(), [](const AuditTarget& a, const AuditTarget& b) {
+        return a.block_count < b.block_count;
+    });
+
+    if (max_files_ > 0 && targets_.size() > static_cast<size_t>(max_files_)) {
+        targets_.resize(max_files_);
+    }
+
+    std::cout << "[数据] 有效文件 " << targets_.size() << " 个";
+    if (skipped > 0) {
+        std::cout << "，跳过 " << skipped << " 个（已删除或无认证标签）";
+    }
+    std::cout << std::endl;
+
+    if (targets_.empty()) {
+        std::cerr << "[错误] 索引数据库中没有可审计的文件（请先运行插入测试）" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// ==================== 测试执行 ====================
+
+bool AuditPerformanceTest::runTest() {
+    std::cout << "\n" << std::string(80, '=') << std::endl;
+    std::cout << "开始文件审计性能测试" << std::endl;
+    std::cout << std::string(80, '=') << std::endl;
+
+    statistics_.start_time = getCurrentTimestamp();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    int total = targets_.size();
+    std::cout << "\n[测试] 将审计 " << total << " 个文件，每个 " << rounds_ << " 轮" << std::endl;
+
+    int count = 0;
+    for (const auto& target : targets_) {
+        count++;
+
+        if (verbose_) {
+            std::cout << "\n" << std::string(80, '-') << std::endl;
+            std::cout << "[" << count << "/" << total << "] 审计文件: " << target.file_id
+                      << " (" << target.block_count << " 块)" << std::endl;
+        }
+
+        AuditResult result = auditSingleFile(target);
+        results_.push_back(result);
+
+        printProgress(count, total);
+
+        if (!result.success) {
+            std::cerr << "\n⚠️  审计失败: " << target.file_id << ": " << result.error_msg << std::endl;
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    statistics_.end_time = getCurrentTimestamp();
+    statistics_.total_duration_sec = std::chrono::duration<double>(end - start).count();
+    statistics_.total_files = results_.size();
+
+    calculateStatistics();
+    printSummary();
+
+    return statistics_.failure_count == 0;
+}
+
+AuditPerformanceTest::AuditResult AuditPerformanceTest::auditSingleFile(const AuditTarget& target) {
+    AuditResult result;
+    result.file_id = target.file_id;
+    result.file_path = target.file_path;
+    result.file_size = target.file_size;
+    result.block_count = target.block_count;
+    result.rounds = 0;
+    result.prove_ms = 0;
+    result.verify_ms = 0;
+    result.prove_wall_ms = 0;
+    result.verify_wall_ms = 0;
+    result.proof_bytes = 0;
+    result.prove_throughput_mbps = 0;
+    result.verified = true;
+    result.tamper_rejected = true;
+    result.timestamp = getCurrentTimestamp();
+    result.success = false;
+
+    std::string proof_path = server_->FileProofs_dir + "/" + target.file_id + ".json";
+
+    for (int round = 0; round < rounds_; ++round) {
+        current_times_.clear();
+
+        // 步骤1：证明方生成文件证明（每轮使用新的随机挑战种子）
+        uint64_t prove_start = perf_metrics::now_ns();
+        if (!server_->GetFileProof(target.file_id)) {
+            result.error_msg = "文件证明生成失败";
+            return result;
+        }
+        double prove_wall = perf_metrics::elapsed_ms(prove_start);
+
+        std::error_code ec;
+        size_t proof_bytes = fs::file_size(proof_path, ec);
+        if (ec) {
+            result.error_msg = "证明文件不存在: " + proof_path;
+            return result;
+        }
+
+        // 步骤2：验证方从证明文件验证
+        uint64_t verify_start = perf_metrics::now_ns();
+        bool ok = server_->VerifyFileProof(proof_path);
+        double verify_wall = perf_metrics::elapsed_ms(verify_start);
+        if (!ok) {
+            result.verified = false;
+        }
+
+        result.prove_ms += current_times_["server_file_proof_total"];
+        result.verify_ms += current_times_["server_verify_file_total"];
+        result.prove_wall_ms += prove_wall;
+        result.verify_wall_ms += verify_wall;
+        result.proof_bytes = std::max(result.proof_bytes, proof_bytes);
+        latency_.record_ms("audit_prove_wall", prove_wall);
+        latency_.record_ms("audit_verify_wall", verify_wall);
+
+        // 步骤3：篡改挑战种子后的证明必须被拒绝
+        if (tamper_check_) {
+            std::ifstream proof_in(proof_path);
+            Json::Value proof_json;
+            Json::CharReaderBuilder reader;
+            std::string errs;
+            FileProofResult tampered;
+            if (Json::parseFromStream(reader, proof_in, &proof_json, &errs)) {
+                tampered = FileProofResult::from_json(proof_json);
+            }
+            if (!tampered.success || tampered.seed.empty()) {
+                result.error_msg = "证明文件解析失败";
+                return result;
+            }
+            char& last = tampered.seed.back();
+            last = (last == '0') ? '1' : '0';
+            // 篡改验证不计入验证耗时统计
+            server_->setPerformanceCallback_s(nullptr);
+            bool accepted = server_->VerifyFileProof(tampered);
+            server_->setPerformanceCallback_s(&callback_s);
+            if (accepted) {
+                result.tamper_rejected = false;
+            }
+        }
+
+        result.rounds++;
+    }
+
+    if (!keep_proofs_) {
+        std::error_code ec;
+        fs::remove(proof_path, ec);
+    }
+
+    result.prove_ms /= result.rounds;
+    result.verify_ms /= result.rounds;
+    result.prove_wall_ms /= result.rounds;
+    result.verify_wall_ms /= result.rounds;
+    if (result.prove_ms > 0) {
+        result.prove_throughput_mbps = (result.file_size / 1048576.0) / (result.prove_ms / 1000.0);
+    }
+
+    if (!result.verified) {
+        result.error_msg = "证明验证未通过";
+    } else if (!result.tamper_rejected) {
+        result.error_msg = "篡改后的证明通过了验证";
+    } else {
+        result.success = true;
+    }
+
+    return result;
+}
+
+// ==================== 统计计算 ====================
+
+void AuditPerformanceTest::calculateStatistics() {
+    std::cout << "\n[统计] 计算统计数据..." << std::endl;
+
+    statistics_.verify_pass_count = 0;
+    statistics_.tamper_reject_count = 0;
+    std::vector<AuditResult> success_results;
+    for (const auto& r : results_) {
+        if (r.rounds > 0 && r.verified) {
+            statistics_.verify_pass_count++;
+        }
+        if (r.rounds > 0 && r.tamper_rejected) {
+            statistics_.tamper_reject_count++;
+        }
+        if (r.success) {
+            success_results.push_back(r);
+        }
+    }
+
+    statistics_.success_count = success_results.size();
+    statistics_.failure_count = results_.size() - statistics_.success_count;
+
+    if (success_results.empty()) {
+        std::cerr << "[警告] 没有成功的测试结果" << std::endl;
+        return;
+    }
+
+    // 时间统计
+    std::vector<double> prove_values, verify_values;
+    double prove_wall_sum = 0, verify_wall_sum = 0, tp_sum = 0;
+    size_t proof_sum = 0;
+    statistics_.proof_min = success_results.front().proof_bytes;
+    statistics_.proof_max = 0;
+    statistics_.file_size_total = 0;
+    statistics_.block_total = 0;
+    for (const auto& r : success_results) {
+        prove_values.push_back(r.prove_ms);
+        verify_values.push_back(r.verify_ms);
+        prove_wall_sum += r.prove_wall_ms;
+        verify_wall_sum += r.verify_wall_ms;
+        tp_sum += r.prove_throughput_mbps;
+        proof_sum += r.proof_bytes;
+        statistics_.proof_min = std::min(statistics_.proof_min, r.proof_bytes);
+        statistics_.proof_max = std::max(statistics_.proof_max, r.proof_bytes);
+        statistics_.file_size_total += r.file_size;
+        statistics_.block_total += r.block_count;
+    }
+
+    size_t n = success_results.size();
+    statistics_.prove_avg = std::accumulate(prove_values.begin(), prove_values.end(), 0.0) / n;
+    statistics_.prove_min = *std::min_element(prove_values.begin(), prove_values.end());
+    statistics_.prove_max = *std::max_element(prove_values.begin(), prove_values.end());
+    statistics_.prove_stddev = calculateStdDev(prove_values, statistics_.prove_avg);
+
+    statistics_.verify_avg = std::accumulate(verify_values.begin(), verify_values.end(), 0.0) / n;
+    statistics_.verify_min = *std::min_element(verify_values.begin(), verify_values.end());
+    statistics_.verify_max = *std::max_element(verify_values.begin(), verify_values.end());
+    statistics_.verify_stddev = calculateStdDev(verify_values, statistics_.verify_avg);
+
+    statistics_.prove_wall_avg = prove_wall_sum / n;
+    statistics_.verify_wall_avg = verify_wall_sum / n;
+    statistics_.proof_avg = proof_sum / n;
+    statistics_.prove_throughput_avg = tp_sum / n;
+
+    // 按块数分组统计
+    std::map<std::string, std::vector<AuditResult>> groups;
+    for (const auto& r : success_results) {
+        groups[getBlockGroup(r.block_count)].push_back(r);
+    }
+
+    for (const auto& group_pair : groups) {
+        const std::string& group_name = group_pair.first;
+        const std::vector<AuditResult>& group_results = group_pair.second;
+
+        double prove_sum = 0, verify_sum = 0, blocks_sum = 0, proof_bytes_sum = 0;
+        for (const auto& r : group_results) {
+            prove_sum += r.prove_ms;
+            verify_sum += r.verify_ms;
+            blocks_sum += r.block_count;
+            proof_bytes_sum += r.proof_bytes;
+        }
+
+        std::map<std::string, double>& g = statistics_.block_groups[group_name];
+        g["count"] = group_results.size();
+        g["blocks_avg"] = blocks_sum / group_results.size();
+        g["prove_avg"] = prove_sum / group_results.size();
+        g["verify_avg"] = verify_sum / group_results.size();
+        g["proof_bytes_avg"] = proof_bytes_sum / group_results.size();
+        // 每块证明耗时：观察证明内核是否随块数线性增长
+        g["prove_per_block_ms"] = blocks_sum > 0 ? prove_sum / blocks_sum : 0.0;
+    }
+
+    std::cout << "[统计] ✅ 统计计算完成" << std::endl;
+}
+
+double AuditPerformanceTest::calculateStdDev(const std::vector<double>& values, double mean) {
+    if (values.size() <= 1) return 0.0;
+
+    double sum_sq_diff = 0.0;
+    for (double v : values) {
+        double diff = v - mean;
+        sum_sq_diff += diff * diff;
+    }
+
+    return std::sqrt(sum_sq_diff / (values.size() - 1));
+}
+
+std::string AuditPerformanceTest::getBlockGroup(size_t blocks) {
+    // 名称带序号前缀，使 std::map 中的分组按块数递增排列
+    if (blocks <= 1) return "1_1";
+    else if (blocks <= 4) return "2_2-4";
+    else if (blocks <= 16) return "3_5-16";
+    else if (blocks <= 64) return "4_17-64";
+    else if (blocks <= 256) return "5_65-256";
+    else return "6_257+";
+}
+
+// ==================== 报告生成 ====================
+
+bool AuditPerformanceTest::saveDetailedReport(const std::string& csv_file) {
+    std::cout << "\n[报告] 保存详细报告: " << csv_file << std::endl;
+
+    fs::create_directories(fs::path(csv_file).parent_path());
+    std::ofstream ofs(csv_file);
+    if (!ofs.is_open()) {
+        std::cerr << "[错误] 无法创建CSV文件: " << csv_file << std::endl;
+        return false;
+    }
+
+    ofs << "file_id,file_size_kb,block_count,rounds,"
+        << "prove_ms,verify_ms,prove_wall_ms,verify_wall_ms,"
+        << "proof_bytes,prove_throughput_mbps,"
+        << "verified,tamper_rejected,timestamp,success,error_msg\n";
+
+    for (const auto& r : results_) {
+        ofs << r.file_id << ","
+            << r.file_size / 1024.0 << ","
+            << r.block_count << ","
+            << r.rounds << ","
+            << r.prove_ms << ","
+            << r.verify_ms << ","
+            << r.prove_wall_ms << ","
+            << r.verify_wall_ms << ","
+            << r.proof_bytes << ","
+            << r.prove_throughput_mbps << ","
+            << (r.verified ? "true" : "false") << ","
+            << (r.tamper_rejected ? "true" : "false") << ","
+            << r.timestamp << ","
+            << (r.success ? "true" : "false") << ","
+            << r.error_msg << "\n";
+    }
+
+    ofs.close();
+    std::cout << "[报告] ✅ 详细报告已保存" << std::endl;
+
+    return true;
+}
+
+bool AuditPerformanceTest::saveSummaryReport(const std::string& json_file) {
+    std::cout << "[报告] 保存总结报告: " << json_file << std::endl;
+
+    Json::Value root;
+
+    // 测试信息
+    root["test_info"]["test_name"] = statistics_.test_name;
+    root["test_info"]["element_format"] = element_codec::format_name(server_->element_format);
+    root["test_info"]["rounds"] = rounds_;
+    root["test_info"]["tamper_check"] = tamper_check_;
+    root["test_info"]["start_time"] = statistics_.start_time;
+    root["test_info"]["end_time"] = statistics_.end_time;
+    root["test_info"]["total_duration_sec"] = statistics_.total_duration_sec;
+    root["test_info"]["total_files"] = statistics_.total_files;
+    root["test_info"]["success_count"] = statistics_.success_count;
+    root["test_info"]["failure_count"] = statistics_.failure_count;
+
+    // 正确性
+    root["statistics"]["correctness"]["verify_pass"] = statistics_.verify_pass_count;
+    root["statistics"]["correctness"]["tamper_rejected"] = statistics_.tamper_reject_count;
+    root["statistics"]["correctness"]["verify_pass_rate"] = statistics_.total_files > 0
+        ? static_cast<double>(statistics_.verify_pass_count) / statistics_.total_files : 0.0;
+
+    // 时间统计
+    root["statistics"]["time_ms"]["prove_avg"] = statistics_.prove_avg;
+    root["statistics"]["time_ms"]["prove_min"] = statistics_.prove_min;
+    root["statistics"]["time_ms"]["prove_max"] = statistics_.prove_max;
+    root["statistics"]["time_ms"]["prove_stddev"] = statistics_.prove_stddev;
+    root["statistics"]["time_ms"]["verify_avg"] = statistics_.verify_avg;
+    root["statistics"]["time_ms"]["verify_min"] = statistics_.verify_min;
+    root["statistics"]["time_ms"]["verify_max"] = statistics_.verify_max;
+    root["statistics"]["time_ms"]["verify_stddev"] = statistics_.verify_stddev;
+    root["statistics"]["time_ms"]["prove_wall_avg"] = statistics_.prove_wall_avg;
+    root["statistics"]["time_ms"]["verify_wall_avg"] = statistics_.verify_wall_avg;
+
+    // 数据大小统计
+    root["statistics"]["size_bytes"]["proof_avg"] = (Json::Value::UInt64)statistics_.proof_avg;
+    root["statistics"]["size_bytes"]["proof_min"] = (Json::Value::UInt64)statistics_.proof_min;
+    root["statistics"]["size_bytes"]["proof_max"] = (Json::Value::UInt64)statistics_.proof_max;
+    root["statistics"]["size_bytes"]["file_total"] = (Json::Value::UInt64)statistics_.file_size_total;
+    root["statistics"]["size_bytes"]["block_total"] = (Json::Value::UInt64)statistics_.block_total;
+
+    // 吞吐量统计
+    root["statistics"]["throughput"]["prove_mbps_avg"] = statistics_.prove_throughput_avg;
+
+    // 延迟分位数与密码学操作计数
+    root["statistics"]["latency_percentiles"] = latency_.to_json();
+    root["statistics"]["op_counters"] = op_summary_.to_json();
+
+    // 分组统计
+    for (const auto& group : statistics_.block_groups) {
+        for (const auto& metric : group.second) {
+            root["block_groups"][group.first][metric.first] = metric.second;
+        }
+    }
+
+    fs::create_directories(fs::path(json_file).parent_path());
+    std::ofstream ofs(json_file);
+    if (!ofs.is_open()) {
+        std::cerr << "[错误] 无法创建JSON文件: " << json_file << std::endl;
+        return false;
+    }
+
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "  ";
+    ofs << Json::writeString(writer, root);
+    ofs.close();
+
+    std::cout << "[报告] ✅ 总结报告已保存" << std::endl;
+
+    return true;
+}
+
+bool AuditPerformanceTest::saveLatencyReport(const std::string& csv_file) {
+    std::cout << "[报告] 保存延迟分位数: " << csv_file << std::endl;
+
+    fs::create_directories(fs::path(csv_file).parent_path());
+    std::ofstream ofs(csv_file);
+    if (!ofs.is_open()) {
+        std::cerr << "[错误] 无法创建CSV文件: " << csv_file << std::endl;
+        return false;
+    }
+    latency_.write_csv(ofs);
+    ofs.close();
+
+    std::cout << "[报告] ✅ 延迟分位数已保存" << std::endl;
+
+    return true;
+}
+
+// ==================== 辅助函数 ====================
+
+void AuditPerformanceTest::printProgress(int current, int total) {
+    int bar_width = 50;
+    float progress = (float)current / total;
+    int pos = bar_width * progress;
+
+    std::cout << "[";
+    for (int i = 0; i < bar_width; ++i) {
+        if (i < pos) std::cout << "=";
+        else if (i == pos) std::cout << ">";
+        else std::cout << " ";
+    }
+    std::cout << "] " << int(progress * 100.0) << "% (" << current << "/" << total << ")\r";
+    std::cout.flush();
+
+    if (current == total) {
+        std::cout << std::endl;
+    }
+}
+
+void AuditPerformanceTest::printSummary() {
+    std::cout << "\n" << std::string(80, '=') << std::endl;
+    std::cout << "测试总结" << std::endl;
+    std::cout << std::string(80, '=') << std::endl;
+
+    std::cout << "\n📊 基本信息:" << std::endl;
+    std::cout << "  测试名称: " << statistics_.test_name << std::endl;
+    std::cout << "  元素格式: " << element_codec::format_name(server_->element_format) << std::endl;
+    std::cout << "  开始时间: " << statistics_.start_time << std::endl;
+    std::cout << "  结束时间: " << statistics_.end_time << std::endl;
+    std::cout << "  总耗时: " << statistics_.total_duration_sec << " 秒" << std::endl;
+    std::cout << "  总文件数: " << statistics_.total_files << " (每个 " << rounds_ << " 轮)" << std::endl;
+    std::cout << "  成功: " << statistics_.success_count << " / 失败: " << statistics_.failure_count << std::endl;
+
+    std::cout << "\n🔐 正确性:" << std::endl;
+    std::cout << "  验证通过: " << statistics_.verify_pass_count << " / " << statistics_.total_files << std::endl;
+    if (tamper_check_) {
+        std::cout << "  篡改拒绝: " << statistics_.tamper_reject_count << " / " << statistics_.total_files << std::endl;
+    }
+
+    if (statistics_.success_count == 0) {
+        std::cout << "\n" << std::string(80, '=') << std::endl;
+        return;
+    }
+
+    std::cout << "\n⏱️  时间统计 (毫秒):" << std::endl;
+    std::cout << "  证明生成 (server_file_proof_total):" << std::endl;
+    std::cout << "    平均: " << statistics_.prove_avg << " ms" << std::endl;
+    std::cout << "    最小: " << statistics_.prove_min << " ms" << std::endl;
+    std::cout << "    最大: " << statistics_.prove_max << " ms" << std::endl;
+    std::cout << "    标准差: " << statistics_.prove_stddev << " ms" << std::endl;
+    std::cout << "    端到端平均: " << statistics_.prove_wall_avg << " ms" << std::endl;
+
+    std::cout << "  证明验证 (server_verify_file_total):" << std::endl;
+    std::cout << "    平均: " << statistics_.verify_avg << " ms" << std::endl;
+    std::cout << "    最小: " << statistics_.verify_min << " ms" << std::endl;
+    std::cout << "    最大: " << statistics_.verify_max << " ms" << std::endl;
+    std::cout << "    标准差: " << statistics_.verify_stddev << " ms" << std::endl;
+    std::cout << "    端到端平均: " << statistics_.verify_wall_avg << " ms" << std::endl;
+
+    std::cout << "\n📊 延迟分位数 (毫秒):" << std::endl;
+    for (const auto& kv : latency_.snapshot()) {
+        const perf_metrics::Histogram& h = kv.second;
+        std::cout << "  " << kv.first << ": p50=" << h.percentile_ms(50)
+                  << ", p90=" << h.percentile_ms(90)
+                  << ", p99=" << h.percentile_ms(99)
+                  << ", max=" << static_cast<double>(h.max_ns()) / 1e6
+                  << " (n=" << h.count() << ")" << std::endl;
+    }
+
+    std::cout << "\n💾 数据大小统计:" << std::endl;
+    std::cout << "  证明大小: 平均 " << statistics_.proof_avg << " bytes, 最小 " << statistics_.proof_min
+              << " bytes, 最大 " << statistics_.proof_max << " bytes" << std::endl;
+    std::cout << "  审计数据: " << statistics_.file_size_total << " bytes, " << statistics_.block_total << " 块" << std::endl;
+
+    std::cout << "\n🚀 证明吞吐量: " << statistics_.prove_throughput_avg << " MB/s" << std::endl;
+
+    std::cout << "\n📦 按块数分组:" << std::endl;
+    for (const auto& group : statistics_.block_groups) {
+        std::cout << "  " << group.first.substr(2) << " 块: "
+                  << "数量=" << (int)group.second.at("count")
+                  << ", 证明平均=" << group.second.at("prove_avg") << "ms"
+                  << ", 验证平均=" << group.second.at("verify_avg") << "ms"
+                  << ", 每块证明=" << group.second.at("prove_per_block_ms") << "ms"
+                  << ", 证明大小=" << group.second.at("proof_bytes_avg") << "B" << std::endl;
+    }
+
+    std::cout << "\n" << std::string(80, '=') << std::endl;
+}
+
+std::string AuditPerformanceTest::getCurrentTimestamp() {
+    auto now = std::chrono::system_clock::now();
+    auto time_t = std::chrono::system_clock::to_time_t(now);
+
+    std::stringstream ss;
+    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
+    return ss.str();
+}
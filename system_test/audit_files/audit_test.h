@@ -0,0 +1,183 @@
+#ifndef AUDIT_PERFORMANCE_TEST_H
+#define AUDIT_PERFORMANCE_TEST_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <jsoncpp/json/json.h>
+#include "../../Storage-node/storage_node.h"
+#include "../../common/perf_metrics.h"
+
+/**
+ * @brief 文件审计（文件证明生成/验证）性能测试类
+ *
+ * 功能：
+ * 1. 打开已有的存储节点数据目录，遍历索引数据库中所有有效文件
+ * 2. 对每个文件执行 GetFileProof（证明方）与 VerifyFileProof（验证方），可重复多轮
+ * 3. 记录证明/验证耗时、证明文件大小与验证结果；可选篡改检查（改动挑战种子后验证必须失败）
+ * 4. 按文件块数分组统计，生成详细报告
+ */
+class AuditPerformanceTest {
+public:
+    /**
+     * @brief 单个文件的审计结果（多轮取平均）
+     */
+    struct AuditResult {
+        std::string file_id;           // 文件ID
+        std::string file_path;         // 服务端密文路径
+        size_t file_size;              // 密文大小（字节）
+        size_t block_count;            // 块数（认证标签数）
+        int rounds;                    // 完成的轮数
+
+        // 时间指标（毫秒）
+        double prove_ms;               // 证明计算时间（server_file_proof_total）
+        double verify_ms;              // 验证计算时间（server_verify_file_total）
+        double prove_wall_ms;          // GetFileProof 端到端时间（含加载索引与写出证明）
+        double verify_wall_ms;         // VerifyFileProof 端到端时间（含读取证明与加载索引）
+
+        // 数据大小指标（字节）
+        size_t proof_bytes;            // FileProofs/[ID_F].json 大小
+
+        // 衍生指标
+        double prove_throughput_mbps;  // 证明吞吐量(MB/s)，按密文大小计
+
+        bool verified;                 // 所有轮次验证均通过
+        bool tamper_rejected;          // 篡改后的证明被拒绝（未开启检查时为true）
+        std::string timestamp;         // 测试时间戳
+        bool success;                  // 是否成功
+        std::string error_msg;         // 错误信息
+    };
+
+    /**
+     * @brief 测试统计数据
+     */
+    struct TestStatistics {
+        // 测试信息
+        std::string test_name;
+        std::string start_time;
+        std::string end_time;
+        double total_duration_sec;
+        int total_files;
+        int success_count;
+        int failure_count;
+        int verify_pass_count;
+        int tamper_reject_count;
+
+        // 时间统计（毫秒）
+        double prove_avg, prove_min, prove_max, prove_stddev;
+        double verify_avg, verify_min, verify_max, verify_stddev;
+        double prove_wall_avg;
+        double verify_wall_avg;
+
+        // 数据大小统计（字节）
+        size_t proof_avg, proof_min, proof_max;
+        size_t file_size_total;
+        size_t block_total;
+
+        // 吞吐量统计（MB/s）
+        double prove_throughput_avg;
+
+        // 按块数分组统计
+        std::map<std::string, std::map<std::string, double>> block_groups;
+    };
+
+    AuditPerformanceTest();
+    ~AuditPerformanceTest();
+
+    /**
+     * @brief 加载测试配置文件
+     * @param config_file 配置文件路径
+     * @return 成功返回true
+     */
+    bool loadConfig(const std::string& config_file);
+
+    /**
+     * @brief 初始化测试环境（打开服务端数据目录并收集待审计文件）
+     * @return 成功返回true
+     */
+    bool initialize();
+
+    /**
+     * @brief 运行完整测试
+     * @return 全部文件的证明均通过验证（且篡改检查均被拒绝）返回true
+     */
+    bool runTest();
+
+    /**
+     * @brief 保存详细报告（CSV格式，每个文件一行）
+     */
+    bool saveDetailedReport(const std::string& csv_file);
+
+    /**
+     * @brief 保存总结报告（JSON格式）
+     */
+    bool saveSummaryReport(const std::string& json_file);
+
+    /**
+     * @brief 保存各阶段延迟分位数（CSV格式，每个指标一行）
+     */
+    bool saveLatencyReport(const std::string& csv_file);
+
+    void printProgress(int current, int total);
+    void printSummary();
+
+private:
+    /**
+     * @brief 待审计文件
+     */
+    struct AuditTarget {
+        std::string file_id;
+        std::string file_path;
+        size_t file_size;
+        size_t block_count;
+    };
+
+    // ==================== 配置参数 ====================
+    std::string public_params_file_;   // 公共参数文件
+    std::string server_data_dir_;      // 服务端数据目录（需已有插入的文件）
+    int server_port_;                  // 服务端端口
+    int max_files_;                    // 最大测试文件数（0=全部）
+    int rounds_;                       // 每个文件的证明/验证轮数
+    bool tamper_check_;                // 是否检查篡改证明被拒绝
+    bool keep_proofs_;                 // 是否保留 FileProofs 下生成的证明文件
+    bool verbose_;                     // 是否显示详细日志
+
+    // ==================== 核心组件 ====================
+    StorageNode* server_;
+    PerformanceCallback_s callback_s;
+
+    // ==================== 数据存储 ====================
+    std::vector<AuditTarget> targets_;
+    std::vector<AuditResult> results_;
+    TestStatistics statistics_;
+
+    // 当前性能数据（临时存储）
+    std::map<std::string, double> current_times_;
+
+    // 各阶段延迟直方图（跨文件、跨轮次累计）
+    perf_metrics::Registry latency_;
+
+    // 证明/验证的密码学操作计数
+    perf_metrics::OpCounterSummary op_summary_;
+
+    // ==================== 私有方法 ====================
+    bool collectTargets();
+    AuditResult auditSingleFile(const AuditTarget& target);
+    void calculateStatistics();
+    double calculateStdDev(const std::vector<double>& values, double mean);
+
+    /**
+     * @brief 获取块数分组名称
+     */
+    std::string getBlockGroup(size_t blocks);
+
+    std::string getCurrentTimestamp();
+};
+
+#endif // AUDIT_PERFORMANCE_TEST_H
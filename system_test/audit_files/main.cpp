@@ -0,0 +1,37 @@
+/*
+ * main.cpp - 文件审计性能测试主程序
+ *
+ * 使用 AuditPerformanceTest 类对已存储文件执行证明生成与验证
+ *
+ * 编译:
+ *   make
+ *
+ * 运行:
+ *   ./audit_perf_test [配置文件路径]
+ *   默认配置: system_test/audit_files/config/audit_test_config.json
+ */
+
+#include "audit_test.h"
+#include "../common/harness_main.h"
+
+int main(int argc, char* argv[]) {
+    harness_main::Spec spec;
+    spec.icon = "🔐";
+    spec.name = "文件审计性能测试";
+    spec.run_label = "运行审计测试";
+    spec.default_config = "system_test/audit_files/config/audit_test_config.json";
+    // 验证失败时仍保存报告，便于对照 audit_detailed.csv 排查
+    spec.save_on_failure = true;
+    spec.failure_note = "存在未通过验证的文件";
+
+    return harness_main::run_harness<AuditPerformanceTest>(argc, argv, spec, [](AuditPerformanceTest& test) {
+        return std::vector<harness_main::Report>{
+            {"详细报告", "system_test/audit_files/results/audit_detailed.csv",
+             [&test](const std::string& p) { return test.saveDetailedReport(p); }},
+            {"总结报告", "system_test/audit_files/results/audit_summary.json",
+             [&test](const std::string& p) { return test.saveSummaryReport(p); }},
+            {"延迟分位数", "system_test/audit_files/results/audit_latency.csv",
+             [&test](const std::string& p) { return test.saveLatencyReport(p); }}
+        };
+    });
+}
@@ -0,0 +1,743 @@
+#include "chain_test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+
+namespace fs = std::filesystem;
+
+using test_fixture::load_json;
+using test_fixture::QuietCout;
+
+namespace {
+
+double median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+}
+
+// 与客户端 encryptPointer 相同的构造（AES-256-CBC，零IV，密钥取状态哈希前32字节）
+std::string encrypt_pointer(const std::string& current_state_hash, const std::string& previous_state) {
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) {
+        return "";
+    }
+    unsigned char key[32] = {0};
+    size_t key_hex_len = std::min<size_t>(current_state_hash.length(), 64) & ~static_cast<size_t>(1);
+    if (!hex_codec::decode(current_state_hash.data(), key_hex_len, key)) {
+        EVP_CIPHER_CTX_free(ctx);
+        return "";
+    }
+    unsigned char iv[16] = {0};
+    std::vector<unsigned char> ciphertext(previous_state.size() + EVP_CIPHER_block_size(EVP_aes_256_cbc()));
+    int len = 0;
+    int total_len = 0;
+    if (EVP_EncryptInit_ex(ctx, EVP_aes_256_cbc(), nullptr, key, iv) != 1 ||
+        EVP_EncryptUpdate(ctx, ciphertext.data(), &len,
+                          reinterpret_cast<const unsigned char*>(previous_state.data()),
+                          static_cast<int>(previous_state.size())) != 1) {
+        EVP_CIPHER_CTX_free(ctx);
+        return "";
+    }
+    total_len = len;
+    if (EVP_EncryptFinal_ex(ctx, ciphertext.data() + len, &len) != 1) {
+        EVP_CIPHER_CTX_free(ctx);
+        return "";
+    }
+    total_len += len;
+    EVP_CIPHER_CTX_free(ctx);
+    return hex_codec::encode(ciphertext.data(), static_cast<size_t>(total_len));
+}
+
+} // namespace
+
+ChainLengthBenchmark::ChainLengthBenchmark()
+    : max_chain_blocks_(1000000),
+      distinct_files_(16),
+      rounds_(3),
+      single_round_from_(10000),
+      zipf_enabled_(true),
+      zipf_keywords_(200),
+      zipf_total_hops_(20000),
+      zipf_exponent_(1.0),
+      zipf_file_size_(4096),
+      quiet_node_output_(true),
+      reset_work_dir_(true),
+      verbose_(false),
+      node_(nullptr),
+      sk_ready_(false),
+      pool_file_size_(0),
+      chain_serial_(0) {}
+
+ChainLengthBenchmark::~ChainLengthBenchmark() {
+    if (sk_ready_) {
+        element_clear(sk_);
+    }
+    delete node_;
+}
+
+// ==================== 配置与初始化 ====================
+
+bool ChainLengthBenchmark::loadConfig(const std::string& config_file) {
+    Json::Value config;
+    if (!load_json(config_file, config)) {
+        std::cerr << "[错误] 无法读取配置文件: " << config_file << std::endl;
+        return false;
+    }
+
+    test_name_ = config.get("test_name", "search chain length").asString();
+
+    const Json::Value& paths = config["paths"];
+    public_params_file_ = paths.get("public_params", "vds-client/data/public_params.json").asString();
+    work_dir_ = paths.get("work_dir", "system_test/chain_files/data/work").asString();
+
+    auto read_sizes = [](const Json::Value& array, std::vector<size_t> fallback) {
+        std::vector<size_t> values;
+        if (array.isArray()) {
+            for (const auto& v : array) {
+                if (v.asUInt64() > 0) {
+                    values.push_back(static_cast<size_t>(v.asUInt64()));
+                }
+            }
+        }
+        if (values.empty()) {
+            values = fallback;
+        }
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        return values;
+    };
+
+    const Json::Value& options = config["options"];
+    chain_lengths_ = read_sizes(options["chain_lengths"], {1, 10, 100, 1000, 10000, 100000});
+    file_sizes_ = read_sizes(options["file_sizes"], {4096, 32768});
+    max_chain_blocks_ = options.get("max_chain_blocks", 1000000).asUInt64();
+    distinct_files_ = std::max(1, options.get("distinct_files", 16).asInt());
+    rounds_ = std::max(1, options.get("rounds", 3).asInt());
+    single_round_from_ = options.get("single_round_from", 10000).asUInt64();
+    quiet_node_output_ = options.get("quiet_node_output", true).asBool();
+    reset_work_dir_ = options.get("reset_work_dir", true).asBool();
+    verbose_ = options.get("verbose", false).asBool();
+
+    const Json::Value& zipf = options["zipf"];
+    zipf_enabled_ = zipf.get("enabled", true).asBool();
+    zipf_keywords_ = std::max(1, zipf.get("keywords", 200).asInt());
+    zipf_total_hops_ = std::max<Json::UInt64>(1, zipf.get("total_hops", 20000).asUInt64());
+    zipf_exponent_ = zipf.get("exponent", 1.0).asDouble();
+    zipf_file_size_ = std::max<Json::UInt64>(1, zipf.get("file_size", 4096).asUInt64());
+
+    std::cout << "[配置] 工作目录: " << work_dir_ << std::endl;
+    std::cout << "[配置] 链长度:";
+    for (size_t l : chain_lengths_) {
+        std::cout << " " << l;
+    }
+    std::cout << ", 文件大小:";
+    for (size_t s : file_sizes_) {
+        std::cout << " " << s;
+    }
+    std::cout << ", 池文件: " << distinct_files_ << std::endl;
+    if (zipf_enabled_) {
+        std::cout << "[配置] Zipf: " << zipf_keywords_ << " 个关键词, 共 " << zipf_total_hops_
+                  << " 跳, s = " << zipf_exponent_ << std::endl;
+    }
+    return true;
+}
+
+bool ChainLengthBenchmark::initialize() {
+    if (reset_work_dir_ && fs::exists(work_dir_)) {
+        std::cout << "[初始化] 清空工作目录: " << work_dir_ << std::endl;
+        fs::remove_all(work_dir_);
+    }
+    std::string node_dir = work_dir_ + "/node";
+    fs::create_directories(node_dir);
+    fs::create_directories(work_dir_ + "/params");
+
+    node_ = new StorageNode(node_dir, 0);
+    if (!node_->load_public_params(public_params_file_) || !node_->initialize_directories()) {
+        std::cerr << "[错误] 存储节点初始化失败" << std::endl;
+        return false;
+    }
+    if (!node_->load_index_database() || !node_->load_search_database()) {
+        std::cerr << "[错误] 存储节点数据库加载失败" << std::endl;
+        return false;
+    }
+
+    // 阶段耗时用于把路径接口的总耗时拆分为数据库重新加载与链遍历
+    callbacks_.on_phase_complete = [this](const std::string& name, double time_ms) {
+        phase_ms_[name] += time_ms;
+    };
+    node_->setPerformanceCallback_s(&callbacks_);
+
+    // 数据拥有者密钥：sk 随机，PK = g^sk
+    element_init_Zr(sk_, node_->pairing);
+    element_random(sk_);
+    sk_ready_ = true;
+    element_t pk;
+    element_init_G1(pk, node_->pairing);
+    element_pow_zn(pk, node_->g, sk_);
+    PK_ = node_->serializeElement(pk);
+    element_clear(pk);
+
+    std::cout << "[初始化] 完成: 数据拥有者公钥 " << PK_.substr(0, 16) << "..." << std::endl;
+    return true;
+}
+
+// ==================== 池文件与链生成 ====================
+
+bool ChainLengthBenchmark::preparePool(size_t file_size) {
+    if (!pool_.empty() && pool_file_size_ == file_size) {
+        return true;
+    }
+    for (const auto& file : pool_) {
+        fs::remove(node_->files_dir + "/" + file.ID_F + ".enc");
+    }
+    pool_.clear();
+    pool_file_size_ = file_size;
+
+    std::mt19937_64 rng(std::random_device{}());
+    const size_t block_size = StorageNode::BLOCK_SIZE;
+    const size_t sector_size = StorageNode::SECTOR_SIZE;
+    size_t blocks = (file_size + block_size - 1) / block_size;
+
+    element_t aux, pow;
+    element_init_G1(aux, node_->pairing);
+    element_init_G1(pow, node_->pairing);
+    mpz_t c_ij, sum;
+    mpz_init(c_ij);
+    mpz_init(sum);
+    std::vector<unsigned char> buf;
+    std::vector<unsigned char> block(block_size);
+
+    for (int f = 0; f < distinct_files_; ++f) {
+        std::string ciphertext = test_fixture::random_bytes(file_size, rng);
+        unsigned char digest[SHA256_DIGEST_LENGTH];
+        SHA256(reinterpret_cast<const unsigned char*>(ciphertext.data()), ciphertext.size(), digest);
+
+        PoolFile file;
+        file.ID_F = node_->file_id_from_digest(digest);
+        std::ofstream out(node_->files_dir + "/" + file.ID_F + ".enc", std::ios::binary);
+        out.write(ciphertext.data(), static_cast<std::streamsize>(ciphertext.size()));
+        if (!out.good()) {
+            std::cerr << "[错误] 池文件写入失败: " << file.ID_F << std::endl;
+            return false;
+        }
+
+        // σ_i = [H2(ID_F||i) · μ^{Σ_j c_ij}]^sk（μ 的阶为 r，先对指数求和取模只做一次幂运算）
+        for (size_t i = 0; i < blocks; ++i) {
+            std::fill(block.begin(), block.end(), 0);
+            size_t offset = i * block_size;
+            std::copy(ciphertext.begin() + offset,
+                      ciphertext.begin() + std::min(file_size, offset + block_size), block.begin());
+            mpz_set_ui(sum, 0);
+            for (size_t j = 0; j < StorageNode::SECTORS_PER_BLOCK; ++j) {
+                mpz_import(c_ij, sector_size, 1, 1, 0, 0, block.data() + j * sector_size);
+                mpz_add(sum, sum, c_ij);
+            }
+            mpz_mod(sum, sum, node_->r);
+
+            node_->computeHashH2(file.ID_F + std::to_string(i), aux);
+            element_pow_mpz(pow, node_->mu, sum);
+            element_mul(aux, aux, pow);
+            element_pow_zn(aux, aux, sk_);
+            file.tags.push_back(node_->serializeElement(aux, buf));
+        }
+        pool_.push_back(std::move(file));
+    }
+
+    mpz_clear(c_ij);
+    mpz_clear(sum);
+    element_clear(aux);
+    element_clear(pow);
+    std::cout << "   [池] " << pool_.size() << " 个文件 x " << file_size << " 字节 (" << blocks << " 块)" << std::endl;
+    return true;
+}
+
+void ChainLengthBenchmark::resetDatabase() {
+    std::lock_guard<std::mutex> writer(node_->writer_mutex);
+    auto lock = node_->write_lock();
+    node_->index_database.clear();
+    node_->search_database.clear();
+    for (const auto& file : pool_) {
+        IndexEntry entry;
+        entry.ID_F = file.ID_F;
+        entry.PK = PK_;
+        entry.TS_F = file.tags;
+        entry.state = "valid";
+        entry.file_path = node_->files_dir + "/" + file.ID_F + ".enc";
+        node_->index_database[file.ID_F] = std::move(entry);
+    }
+}
+
+bool ChainLengthBenchmark::buildChain(ChainSpec& spec) {
+    uint64_t t0 = perf_metrics::now_ns();
+    std::string T = randomHex(16);
+    std::string prev_state;
+
+    element_t h_cur, h_prev, h_file, kt;
+    element_init_G1(h_cur, node_->pairing);
+    element_init_G1(h_prev, node_->pairing);
+    element_init_G1(h_file, node_->pairing);
+    element_init_G1(kt, node_->pairing);
+    std::vector<unsigned char> buf;
+    bool ok = true;
+
+    {
+        std::lock_guard<std::mutex> writer(node_->writer_mutex);
+        auto lock = node_->write_lock();
+        for (size_t d = 0; d < spec.length && ok; ++d) {
+            const PoolFile& file = pool_[d % pool_.size()];
+            std::string state = randomHex(32);
+
+            // Ti_bar = H2(T||st_d)；首跳指针加密自身状态，搜索在此处到达链尾
+            node_->computeHashH2(T + state, h_cur);
+            IndexKeywords kw;
+            kw.Ti_bar = node_->serializeElement(h_cur, buf);
+            kw.ptr_i = encrypt_pointer(node_->computeHashH3(state), d == 0 ? state : prev_state);
+
+            // kt = [H2(ID_F) · H2(T||st_d) / H2(T||st_{d-1})]^sk
+            node_->computeHashH2(file.ID_F, h_file);
+            element_mul(kt, h_file, h_cur);
+            if (d > 0) {
+                element_div(kt, kt, h_prev);
+            }
+            element_pow_zn(kt, kt, sk_);
+            kw.kt_wi = node_->serializeElement(kt, buf);
+            ok = !kw.ptr_i.empty();
+
+            IndexSearchEntry search_entry;
+            search_entry.Ti_bar = kw.Ti_bar;
+            search_entry.ID_F = file.ID_F;
+            search_entry.ptr_i = kw.ptr_i;
+            search_entry.state = "valid";
+            search_entry.kt_wi = kw.kt_wi;
+            node_->search_database[kw.Ti_bar] = std::move(search_entry);
+            node_->index_database[file.ID_F].keywords.push_back(std::move(kw));
+
+            element_set(h_prev, h_cur);
+            prev_state = state;
+        }
+    }
+
+    element_clear(h_cur);
+    element_clear(h_prev);
+    element_clear(h_file);
+    element_clear(kt);
+
+    spec.params = Json::Value(Json::objectValue);
+    spec.params["PK"] = PK_;
+    spec.params["T"] = T;
+    spec.params["std"] = prev_state;
+    spec.blocks = pool_.empty() ? 0 : pool_.front().tags.size();
+    spec.build_ms = perf_metrics::elapsed_ms(t0);
+    chain_serial_++;
+    if (!ok) {
+        std::cerr << "[错误] 状态指针加密失败: " << spec.name << std::endl;
+    }
+    return ok;
+}
+
+bool ChainLengthBenchmark::persistDatabase() {
+    QuietCout quiet(quiet_node_output_);
+    return node_->save_index_database() && node_->save_search_database();
+}
+
+// ==================== 测试执行 ====================
+
+int ChainLengthBenchmark::roundsFor(size_t length) const {
+    return (single_round_from_ > 0 && length >= single_round_from_) ? 1 : rounds_;
+}
+
+bool ChainLengthBenchmark::runSearch(const ChainSpec& spec, int round, SearchRun& run) {
+    run = SearchRun{spec.workload, spec.name, spec.length, spec.file_size, spec.blocks, round,
+                    0, 0, 0, 0, 0, 0, 0, 0, true, false};
+
+    Json::Value params = spec.params;
+    std::string params_path = work_dir_ + "/params/" + spec.name + ".json";
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "  ";
+
+    // 每段一次路径接口调用；未走到链尾时把 continuation 加入参数继续
+    while (true) {
+        {
+            std::ofstream out(params_path);
+            out << Json::writeString(writer, params);
+        }
+
+        phase_ms_.clear();
+        uint64_t t0 = perf_metrics::now_ns();
+        bool searched;
+        {
+            QuietCout quiet(quiet_node_output_);
+            searched = node_->SearchKeywordsAssociatedFilesProof(params_path);
+        }
+        run.search_ms += perf_metrics::elapsed_ms(t0);
+        run.search_reload_ms += phase_ms_["db_load_index"] + phase_ms_["db_load_search"];
+        run.chain_walk_ms += phase_ms_["chain_walk"];
+        if (!searched) {
+            return false;
+        }
+
+        SearchProofResult key;
+        key.T = spec.params["T"].asString();
+        key.segment = run.segments;
+        std::string proof_path = node_->search_proof_output_path(key);
+        Json::Value proof_json;
+        if (!load_json(proof_path, proof_json)) {
+            std::cerr << "[错误] 无法读取搜索证明: " << proof_path << std::endl;
+            return false;
+        }
+        SearchProofResult proof = SearchProofResult::from_json(proof_json);
+        run.segments++;
+        run.hops += static_cast<size_t>(proof.hops);
+        run.files += proof.AS.size();
+
+        phase_ms_.clear();
+        t0 = perf_metrics::now_ns();
+        bool verified;
+        {
+            QuietCout quiet(quiet_node_output_);
+            verified = node_->VerifySearchProof(proof_path);
+        }
+        run.verify_ms += perf_metrics::elapsed_ms(t0);
+        run.verify_reload_ms += phase_ms_["db_load_index"];
+        run.verified = run.verified && verified;
+
+        if (proof.complete) {
+            break;
+        }
+        params["continuation"] = proof.continuation;
+    }
+
+    run.success = run.hops == spec.length;
+    return run.success;
+}
+
+void ChainLengthBenchmark::measureChain(const ChainSpec& spec, int rounds) {
+    for (int r = 0; r < rounds; ++r) {
+        SearchRun run;
+        if (!runSearch(spec, r, run) && verbose_) {
+            std::cerr << "   ⚠️  搜索未完成: " << spec.name << " (" << run.hops << "/" << spec.length << " 跳)" << std::endl;
+        }
+        runs_.push_back(run);
+        if (verbose_ || spec.workload == "fixed") {
+            std::cout << std::fixed << std::setprecision(2)
+                      << "   " << (run.success && run.verified ? "✅ " : "❌ ") << spec.name << " #" << r
+                      << ": " << run.segments << " 段, 搜索 " << run.search_ms << " ms (重新加载 "
+                      << run.search_reload_ms << ", 链遍历 " << run.chain_walk_ms << "), 验证 "
+                      << run.verify_ms << " ms" << std::endl;
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+}
+
+bool ChainLengthBenchmark::runTest() {
+    start_time_ = test_fixture::current_timestamp();
+
+    // 负载1：固定链长度 x 文件大小，每条链单独放入数据库
+    for (size_t file_size : file_sizes_) {
+        std::cout << "\n[fixed] 文件大小 " << file_size << " 字节" << std::endl;
+        if (!preparePool(file_size)) {
+            return false;
+        }
+        for (size_t length : chain_lengths_) {
+            size_t blocks = pool_.front().tags.size();
+            std::string name = "fixed_" + std::to_string(length) + "_" + std::to_string(file_size);
+            if (max_chain_blocks_ > 0 && length * blocks > max_chain_blocks_) {
+                std::cout << "   ⏭️  跳过 " << name << " (" << length * blocks << " 块超过 max_chain_blocks)" << std::endl;
+                skipped_.push_back(name);
+                continue;
+            }
+
+            resetDatabase();
+            ChainSpec spec;
+            spec.workload = "fixed";
+            spec.name = name;
+            spec.length = length;
+            spec.file_size = file_size;
+            if (!buildChain(spec) || !persistDatabase()) {
+                return false;
+            }
+            std::cout << "   [生成] " << name << ": " << length << " 跳, " << std::fixed << std::setprecision(1)
+                      << spec.build_ms << " ms" << std::endl;
+            std::cout.unsetf(std::ios::fixed);
+            measureChain(spec, roundsFor(length));
+            fixed_chains_.push_back(spec);
+        }
+    }
+
+    // 负载2：Zipf 关键词热度，所有关键词共享一个数据库
+    if (zipf_enabled_) {
+        std::cout << "\n[zipf] " << zipf_keywords_ << " 个关键词, s = " << zipf_exponent_ << std::endl;
+        if (!preparePool(zipf_file_size_)) {
+            return false;
+        }
+        resetDatabase();
+
+        std::vector<double> weights(zipf_keywords_);
+        for (int k = 0; k < zipf_keywords_; ++k) {
+            weights[k] = 1.0 / std::pow(static_cast<double>(k + 1), zipf_exponent_);
+        }
+        double total_weight = std::accumulate(weights.begin(), weights.end(), 0.0);
+
+        uint64_t t0 = perf_metrics::now_ns();
+        for (int k = 0; k < zipf_keywords_; ++k) {
+            ChainSpec spec;
+            spec.workload = "zipf";
+            spec.name = "zipf_rank_" + std::to_string(k + 1);
+            spec.popularity = weights[k] / total_weight;
+            spec.length = std::max<size_t>(1, static_cast<size_t>(
+                std::llround(static_cast<double>(zipf_total_hops_) * spec.popularity)));
+            spec.file_size = zipf_file_size_;
+            if (!buildChain(spec)) {
+                return false;
+            }
+            zipf_chains_.push_back(spec);
+        }
+        if (!persistDatabase()) {
+            return false;
+        }
+        std::cout << "   [生成] 最长链 " << zipf_chains_.front().length << " 跳, 用时 " << std::fixed
+                  << std::setprecision(1) << perf_metrics::elapsed_ms(t0) << " ms" << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+
+        for (size_t k = 0; k < zipf_chains_.size(); ++k) {
+            measureChain(zipf_chains_[k], roundsFor(zipf_chains_[k].length));
+            if ((k + 1) % 20 == 0 || k + 1 == zipf_chains_.size()) {
+                std::cout << "   进度: " << (k + 1) << "/" << zipf_chains_.size() << std::endl;
+            }
+        }
+    }
+
+    end_time_ = test_fixture::current_timestamp();
+    printSummary();
+
+    for (const auto& run : runs_) {
+        if (!run.success || !run.verified) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==================== 统计与报告 ====================
+
+namespace {
+
+struct ChainStats {
+    int rounds = 0;
+    int segments = 0;
+    double search_ms = 0;
+    double search_reload_ms = 0;
+    double chain_walk_ms = 0;
+    double verify_ms = 0;
+    double verify_reload_ms = 0;
+    double per_hop_walk_us = 0;     // 链遍历部分的单跳耗时
+    double hops_per_second = 0;     // 按搜索总耗时计算的吞吐
+    bool passed = true;
+};
+
+ChainStats summarize(const std::vector<ChainLengthBenchmark::SearchRun>& runs, const std::string& name) {
+    ChainStats s;
+    std::vector<double> search, search_reload, walk, verify, verify_reload;
+    size_t hops = 0;
+    for (const auto& r : runs) {
+        if (r.name != name) continue;
+        s.rounds++;
+        s.segments = r.segments;
+        hops = r.hops;
+        search.push_back(r.search_ms);
+        search_reload.push_back(r.search_reload_ms);
+        walk.push_back(r.chain_walk_ms);
+        verify.push_back(r.verify_ms);
+        verify_reload.push_back(r.verify_reload_ms);
+        s.passed = s.passed && r.success && r.verified;
+    }
+    s.search_ms = median(search);
+    s.search_reload_ms = median(search_reload);
+    s.chain_walk_ms = median(walk);
+    s.verify_ms = median(verify);
+    s.verify_reload_ms = median(verify_reload);
+    if (hops > 0) {
+        s.per_hop_walk_us = s.chain_walk_ms * 1000.0 / static_cast<double>(hops);
+    }
+    if (s.search_ms > 0) {
+        s.hops_per_second = static_cast<double>(hops) / (s.search_ms / 1000.0);
+    }
+    return s;
+}
+
+Json::Value stats_json(const ChainLengthBenchmark::ChainSpec& spec, const ChainStats& s) {
+    Json::Value item;
+    item["name"] = spec.name;
+    item["length"] = static_cast<Json::UInt64>(spec.length);
+    item["file_size"] = static_cast<Json::UInt64>(spec.file_size);
+    item["blocks"] = static_cast<Json::UInt64>(spec.blocks);
+    item["build_ms"] = spec.build_ms;
+    item["rounds"] = s.rounds;
+    item["segments"] = s.segments;
+    item["search_ms"] = s.search_ms;
+    item["search_reload_ms"] = s.search_reload_ms;
+    item["chain_walk_ms"] = s.chain_walk_ms;
+    item["verify_ms"] = s.verify_ms;
+    item["verify_reload_ms"] = s.verify_reload_ms;
+    item["per_hop_walk_us"] = s.per_hop_walk_us;
+    item["hops_per_second"] = s.hops_per_second;
+    item["passed"] = s.passed;
+    return item;
+}
+
+} // namespace
+
+void ChainLengthBenchmark::printSummary() const {
+    std::cout << "\n" << std::string(110, '=') << std::endl;
+    std::cout << "搜索链长度基准总结（中位数，单位 ms）" << std::endl;
+    std::cout << std::string(110, '=') << std::endl;
+    std::cout << std::right << std::setw(9) << "跳数" << std::setw(9) << "文件B" << std::setw(6) << "段"
+              << std::setw(12) << "搜索" << std::setw(12) << "重新加载" << std::setw(12) << "链遍历"
+              << std::setw(11) << "us/跳" << std::setw(12) << "验证" << std::setw(12) << "跳/秒"
+              << std::setw(6) << "通过" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& spec : fixed_chains_) {
+        ChainStats s = summarize(runs_, spec.name);
+        std::cout << std::setw(9) << spec.length << std::setw(9) << spec.file_size << std::setw(6) << s.segments
+                  << std::setw(12) << s.search_ms << std::setw(12) << s.search_reload_ms
+                  << std::setw(12) << s.chain_walk_ms << std::setw(11) << s.per_hop_walk_us
+                  << std::setw(12) << s.verify_ms << std::setw(12) << s.hops_per_second
+                  << std::setw(6) << (s.passed ? "是" : "否") << std::endl;
+    }
+
+    if (!zipf_chains_.empty()) {
+        double expected_search = 0;
+        double expected_verify = 0;
+        double multi_segment = 0;
+        for (const auto& spec : zipf_chains_) {
+            ChainStats s = summarize(runs_, spec.name);
+            expected_search += spec.popularity * s.search_ms;
+            expected_verify += spec.popularity * s.verify_ms;
+            if (s.segments > 1) {
+                multi_segment += spec.popularity;
+            }
+        }
+        std::cout << "\n📊 Zipf 查询组合: 期望搜索 " << expected_search << " ms, 期望验证 " << expected_verify
+                  << " ms, 需要续传的查询占比 " << multi_segment * 100.0 << "%" << std::endl;
+    }
+    if (!skipped_.empty()) {
+        std::cout << "⏭️  跳过 " << skipped_.size() << " 个组合（超过 max_chain_blocks）" << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+}
+
+bool ChainLengthBenchmark::saveDetailedReport(const std::string& csv_file) {
+    fs::create_directories(fs::path(csv_file).parent_path());
+    std::ofstream out(csv_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    out << "workload,name,length,file_size,blocks,round,segments,hops,files,search_ms,search_reload_ms,"
+        << "chain_walk_ms,verify_ms,verify_reload_ms,verified,success\n";
+    out << std::fixed << std::setprecision(3);
+    for (const auto& r : runs_) {
+        out << r.workload << "," << r.name << "," << r.length << "," << r.file_size << "," << r.blocks << ","
+            << r.round << "," << r.segments << "," << r.hops << "," << r.files << "," << r.search_ms << ","
+            << r.search_reload_ms << "," << r.chain_walk_ms << "," << r.verify_ms << "," << r.verify_reload_ms
+            << "," << (r.verified ? "true" : "false") << "," << (r.success ? "true" : "false") << "\n";
+    }
+    return true;
+}
+
+bool ChainLengthBenchmark::saveSummaryReport(const std::string& json_file) {
+    fs::create_directories(fs::path(json_file).parent_path());
+    Json::Value root;
+    root["test_info"]["test_name"] = test_name_;
+    root["test_info"]["start_time"] = start_time_;
+    root["test_info"]["end_time"] = end_time_;
+    root["test_info"]["distinct_files"] = distinct_files_;
+    root["test_info"]["rounds"] = rounds_;
+    root["test_info"]["single_round_from"] = static_cast<Json::UInt64>(single_round_from_);
+    root["test_info"]["max_chain_blocks"] = static_cast<Json::UInt64>(max_chain_blocks_);
+
+    bool all_passed = true;
+    Json::Value fixed(Json::arrayValue);
+    for (const auto& spec : fixed_chains_) {
+        ChainStats s = summarize(runs_, spec.name);
+        fixed.append(stats_json(spec, s));
+        all_passed = all_passed && s.passed;
+    }
+    root["fixed"] = fixed;
+
+    Json::Value skipped(Json::arrayValue);
+    for (const auto& name : skipped_) {
+        skipped.append(name);
+    }
+    root["skipped"] = skipped;
+
+    if (!zipf_chains_.empty()) {
+        Json::Value zipf;
+        zipf["keywords"] = zipf_keywords_;
+        zipf["total_hops"] = static_cast<Json::UInt64>(zipf_total_hops_);
+        zipf["exponent"] = zipf_exponent_;
+        zipf["file_size"] = static_cast<Json::UInt64>(zipf_file_size_);
+
+        // 按 Zipf 查询概率加权：单线程下该查询组合的期望延迟与吞吐
+        double expected_search = 0;
+        double expected_verify = 0;
+        double multi_segment = 0;
+        Json::Value chains(Json::arrayValue);
+        for (size_t k = 0; k < zipf_chains_.size(); ++k) {
+            const ChainSpec& spec = zipf_chains_[k];
+            ChainStats s = summarize(runs_, spec.name);
+            expected_search += spec.popularity * s.search_ms;
+            expected_verify += spec.popularity * s.verify_ms;
+            if (s.segments > 1) {
+                multi_segment += spec.popularity;
+            }
+            Json::Value item = stats_json(spec, s);
+            item["rank"] = static_cast<Json::UInt64>(k + 1);
+            item["popularity"] = spec.popularity;
+            chains.append(item);
+            all_passed = all_passed && s.passed;
+        }
+        zipf["expected_search_ms"] = expected_search;
+        zipf["expected_verify_ms"] = expected_verify;
+        zipf["query_throughput_qps"] = expected_search > 0 ? 1000.0 / expected_search : 0.0;
+        zipf["multi_segment_query_share"] = multi_segment;
+        zipf["chains"] = chains;
+        root["zipf"] = zipf;
+    }
+    root["passed"] = all_passed;
+
+    std::ofstream out(json_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "  ";
+    out << Json::writeString(writer, root);
+    return true;
+}
+
+// ==================== 辅助函数 ====================
+
+std::string ChainLengthBenchmark::randomHex(size_t bytes) {
+    std::vector<unsigned char> random_bytes(bytes);
+    if (RAND_bytes(random_bytes.data(), static_cast<int>(bytes)) != 1) {
+        std::mt19937_64 rng(std::random_device{}() ^ chain_serial_);
+        for (auto& b : random_bytes) {
+            b = static_cast<unsigned char>(rng());
+        }
+    }
+    return hex_codec::encode(random_bytes.data(), bytes);
+}
@@ -0,0 +1,126 @@
+#ifndef CHAIN_LENGTH_BENCHMARK_H
+#define CHAIN_LENGTH_BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <filesystem>
+#include <jsoncpp/json/json.h>
+
+#include "../../Storage-node/storage_node.h"
+#include "../../common/perf_metrics.h"
+#include "../common/test_fixture.h"
+
+/**
+ * @brief 搜索链长度基准（链长度 / 文件大小 / Zipf 关键词热度）
+ *
+ * 测试程序充当数据拥有者：生成自己的私钥 sk 与公钥 PK = g^sk，按客户端相同的构造
+ * （Ti_bar = H2(T||st)、ptr = AES(H3(st_d), st_{d-1})、kt = [H2(ID_F)·H2(T||st_d)/H2(T||st_{d-1})]^sk、
+ * σ_i = [H2(ID_F||i)·μ^{Σc_ij}]^sk）直接生成任意长度的关键词链并写入存储节点数据库，
+ * 链上各跳轮流引用一小组"池文件"（真实密文与认证标签），因此 10 万跳的链也能在几分钟内生成。
+ *
+ * 两类负载：
+ *   fixed - chain_lengths x file_sizes 的每个组合各一条链，单独放入数据库测量
+ *   zipf  - keywords 个关键词共享一个数据库，链长度与查询热度均服从 Zipf(s) 分布
+ * 每次搜索通过 SearchKeywordsAssociatedFilesProof（路径接口，超过单段跳数上限时按续传令牌分段）
+ * 完成整条链，并逐段调用 VerifySearchProof（路径接口）验证。
+ */
+class ChainLengthBenchmark {
+public:
+    struct ChainSpec {
+        std::string workload;      // fixed / zipf
+        std::string name;          // 报告中的链名称
+        size_t length = 0;         // 跳数
+        size_t file_size = 0;      // 池文件大小（字节）
+        size_t blocks = 0;         // 每个池文件的块数
+        double popularity = 0;     // zipf 查询概率（fixed 为0）
+        double build_ms = 0;       // 生成并写入内存数据库的耗时
+        Json::Value params;        // 搜索参数 {PK, T, std}
+    };
+
+    struct SearchRun {
+        std::string workload;
+        std::string name;
+        size_t length;
+        size_t file_size;
+        size_t blocks;
+        int round;
+        int segments;              // 路径接口调用次数（单段最多 1000 跳）
+        size_t hops;
+        size_t files;
+        double search_ms;          // 全部分段的搜索总耗时
+        double search_reload_ms;   // 其中数据库重新加载（db_load_index + db_load_search）
+        double chain_walk_ms;      // 其中链遍历与证明计算（chain_walk）
+        double verify_ms;          // 全部分段的验证总耗时
+        double verify_reload_ms;   // 其中索引数据库重新加载
+        bool verified;
+        bool success;
+    };
+
+    ChainLengthBenchmark();
+    ~ChainLengthBenchmark();
+
+    bool loadConfig(const std::string& config_file);
+    bool initialize();
+    bool runTest();
+    bool saveDetailedReport(const std::string& csv_file);
+    bool saveSummaryReport(const std::string& json_file);
+
+private:
+    struct PoolFile {
+        std::string ID_F;
+        std::vector<std::string> tags;
+    };
+
+    bool preparePool(size_t file_size);
+    void resetDatabase();
+    bool buildChain(ChainSpec& spec);
+    bool persistDatabase();
+    void measureChain(const ChainSpec& spec, int rounds);
+    bool runSearch(const ChainSpec& spec, int round, SearchRun& run);
+    int roundsFor(size_t length) const;
+    void printSummary() const;
+    std::string randomHex(size_t bytes);
+
+    // 配置
+    std::string test_name_;
+    std::string public_params_file_;
+    std::string work_dir_;
+    std::vector<size_t> chain_lengths_;
+    std::vector<size_t> file_sizes_;
+    size_t max_chain_blocks_;  // 链长度 x 块数超过该值的组合跳过
+    int distinct_files_;       // 池文件数
+    int rounds_;
+    size_t single_round_from_; // 链长度达到该值后只测一轮
+    bool zipf_enabled_;
+    int zipf_keywords_;
+    size_t zipf_total_hops_;
+    double zipf_exponent_;
+    size_t zipf_file_size_;
+    bool quiet_node_output_;
+    bool reset_work_dir_;
+    bool verbose_;
+
+    // 组件
+    StorageNode* node_;
+    PerformanceCallback_s callbacks_;
+    std::map<std::string, double> phase_ms_;   // 当前一次节点调用的阶段耗时
+
+    // 数据拥有者密钥与当前池
+    element_t sk_;
+    bool sk_ready_;
+    std::string PK_;
+    std::vector<PoolFile> pool_;
+    size_t pool_file_size_;
+    uint64_t chain_serial_;
+
+    // 结果
+    std::vector<SearchRun> runs_;
+    std::vector<ChainSpec> fixed_chains_;
+    std::vector<ChainSpec> zipf_chains_;
+    std::vector<std::string> skipped_;
+    std::string start_time_;
+    std::string end_time_;
+};
+
+#endif // CHAIN_LENGTH_BENCHMARK_H
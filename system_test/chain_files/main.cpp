@@ -0,0 +1,32 @@
+/*
+ * main.cpp - 搜索链长度基准主程序
+ *
+ * 使用 ChainLengthBenchmark 类测量搜索/验证延迟随链长度、文件大小与关键词热度的变化
+ *
+ * 编译:
+ *   make
+ *
+ * 运行:
+ *   ./chain_length_benchmark [配置文件路径]
+ *   默认配置: system_test/chain_files/config/chain_test_config.json
+ */
+
+#include "chain_test.h"
+#include "../common/harness_main.h"
+
+int main(int argc, char* argv[]) {
+    harness_main::Spec spec;
+    spec.icon = "⛓️";
+    spec.name = "搜索链长度基准";
+    spec.run_label = "运行搜索链长度基准";
+    spec.default_config = "system_test/chain_files/config/chain_test_config.json";
+
+    return harness_main::run_harness<ChainLengthBenchmark>(argc, argv, spec, [](ChainLengthBenchmark& test) {
+        return std::vector<harness_main::Report>{
+            {"详细报告", "system_test/chain_files/results/chain_detailed.csv",
+             [&test](const std::string& p) { return test.saveDetailedReport(p); }},
+            {"总结报告", "system_test/chain_files/results/chain_summary.json",
+             [&test](const std::string& p) { return test.saveSummaryReport(p); }}
+        };
+    });
+}
@@ -0,0 +1,35 @@
+#include "client_fixture.h"
+
+#include <fstream>
+#include <iostream>
+
+namespace test_fixture {
+
+bool encrypt_random_file(StorageClient& client, const std::string& client_dir, const std::string& plain_path,
+                         size_t file_size, const std::vector<std::string>& keywords, std::mt19937_64& rng,
+                         EncryptedFile& out) {
+    std::string content = random_bytes(file_size, rng);
+    std::ofstream plain(plain_path, std::ios::binary);
+    plain.write(content.data(), static_cast<std::streamsize>(content.size()));
+    plain.close();
+    if (!plain) {
+        std::cerr << "[错误] 明文写入失败: " << plain_path << std::endl;
+        return false;
+    }
+
+    if (!client.encryptFile(plain_path, keywords)) {
+        std::cerr << "[错误] 客户端加密失败: " << plain_path << std::endl;
+        return false;
+    }
+
+    out.plain_path = plain_path;
+    out.bundle_path = client_dir + "/Insert/" + make_safe_name(plain_path) + insert_bundle::kExtension;
+    std::string error;
+    if (!insert_bundle::read(out.bundle_path, out.bundle, error)) {
+        std::cerr << "[错误] 请求包读取失败: " << out.bundle_path << " " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace test_fixture
@@ -0,0 +1,46 @@
+#ifndef SYSTEM_TEST_CLIENT_FIXTURE_H
+#define SYSTEM_TEST_CLIENT_FIXTURE_H
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test_fixture.h"
+#include "../../vds-client/client.h"
+#include "../../common/insert_bundle.h"
+
+// ==================== 测试工具共用的语料准备 ====================
+//
+// 各测试程序都按同样的步骤准备语料：生成随机明文 -> StorageClient::encryptFile
+// -> 读取客户端写出的 <client_dir>/Insert/<安全文件名>.vdsb 插入请求包。
+// 这里集中实现这一流程，测试程序只决定文件数、大小与关键词分配。
+
+namespace test_fixture {
+
+/**
+ * @brief 已由客户端加密的测试文件
+ */
+struct EncryptedFile {
+    std::string plain_path;          // 明文路径
+    std::string bundle_path;         // 客户端写出的插入请求包
+    insert_bundle::Bundle bundle;    // 解析后的请求包（含 ID_F 与密文）
+};
+
+/**
+ * encrypt_random_file() - 生成随机明文并由客户端加密，读回插入请求包
+ * @param client 已初始化的客户端
+ * @param client_dir 客户端数据目录（请求包位于 client_dir/Insert）
+ * @param plain_path 明文写入路径（所在目录须已存在）
+ * @param file_size 明文大小（字节）
+ * @param keywords 文件关键词
+ * @param rng 随机数发生器
+ * @param out 输出
+ * @return 成功返回true，失败时已输出错误信息
+ */
+bool encrypt_random_file(StorageClient& client, const std::string& client_dir, const std::string& plain_path,
+                         size_t file_size, const std::vector<std::string>& keywords, std::mt19937_64& rng,
+                         EncryptedFile& out);
+
+} // namespace test_fixture
+
+#endif // SYSTEM_TEST_CLIENT_FIXTURE_H
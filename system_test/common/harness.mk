@@ -0,0 +1,125 @@
+# ============================================================
+# 测试程序共用的 Makefile 规则
+#
+# 各测试目录的 Makefile 设置以下变量后 include 本文件：
+#   TARGET        - 可执行文件名
+#   TITLE         - 测试名称（用于提示信息），如 删除性能测试
+#   ICON          - 提示信息图标
+#   SOURCES       - 源文件（可使用 CLIENT_DIR / SERVER_DIR / COMMON_TEST_DIR；include 之前定义时用 = 延迟展开）
+#   CONFIG_FILE   - 默认配置文件（相对测试目录）
+#   SUMMARY_FILE  - 总结报告文件名（results/ 下，make show-results 显示）
+#   RESULT_FILES  - 全部结果文件名（results/ 下，make help 列出）
+#   EXTRA_HELP    - 可选，make help 中追加的目标说明（每项一个带引号的字符串）
+# include 之后可以追加测试专用的目标。
+# ============================================================
+
+# 编译器配置
+CXX = g++
+CXXFLAGS = -std=c++17 -Wall -Wextra -g -O2
+
+# 目录配置
+PROJECT_ROOT = ../..
+CLIENT_DIR = $(PROJECT_ROOT)/vds-client
+SERVER_DIR = $(PROJECT_ROOT)/Storage-node
+COMMON_TEST_DIR = ../common
+TEST_DIR = .
+
+# 包含路径
+INCLUDES = -I$(CLIENT_DIR) -I$(SERVER_DIR) -I/usr/local/include
+
+# 库路径和链接库
+LIBS = -L/usr/local/lib -lpbc -lgmp -lcrypto -ljsoncpp -lstdc++fs -pthread
+
+# 结果目录
+RESULTS_DIR = results
+
+# ============================================================
+# 构建目标
+# ============================================================
+
+.PHONY: all clean clean-all run run-config show-results help setup
+
+# 默认目标
+all: setup $(TARGET)
+
+# 编译主程序
+$(TARGET): $(SOURCES)
+	@echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
+	@echo "🔨 编译$(TITLE)程序..."
+	@echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
+	$(CXX) $(CXXFLAGS) $(INCLUDES) $(SOURCES) -o $(TARGET) $(LIBS)
+	@echo "✅ 编译完成: $(TARGET)"
+	@echo ""
+
+# 创建必要的目录
+setup:
+	@mkdir -p $(RESULTS_DIR)
+	@echo "✅ 结果目录已准备: $(RESULTS_DIR)"
+
+# 清理编译文件
+clean:
+	@echo "🧹 清理编译文件..."
+	@rm -f $(TARGET)
+	@echo "✅ 清理完成"
+
+# 清理所有（包括结果）
+clean-all: clean
+	@echo "🧹 清理所有文件（包括结果）..."
+	@rm -rf $(RESULTS_DIR)
+	@echo "✅ 完全清理完成"
+
+# 运行测试
+run: $(TARGET)
+	@echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
+	@echo "▶️  运行$(TITLE)..."
+	@echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
+	./$(TARGET)
+
+# 使用自定义配置运行
+run-config: $(TARGET)
+	@if [ -z "$(CONFIG)" ]; then \
+		echo "❌ 错误: 请指定配置文件"; \
+		echo "用法: make run-config CONFIG=your_config.json"; \
+		exit 1; \
+	fi
+	@echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
+	@echo "▶️  运行$(TITLE) (配置: $(CONFIG))..."
+	@echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
+	./$(TARGET) $(CONFIG)
+
+# 查看结果
+show-results:
+	@if [ -f "$(RESULTS_DIR)/$(SUMMARY_FILE)" ]; then \
+		echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"; \
+		echo "$(ICON) 测试结果总结"; \
+		echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"; \
+		cat $(RESULTS_DIR)/$(SUMMARY_FILE) | jq '.' || cat $(RESULTS_DIR)/$(SUMMARY_FILE); \
+	else \
+		echo "❌ 未找到结果文件: $(RESULTS_DIR)/$(SUMMARY_FILE)"; \
+		echo "请先运行: make run"; \
+	fi
+
+# 帮助信息
+help:
+	@echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
+	@echo "$(ICON) VDS $(TITLE) - Makefile 帮助"
+	@echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
+	@echo ""
+	@echo "可用目标:"
+	@echo "  make              - 编译程序（默认）"
+	@echo "  make run          - 编译并运行测试（使用默认配置）"
+	@echo "  make run-config   - 使用自定义配置运行"
+	@echo "                      示例: make run-config CONFIG=my.json"
+	@echo "  make show-results - 查看测试结果"
+	@echo "  make clean        - 清理编译文件"
+	@echo "  make clean-all    - 清理所有文件（包括结果）"
+	@for line in $(EXTRA_HELP); do echo "$$line"; done
+	@echo "  make help         - 显示此帮助信息"
+	@echo ""
+	@echo "配置文件:"
+	@echo "  默认: $(CONFIG_FILE)"
+	@echo ""
+	@echo "结果文件:"
+	@for f in $(RESULT_FILES); do echo "  $(RESULTS_DIR)/$$f"; done
+	@echo ""
+	@echo "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"
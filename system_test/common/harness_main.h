@@ -0,0 +1,145 @@
+#ifndef SYSTEM_TEST_HARNESS_MAIN_H
+#define SYSTEM_TEST_HARNESS_MAIN_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ==================== 测试程序共用的主流程 ====================
+//
+// 各测试程序的 main 都是：解析 [配置文件路径] -> loadConfig -> initialize -> runTest -> 保存报告。
+// run_harness() 实现这一流程，测试程序只提供名称、默认配置与报告列表。
+
+namespace harness_main {
+
+/**
+ * @brief 测试程序描述
+ */
+struct Spec {
+    std::string icon;             // 标题图标
+    std::string name;             // 工具名称，如 "删除性能测试"
+    std::string run_label;        // 阶段3的描述，如 "运行删除性能测试"
+    std::string default_config;   // 默认配置文件（相对项目根目录）
+    // runTest 失败时仍保存报告（失败本身是测量结果的一部分），failure_note 为此时的提示
+    bool save_on_failure = false;
+    std::string failure_note;
+};
+
+/**
+ * @brief 一份输出报告
+ */
+struct Report {
+    std::string label;                                  // 如 "详细报告"
+    std::string path;                                   // 输出路径（相对项目根目录）
+    std::function<bool(const std::string&)> save;
+};
+
+inline void print_rule() {
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
+}
+
+inline void print_usage(const Spec& spec, const char* program_name) {
+    std::cout << std::endl;
+    print_rule();
+    std::cout << spec.icon << "  " << spec.name << "工具" << std::endl;
+    print_rule();
+    std::cout << "\n用法: " << program_name << " [配置文件路径]" << std::endl;
+    std::cout << "\n参数:" << std::endl;
+    std::cout << "  配置文件路径  - JSON格式的测试配置文件（可选）" << std::endl;
+    std::cout << "                  默认: " << spec.default_config << std::endl;
+    std::cout << "\n示例:" << std::endl;
+    std::cout << "  " << program_name << std::endl;
+    std::cout << "  " << program_name << " custom_config.json" << std::endl;
+    std::cout << std::endl;
+    print_rule();
+    std::cout << std::endl;
+}
+
+/**
+ * parse_args() - 解析命令行
+ * @return -1 表示继续执行，否则为进程退出码
+ */
+inline int parse_args(int argc, char* argv[], const Spec& spec, std::string& config_file) {
+    config_file = spec.default_config;
+    if (argc == 2) {
+        std::string arg = argv[1];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(spec, argv[0]);
+            return 0;
+        }
+        config_file = arg;
+    } else if (argc > 2) {
+        std::cerr << "❌ 错误: 参数过多" << std::endl;
+        print_usage(spec, argv[0]);
+        return 1;
+    }
+    return -1;
+}
+
+/**
+ * run_harness() - 执行完整的测试流程
+ * @param make_reports 以测试实例构造报告列表（在 runTest 之后调用）
+ * @return 进程退出码
+ */
+template <typename Test>
+int run_harness(int argc, char* argv[], const Spec& spec,
+                const std::function<std::vector<Report>(Test&)>& make_reports) {
+    std::string config_file;
+    int exit_code = parse_args(argc, argv, spec, config_file);
+    if (exit_code >= 0) {
+        return exit_code;
+    }
+
+    std::cout << std::endl;
+    print_rule();
+    std::cout << spec.icon << "  VDS " << spec.name << "工具 v1.0" << std::endl;
+    print_rule();
+    std::cout << std::endl;
+
+    Test test;
+
+    std::cout << "[阶段 1/4] 加载配置..." << std::endl;
+    if (!test.loadConfig(config_file)) {
+        std::cerr << "\n❌ 配置加载失败，测试中止" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n[阶段 2/4] 初始化测试环境..." << std::endl;
+    if (!test.initialize()) {
+        std::cerr << "\n❌ 初始化失败，测试中止" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n[阶段 3/4] " << spec.run_label << "..." << std::endl;
+    print_rule();
+    std::cout << std::endl;
+    bool passed = test.runTest();
+    if (!passed) {
+        if (!spec.save_on_failure) {
+            std::cerr << "\n❌ 测试执行失败" << std::endl;
+            return 1;
+        }
+        std::cerr << "\n⚠️  " << spec.failure_note << "，仍保存测试结果" << std::endl;
+    }
+
+    std::cout << "\n[阶段 4/4] 保存测试结果..." << std::endl;
+    for (const auto& report : make_reports(test)) {
+        if (!report.save(report.path)) {
+            std::cerr << "⚠️  警告: " << report.label << "保存失败" << std::endl;
+        } else {
+            std::cout << "✅ " << report.label << "已保存: " << report.path << std::endl;
+        }
+    }
+
+    std::cout << std::endl;
+    print_rule();
+    std::cout << (passed ? "✅ 测试完成" : "❌ 测试完成（" + spec.failure_note + "）") << std::endl;
+    print_rule();
+    std::cout << std::endl;
+    return passed ? 0 : 1;
+}
+
+} // namespace harness_main
+
+#endif // SYSTEM_TEST_HARNESS_MAIN_H
@@ -0,0 +1,77 @@
+#include "test_fixture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace test_fixture {
+
+bool load_json(const std::string& path, Json::Value& out) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        return false;
+    }
+    Json::CharReaderBuilder builder;
+    std::string errs;
+    return Json::parseFromStream(builder, in, &out, &errs);
+}
+
+bool read_whole_file(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    out = ss.str();
+    return true;
+}
+
+std::string make_safe_name(const std::string& file_path) {
+    // 与客户端命名规则一致：绝对路径 + 分隔符替换
+    std::string safe = fs::absolute(file_path).lexically_normal().string();
+    std::replace(safe.begin(), safe.end(), '/', '_');
+    std::replace(safe.begin(), safe.end(), '\\', '_');
+    std::replace(safe.begin(), safe.end(), ':', '_');
+    return safe;
+}
+
+std::string random_bytes(size_t size, std::mt19937_64& rng) {
+    std::string content(size, '\0');
+    for (auto& c : content) {
+        c = static_cast<char>(rng());
+    }
+    return content;
+}
+
+std::vector<std::string> pick_keywords(const std::vector<std::string>& pool, size_t first, size_t count) {
+    std::vector<std::string> keywords;
+    if (pool.empty()) {
+        return keywords;
+    }
+    count = std::min(count, pool.size());
+    for (size_t j = 0; j < count; ++j) {
+        keywords.push_back(pool[(first + j) % pool.size()]);
+    }
+    std::sort(keywords.begin(), keywords.end());
+    keywords.erase(std::unique(keywords.begin(), keywords.end()), keywords.end());
+    return keywords;
+}
+
+std::string current_timestamp() {
+    auto now = std::chrono::system_clock::now();
+    std::time_t t = std::chrono::system_clock::to_time_t(now);
+    std::tm tm_buf;
+    localtime_r(&t, &tm_buf);
+    std::ostringstream ss;
+    ss << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S");
+    return ss.str();
+}
+
+} // namespace test_fixture
@@ -0,0 +1,83 @@
+#ifndef SYSTEM_TEST_FIXTURE_H
+#define SYSTEM_TEST_FIXTURE_H
+
+#include <iostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <jsoncpp/json/json.h>
+
+// ==================== 测试工具共用的辅助函数 ====================
+//
+// 配置读取、随机内容、关键词分配、时间戳与日志静默。不依赖客户端，
+// 需要客户端加密语料的测试程序另外使用 client_fixture.h。
+
+namespace test_fixture {
+
+/**
+ * load_json() - 读取并解析JSON文件
+ * @return 文件不存在或解析失败返回false
+ */
+bool load_json(const std::string& path, Json::Value& out);
+
+/**
+ * read_whole_file() - 以二进制方式读取整个文件
+ */
+bool read_whole_file(const std::string& path, std::string& out);
+
+/**
+ * make_safe_name() - 客户端的请求包命名规则：绝对路径 + 分隔符替换为 '_'
+ */
+std::string make_safe_name(const std::string& file_path);
+
+/**
+ * random_bytes() - 生成 size 字节的随机内容
+ */
+std::string random_bytes(size_t size, std::mt19937_64& rng);
+
+/**
+ * pick_keywords() - 从关键词池中按 pool[(first + j) % pool.size()] 取 count 个（去重并排序）
+ */
+std::vector<std::string> pick_keywords(const std::vector<std::string>& pool, size_t first, size_t count);
+
+/**
+ * current_timestamp() - 本地时间 "YYYY-MM-DD HH:MM:SS"
+ */
+std::string current_timestamp();
+
+/**
+ * @brief 丢弃写入内容的输出缓冲（静默客户端与存储节点的逐文件日志）
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+/**
+ * @brief 作用域内把 std::cout 重定向到 NullBuffer
+ */
+class QuietCout {
+public:
+    explicit QuietCout(bool enabled) : saved_(nullptr) {
+        if (enabled) {
+            saved_ = std::cout.rdbuf(&null_);
+        }
+    }
+    ~QuietCout() {
+        if (saved_) {
+            std::cout.rdbuf(saved_);
+        }
+    }
+
+    QuietCout(const QuietCout&) = delete;
+    QuietCout& operator=(const QuietCout&) = delete;
+
+private:
+    NullBuffer null_;
+    std::streambuf* saved_;
+};
+
+} // namespace test_fixture
+
+#endif // SYSTEM_TEST_FIXTURE_H
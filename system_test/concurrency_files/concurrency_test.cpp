@@ -0,0 +1,527 @@
+#include "concurrency_test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+using test_fixture::load_json;
+
+namespace {
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t idx = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+    return values[std::min(idx, values.size() - 1)];
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+ConcurrencyStressTest::ConcurrencyStressTest()
+    : stable_files_(16),
+      churn_files_(32),
+      file_size_(8 * 1024),
+      stable_keywords_(4),
+      churn_keywords_(4),
+      keywords_per_file_(2),
+      reader_threads_(4),
+      baseline_rounds_(8),
+      delete_fraction_(0.5),
+      reset_work_dir_(true),
+      verbose_(false),
+      client_(nullptr),
+      node_(nullptr) {}
+
+ConcurrencyStressTest::~ConcurrencyStressTest() {
+    delete node_;
+    delete client_;
+}
+
+// ==================== 配置与初始化 ====================
+
+bool ConcurrencyStressTest::loadConfig(const std::string& config_file) {
+    Json::Value config;
+    if (!load_json(config_file, config)) {
+        std::cerr << "[错误] 无法读取配置文件: " << config_file << std::endl;
+        return false;
+    }
+
+    test_name_ = config.get("test_name", "concurrency stress").asString();
+
+    const Json::Value& paths = config["paths"];
+    public_params_file_ = paths.get("public_params", "vds-client/data/public_params.json").asString();
+    work_dir_ = paths.get("work_dir", "system_test/concurrency_files/data/work").asString();
+
+    const Json::Value& options = config["options"];
+    stable_files_ = std::max(1, options.get("stable_files", 16).asInt());
+    churn_files_ = std::max(1, options.get("churn_files", 32).asInt());
+    file_size_ = options.get("file_size", 8 * 1024).asUInt64();
+    stable_keywords_ = std::max(1, options.get("stable_keywords", 4).asInt());
+    churn_keywords_ = std::max(1, options.get("churn_keywords", 4).asInt());
+    keywords_per_file_ = std::max(1, options.get("keywords_per_file", 2).asInt());
+    reader_threads_ = std::max(1, options.get("reader_threads", 4).asInt());
+    baseline_rounds_ = std::max(1, options.get("baseline_rounds", 8).asInt());
+    delete_fraction_ = std::min(1.0, std::max(0.0, options.get("delete_fraction", 0.5).asDouble()));
+    reset_work_dir_ = options.get("reset_work_dir", true).asBool();
+    verbose_ = options.get("verbose", false).asBool();
+
+    std::cout << "[配置] 工作目录: " << work_dir_ << std::endl;
+    std::cout << "[配置] 稳定文件: " << stable_files_ << ", 变动文件: " << churn_files_
+              << " (删除比例 " << delete_fraction_ << "), 文件大小: " << file_size_ << " 字节" << std::endl;
+    std::cout << "[配置] 读者线程: " << reader_threads_ << ", baseline 轮数: " << baseline_rounds_ << std::endl;
+    return true;
+}
+
+bool ConcurrencyStressTest::initialize() {
+    if (reset_work_dir_ && fs::exists(work_dir_)) {
+        std::cout << "[初始化] 清空工作目录: " << work_dir_ << std::endl;
+        fs::remove_all(work_dir_);
+    }
+    std::string client_dir = work_dir_ + "/client";
+    std::string node_dir = work_dir_ + "/node";
+    fs::create_directories(client_dir);
+    fs::create_directories(node_dir);
+    fs::create_directories(work_dir_ + "/plain");
+
+    client_ = new StorageClient();
+    StorageClient::configureDataDirectories(client_dir);
+    if (!client_->initialize(public_params_file_) || !client_->initializeDataDirectories()) {
+        std::cerr << "[错误] 客户端初始化失败" << std::endl;
+        return false;
+    }
+    std::string key_file = client_dir + "/private_key.dat";
+    if (!client_->loadKeys(key_file)) {
+        if (!client_->generateKeys(key_file)) {
+            std::cerr << "[错误] 密钥生成失败" << std::endl;
+            return false;
+        }
+        client_->saveKeys(key_file);
+    }
+    client_->setInsertBundleMode(true);
+
+    node_ = new StorageNode(node_dir, 0);
+    if (!node_->load_public_params(public_params_file_) || !node_->initialize_directories()) {
+        std::cerr << "[错误] 存储节点初始化失败" << std::endl;
+        return false;
+    }
+    if (!node_->load_index_database() || !node_->load_search_database()) {
+        std::cerr << "[错误] 存储节点数据库加载失败" << std::endl;
+        return false;
+    }
+
+    // 稳定文件在测试开始前插入，变动文件只生成请求包
+    std::cout << "\n[准备] 生成请求..." << std::endl;
+    if (!prepareFiles("stable", stable_files_, stable_keywords_, stable_) ||
+        !prepareFiles("churn", churn_files_, churn_keywords_, churn_)) {
+        return false;
+    }
+    for (const auto& file : stable_) {
+        if (!node_->insert_from_bundle(file.bundle)) {
+            std::cerr << "[错误] 稳定文件插入失败: " << file.ID_F << std::endl;
+            return false;
+        }
+    }
+
+    // 稳定关键词的搜索令牌（变动文件使用独立关键词，不改变这些令牌）
+    for (int k = 0; k < stable_keywords_; ++k) {
+        std::string kw = "stable_kw_" + std::to_string(k);
+        Json::Value params;
+        if (!client_->searchKeyword(kw) || !load_json(work_dir_ + "/client/Search/" + kw + ".json", params)) {
+            std::cerr << "[错误] 搜索令牌生成失败: " << kw << std::endl;
+            return false;
+        }
+        stable_search_params_.push_back(params);
+    }
+
+    size_t delete_count = static_cast<size_t>(churn_files_ * delete_fraction_ + 0.5);
+    for (size_t i = 0; i < delete_count; ++i) {
+        Json::Value params;
+        const std::string& ID_F = churn_[i].ID_F;
+        if (!client_->deleteFile(ID_F) || !load_json(work_dir_ + "/client/Deles/" + ID_F + ".json", params)) {
+            std::cerr << "[错误] 删除令牌生成失败: " << ID_F << std::endl;
+            return false;
+        }
+        churn_delete_params_.push_back(params);
+    }
+
+    std::cout << "[准备] 完成: 稳定文件 " << stable_.size() << " (已插入), 变动文件 " << churn_.size()
+              << ", 搜索令牌 " << stable_search_params_.size() << ", 删除令牌 "
+              << churn_delete_params_.size() << std::endl;
+    return true;
+}
+
+bool ConcurrencyStressTest::prepareFiles(const std::string& prefix, int count, int keyword_pool,
+                                         std::vector<TestFile>& out) {
+    std::mt19937_64 rng(std::random_device{}());
+    int per_file = std::min(keywords_per_file_, keyword_pool);
+    std::vector<std::string> pool;
+    for (int k = 0; k < keyword_pool; ++k) {
+        pool.push_back(prefix + "_kw_" + std::to_string(k));
+    }
+
+    for (int i = 0; i < count; ++i) {
+        TestFile file;
+        std::vector<std::string> keywords = test_fixture::pick_keywords(pool, static_cast<size_t>(i * per_file),
+                                                                     static_cast<size_t>(per_file));
+        file.keyword_count = keywords.size();
+
+        test_fixture::EncryptedFile encrypted;
+        if (!test_fixture::encrypt_random_file(*client_, work_dir_ + "/client",
+                                               work_dir_ + "/plain/" + prefix + "_" + std::to_string(i) + ".bin",
+                                               file_size_, keywords, rng, encrypted)) {
+            return false;
+        }
+        file.plain_path = encrypted.plain_path;
+        file.bundle = std::move(encrypted.bundle);
+        file.ID_F = file.bundle.ID_F;
+        out.push_back(std::move(file));
+    }
+    return true;
+}
+
+// ==================== 测试执行 ====================
+
+void ConcurrencyStressTest::readerLoop(const std::string& phase, int thread_id, int rounds,
+                                       const std::atomic<bool>* stop, std::vector<OpResult>& out) {
+    for (int r = 0; stop ? (r == 0 || !stop->load()) : (r < rounds); ++r) {
+        // 搜索 + 验证
+        size_t kw = static_cast<size_t>(thread_id + r) % stable_search_params_.size();
+        OpResult res{phase, "search", kw, 0, false, ""};
+        auto t0 = std::chrono::steady_clock::now();
+        SearchProofResult search_proof = node_->ComputeSearchProof(stable_search_params_[kw]);
+        res.latency_ms = elapsed_ms(t0);
+        res.success = search_proof.success && !search_proof.AS.empty();
+        if (!res.success) res.error_msg = "搜索证明生成失败";
+        out.push_back(res);
+
+        if (search_proof.success) {
+            OpResult vres{phase, "verify_search", kw, 0, false, ""};
+            t0 = std::chrono::steady_clock::now();
+            vres.success = node_->VerifySearchProof(search_proof);
+            vres.latency_ms = elapsed_ms(t0);
+            if (!vres.success) vres.error_msg = "搜索证明验证未通过";
+            out.push_back(vres);
+        }
+
+        // 文件证明 + 验证
+        size_t idx = static_cast<size_t>(thread_id * 7 + r) % stable_.size();
+        OpResult fres{phase, "file_proof", idx, 0, false, ""};
+        t0 = std::chrono::steady_clock::now();
+        FileProofResult file_proof = node_->ComputeFileProof(stable_[idx].ID_F);
+        fres.latency_ms = elapsed_ms(t0);
+        fres.success = file_proof.success;
+        if (!fres.success) fres.error_msg = "文件证明生成失败";
+        out.push_back(fres);
+
+        if (file_proof.success) {
+            OpResult vres{phase, "verify_file", idx, 0, false, ""};
+            t0 = std::chrono::steady_clock::now();
+            vres.success = node_->VerifyFileProof(file_proof);
+            vres.latency_ms = elapsed_ms(t0);
+            if (!vres.success) vres.error_msg = "文件证明验证未通过";
+            out.push_back(vres);
+        }
+    }
+}
+
+void ConcurrencyStressTest::runReaders(const std::string& phase, int rounds_per_thread,
+                                       const std::atomic<bool>* stop) {
+    std::vector<std::vector<OpResult>> per_thread(reader_threads_);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < reader_threads_; ++t) {
+        readers.emplace_back([this, &phase, &per_thread, t, rounds_per_thread, stop]() {
+            readerLoop(phase, t, rounds_per_thread, stop, per_thread[t]);
+        });
+    }
+    for (auto& th : readers) {
+        th.join();
+    }
+    for (const auto& v : per_thread) {
+        results_.insert(results_.end(), v.begin(), v.end());
+    }
+}
+
+bool ConcurrencyStressTest::runTest() {
+    start_time_ = test_fixture::current_timestamp();
+
+    // 阶段1：仅读者
+    std::cout << "\n[阶段] baseline: " << reader_threads_ << " 个读者 x " << baseline_rounds_ << " 轮" << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    runReaders("baseline", baseline_rounds_, nullptr);
+    phase_wall_ms_["baseline"] = elapsed_ms(start);
+
+    // 阶段2：读者 + 插入线程 + 删除线程
+    std::cout << "\n[阶段] mixed: " << reader_threads_ << " 个读者 + 插入 " << churn_.size()
+              << " + 删除 " << churn_delete_params_.size() << std::endl;
+    std::atomic<bool> writers_done(false);
+    std::mutex progress_mutex;
+    std::condition_variable progress_cv;
+    size_t inserted = 0;
+    std::vector<OpResult> writer_results;
+    std::mutex writer_results_mutex;
+
+    start = std::chrono::steady_clock::now();
+    std::thread reader_group([this, &writers_done]() {
+        runReaders("mixed", 0, &writers_done);
+    });
+
+    std::thread inserter([&]() {
+        for (size_t i = 0; i < churn_.size(); ++i) {
+            OpResult res{"mixed", "insert", i, 0, false, ""};
+            auto t0 = std::chrono::steady_clock::now();
+            res.success = node_->insert_from_bundle(churn_[i].bundle);
+            res.latency_ms = elapsed_ms(t0);
+            if (!res.success) res.error_msg = "插入失败";
+            {
+                std::lock_guard<std::mutex> lock(writer_results_mutex);
+                writer_results.push_back(res);
+            }
+            {
+                std::lock_guard<std::mutex> lock(progress_mutex);
+                inserted = i + 1;
+            }
+            progress_cv.notify_all();
+        }
+    });
+
+    std::thread deleter([&]() {
+        for (size_t i = 0; i < churn_delete_params_.size(); ++i) {
+            {
+                std::unique_lock<std::mutex> lock(progress_mutex);
+                progress_cv.wait(lock, [&]() { return inserted > i; });
+            }
+            OpResult res{"mixed", "delete", i, 0, false, ""};
+            auto t0 = std::chrono::steady_clock::now();
+            res.success = node_->delete_file(churn_delete_params_[i]);
+            res.latency_ms = elapsed_ms(t0);
+            if (!res.success) res.error_msg = "删除失败";
+            std::lock_guard<std::mutex> lock(writer_results_mutex);
+            writer_results.push_back(res);
+        }
+    });
+
+    inserter.join();
+    deleter.join();
+    writers_done = true;
+    reader_group.join();
+    phase_wall_ms_["mixed"] = elapsed_ms(start);
+    results_.insert(results_.end(), writer_results.begin(), writer_results.end());
+
+    // 阶段3：一致性检查
+    std::cout << "\n[阶段] final: 一致性与持久化检查" << std::endl;
+    runFinalChecks();
+
+    end_time_ = test_fixture::current_timestamp();
+    calculateStatistics();
+    printSummary();
+
+    for (const auto& c : checks_) {
+        if (!c.passed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==================== 一致性检查 ====================
+
+void ConcurrencyStressTest::addCheck(const std::string& name, bool passed, const std::string& detail) {
+    checks_.push_back({name, passed, detail});
+    std::cout << "   " << (passed ? "✅ " : "❌ ") << name << ": " << detail << std::endl;
+}
+
+void ConcurrencyStressTest::runFinalChecks() {
+    int reader_failures = 0;
+    int writer_failures = 0;
+    for (const auto& r : results_) {
+        if (r.success) continue;
+        if (r.op == "insert" || r.op == "delete") {
+            writer_failures++;
+        } else {
+            reader_failures++;
+        }
+        if (verbose_) {
+            std::cerr << "   ⚠️  " << r.phase << "/" << r.op << "[" << r.index << "]: " << r.error_msg << std::endl;
+        }
+    }
+    addCheck("reader_ops", reader_failures == 0, std::to_string(reader_failures) + " 次失败");
+    addCheck("writer_ops", writer_failures == 0, std::to_string(writer_failures) + " 次失败");
+
+    size_t expected_files = stable_.size() + churn_.size();
+    size_t expected_search = 0;
+    std::map<std::string, std::string> expected_state;
+    for (const auto& f : stable_) {
+        expected_search += f.keyword_count;
+        expected_state[f.ID_F] = "valid";
+    }
+    for (size_t i = 0; i < churn_.size(); ++i) {
+        expected_search += churn_[i].keyword_count;
+        expected_state[churn_[i].ID_F] = i < churn_delete_params_.size() ? "invalid" : "valid";
+    }
+
+    auto compare = [&](StorageNode& node, const std::string& label) {
+        auto lock = node.read_lock();
+        int mismatched = 0;
+        for (const auto& kv : expected_state) {
+            auto it = node.index_database.find(kv.first);
+            if (it == node.index_database.end() || it->second.state != kv.second) {
+                mismatched++;
+            }
+        }
+        addCheck(label + "_file_count", node.index_database.size() == expected_files,
+                 std::to_string(node.index_database.size()) + " / 期望 " + std::to_string(expected_files));
+        addCheck(label + "_search_count", node.search_database.size() == expected_search,
+                 std::to_string(node.search_database.size()) + " / 期望 " + std::to_string(expected_search));
+        addCheck(label + "_file_states", mismatched == 0, std::to_string(mismatched) + " 个状态不符");
+    };
+
+    compare(*node_, "memory");
+
+    // 写入期间的每次保存都基于一致的快照，重新加载后应与内存状态相同
+    StorageNode reloaded(work_dir_ + "/node", 0);
+    if (!reloaded.load_public_params(public_params_file_) ||
+        !reloaded.load_index_database() || !reloaded.load_search_database()) {
+        addCheck("reload", false, "重新加载数据库失败");
+        return;
+    }
+    compare(reloaded, "disk");
+}
+
+// ==================== 统计与报告 ====================
+
+void ConcurrencyStressTest::calculateStatistics() {
+    statistics_.clear();
+    const char* phases[] = {"baseline", "mixed"};
+    const char* ops[] = {"search", "verify_search", "file_proof", "verify_file", "insert", "delete"};
+    for (const char* phase : phases) {
+        for (const char* op : ops) {
+            OpStatistics s;
+            s.phase = phase;
+            s.op = op;
+            std::vector<double> latencies;
+            for (const auto& r : results_) {
+                if (r.phase != phase || r.op != op) continue;
+                s.count++;
+                if (!r.success) s.failures++;
+                latencies.push_back(r.latency_ms);
+            }
+            if (latencies.empty()) continue;
+            s.avg_ms = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
+            s.p50_ms = percentile(latencies, 50);
+            s.p95_ms = percentile(latencies, 95);
+            s.max_ms = *std::max_element(latencies.begin(), latencies.end());
+            double wall_ms = phase_wall_ms_[phase];
+            if (wall_ms > 0) {
+                s.throughput = s.count / (wall_ms / 1000.0);
+            }
+            statistics_.push_back(s);
+        }
+    }
+}
+
+void ConcurrencyStressTest::printSummary() const {
+    std::cout << "\n" << std::string(80, '=') << std::endl;
+    std::cout << "并发压力测试总结" << std::endl;
+    std::cout << std::string(80, '=') << std::endl;
+    std::cout << std::left << std::setw(10) << "阶段" << std::setw(15) << "操作" << std::right
+              << std::setw(7) << "数量" << std::setw(7) << "失败"
+              << std::setw(10) << "avg ms" << std::setw(10) << "p50 ms" << std::setw(10) << "p95 ms"
+              << std::setw(10) << "max ms" << std::setw(10) << "次/秒" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& s : statistics_) {
+        std::cout << std::left << std::setw(10) << s.phase << std::setw(15) << s.op << std::right
+                  << std::setw(7) << s.count << std::setw(7) << s.failures
+                  << std::setw(10) << s.avg_ms << std::setw(10) << s.p50_ms << std::setw(10) << s.p95_ms
+                  << std::setw(10) << s.max_ms << std::setw(10) << s.throughput << std::endl;
+    }
+    int passed = 0;
+    for (const auto& c : checks_) {
+        if (c.passed) passed++;
+    }
+    std::cout << "\n🔎 一致性检查: " << passed << "/" << checks_.size() << " 通过" << std::endl;
+}
+
+bool ConcurrencyStressTest::saveDetailedReport(const std::string& csv_file) {
+    fs::create_directories(fs::path(csv_file).parent_path());
+    std::ofstream out(csv_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    out << "phase,op,index,latency_ms,success,error\n";
+    for (const auto& r : results_) {
+        out << r.phase << "," << r.op << "," << r.index << "," << std::fixed << std::setprecision(3)
+            << r.latency_ms << "," << (r.success ? "true" : "false") << ",\"" << r.error_msg << "\"\n";
+    }
+    return true;
+}
+
+bool ConcurrencyStressTest::saveSummaryReport(const std::string& json_file) {
+    fs::create_directories(fs::path(json_file).parent_path());
+    Json::Value root;
+    root["test_info"]["test_name"] = test_name_;
+    root["test_info"]["start_time"] = start_time_;
+    root["test_info"]["end_time"] = end_time_;
+    root["test_info"]["reader_threads"] = reader_threads_;
+    root["test_info"]["stable_files"] = stable_files_;
+    root["test_info"]["churn_files"] = churn_files_;
+    root["test_info"]["deleted_files"] = static_cast<Json::UInt64>(churn_delete_params_.size());
+    root["test_info"]["file_size"] = static_cast<Json::UInt64>(file_size_);
+
+    for (const auto& kv : phase_wall_ms_) {
+        root["phase_wall_ms"][kv.first] = kv.second;
+    }
+
+    Json::Value ops(Json::arrayValue);
+    for (const auto& s : statistics_) {
+        Json::Value op;
+        op["phase"] = s.phase;
+        op["op"] = s.op;
+        op["count"] = s.count;
+        op["failures"] = s.failures;
+        op["avg_ms"] = s.avg_ms;
+        op["p50_ms"] = s.p50_ms;
+        op["p95_ms"] = s.p95_ms;
+        op["max_ms"] = s.max_ms;
+        op["throughput_ops"] = s.throughput;
+        ops.append(op);
+    }
+    root["operations"] = ops;
+
+    Json::Value checks(Json::arrayValue);
+    bool all_passed = true;
+    for (const auto& c : checks_) {
+        Json::Value check;
+        check["name"] = c.name;
+        check["passed"] = c.passed;
+        check["detail"] = c.detail;
+        checks.append(check);
+        all_passed = all_passed && c.passed;
+    }
+    root["checks"] = checks;
+    root["passed"] = all_passed;
+
+    std::ofstream out(json_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "  ";
+    out << Json::writeString(writer, root);
+    return true;
+}
@@ -0,0 +1,117 @@
+#ifndef CONCURRENCY_STRESS_TEST_H
+#define CONCURRENCY_STRESS_TEST_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <map>
+#include <filesystem>
+#include <jsoncpp/json/json.h>
+
+#include "../../vds-client/client.h"
+#include "../../Storage-node/storage_node.h"
+#include "../common/client_fixture.h"
+
+/**
+ * @brief 存储节点并发压力测试（并发搜索/证明 + 插入 + 删除）
+ *
+ * 文件分两组：
+ *   - 稳定文件：准备阶段插入，只被读者访问（搜索、文件证明及其验证），结果必须全部有效
+ *   - 变动文件：测试期间由写者线程插入，删除线程随后删除其中一部分
+ * 阶段：
+ *   baseline - 仅读者，得到无写入时的吞吐量
+ *   mixed    - 读者与插入/删除线程同时运行
+ *   final    - 写入结束后检查内存数据库状态，并重新从磁盘加载比对持久化结果
+ */
+class ConcurrencyStressTest {
+public:
+    struct OpResult {
+        std::string phase;
+        std::string op;
+        size_t index;          // 文件/关键词序号
+        double latency_ms;
+        bool success;
+        std::string error_msg;
+    };
+
+    struct OpStatistics {
+        std::string phase;
+        std::string op;
+        int count = 0;
+        int failures = 0;
+        double avg_ms = 0;
+        double p50_ms = 0;
+        double p95_ms = 0;
+        double max_ms = 0;
+        double throughput = 0;    // 次/秒（按阶段墙钟时间）
+    };
+
+    struct CheckResult {
+        std::string name;
+        bool passed;
+        std::string detail;
+    };
+
+    ConcurrencyStressTest();
+    ~ConcurrencyStressTest();
+
+    bool loadConfig(const std::string& config_file);
+    bool initialize();
+    bool runTest();
+    bool saveDetailedReport(const std::string& csv_file);
+    bool saveSummaryReport(const std::string& json_file);
+
+private:
+    struct TestFile {
+        std::string plain_path;
+        std::string ID_F;
+        insert_bundle::Bundle bundle;
+        size_t keyword_count = 0;
+    };
+
+    bool prepareFiles(const std::string& prefix, int count, int keyword_pool,
+                      std::vector<TestFile>& out);
+    void runReaders(const std::string& phase, int rounds_per_thread, const std::atomic<bool>* stop);
+    void readerLoop(const std::string& phase, int thread_id, int rounds,
+                    const std::atomic<bool>* stop, std::vector<OpResult>& out);
+    void runFinalChecks();
+    void addCheck(const std::string& name, bool passed, const std::string& detail);
+    void calculateStatistics();
+    void printSummary() const;
+
+    // 配置
+    std::string test_name_;
+    std::string public_params_file_;
+    std::string work_dir_;
+    int stable_files_;
+    int churn_files_;
+    size_t file_size_;
+    int stable_keywords_;
+    int churn_keywords_;
+    int keywords_per_file_;
+    int reader_threads_;         // 读者线程数（交替执行搜索与文件证明）
+    int baseline_rounds_;        // baseline 阶段每个读者的轮数
+    double delete_fraction_;     // 变动文件中被删除的比例
+    bool reset_work_dir_;
+    bool verbose_;
+
+    // 组件
+    StorageClient* client_;
+    StorageNode* node_;
+
+    // 数据
+    std::vector<TestFile> stable_;
+    std::vector<TestFile> churn_;
+    std::vector<Json::Value> stable_search_params_;
+    std::vector<Json::Value> churn_delete_params_;
+
+    // 结果
+    std::vector<OpResult> results_;
+    std::map<std::string, double> phase_wall_ms_;
+    std::vector<OpStatistics> statistics_;
+    std::vector<CheckResult> checks_;
+    std::string start_time_;
+    std::string end_time_;
+};
+
+#endif // CONCURRENCY_STRESS_TEST_H
@@ -0,0 +1,32 @@
+/*
+ * main.cpp - 并发压力测试主程序
+ *
+ * 使用 ConcurrencyStressTest 类进行完整的并发压力测试
+ *
+ * 编译:
+ *   make
+ *
+ * 运行:
+ *   ./concurrency_stress_test [配置文件路径]
+ *   默认配置: system_test/concurrency_files/config/concurrency_test_config.json
+ */
+
+#include "concurrency_test.h"
+#include "../common/harness_main.h"
+
+int main(int argc, char* argv[]) {
+    harness_main::Spec spec;
+    spec.icon = "🧵";
+    spec.name = "并发压力测试";
+    spec.run_label = "运行并发压力测试";
+    spec.default_config = "system_test/concurrency_files/config/concurrency_test_config.json";
+
+    return harness_main::run_harness<ConcurrencyStressTest>(argc, argv, spec, [](ConcurrencyStressTest& test) {
+        return std::vector<harness_main::Report>{
+            {"详细报告", "system_test/concurrency_files/results/concurrency_detailed.csv",
+             [&test](const std::string& p) { return test.saveDetailedReport(p); }},
+            {"总结报告", "system_test/concurrency_files/results/concurrency_summary.json",
+             [&test](const std::string& p) { return test.saveSummaryReport(p); }}
+        };
+    });
+}
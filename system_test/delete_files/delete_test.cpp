@@ -0,0 +1,680 @@
+#include "delete_test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+using test_fixture::load_json;
+using test_fixture::QuietCout;
+
+namespace {
+
+uint64_t file_size_or_zero(const std::string& path) {
+    std::error_code ec;
+    uint64_t size = fs::file_size(path, ec);
+    return ec ? 0 : size;
+}
+
+} // namespace
+
+DeletePerformanceTest::DeletePerformanceTest()
+    : files_(200),
+      keywords_(8),
+      keywords_per_file_(2),
+      file_size_(4 * 1024),
+      batch_size_(1),
+      search_rounds_(3),
+      compaction_("none"),
+      seed_(42),
+      quiet_node_output_(true),
+      reset_work_dir_(true),
+      verbose_(false),
+      client_(nullptr),
+      node_(nullptr),
+      next_delete_(0) {
+
+    callback_s_.on_phase_complete = [this](const std::string& name, double time_ms) {
+        latency_.record_ms(name, time_ms);
+    };
+    callback_s_.on_op_counters = [this](const std::string& name, const perf_metrics::OpCounters& counters) {
+        op_summary_.record(name, counters);
+    };
+}
+
+DeletePerformanceTest::~DeletePerformanceTest() {
+    delete node_;
+    delete client_;
+}
+
+// ==================== 配置与初始化 ====================
+
+bool DeletePerformanceTest::loadConfig(const std::string& config_file) {
+    Json::Value config;
+    if (!load_json(config_file, config)) {
+        std::cerr << "[错误] 无法读取配置文件: " << config_file << std::endl;
+        return false;
+    }
+
+    test_name_ = config.get("test_name", "storage node delete").asString();
+
+    const Json::Value& paths = config["paths"];
+    public_params_file_ = paths.get("public_params", "vds-client/data/public_params.json").asString();
+    work_dir_ = paths.get("work_dir", "system_test/delete_files/data/work").asString();
+
+    const Json::Value& options = config["options"];
+    delete_fractions_.clear();
+    if (options["delete_fractions"].isArray()) {
+        for (const auto& v : options["delete_fractions"]) {
+            double f = v.asDouble();
+            if (f < 0.0 || f > 1.0) {
+                std::cerr << "[错误] delete_fractions 取值须在 [0, 1]: " << f << std::endl;
+                return false;
+            }
+            delete_fractions_.push_back(f);
+        }
+    }
+    if (delete_fractions_.empty()) {
+        delete_fractions_ = {0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 1.0};
+    }
+    // 累计比例：排序去重
+    std::sort(delete_fractions_.begin(), delete_fractions_.end());
+    delete_fractions_.erase(std::unique(delete_fractions_.begin(), delete_fractions_.end()),
+                            delete_fractions_.end());
+
+    files_ = std::max(1, options.get("files", 200).asInt());
+    keywords_ = std::max(1, options.get("keywords", 8).asInt());
+    keywords_per_file_ = std::max(1, std::min(keywords_, options.get("keywords_per_file", 2).asInt()));
+    file_size_ = std::max<Json::UInt64>(1, options.get("file_size", 4 * 1024).asUInt64());
+    batch_size_ = std::max(1, options.get("batch_size", 1).asInt());
+    search_rounds_ = std::max(1, options.get("search_rounds", 3).asInt());
+    compaction_ = options.get("compaction", "none").asString();
+    seed_ = options.get("seed", 42).asUInt64();
+    quiet_node_output_ = options.get("quiet_node_output", true).asBool();
+    reset_work_dir_ = options.get("reset_work_dir", true).asBool();
+    verbose_ = options.get("verbose", false).asBool();
+
+    if (compaction_ != "none" && compaction_ != "after_step") {
+        std::cerr << "[错误] 未知的 compaction 取值: " << compaction_ << " (none / after_step)" << std::endl;
+        return false;
+    }
+
+    std::cout << "[配置] 工作目录: " << work_dir_ << std::endl;
+    std::cout << "[配置] 语料: " << files_ << " 个文件 x " << file_size_ << " 字节, "
+              << keywords_ << " 个关键词 (每个文件 " << keywords_per_file_ << " 个)" << std::endl;
+    std::cout << "[配置] 累计删除比例:";
+    for (double f : delete_fractions_) {
+        std::cout << " " << f;
+    }
+    std::cout << std::endl;
+    std::cout << "[配置] 每次删除调用: " << batch_size_ << " 个文件, 搜索: " << search_rounds_
+              << " 轮, 回收: " << compaction_ << std::endl;
+    return true;
+}
+
+bool DeletePerformanceTest::initialize() {
+    if (reset_work_dir_ && fs::exists(work_dir_)) {
+        std::cout << "[初始化] 清空工作目录: " << work_dir_ << std::endl;
+        fs::remove_all(work_dir_);
+    }
+    std::string client_dir = work_dir_ + "/client";
+    std::string node_dir = work_dir_ + "/node";
+    fs::create_directories(client_dir);
+    fs::create_directories(node_dir);
+    fs::create_directories(work_dir_ + "/plain");
+
+    client_ = new StorageClient();
+    StorageClient::configureDataDirectories(client_dir);
+    if (!client_->initialize(public_params_file_) || !client_->initializeDataDirectories()) {
+        std::cerr << "[错误] 客户端初始化失败" << std::endl;
+        return false;
+    }
+    std::string key_file = client_dir + "/private_key.dat";
+    if (!client_->loadKeys(key_file)) {
+        if (!client_->generateKeys(key_file)) {
+            std::cerr << "[错误] 密钥生成失败" << std::endl;
+            return false;
+        }
+        client_->saveKeys(key_file);
+    }
+    client_->setInsertBundleMode(true);
+
+    node_ = new StorageNode(node_dir, 0);
+    if (!node_->load_public_params(public_params_file_) || !node_->initialize_directories()) {
+        std::cerr << "[错误] 存储节点初始化失败" << std::endl;
+        return false;
+    }
+    if (!node_->load_index_database() || !node_->load_search_database()) {
+        std::cerr << "[错误] 存储节点数据库加载失败" << std::endl;
+        return false;
+    }
+
+    if (!prepareCorpus()) {
+        return false;
+    }
+
+    // 语料准备完成后再挂回调，插入耗时不计入统计
+    node_->setPerformanceCallback_s(&callback_s_);
+    return true;
+}
+
+bool DeletePerformanceTest::prepareCorpus() {
+    std::cout << "\n[准备] 生成并插入 " << files_ << " 个文件..." << std::endl;
+    std::mt19937_64 rng(seed_);
+
+    std::vector<std::string> pool;
+    for (int k = 0; k < keywords_; ++k) {
+        pool.push_back("delete_kw_" + std::to_string(k));
+    }
+
+    for (int i = 0; i < files_; ++i) {
+        // 相邻文件错开关键词，每条链上都均匀分布着各个文件
+        std::vector<std::string> keywords =
+            test_fixture::pick_keywords(pool, static_cast<size_t>(i), static_cast<size_t>(keywords_per_file_));
+
+        test_fixture::EncryptedFile file;
+        {
+            QuietCout quiet(quiet_node_output_);
+            if (!test_fixture::encrypt_random_file(*client_, work_dir_ + "/client",
+                                                   work_dir_ + "/plain/file_" + std::to_string(i) + ".bin",
+                                                   file_size_, keywords, rng, file)) {
+                return false;
+            }
+            if (!node_->insert_from_bundle(file.bundle)) {
+                std::cerr << "[错误] 插入失败: " << file.bundle.ID_F << std::endl;
+                return false;
+            }
+        }
+        const insert_bundle::Bundle& bundle = file.bundle;
+
+        file_ids_.push_back(bundle.ID_F);
+        for (const auto& kw : keywords) {
+            keyword_files_[kw].push_back(bundle.ID_F);
+        }
+        if ((i + 1) % 50 == 0 || i + 1 == files_) {
+            std::cout << "   已插入 " << (i + 1) << "/" << files_ << std::endl;
+        }
+    }
+
+    // 删除不改变客户端关键词状态，搜索令牌在整个测试中不变
+    for (const auto& kw : pool) {
+        Json::Value params;
+        bool ok;
+        {
+            QuietCout quiet(quiet_node_output_);
+            ok = client_->searchKeyword(kw) && load_json(work_dir_ + "/client/Search/" + kw + ".json", params);
+        }
+        if (!ok) {
+            std::cerr << "[错误] 搜索令牌生成失败: " << kw << std::endl;
+            return false;
+        }
+        search_params_[kw] = params;
+    }
+
+    std::shuffle(file_ids_.begin(), file_ids_.end(), rng);
+
+    std::cout << "[准备] 完成: " << file_ids_.size() << " 个文件, " << search_params_.size()
+              << " 个搜索令牌" << std::endl;
+    return true;
+}
+
+// ==================== 测试执行 ====================
+
+bool DeletePerformanceTest::runTest() {
+    start_time_ = test_fixture::current_timestamp();
+    step_results_.assign(delete_fractions_.size(), StepResult());
+
+    checkForgedDelete();
+
+    for (size_t s = 0; s < delete_fractions_.size(); ++s) {
+        std::cout << "\n[删除] " << (s + 1) << "/" << delete_fractions_.size() << ": 累计删除 "
+                  << delete_fractions_[s] * 100 << "%" << std::endl;
+        StepResult& step = step_results_[s];
+        runStep(s, step);
+        std::cout << std::fixed << std::setprecision(2)
+                  << "   删除 " << step.deleted_this_step << " 个 (p50 " << step.delete_ms.percentile_ms(50)
+                  << " ms), 搜索 p50 " << step.search_ms.percentile_ms(50) << " ms, 平均跳数 "
+                  << step.hops_avg << ", 平均结果 " << step.files_avg;
+        if (compaction_ == "after_step") {
+            std::cout << ", 回收后搜索 p50 " << step.search_gc_ms.percentile_ms(50) << " ms";
+        }
+        std::cout << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+        if (step.leaked > 0 || step.missing > 0) {
+            std::cerr << "   ❌ 搜索结果不一致: 已删除文件出现 " << step.leaked << " 次, 未删除文件缺失 "
+                      << step.missing << " 次" << std::endl;
+        }
+    }
+
+    end_time_ = test_fixture::current_timestamp();
+    printSummary();
+
+    if (forgery_.accepted > 0 || forgery_.search_failures > 0) {
+        return false;
+    }
+    for (const auto& step : step_results_) {
+        if (step.delete_failures > 0 || step.search_failures > 0 || step.leaked > 0 || step.missing > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DeletePerformanceTest::checkForgedDelete() {
+    if (file_ids_.size() < 2) {
+        return;
+    }
+    // 目标文件最后才被删除；donor 的 del 是合法元素，但属于另一个文件
+    const std::string& victim = file_ids_.back();
+    const std::string& donor = file_ids_.front();
+    std::cout << "\n[伪造] 对未删除文件发送伪造的删除令牌: " << victim.substr(0, 16) << "..." << std::endl;
+
+    Json::Value donor_params;
+    bool ok;
+    {
+        QuietCout quiet(quiet_node_output_);
+        ok = client_->deleteFile(donor) &&
+             load_json(work_dir_ + "/client/Deles/" + donor + ".json", donor_params);
+    }
+    if (!ok) {
+        std::cerr << "[错误] 删除令牌生成失败: " << donor << std::endl;
+        forgery_.search_failures++;
+        return;
+    }
+
+    Json::Value replayed = donor_params;
+    replayed["ID_F"] = victim;
+    Json::Value pk_as_del = replayed;
+    pk_as_del["del"] = donor_params["PK"];
+
+    const std::pair<const char*, Json::Value> forged[] = {{"replayed_del", replayed}, {"pk_as_del", pk_as_del}};
+    for (const auto& item : forged) {
+        std::vector<DeleteResult> outcome;
+        uint64_t t0 = perf_metrics::now_ns();
+        {
+            QuietCout quiet(quiet_node_output_);
+            node_->delete_files_batch(std::vector<Json::Value>{item.second}, &outcome);
+        }
+        bool rejected = outcome.size() == 1 && !outcome[0].success;
+        forgery_.attempts++;
+        if (!rejected) {
+            forgery_.accepted++;
+            std::cerr << "   ❌ 伪造的删除令牌被接受: " << item.first << std::endl;
+        }
+        results_.push_back({0, "forged_delete", item.first, perf_metrics::elapsed_ms(t0), 0, 0, rejected});
+    }
+
+    // 目标文件所在的每条链仍须通过验证并返回该文件
+    for (const auto& kv : keyword_files_) {
+        if (std::find(kv.second.begin(), kv.second.end(), victim) == kv.second.end()) {
+            continue;
+        }
+        std::set<std::string> found;
+        size_t hops = 0;
+        double search_ms = 0;
+        bool verified = true;
+        bool searched = searchKeyword(kv.first, found, hops, search_ms, verified);
+        bool passed = searched && verified && found.count(victim) > 0;
+        if (!passed) {
+            forgery_.search_failures++;
+            std::cerr << "   ❌ 伪造请求之后搜索失败: " << kv.first << std::endl;
+        }
+        results_.push_back({0, "forged_search", kv.first, search_ms, hops, found.size(), passed});
+    }
+    std::cout << "   尝试 " << forgery_.attempts << " 次, 被接受 " << forgery_.accepted
+              << " 次, 之后搜索失败 " << forgery_.search_failures << " 次" << std::endl;
+}
+
+void DeletePerformanceTest::runStep(size_t step_index, StepResult& step) {
+    step.fraction = delete_fractions_[step_index];
+
+    // 1. 删除到目标比例
+    size_t target = static_cast<size_t>(std::llround(step.fraction * static_cast<double>(file_ids_.size())));
+    if (target > next_delete_) {
+        std::vector<std::string> ids(file_ids_.begin() + static_cast<std::ptrdiff_t>(next_delete_),
+                                     file_ids_.begin() + static_cast<std::ptrdiff_t>(target));
+        deleteFiles(step_index, ids, step);
+        next_delete_ = target;
+    }
+    step.deleted = deleted_.size();
+    step.live_files = file_ids_.size() - deleted_.size();
+
+    // 2. 删除后的搜索
+    measureSearch(step_index, "search", step.search_ms, step);
+
+    // 3. 回收已删除文件后再测一次搜索
+    if (compaction_ == "after_step") {
+        bool compacted;
+        uint64_t t0 = perf_metrics::now_ns();
+        {
+            QuietCout quiet(quiet_node_output_);
+            compacted = node_->compact_deleted_files(&step.compaction);
+        }
+        results_.push_back({step_index, "compact", std::to_string(step.compaction.files),
+                            perf_metrics::elapsed_ms(t0), static_cast<size_t>(step.compaction.files), 0,
+                            compacted});
+        if (!compacted) {
+            step.search_failures++;
+        }
+        measureSearch(step_index, "search_gc", step.search_gc_ms, step);
+    }
+
+    std::string node_dir = node_->get_data_dir();
+    step.index_db_bytes = file_size_or_zero(node_dir + "/index_db.json");
+    step.search_db_bytes = file_size_or_zero(node_dir + "/search_db.json");
+    step.node_memory = node_->get_memory_usage();
+}
+
+void DeletePerformanceTest::deleteFiles(size_t step_index, const std::vector<std::string>& ids,
+                                        StepResult& step) {
+    std::string deles_dir = work_dir_ + "/client/Deles/";
+
+    for (size_t begin = 0; begin < ids.size(); begin += static_cast<size_t>(batch_size_)) {
+        size_t end = std::min(ids.size(), begin + static_cast<size_t>(batch_size_));
+
+        // 客户端删除令牌
+        std::vector<std::string> paths;
+        std::vector<std::string> batch_ids;
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t t0 = perf_metrics::now_ns();
+            bool ok;
+            {
+                QuietCout quiet(quiet_node_output_);
+                ok = client_->deleteFile(ids[i]);
+            }
+            uint64_t ns = perf_metrics::now_ns() - t0;
+            step.client_ms.record(ns);
+            results_.push_back({step_index, "client_delete", ids[i], static_cast<double>(ns) / 1e6, 0, 0, ok});
+            if (!ok) {
+                step.delete_failures++;
+                continue;
+            }
+            paths.push_back(deles_dir + ids[i] + ".json");
+            batch_ids.push_back(ids[i]);
+        }
+        if (paths.empty()) {
+            continue;
+        }
+
+        // 节点删除：单个文件走 delete_file_from_json，多个文件走一次批量调用
+        std::vector<DeleteResult> outcome;
+        uint64_t t0 = perf_metrics::now_ns();
+        {
+            QuietCout quiet(quiet_node_output_);
+            if (paths.size() == 1 && batch_size_ == 1) {
+                DeleteResult res;
+                res.ID_F = batch_ids[0];
+                res.success = node_->delete_file_from_json(paths[0]);
+                outcome.push_back(res);
+            } else {
+                node_->delete_files_from_json(paths, &outcome);
+            }
+        }
+        uint64_t ns = perf_metrics::now_ns() - t0;
+        step.batch_ms.record(ns);
+
+        size_t succeeded = 0;
+        for (size_t i = 0; i < batch_ids.size(); ++i) {
+            bool ok = i < outcome.size() && outcome[i].success;
+            if (ok) {
+                deleted_.insert(batch_ids[i]);
+                succeeded++;
+            } else {
+                step.delete_failures++;
+                if (verbose_) {
+                    std::cerr << "   ⚠️  删除失败: " << batch_ids[i]
+                              << (i < outcome.size() ? " " + outcome[i].error : std::string()) << std::endl;
+                }
+            }
+            // 批内各文件分摊批耗时
+            step.delete_ms.record(ns / batch_ids.size());
+        }
+        step.deleted_this_step += succeeded;
+
+        if (batch_size_ == 1) {
+            results_.push_back({step_index, "delete", batch_ids[0], static_cast<double>(ns) / 1e6, 1, 0,
+                                succeeded == 1});
+        } else {
+            results_.push_back({step_index, "delete_batch", std::to_string(begin / batch_size_),
+                                static_cast<double>(ns) / 1e6, batch_ids.size(), 0,
+                                succeeded == batch_ids.size()});
+        }
+    }
+}
+
+void DeletePerformanceTest::measureSearch(size_t step_index, const std::string& op,
+                                          perf_metrics::Histogram& hist, StepResult& step) {
+    size_t total_hops = 0;
+    size_t total_files = 0;
+    size_t searches = 0;
+
+    for (int r = 0; r < search_rounds_; ++r) {
+        for (const auto& kv : search_params_) {
+            const std::string& kw = kv.first;
+            std::set<std::string> found;
+            size_t hops = 0;
+            double search_ms = 0;
+            bool verified = true;
+            bool ok = searchKeyword(kw, found, hops, search_ms, verified);
+            hist.record(static_cast<uint64_t>(search_ms * 1e6));
+            results_.push_back({step_index, op, kw, search_ms, hops, found.size(), ok && verified});
+            total_hops += hops;
+            total_files += found.size();
+            searches++;
+
+            if (!ok || !verified) {
+                step.search_failures++;
+                if (verbose_) {
+                    std::cerr << "   ⚠️  " << op << " 失败: " << kw << (ok ? " (验证未通过)" : "") << std::endl;
+                }
+                continue;
+            }
+
+            // 结果集合须恰好是该关键词下未删除的文件（每轮结果相同，只在第一轮计数）
+            if (r > 0) {
+                continue;
+            }
+            for (const auto& id : found) {
+                if (deleted_.count(id)) {
+                    step.leaked++;
+                }
+            }
+            for (const auto& id : keyword_files_[kw]) {
+                if (!deleted_.count(id) && !found.count(id)) {
+                    step.missing++;
+                }
+            }
+        }
+    }
+
+    if (op == "search" && searches > 0) {
+        step.hops_avg = static_cast<double>(total_hops) / searches;
+        step.files_avg = static_cast<double>(total_files) / searches;
+    }
+}
+
+bool DeletePerformanceTest::searchKeyword(const std::string& keyword, std::set<std::string>& found,
+                                          size_t& hops, double& search_ms, bool& verified) {
+    Json::Value params = search_params_[keyword];
+
+    // 未走到链尾时把 continuation 加入参数继续；只计搜索耗时，验证单独由阶段回调统计
+    while (true) {
+        SearchProofResult proof;
+        uint64_t t0 = perf_metrics::now_ns();
+        {
+            QuietCout quiet(quiet_node_output_);
+            proof = node_->ComputeSearchProof(params);
+        }
+        search_ms += perf_metrics::elapsed_ms(t0);
+        if (!proof.success) {
+            return false;
+        }
+        hops += static_cast<size_t>(proof.hops);
+        found.insert(proof.AS.begin(), proof.AS.end());
+
+        {
+            QuietCout quiet(quiet_node_output_);
+            verified = node_->VerifySearchProof(proof) && verified;
+        }
+
+        if (proof.complete) {
+            return true;
+        }
+        params["continuation"] = proof.continuation;
+    }
+}
+
+// ==================== 统计与报告 ====================
+
+void DeletePerformanceTest::printSummary() const {
+    std::cout << "\n" << std::string(110, '=') << std::endl;
+    std::cout << "删除性能测试总结 (每次删除调用 " << batch_size_ << " 个文件)" << std::endl;
+    std::cout << std::string(110, '=') << std::endl;
+    std::cout << std::right << std::setw(8) << "删除%" << std::setw(8) << "已删除" << std::setw(8) << "剩余"
+              << std::setw(12) << "删除p50" << std::setw(12) << "删除p99" << std::setw(12) << "搜索p50"
+              << std::setw(12) << "搜索p99" << std::setw(10) << "跳数" << std::setw(10) << "结果";
+    if (compaction_ == "after_step") {
+        std::cout << std::setw(12) << "回收ms" << std::setw(12) << "回收后p50";
+    }
+    std::cout << std::setw(8) << "异常" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& s : step_results_) {
+        std::cout << std::setw(8) << s.fraction * 100 << std::setw(8) << s.deleted << std::setw(8) << s.live_files
+                  << std::setw(12) << s.delete_ms.percentile_ms(50) << std::setw(12) << s.delete_ms.percentile_ms(99)
+                  << std::setw(12) << s.search_ms.percentile_ms(50) << std::setw(12) << s.search_ms.percentile_ms(99)
+                  << std::setw(10) << s.hops_avg << std::setw(10) << s.files_avg;
+        if (compaction_ == "after_step") {
+            std::cout << std::setw(12) << s.compaction.elapsed_ms << std::setw(12) << s.search_gc_ms.percentile_ms(50);
+        }
+        std::cout << std::setw(8) << (s.delete_failures + s.search_failures + s.leaked + s.missing) << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+}
+
+bool DeletePerformanceTest::saveDetailedReport(const std::string& csv_file) {
+    fs::create_directories(fs::path(csv_file).parent_path());
+    std::ofstream out(csv_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    out << "step,fraction,op,target,latency_ms,hops,files,success\n";
+    for (const auto& r : results_) {
+        out << r.step << "," << delete_fractions_[r.step] << "," << r.op << "," << r.target << "," << std::fixed
+            << std::setprecision(3) << r.latency_ms << "," << r.hops << "," << r.files << ","
+            << (r.success ? "true" : "false") << "\n";
+        out.unsetf(std::ios::fixed);
+    }
+    return true;
+}
+
+bool DeletePerformanceTest::saveStepReport(const std::string& csv_file) {
+    fs::create_directories(fs::path(csv_file).parent_path());
+    std::ofstream out(csv_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    out << "step,fraction,deleted,live_files,deleted_this_step,delete_failures,"
+        << "client_p50_ms,delete_mean_ms,delete_p50_ms,delete_p99_ms,batch_mean_ms,"
+        << "search_mean_ms,search_p50_ms,search_p99_ms,hops_avg,files_avg,"
+        << "compact_files,compact_ms,compact_bytes,search_gc_p50_ms,search_gc_p99_ms,"
+        << "search_failures,leaked,missing,index_db_bytes,search_db_bytes\n";
+    out << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < step_results_.size(); ++i) {
+        const StepResult& s = step_results_[i];
+        out << i << "," << s.fraction << "," << s.deleted << "," << s.live_files << "," << s.deleted_this_step << ","
+            << s.delete_failures << "," << s.client_ms.percentile_ms(50) << "," << s.delete_ms.mean_ns() / 1e6 << ","
+            << s.delete_ms.percentile_ms(50) << "," << s.delete_ms.percentile_ms(99) << ","
+            << s.batch_ms.mean_ns() / 1e6 << "," << s.search_ms.mean_ns() / 1e6 << ","
+            << s.search_ms.percentile_ms(50) << "," << s.search_ms.percentile_ms(99) << ","
+            << s.hops_avg << "," << s.files_avg << "," << s.compaction.files << "," << s.compaction.elapsed_ms << ","
+            << s.compaction.total_bytes() << "," << s.search_gc_ms.percentile_ms(50) << ","
+            << s.search_gc_ms.percentile_ms(99) << "," << s.search_failures << "," << s.leaked << ","
+            << s.missing << "," << s.index_db_bytes << "," << s.search_db_bytes << "\n";
+    }
+    return true;
+}
+
+bool DeletePerformanceTest::saveSummaryReport(const std::string& json_file) {
+    fs::create_directories(fs::path(json_file).parent_path());
+    Json::Value root;
+    root["test_info"]["test_name"] = test_name_;
+    root["test_info"]["start_time"] = start_time_;
+    root["test_info"]["end_time"] = end_time_;
+    root["test_info"]["files"] = files_;
+    root["test_info"]["keywords"] = keywords_;
+    root["test_info"]["keywords_per_file"] = keywords_per_file_;
+    root["test_info"]["file_size"] = static_cast<Json::UInt64>(file_size_);
+    root["test_info"]["batch_size"] = batch_size_;
+    root["test_info"]["search_rounds"] = search_rounds_;
+    root["test_info"]["compaction"] = compaction_;
+    root["test_info"]["seed"] = static_cast<Json::UInt64>(seed_);
+
+    auto latency_json = [](const perf_metrics::Histogram& h) {
+        Json::Value item;
+        item["count"] = static_cast<Json::UInt64>(h.count());
+        item["mean_ms"] = h.mean_ns() / 1e6;
+        item["p50_ms"] = h.percentile_ms(50);
+        item["p90_ms"] = h.percentile_ms(90);
+        item["p99_ms"] = h.percentile_ms(99);
+        item["max_ms"] = static_cast<double>(h.max_ns()) / 1e6;
+        return item;
+    };
+
+    Json::Value steps(Json::arrayValue);
+    int failures = 0;
+    for (const auto& s : step_results_) {
+        Json::Value step;
+        step["fraction"] = s.fraction;
+        step["deleted"] = static_cast<Json::UInt64>(s.deleted);
+        step["live_files"] = static_cast<Json::UInt64>(s.live_files);
+        step["deleted_this_step"] = static_cast<Json::UInt64>(s.deleted_this_step);
+        step["client_delete"] = latency_json(s.client_ms);
+        step["delete"] = latency_json(s.delete_ms);
+        step["delete"]["failures"] = s.delete_failures;
+        step["delete_call"] = latency_json(s.batch_ms);
+        step["search"] = latency_json(s.search_ms);
+        step["search"]["failures"] = s.search_failures;
+        step["search"]["hops_avg"] = s.hops_avg;
+        step["search"]["files_avg"] = s.files_avg;
+        step["correctness"]["leaked"] = s.leaked;
+        step["correctness"]["missing"] = s.missing;
+        if (compaction_ == "after_step") {
+            step["compaction"]["files"] = static_cast<Json::UInt64>(s.compaction.files);
+            step["compaction"]["elapsed_ms"] = s.compaction.elapsed_ms;
+            step["compaction"]["ciphertext_bytes"] = static_cast<Json::UInt64>(s.compaction.ciphertext_bytes);
+            step["compaction"]["metadata_bytes"] = static_cast<Json::UInt64>(s.compaction.metadata_bytes);
+            step["compaction"]["index_bytes"] = static_cast<Json::UInt64>(s.compaction.index_bytes);
+            step["search_gc"] = latency_json(s.search_gc_ms);
+        }
+        step["disk"]["index_db_bytes"] = static_cast<Json::UInt64>(s.index_db_bytes);
+        step["disk"]["search_db_bytes"] = static_cast<Json::UInt64>(s.search_db_bytes);
+        step["memory"] = s.node_memory.to_json();
+        steps.append(step);
+        failures += s.delete_failures + s.search_failures + s.leaked + s.missing;
+    }
+    root["forged_delete"]["attempts"] = forgery_.attempts;
+    root["forged_delete"]["accepted"] = forgery_.accepted;
+    root["forged_delete"]["search_failures"] = forgery_.search_failures;
+    failures += forgery_.accepted + forgery_.search_failures;
+    root["test_info"]["failure_count"] = failures;
+    root["steps"] = steps;
+    root["latency_percentiles"] = latency_.to_json();
+    root["op_counters"] = op_summary_.to_json();
+    root["passed"] = failures == 0;
+
+    std::ofstream out(json_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "  ";
+    out << Json::writeString(writer, root);
+    return true;
+}
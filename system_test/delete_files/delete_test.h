@@ -0,0 +1,133 @@
+#ifndef DELETE_PERFORMANCE_TEST_H
+#define DELETE_PERFORMANCE_TEST_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <filesystem>
+#include <jsoncpp/json/json.h>
+
+#include "../../vds-client/client.h"
+#include "../../Storage-node/storage_node.h"
+#include "../../common/perf_metrics.h"
+#include "../common/client_fixture.h"
+
+/**
+ * @brief 删除性能测试（删除延迟与已删除条目对搜索的影响）
+ *
+ * 初始化时在独立工作目录中用客户端生成 files 个文件（每个文件 keywords_per_file 个关键词，
+ * 取自 keywords 个关键词的池，因此每条关键词链上都混有之后被删除的文件），全部插入节点，
+ * 并生成每个关键词的搜索令牌。之后按 delete_fractions（累计删除比例，删除顺序随机）逐级：
+ *   delete  - 客户端 deleteFile 生成删除令牌，节点按 batch_size 执行删除：
+ *             1 时每个文件调用一次 delete_file_from_json（菜单路径，每次重新加载并保存数据库），
+ *             大于 1 时每批调用一次 delete_files_from_json（数据库整批加载、保存一次）
+ *   search  - 对每个关键词执行 ComputeSearchProof（超过单段跳数上限时按续传令牌分段）并验证，
+ *             检查返回的文件集合与未删除文件一致（已删除文件不得出现，未删除文件不得缺失）
+ *   compact - compaction 为 after_step 时执行 compact_deleted_files，再测一次搜索
+ * 删除开始前还会对一个未删除的文件发送伪造的删除令牌（另一文件的 del、以 PK 充当 del），
+ * 节点必须拒绝，且该文件所在关键词的搜索仍须通过验证并返回该文件。
+ * 链节点在删除与回收后都保留在搜索数据库中，搜索跳数不随删除减少，只是跳过已删除文件的证明计算。
+ * 删除比例为 1.0 时每条链上的文件都已删除，搜索返回空的 AS，证明仍须通过验证。
+ */
+class DeletePerformanceTest {
+public:
+    struct OpResult {
+        size_t step;           // 删除级别序号
+        std::string op;        // client_delete / delete / delete_batch / search / search_gc / compact
+        std::string target;    // 文件ID、关键词或批次序号
+        double latency_ms;
+        size_t hops;           // 搜索跳数（其他操作为批内文件数或0）
+        size_t files;          // 搜索返回的文件数
+        bool success;
+    };
+
+    struct StepResult {
+        double fraction = 0;           // 目标累计删除比例
+        size_t deleted = 0;            // 累计已删除文件数
+        size_t deleted_this_step = 0;
+        size_t live_files = 0;
+        int delete_failures = 0;
+        perf_metrics::Histogram client_ms;      // 客户端生成删除令牌
+        perf_metrics::Histogram delete_ms;      // 节点每个文件的删除耗时（批量时为批耗时 / 批内文件数）
+        perf_metrics::Histogram batch_ms;       // 节点每次删除调用的耗时
+        perf_metrics::Histogram search_ms;      // 单个关键词整条链的搜索耗时
+        perf_metrics::Histogram search_gc_ms;   // 回收后的搜索耗时
+        double hops_avg = 0;           // 每次搜索的平均跳数
+        double files_avg = 0;          // 每次搜索返回的平均文件数
+        int search_failures = 0;       // 搜索或验证失败
+        int leaked = 0;                // 搜索结果中出现的已删除文件
+        int missing = 0;               // 搜索结果中缺失的未删除文件
+        CompactionStats compaction;    // 本级回收统计（未回收时全为0）
+        uint64_t index_db_bytes = 0;
+        uint64_t search_db_bytes = 0;
+        MemoryUsage node_memory;       // 本级结束时节点各内存结构的估算占用
+    };
+
+    struct ForgeryResult {
+        int attempts = 0;
+        int accepted = 0;              // 节点接受了伪造的删除令牌
+        int search_failures = 0;       // 伪造请求之后搜索或验证失败，或结果缺少目标文件
+    };
+
+    DeletePerformanceTest();
+    ~DeletePerformanceTest();
+
+    bool loadConfig(const std::string& config_file);
+    bool initialize();
+    bool runTest();
+    bool saveDetailedReport(const std::string& csv_file);
+    bool saveStepReport(const std::string& csv_file);
+    bool saveSummaryReport(const std::string& json_file);
+
+private:
+    bool prepareCorpus();
+    void checkForgedDelete();
+    void runStep(size_t step_index, StepResult& step);
+    void deleteFiles(size_t step_index, const std::vector<std::string>& ids, StepResult& step);
+    void measureSearch(size_t step_index, const std::string& op, perf_metrics::Histogram& hist,
+                       StepResult& step);
+    bool searchKeyword(const std::string& keyword, std::set<std::string>& found, size_t& hops,
+                       double& search_ms, bool& verified);
+    void printSummary() const;
+
+    // 配置
+    std::string test_name_;
+    std::string public_params_file_;
+    std::string work_dir_;
+    std::vector<double> delete_fractions_;
+    int files_;                 // 语料文件数
+    int keywords_;              // 关键词池大小
+    int keywords_per_file_;
+    size_t file_size_;
+    int batch_size_;            // 节点每次删除调用的文件数
+    int search_rounds_;         // 每级每个关键词的搜索次数
+    std::string compaction_;    // none / after_step
+    uint64_t seed_;             // 删除顺序的随机种子
+    bool quiet_node_output_;
+    bool reset_work_dir_;
+    bool verbose_;
+
+    // 组件
+    StorageClient* client_;
+    StorageNode* node_;
+    PerformanceCallback_s callback_s_;
+    perf_metrics::Registry latency_;              // 节点各阶段延迟直方图（删除与搜索）
+    perf_metrics::OpCounterSummary op_summary_;
+
+    // 数据
+    std::vector<std::string> file_ids_;                           // 删除顺序
+    std::map<std::string, std::vector<std::string>> keyword_files_;   // 关键词 -> 文件ID
+    std::map<std::string, Json::Value> search_params_;            // 关键词 -> 搜索参数
+    std::set<std::string> deleted_;
+    size_t next_delete_;
+
+    // 结果
+    std::vector<OpResult> results_;
+    std::vector<StepResult> step_results_;
+    ForgeryResult forgery_;
+    std::string start_time_;
+    std::string end_time_;
+};
+
+#endif // DELETE_PERFORMANCE_TEST_H
@@ -0,0 +1,37 @@
+/*
+ * main.cpp - 删除性能测试主程序
+ *
+ * 使用 DeletePerformanceTest 类测量删除延迟及已删除条目对搜索的影响
+ *
+ * 编译:
+ *   make
+ *
+ * 运行:
+ *   ./delete_perf_test [配置文件路径]
+ *   默认配置: system_test/delete_files/config/delete_test_config.json
+ */
+
+#include "delete_test.h"
+#include "../common/harness_main.h"
+
+int main(int argc, char* argv[]) {
+    harness_main::Spec spec;
+    spec.icon = "🗑️";
+    spec.name = "删除性能测试";
+    spec.run_label = "运行删除性能测试";
+    spec.default_config = "system_test/delete_files/config/delete_test_config.json";
+    // 删除失败或搜索结果不一致时仍保存报告，便于对照 delete_detailed.csv 排查
+    spec.save_on_failure = true;
+    spec.failure_note = "存在删除失败或搜索结果不一致";
+
+    return harness_main::run_harness<DeletePerformanceTest>(argc, argv, spec, [](DeletePerformanceTest& test) {
+        return std::vector<harness_main::Report>{
+            {"详细报告", "system_test/delete_files/results/delete_detailed.csv",
+             [&test](const std::string& p) { return test.saveDetailedReport(p); }},
+            {"分级报告", "system_test/delete_files/results/delete_steps.csv",
+             [&test](const std::string& p) { return test.saveStepReport(p); }},
+            {"总结报告", "system_test/delete_files/results/delete_summary.json",
+             [&test](const std::string& p) { return test.saveSummaryReport(p); }}
+        };
+    });
+}
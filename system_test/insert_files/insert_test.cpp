@@ -19,11 +19,14 @@ InsertPerformanceTest::InsertPerformanceTest()
       max_files_(0),
       verbose_(true),
       save_intermediate_(true),
+      element_format_("compressed_base64"),
+      insert_bundle_(true),
       server_port_(9000) {
     
     // 设置性能监控回调
     callback_s.on_phase_complete = [this](const std::string& name, double time_ms) {
         current_times_[name] = time_ms;
+        latency_.record_ms(name, time_ms);
         if (verbose_) {
             std::cout << "  [TIME] " << name << ": " << time_ms << " ms" << std::endl;
         }
@@ -35,8 +38,12 @@ InsertPerformanceTest::InsertPerformanceTest()
             std::cout << "  [SIZE] " << name << ": " << size_bytes << " bytes" << std::endl;
         }
     };
+    callback_s.on_op_counters = [this](const std::string& name, const perf_metrics::OpCounters& counters) {
+        op_summary_.record(name, counters);
+    };
     callback_c.on_phase_complete = [this](const std::string& name, double time_ms) {
         current_times_[name] = time_ms;
+        latency_.record_ms(name, time_ms);
         if (verbose_) {
             std::cout << "  [TIME] " << name << ": " << time_ms << " ms" << std::endl;
         }
@@ -103,6 +110,8 @@ bool InsertPerformanceTest::loadConfig(const std::string& config_file) {
     max_files_ = options.get("max_files", 0).asInt();
     verbose_ = options.get("verbose", true).asBool();
     save_intermediate_ = options.get("save_intermediate", true).asBool();
+    element_format_ = options.get("element_format", "compressed_base64").asString();
+    insert_bundle_ = options.get("insert_bundle", true).asBool();
     
     statistics_.test_name = config.get("test_name", "insert_performance").asString();
     
@@ -244,6 +253,17 @@ bool InsertPerformanceTest::initialize() {
         client_->saveKeys(private_key_file_);
     }
     
+    // 设置元素序列化格式（影响 insert.json 大小）
+    ElementFormat element_format;
+    if (!element_codec::parse_format(element_format_, element_format)) {
+        std::cerr << "[错误] 不支持的 element_format: " << element_format_ << std::endl;
+        return false;
+    }
+    client_->setElementFormat(element_format);
+    
+    // 插入请求形式：单个 .vdsb 请求包，或旧版 .enc + insert.json
+    client_->setInsertBundleMode(insert_bundle_);
+    
     // 设置性能监控回调
     client_->setPerformanceCallback_c(&callback_c);
     
@@ -345,10 +365,9 @@ bool InsertPerformanceTest::runTest() {
     }
     
     auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
     
     statistics_.end_time = getCurrentTimestamp();
-    statistics_.total_duration_sec = duration.count() / 1000.0;
+    statistics_.total_duration_sec = std::chrono::duration<double>(end - start).count();
     statistics_.total_files = results_.size();
     
     // 计算统计数据
@@ -392,8 +411,10 @@ InsertPerformanceTest::FileTestResult InsertPerformanceTest::testSingleFile(
         // 步骤2：服务端插入文件
         std::cout << "  [步骤2] 服务端插入文件..." << std::endl;
         
-        // 找到生成的insert.json和.enc文件（与客户端命名规则一致：绝对路径+分隔符替换）
+        // 找到生成的插入请求（与客户端命名规则一致：绝对路径+分隔符替换）
         std::string safe_name = makeSafeName(file_path);
+        std::string client_bundle = client_insert_dir_ + "/" + safe_name + insert_bundle::kExtension;
+        std::string server_bundle = server_insert_dir_ + "/" + safe_name + insert_bundle::kExtension;
         std::string client_enc_file = client_enc_dir_ + "/" + safe_name + ".enc";
         std::string client_insert_json = client_insert_dir_ + "/" + safe_name + "_insert.json";
         std::string server_enc_file = server_enc_dir_ + "/" + safe_name + ".enc";
@@ -401,16 +422,26 @@ InsertPerformanceTest::FileTestResult InsertPerformanceTest::testSingleFile(
         
         std::string enc_file = fs::exists(server_enc_file) ? server_enc_file : client_enc_file;
         std::string insert_json = fs::exists(server_insert_json) ? server_insert_json : client_insert_json;
+        std::string bundle_file;
+        if (insert_bundle_) {
+            bundle_file = fs::exists(server_bundle) ? server_bundle : client_bundle;
+        }
         
         if (verbose_) {
-            std::cout << "    使用的insert.json路径: " << insert_json << std::endl;
-            std::cout << "    使用的密文路径: " << enc_file << std::endl;
+            if (insert_bundle_) {
+                std::cout << "    使用的请求包路径: " << bundle_file << std::endl;
+            } else {
+                std::cout << "    使用的insert.json路径: " << insert_json << std::endl;
+                std::cout << "    使用的密文路径: " << enc_file << std::endl;
+            }
         }
         
         // 清理性能数据
         clearPerformanceData();
         
-        if (!server_->insert_file(insert_json, enc_file)) {
+        bool inserted = insert_bundle_ ? server_->insert_bundle(bundle_file)
+                                       : server_->insert_file(insert_json, enc_file);
+        if (!inserted) {
             result.error_msg = "服务端插入失败";
             return result;
         }
@@ -607,6 +638,8 @@ bool InsertPerformanceTest::saveSummaryReport(const std::string& json_file) {
     
     // 测试信息
     root["test_info"]["test_name"] = statistics_.test_name;
+    root["test_info"]["element_format"] = element_format_;
+    root["test_info"]["insert_bundle"] = insert_bundle_;
     root["test_info"]["start_time"] = statistics_.start_time;
     root["test_info"]["end_time"] = statistics_.end_time;
     root["test_info"]["total_duration_sec"] = statistics_.total_duration_sec;
@@ -641,6 +674,15 @@ bool InsertPerformanceTest::saveSummaryReport(const std::string& json_file) {
     root["statistics"]["throughput"]["client_mbps_avg"] = statistics_.client_throughput_avg;
     root["statistics"]["throughput"]["server_mbps_avg"] = statistics_.server_throughput_avg;
     
+    // 延迟分位数（客户端与服务端各阶段）
+    root["statistics"]["latency_percentiles"] = latency_.to_json();
+    root["statistics"]["op_counters"] = op_summary_.to_json();
+    
+    // 插入完成后节点各内存结构的估算占用
+    if (server_) {
+        root["statistics"]["memory"] = server_->get_memory_usage().to_json();
+    }
+    
     // 分组统计
     for (const auto& group : statistics_.size_groups) {
         for (const auto& metric : group.second) {
@@ -665,6 +707,22 @@ bool InsertPerformanceTest::saveSummaryReport(const std::string& json_file) {
     return true;
 }
 
+bool InsertPerformanceTest::saveLatencyReport(const std::string& csv_file) {
+    std::cout << "[报告] 保存延迟分位数: " << csv_file << std::endl;
+    
+    std::ofstream ofs(csv_file);
+    if (!ofs.is_open()) {
+        std::cerr << "[错误] 无法创建CSV文件: " << csv_file << std::endl;
+        return false;
+    }
+    latency_.write_csv(ofs);
+    ofs.close();
+    
+    std::cout << "[报告] ✅ 延迟分位数已保存" << std::endl;
+    
+    return true;
+}
+
 // ==================== 辅助函数 ====================
 
 void InsertPerformanceTest::printProgress(int current, int total) {
@@ -693,6 +751,8 @@ void InsertPerformanceTest::printSummary() {
     
     std::cout << "\n📊 基本信息:" << std::endl;
     std::cout << "  测试名称: " << statistics_.test_name << std::endl;
+    std::cout << "  元素格式: " << element_format_ << std::endl;
+    std::cout << "  插入请求: " << (insert_bundle_ ? "单个 .vdsb 请求包" : ".enc + insert.json") << std::endl;
     std::cout << "  开始时间: " << statistics_.start_time << std::endl;
     std::cout << "  结束时间: " << statistics_.end_time << std::endl;
     std::cout << "  总耗时: " << statistics_.total_duration_sec << " 秒" << std::endl;
@@ -712,6 +772,17 @@ void InsertPerformanceTest::printSummary() {
     std::cout << "    最大: " << statistics_.t3_max << " ms" << std::endl;
     std::cout << "    标准差: " << statistics_.t3_stddev << " ms" << std::endl;
     
+    std::cout << "\n📊 延迟分位数 (毫秒):" << std::endl;
+    for (const auto& kv : latency_.snapshot()) {
+        const perf_metrics::Histogram& h = kv.second;
+        std::cout << "  " << kv.first << ": p50=" << h.percentile_ms(50)
+                  << ", p90=" << h.percentile_ms(90)
+                  << ", p99=" << h.percentile_ms(99)
+                  << ", p999=" << h.percentile_ms(99.9)
+                  << ", max=" << static_cast<double>(h.max_ns()) / 1e6
+                  << " (n=" << h.count() << ")" << std::endl;
+    }
+    
     std::cout << "\n💾 数据大小统计:" << std::endl;
     std::cout << "  S1 (明文): 平均 " << statistics_.s1_avg << " bytes, 总计 " << statistics_.s1_total << " bytes" << std::endl;
     std::cout << "  S2 (密文): 平均 " << statistics_.s2_avg << " bytes, 总计 " << statistics_.s2_total << " bytes" << std::endl;
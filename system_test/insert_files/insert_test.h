@@ -13,6 +13,7 @@
 #include <jsoncpp/json/json.h>
 #include "../../vds-client/client.h"
 #include "../../Storage-node/storage_node.h"
+#include "../../common/perf_metrics.h"
 
 /**
  * @brief 插入操作性能测试类
@@ -133,6 +134,13 @@ public:
      */
     bool saveSummaryReport(const std::string& json_file);
     
+    /**
+     * @brief 保存各阶段延迟分位数（CSV格式，每个指标一行）
+     * @param csv_file 输出CSV文件路径
+     * @return 成功返回true
+     */
+    bool saveLatencyReport(const std::string& csv_file);
+    
     /**
      * @brief 打印测试进度
      */
@@ -163,6 +171,8 @@ private:
     int max_files_;                    // 最大测试文件数（0=全部）
     bool verbose_;                     // 是否显示详细日志
     bool save_intermediate_;           // 是否保存中间文件
+    std::string element_format_;       // 客户端G1元素格式（compressed_base64 / uncompressed_hex）
+    bool insert_bundle_;               // 是否使用单个 .vdsb 插入请求包
     
     // ==================== 核心组件 ====================
     StorageClient* client_;            // 客户端实例
@@ -184,6 +194,12 @@ private:
     std::map<std::string, double> current_times_;
     std::map<std::string, size_t> current_sizes_;
     
+    // 各阶段延迟直方图（跨文件累计，用于分位数统计）
+    perf_metrics::Registry latency_;
+    
+    // 服务端插入请求的密码学操作与数据量计数
+    perf_metrics::OpCounterSummary op_summary_;
+    
     // ==================== 私有方法 ====================
     
     /**
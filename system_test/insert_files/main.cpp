@@ -85,6 +85,7 @@ int main(int argc, char* argv[]) {
 
     std::string csv_file = "system_test/insert_files/results/insert_detailed.csv";
     std::string json_file = "system_test/insert_files/results/insert_summary.json";
+    std::string latency_file = "system_test/insert_files/results/insert_latency.csv";
 
     if (!test.saveDetailedReport(csv_file)) {
         std::cerr << "⚠️  警告: 详细报告保存失败" << std::endl;
@@ -98,6 +99,12 @@ int main(int argc, char* argv[]) {
         std::cout << "✅ 总结报告已保存: " << json_file << std::endl;
     }
 
+    if (!test.saveLatencyReport(latency_file)) {
+        std::cerr << "⚠️  警告: 延迟分位数保存失败" << std::endl;
+    } else {
+        std::cout << "✅ 延迟分位数已保存: " << latency_file << std::endl;
+    }
+
     // 打印最终总结
     std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
     std::cout << "✅ 测试完成" << std::endl;
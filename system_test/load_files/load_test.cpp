@@ -0,0 +1,753 @@
+#include "load_test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+using test_fixture::load_json;
+
+namespace {
+
+const std::vector<std::string> kOps = {"insert", "search", "delete", "audit"};
+
+Json::Value histogram_json(const perf_metrics::Histogram& h) {
+    Json::Value item;
+    item["count"] = static_cast<Json::UInt64>(h.count());
+    item["mean_ms"] = h.mean_ns() / 1e6;
+    item["p50_ms"] = h.percentile_ms(50);
+    item["p90_ms"] = h.percentile_ms(90);
+    item["p99_ms"] = h.percentile_ms(99);
+    item["p999_ms"] = h.percentile_ms(99.9);
+    item["max_ms"] = static_cast<double>(h.max_ns()) / 1e6;
+    return item;
+}
+
+} // namespace
+
+LoadGeneratorTest::LoadGeneratorTest()
+    : port_(0),
+      workers_(0),
+      identities_(4),
+      connections_(8),
+      rate_(20.0),
+      duration_s_(30.0),
+      poisson_(true),
+      preload_files_(16),
+      file_size_(8 * 1024),
+      search_keywords_(4),
+      keywords_per_file_(2),
+      insert_headroom_(1.2),
+      report_interval_s_(1.0),
+      max_outstanding_(1000),
+      reset_work_dir_(true),
+      verbose_(false),
+      node_(nullptr),
+      server_(nullptr),
+      arrivals_(0),
+      dropped_(0),
+      run_wall_s_(0) {}
+
+LoadGeneratorTest::~LoadGeneratorTest() {
+    if (server_) {
+        server_->stop();
+        delete server_;
+    }
+    delete node_;
+}
+
+// ==================== 配置与初始化 ====================
+
+bool LoadGeneratorTest::loadConfig(const std::string& config_file) {
+    Json::Value config;
+    if (!load_json(config_file, config)) {
+        std::cerr << "[错误] 无法读取配置文件: " << config_file << std::endl;
+        return false;
+    }
+
+    test_name_ = config.get("test_name", "load generator").asString();
+
+    const Json::Value& paths = config["paths"];
+    public_params_file_ = paths.get("public_params", "vds-client/data/public_params.json").asString();
+    work_dir_ = paths.get("work_dir", "system_test/load_files/data/work").asString();
+
+    const Json::Value& server = config["server"];
+    host_ = server.get("host", "").asString();
+    port_ = server.get("port", 0).asInt();
+    workers_ = server.get("workers", 0).asInt();
+    record_dir_ = server.get("record_dir", "").asString();
+    if (!host_.empty() && port_ <= 0) {
+        std::cerr << "[错误] 连接外部节点时必须指定 server.port" << std::endl;
+        return false;
+    }
+
+    const Json::Value& options = config["options"];
+    identities_ = std::max(1, options.get("identities", 4).asInt());
+    connections_ = std::max(1, options.get("connections", 8).asInt());
+    rate_ = options.get("rate", 20.0).asDouble();
+    duration_s_ = options.get("duration_s", 30.0).asDouble();
+    std::string arrival = options.get("arrival", "poisson").asString();
+    if (arrival != "poisson" && arrival != "uniform") {
+        std::cerr << "[错误] 未知的到达过程: " << arrival << " (poisson / uniform)" << std::endl;
+        return false;
+    }
+    poisson_ = arrival == "poisson";
+    if (rate_ <= 0 || duration_s_ <= 0) {
+        std::cerr << "[错误] rate 与 duration_s 必须为正数" << std::endl;
+        return false;
+    }
+
+    const Json::Value& mix = options["mix"];
+    double total = 0;
+    for (const auto& op : kOps) {
+        mix_[op] = std::max(0.0, mix.get(op, 0.0).asDouble());
+        total += mix_[op];
+    }
+    if (total <= 0) {
+        std::cerr << "[错误] options.mix 中至少一个请求类型的比例须大于0" << std::endl;
+        return false;
+    }
+    for (auto& kv : mix_) {
+        kv.second /= total;
+    }
+
+    preload_files_ = std::max(1, options.get("preload_files", 16).asInt());
+    file_size_ = options.get("file_size", 8 * 1024).asUInt64();
+    search_keywords_ = std::max(1, options.get("search_keywords", 4).asInt());
+    keywords_per_file_ = std::min(search_keywords_, std::max(1, options.get("keywords_per_file", 2).asInt()));
+    insert_headroom_ = std::max(1.0, options.get("insert_headroom", 1.2).asDouble());
+    report_interval_s_ = std::max(0.1, options.get("report_interval_s", 1.0).asDouble());
+    max_outstanding_ = std::max<Json::UInt64>(1, options.get("max_outstanding", 1000).asUInt64());
+    reset_work_dir_ = options.get("reset_work_dir", true).asBool();
+    verbose_ = options.get("verbose", false).asBool();
+
+    std::cout << "[配置] 工作目录: " << work_dir_ << std::endl;
+    std::cout << "[配置] 节点: " << (host_.empty() ? std::string("进程内 127.0.0.1") : host_ + ":" + std::to_string(port_))
+              << ", 并发连接 " << connections_ << ", 客户端身份 " << identities_ << std::endl;
+    std::cout << "[配置] 目标到达率: " << rate_ << " 请求/秒 (" << arrival << "), 持续 " << duration_s_ << " 秒" << std::endl;
+    std::cout << "[配置] 请求比例:";
+    for (const auto& op : kOps) {
+        std::cout << " " << op << "=" << std::fixed << std::setprecision(2) << mix_[op];
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::endl;
+    return true;
+}
+
+bool LoadGeneratorTest::initialize() {
+    if (reset_work_dir_ && fs::exists(work_dir_)) {
+        std::cout << "[初始化] 清空工作目录: " << work_dir_ << std::endl;
+        fs::remove_all(work_dir_);
+    }
+    fs::create_directories(work_dir_ + "/plain");
+
+    if (host_.empty()) {
+        std::string node_dir = work_dir_ + "/node";
+        fs::create_directories(node_dir);
+        node_ = new StorageNode(node_dir, port_);
+        if (!node_->load_public_params(public_params_file_)) {
+            std::cerr << "[错误] 服务端加载公共参数失败" << std::endl;
+            return false;
+        }
+        if (!node_->initialize_directories()) {
+            std::cerr << "[错误] 服务端目录初始化失败" << std::endl;
+            return false;
+        }
+        node_->load_index_database();
+        node_->load_search_database();
+
+        server_ = new NodeServer(node_, port_, workers_, "127.0.0.1");
+        std::string error;
+        if (!record_dir_.empty() && !server_->start_recording(record_dir_, error)) {
+            std::cerr << "[错误] 请求录制开启失败: " << error << std::endl;
+            return false;
+        }
+        if (!server_->start()) {
+            std::cerr << "[错误] 服务启动失败" << std::endl;
+            return false;
+        }
+        host_ = "127.0.0.1";
+        port_ = server_->port();
+        std::cout << "[初始化] 服务监听 127.0.0.1:" << port_ << std::endl;
+        if (!record_dir_.empty()) {
+            std::cout << "[初始化] 请求录制: " << record_dir_ << std::endl;
+        }
+    } else if (!record_dir_.empty()) {
+        std::cout << "⚠️  连接外部节点时忽略 server.record_dir（在节点上使用 --record）" << std::endl;
+    }
+
+    // 按期望请求数（含余量）为每个身份预生成插入请求包与删除令牌
+    auto per_identity = [this](const std::string& op) {
+        double expected = rate_ * duration_s_ * mix_[op] * insert_headroom_ / identities_;
+        return mix_[op] > 0 ? static_cast<size_t>(std::ceil(expected)) + 1 : 0;
+    };
+    size_t insert_count = per_identity("insert");
+    size_t delete_count = per_identity("delete");
+
+    std::cout << "\n[准备] 每个身份: 审计/搜索文件 " << preload_files_ << ", 待删除文件 " << delete_count
+              << ", 运行中插入 " << insert_count << std::endl;
+    for (int i = 0; i < identities_; ++i) {
+        if (!prepareIdentity(i, insert_count, delete_count)) {
+            return false;
+        }
+    }
+    return preload();
+}
+
+// 客户端不是线程安全的且数据目录为全局配置：逐个身份生成全部请求，运行阶段只发送预生成的请求
+bool LoadGeneratorTest::prepareIdentity(int id, size_t insert_count, size_t delete_count) {
+    auto identity = std::make_unique<Identity>();
+    identity->id = id;
+
+    std::string client_dir = work_dir_ + "/client_" + std::to_string(id);
+    fs::create_directories(client_dir);
+    StorageClient client;
+    StorageClient::configureDataDirectories(client_dir);
+    if (!client.initialize(public_params_file_) || !client.initializeDataDirectories()) {
+        std::cerr << "[错误] 客户端 " << id << " 初始化失败" << std::endl;
+        return false;
+    }
+    std::string key_file = client_dir + "/private_key.dat";
+    if (!client.loadKeys(key_file)) {
+        if (!client.generateKeys(key_file)) {
+            std::cerr << "[错误] 客户端 " << id << " 密钥生成失败" << std::endl;
+            return false;
+        }
+        client.saveKeys(key_file);
+    }
+    client.setInsertBundleMode(true);
+
+    std::string prefix = "id" + std::to_string(id);
+    std::vector<std::string> search_pool;
+    for (int k = 0; k < search_keywords_; ++k) {
+        search_pool.push_back(prefix + "_kw_" + std::to_string(k));
+    }
+
+    // 预置文件：前 preload_files 个作为审计目标，其余在运行中删除
+    std::vector<std::string> ids;
+    int preload_count = preload_files_ + static_cast<int>(delete_count);
+    if (!encryptFiles(client, client_dir, prefix + "_pre", preload_count, search_pool, keywords_per_file_,
+                      identity->preload_bundles, &ids)) {
+        return false;
+    }
+    identity->audit_ids.assign(ids.begin(), ids.begin() + preload_files_);
+
+    for (const auto& kw : search_pool) {
+        Json::Value params;
+        if (!client.searchKeyword(kw) || !load_json(client_dir + "/Search/" + kw + ".json", params)) {
+            std::cerr << "[错误] 搜索令牌生成失败: " << kw << std::endl;
+            return false;
+        }
+        identity->search_params.push_back(params);
+    }
+
+    for (size_t i = static_cast<size_t>(preload_files_); i < ids.size(); ++i) {
+        Json::Value params;
+        if (!client.deleteFile(ids[i]) || !load_json(client_dir + "/Deles/" + ids[i] + ".json", params)) {
+            std::cerr << "[错误] 删除令牌生成失败: " << ids[i] << std::endl;
+            return false;
+        }
+        identity->delete_params.push_back(params);
+    }
+
+    // 运行中插入的文件使用各自独立的关键词：并发插入的先后顺序不影响任何关键词链，
+    // 也不改变搜索关键词的状态（搜索令牌已在上面生成）
+    std::vector<std::string> insert_pool;
+    for (size_t k = 0; k < insert_count * keywords_per_file_; ++k) {
+        insert_pool.push_back(prefix + "_new_" + std::to_string(k));
+    }
+    if (!encryptFiles(client, client_dir, prefix + "_new", static_cast<int>(insert_count), insert_pool,
+                      keywords_per_file_, identity->insert_bundles, nullptr)) {
+        return false;
+    }
+
+    std::cout << "   ├─ 身份 " << id << ": 预置 " << identity->preload_bundles.size() << ", 插入 "
+              << identity->insert_bundles.size() << ", 搜索令牌 " << identity->search_params.size()
+              << ", 删除令牌 " << identity->delete_params.size() << std::endl;
+    identity_data_.push_back(std::move(identity));
+    return true;
+}
+
+bool LoadGeneratorTest::encryptFiles(StorageClient& client, const std::string& client_dir,
+                                     const std::string& prefix, int count,
+                                     const std::vector<std::string>& keyword_pool, int keywords_per_file,
+                                     std::vector<std::string>& bundles, std::vector<std::string>* ids) {
+    std::mt19937_64 rng(std::random_device{}());
+    size_t per_file = std::min<size_t>(keywords_per_file, keyword_pool.size());
+
+    for (int i = 0; i < count; ++i) {
+        std::vector<std::string> keywords =
+            test_fixture::pick_keywords(keyword_pool, static_cast<size_t>(i) * per_file, per_file);
+        test_fixture::EncryptedFile file;
+        if (!test_fixture::encrypt_random_file(client, client_dir,
+                                               work_dir_ + "/plain/" + prefix + "_" + std::to_string(i) + ".bin",
+                                               file_size_, keywords, rng, file)) {
+            return false;
+        }
+        std::string bytes;
+        if (!test_fixture::read_whole_file(file.bundle_path, bytes)) {
+            std::cerr << "[错误] 请求包读取失败: " << file.bundle_path << std::endl;
+            return false;
+        }
+        if (ids) {
+            ids->push_back(file.bundle.ID_F);
+        }
+        bundles.push_back(std::move(bytes));
+    }
+    return true;
+}
+
+bool LoadGeneratorTest::preload() {
+    node_protocol::Client conn;
+    if (!conn.connect(host_, port_)) {
+        std::cerr << "[错误] 连接失败: " << conn.last_error() << std::endl;
+        return false;
+    }
+    size_t inserted = 0;
+    for (const auto& identity : identity_data_) {
+        for (const auto& bundle : identity->preload_bundles) {
+            Json::Value req;
+            req["op"] = "insert";
+            node_protocol::Message resp;
+            std::string error;
+            if (!call(conn, req, bundle, resp, error)) {
+                std::cerr << "[错误] 预置文件插入失败 (身份 " << identity->id << "): " << error << std::endl;
+                return false;
+            }
+            inserted++;
+        }
+        identity->preload_bundles.clear();
+    }
+    std::cout << "[准备] 完成: 已预置 " << inserted << " 个文件" << std::endl;
+    return true;
+}
+
+// ==================== 测试执行 ====================
+
+bool LoadGeneratorTest::call(node_protocol::Client& conn, const Json::Value& request,
+                             const std::string& payload, node_protocol::Message& response,
+                             std::string& error) {
+    if (!conn.call(request, payload, response)) {
+        error = conn.last_error();
+        return false;
+    }
+    if (!response.header.get("ok", false).asBool()) {
+        error = response.header.get("error", "未知错误").asString();
+        return false;
+    }
+    return true;
+}
+
+bool LoadGeneratorTest::execute(node_protocol::Client& conn, const Task& task, OpResult& result,
+                                std::mt19937_64& rng) {
+    Identity& identity = *identity_data_[task.identity];
+    node_protocol::Message resp;
+    Json::Value req;
+
+    if (task.op == "insert") {
+        size_t i = identity.next_insert++;
+        if (i >= identity.insert_bundles.size()) {
+            result.skipped = true;
+            result.error_msg = "预生成的插入请求已用完";
+            return false;
+        }
+        req["op"] = "insert";
+        return call(conn, req, identity.insert_bundles[i], resp, result.error_msg);
+    }
+
+    if (task.op == "search") {
+        std::uniform_int_distribution<size_t> pick(0, identity.search_params.size() - 1);
+        req["op"] = "search";
+        req["params"] = identity.search_params[pick(rng)];
+        return call(conn, req, "", resp, result.error_msg);
+    }
+
+    if (task.op == "delete") {
+        size_t i = identity.next_delete++;
+        if (i >= identity.delete_params.size()) {
+            result.skipped = true;
+            result.error_msg = "预生成的删除令牌已用完";
+            return false;
+        }
+        req["op"] = "delete";
+        req["params"] = identity.delete_params[i];
+        return call(conn, req, "", resp, result.error_msg);
+    }
+
+    // audit：取持有性证明并验证，审计目标在运行中不会被删除
+    std::uniform_int_distribution<size_t> pick(0, identity.audit_ids.size() - 1);
+    req["op"] = "file_proof";
+    req["ID_F"] = identity.audit_ids[pick(rng)];
+    if (!call(conn, req, "", resp, result.error_msg)) {
+        return false;
+    }
+    Json::Value verify;
+    verify["op"] = "verify_file";
+    verify["proof"] = resp.header["result"];
+    if (!call(conn, verify, "", resp, result.error_msg)) {
+        return false;
+    }
+    if (!resp.header["result"].get("valid", false).asBool()) {
+        result.error_msg = "文件证明验证未通过";
+        return false;
+    }
+    return true;
+}
+
+bool LoadGeneratorTest::runTest() {
+    start_time_ = test_fixture::current_timestamp();
+    std::cout << "\n[运行] 开环负载: " << rate_ << " 请求/秒 x " << duration_s_ << " 秒, "
+              << connections_ << " 个连接" << std::endl;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<Task> queue;
+    bool dispatch_done = false;
+    std::atomic<uint64_t> completed(0);
+    std::atomic<uint64_t> failed(0);
+    std::atomic<int> active_workers(connections_);
+    std::mutex results_mutex;
+    bool connect_failed = false;
+
+    uint64_t run_start = perf_metrics::now_ns();
+    uint64_t duration_ns = static_cast<uint64_t>(duration_s_ * 1e9);
+
+    // 调度线程：按计划到达时刻入队，不等待响应（开环）
+    std::thread dispatcher([&]() {
+        std::mt19937_64 rng(std::random_device{}());
+        std::exponential_distribution<double> gap_poisson(rate_);
+        std::vector<double> weights;
+        for (const auto& op : kOps) {
+            weights.push_back(mix_[op]);
+        }
+        std::discrete_distribution<size_t> pick_op(weights.begin(), weights.end());
+        std::uniform_int_distribution<int> pick_identity(0, identities_ - 1);
+
+        double t = 0;
+        while (true) {
+            t += poisson_ ? gap_poisson(rng) : 1.0 / rate_;
+            uint64_t intended = static_cast<uint64_t>(t * 1e9);
+            if (intended >= duration_ns) {
+                break;
+            }
+            uint64_t now = perf_metrics::now_ns() - run_start;
+            if (intended > now) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(intended - now));
+            }
+            Task task{kOps[pick_op(rng)], pick_identity(rng), intended};
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            arrivals_++;
+            if (queue.size() >= max_outstanding_) {
+                dropped_++;
+                continue;
+            }
+            queue.push_back(std::move(task));
+            queue_cv.notify_one();
+        }
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        dispatch_done = true;
+        queue_cv.notify_all();
+    });
+
+    std::vector<std::thread> pool;
+    for (int w = 0; w < connections_; ++w) {
+        pool.emplace_back([&, w]() {
+            std::mt19937_64 rng(std::random_device{}() + w);
+            node_protocol::Client conn;
+            if (!conn.connect(host_, port_)) {
+                std::lock_guard<std::mutex> lock(results_mutex);
+                std::cerr << "[错误] 连接失败: " << conn.last_error() << std::endl;
+                connect_failed = true;
+                active_workers--;
+                return;
+            }
+            std::vector<OpResult> local;
+            while (true) {
+                Task task;
+                {
+                    std::unique_lock<std::mutex> lock(queue_mutex);
+                    queue_cv.wait(lock, [&]() { return dispatch_done || !queue.empty(); });
+                    if (queue.empty()) {
+                        break;
+                    }
+                    task = std::move(queue.front());
+                    queue.pop_front();
+                }
+
+                OpResult r;
+                r.op = task.op;
+                r.identity = task.identity;
+                r.intended_ns = task.intended_ns;
+                r.skipped = false;
+                r.start_ns = perf_metrics::now_ns() - run_start;
+                if (!conn.connected() && !conn.connect(host_, port_)) {
+                    r.success = false;
+                    r.error_msg = "重新连接失败: " + conn.last_error();
+                } else {
+                    r.success = execute(conn, task, r, rng);
+                }
+                r.end_ns = perf_metrics::now_ns() - run_start;
+                if (!r.skipped) {
+                    completed++;
+                    if (!r.success) {
+                        failed++;
+                    }
+                }
+                local.push_back(std::move(r));
+            }
+            std::lock_guard<std::mutex> lock(results_mutex);
+            results_.insert(results_.end(), local.begin(), local.end());
+            active_workers--;
+        });
+    }
+
+    // 主线程：按报告间隔打印进度
+    uint64_t last_completed = 0;
+    auto interval = std::chrono::duration<double>(report_interval_s_);
+    while (active_workers > 0) {
+        std::this_thread::sleep_for(interval);
+        size_t depth;
+        uint64_t dropped;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            depth = queue.size();
+            dropped = dropped_;
+        }
+        uint64_t done = completed;
+        std::cout << "   [" << std::fixed << std::setprecision(1) << perf_metrics::elapsed_ms(run_start) / 1000.0
+                  << " s] 完成 " << done << " (+" << std::setprecision(1)
+                  << (done - last_completed) / report_interval_s_ << "/s), 失败 " << failed
+                  << ", 排队 " << depth << ", 丢弃 " << dropped << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+        last_completed = done;
+    }
+
+    dispatcher.join();
+    for (auto& th : pool) {
+        th.join();
+    }
+    // 所有连接都已退出时队列中剩余的请求未被发送，计为丢弃
+    dropped_ += queue.size();
+    run_wall_s_ = perf_metrics::elapsed_ms(run_start) / 1000.0;
+
+    for (const auto& r : results_) {
+        if (r.skipped) {
+            continue;
+        }
+        latency_.record_ns(r.op + ".response", r.end_ns - r.intended_ns);
+        latency_.record_ns(r.op + ".service", r.end_ns - r.start_ns);
+        if (verbose_ && !r.success) {
+            std::cerr << "   ⚠️  " << r.op << " (身份 " << r.identity << ") 失败: " << r.error_msg << std::endl;
+        }
+    }
+    buildTimeSeries();
+
+    node_protocol::Client conn;
+    Json::Value req;
+    req["op"] = "status";
+    node_protocol::Message resp;
+    std::string error;
+    if (conn.connect(host_, port_) && call(conn, req, "", resp, error)) {
+        server_status_ = resp.header["result"];
+    } else {
+        std::cerr << "⚠️  节点状态获取失败: " << (error.empty() ? conn.last_error() : error) << std::endl;
+    }
+    if (server_) {
+        server_->stop();
+    }
+
+    end_time_ = test_fixture::current_timestamp();
+    printSummary();
+    return !connect_failed && failed == 0;
+}
+
+// ==================== 统计与报告 ====================
+
+void LoadGeneratorTest::buildTimeSeries() {
+    // 按完成时刻分窗口，每个窗口每种请求一行，另有 all 汇总
+    std::map<std::pair<size_t, std::string>, WindowStats> windows;
+    uint64_t interval_ns = static_cast<uint64_t>(report_interval_s_ * 1e9);
+    for (const auto& r : results_) {
+        if (r.skipped) {
+            continue;
+        }
+        size_t w = static_cast<size_t>(r.end_ns / interval_ns);
+        for (const std::string& op : {r.op, std::string("all")}) {
+            WindowStats& s = windows[{w, op}];
+            s.start_s = w * report_interval_s_;
+            s.op = op;
+            s.count++;
+            if (!r.success) {
+                s.errors++;
+            }
+            s.response.record(r.end_ns - r.intended_ns);
+        }
+    }
+    windows_.clear();
+    for (auto& kv : windows) {
+        windows_.push_back(std::move(kv.second));
+    }
+}
+
+void LoadGeneratorTest::printSummary() const {
+    std::cout << "\n" << std::string(100, '=') << std::endl;
+    std::cout << "开环负载测试总结" << std::endl;
+    std::cout << std::string(100, '=') << std::endl;
+
+    uint64_t sent = 0;
+    for (const auto& r : results_) {
+        if (!r.skipped) sent++;
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "目标到达率: " << rate_ << " 请求/秒, 实际到达 " << arrivals_ << ", 丢弃 " << dropped_
+              << ", 发送 " << sent << ", 用时 " << run_wall_s_ << " 秒, 实际吞吐 "
+              << (run_wall_s_ > 0 ? sent / run_wall_s_ : 0.0) << " 请求/秒" << std::endl;
+
+    std::cout << "\n响应延迟（自计划到达时刻起，含排队）:" << std::endl;
+    std::cout << std::left << std::setw(10) << "请求" << std::right
+              << std::setw(8) << "数量" << std::setw(8) << "失败" << std::setw(8) << "跳过"
+              << std::setw(11) << "mean ms" << std::setw(11) << "p50 ms" << std::setw(11) << "p90 ms"
+              << std::setw(11) << "p99 ms" << std::setw(11) << "max ms" << std::setw(12) << "服务p50" << std::endl;
+    auto snapshot = latency_.snapshot();
+    for (const auto& op : kOps) {
+        uint64_t failures = 0;
+        uint64_t skipped = 0;
+        for (const auto& r : results_) {
+            if (r.op != op) continue;
+            if (r.skipped) skipped++;
+            else if (!r.success) failures++;
+        }
+        const perf_metrics::Histogram& resp = snapshot[op + ".response"];
+        const perf_metrics::Histogram& svc = snapshot[op + ".service"];
+        std::cout << std::left << std::setw(10) << op << std::right
+                  << std::setw(8) << resp.count() << std::setw(8) << failures << std::setw(8) << skipped
+                  << std::setw(11) << resp.mean_ns() / 1e6 << std::setw(11) << resp.percentile_ms(50)
+                  << std::setw(11) << resp.percentile_ms(90) << std::setw(11) << resp.percentile_ms(99)
+                  << std::setw(11) << resp.max_ns() / 1e6 << std::setw(12) << svc.percentile_ms(50) << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+
+    if (!server_status_.isNull()) {
+        std::cout << "\n📡 节点: 文件数 " << server_status_["file_count"].asUInt64()
+                  << ", 搜索索引数 " << server_status_["search_index_count"].asUInt64() << std::endl;
+    }
+}
+
+bool LoadGeneratorTest::saveDetailedReport(const std::string& csv_file) {
+    fs::create_directories(fs::path(csv_file).parent_path());
+    std::ofstream out(csv_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    out << "op,identity,intended_ms,start_ms,end_ms,response_ms,service_ms,success,skipped,error\n";
+    out << std::fixed << std::setprecision(3);
+    for (const auto& r : results_) {
+        out << r.op << "," << r.identity << "," << r.intended_ns / 1e6 << "," << r.start_ns / 1e6 << ","
+            << r.end_ns / 1e6 << "," << (r.end_ns - r.intended_ns) / 1e6 << "," << (r.end_ns - r.start_ns) / 1e6
+            << "," << (r.success ? "true" : "false") << "," << (r.skipped ? "true" : "false")
+            << ",\"" << r.error_msg << "\"\n";
+    }
+    return true;
+}
+
+bool LoadGeneratorTest::saveTimeSeriesReport(const std::string& csv_file) {
+    fs::create_directories(fs::path(csv_file).parent_path());
+    std::ofstream out(csv_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    out << "window_start_s,op,completed,errors,throughput_rps,mean_ms,p50_ms,p90_ms,p99_ms,max_ms\n";
+    out << std::fixed << std::setprecision(3);
+    for (const auto& w : windows_) {
+        out << w.start_s << "," << w.op << "," << w.count << "," << w.errors << ","
+            << w.count / report_interval_s_ << "," << w.response.mean_ns() / 1e6 << ","
+            << w.response.percentile_ms(50) << "," << w.response.percentile_ms(90) << ","
+            << w.response.percentile_ms(99) << "," << w.response.max_ns() / 1e6 << "\n";
+    }
+    return true;
+}
+
+bool LoadGeneratorTest::saveSummaryReport(const std::string& json_file) {
+    fs::create_directories(fs::path(json_file).parent_path());
+    Json::Value root;
+    root["test_info"]["test_name"] = test_name_;
+    root["test_info"]["start_time"] = start_time_;
+    root["test_info"]["end_time"] = end_time_;
+    root["test_info"]["identities"] = identities_;
+    root["test_info"]["connections"] = connections_;
+    root["test_info"]["arrival"] = poisson_ ? "poisson" : "uniform";
+    root["test_info"]["rate"] = rate_;
+    root["test_info"]["duration_s"] = duration_s_;
+    root["test_info"]["preload_files"] = preload_files_;
+    root["test_info"]["file_size"] = static_cast<Json::UInt64>(file_size_);
+    root["test_info"]["search_keywords"] = search_keywords_;
+    root["test_info"]["keywords_per_file"] = keywords_per_file_;
+    root["test_info"]["report_interval_s"] = report_interval_s_;
+    for (const auto& kv : mix_) {
+        root["test_info"]["mix"][kv.first] = kv.second;
+    }
+
+    uint64_t sent = 0;
+    uint64_t failures = 0;
+    for (const auto& r : results_) {
+        if (r.skipped) continue;
+        sent++;
+        if (!r.success) failures++;
+    }
+    root["load"]["arrivals"] = static_cast<Json::UInt64>(arrivals_);
+    root["load"]["dropped"] = static_cast<Json::UInt64>(dropped_);
+    root["load"]["sent"] = static_cast<Json::UInt64>(sent);
+    root["load"]["failures"] = static_cast<Json::UInt64>(failures);
+    root["load"]["wall_s"] = run_wall_s_;
+    root["load"]["offered_rps"] = rate_;
+    root["load"]["arrival_rps"] = arrivals_ / duration_s_;
+    root["load"]["achieved_rps"] = run_wall_s_ > 0 ? sent / run_wall_s_ : 0.0;
+
+    auto snapshot = latency_.snapshot();
+    Json::Value ops(Json::objectValue);
+    for (const auto& op : kOps) {
+        Json::Value item;
+        uint64_t op_failures = 0;
+        uint64_t skipped = 0;
+        for (const auto& r : results_) {
+            if (r.op != op) continue;
+            if (r.skipped) skipped++;
+            else if (!r.success) op_failures++;
+        }
+        item["failures"] = static_cast<Json::UInt64>(op_failures);
+        item["skipped"] = static_cast<Json::UInt64>(skipped);
+        item["throughput_rps"] = run_wall_s_ > 0 ? snapshot[op + ".response"].count() / run_wall_s_ : 0.0;
+        item["response"] = histogram_json(snapshot[op + ".response"]);
+        item["service"] = histogram_json(snapshot[op + ".service"]);
+        ops[op] = item;
+    }
+    root["operations"] = ops;
+
+    if (server_) {
+        NodeServer::Stats stats = server_->stats();
+        root["server"]["connections_accepted"] = static_cast<Json::UInt64>(stats.connections_accepted);
+        root["server"]["requests"] = static_cast<Json::UInt64>(stats.requests);
+        root["server"]["failed_requests"] = static_cast<Json::UInt64>(stats.failed_requests);
+        root["server"]["bytes_in"] = static_cast<Json::UInt64>(stats.bytes_in);
+        root["server"]["bytes_out"] = static_cast<Json::UInt64>(stats.bytes_out);
+    }
+    root["server"]["status"] = server_status_;
+
+    std::ofstream out(json_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "  ";
+    out << Json::writeString(writer, root);
+    return true;
+}
@@ -0,0 +1,133 @@
+#ifndef LOAD_GENERATOR_TEST_H
+#define LOAD_GENERATOR_TEST_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <filesystem>
+#include <jsoncpp/json/json.h>
+
+#include "../../vds-client/client.h"
+#include "../../Storage-node/storage_node.h"
+#include "../../Storage-node/node_server.h"
+#include "../../common/node_protocol.h"
+#include "../../common/perf_metrics.h"
+#include "../common/client_fixture.h"
+
+/**
+ * @brief 存储节点开环混合负载生成器（容量规划）
+ *
+ * 准备阶段为 N 个客户端身份（各自独立的密钥对与数据目录）生成预置文件、插入请求包、
+ * 搜索令牌与删除令牌，并把预置文件插入节点。运行阶段由调度线程按目标到达率
+ * （泊松或均匀间隔）产生请求，请求类型按 insert/search/delete/audit 比例抽取、身份均匀抽取，
+ * 放入队列后由 connections 个连接并发发送。
+ *
+ * 开环：到达时间不受响应快慢影响，响应延迟从计划到达时刻起算（含排队），
+ * 同时记录从实际发送起算的服务时间；结果按 report_interval_s 切分为时间序列。
+ * server.host 为空时在进程内启动 StorageNode + NodeServer，否则连接指定节点。
+ */
+class LoadGeneratorTest {
+public:
+    struct OpResult {
+        std::string op;            // insert / search / delete / audit
+        int identity;
+        uint64_t intended_ns;      // 计划到达时刻（相对运行开始）
+        uint64_t start_ns;         // 实际发送时刻
+        uint64_t end_ns;           // 收到响应时刻
+        bool success;
+        bool skipped;              // 预生成的请求已用完，未发送
+        std::string error_msg;
+    };
+
+    struct WindowStats {
+        double start_s = 0;
+        std::string op;
+        uint64_t count = 0;
+        uint64_t errors = 0;
+        perf_metrics::Histogram response;
+    };
+
+    LoadGeneratorTest();
+    ~LoadGeneratorTest();
+
+    bool loadConfig(const std::string& config_file);
+    bool initialize();
+    bool runTest();
+    bool saveDetailedReport(const std::string& csv_file);
+    bool saveTimeSeriesReport(const std::string& csv_file);
+    bool saveSummaryReport(const std::string& json_file);
+
+private:
+    struct Identity {
+        int id = 0;
+        std::vector<std::string> preload_bundles;      // 运行前插入（.vdsb 字节）
+        std::vector<std::string> insert_bundles;       // 运行中插入
+        std::vector<std::string> audit_ids;            // 运行中不会被删除的预置文件
+        std::vector<Json::Value> search_params;
+        std::vector<Json::Value> delete_params;        // 预置文件的后半部分
+        std::atomic<size_t> next_insert{0};
+        std::atomic<size_t> next_delete{0};
+    };
+
+    struct Task {
+        std::string op;
+        int identity;
+        uint64_t intended_ns;
+    };
+
+    bool prepareIdentity(int id, size_t insert_count, size_t delete_count);
+    bool encryptFiles(StorageClient& client, const std::string& client_dir, const std::string& prefix,
+                      int count, const std::vector<std::string>& keyword_pool, int keywords_per_file,
+                      std::vector<std::string>& bundles, std::vector<std::string>* ids);
+    bool preload();
+    bool execute(node_protocol::Client& conn, const Task& task, OpResult& result, std::mt19937_64& rng);
+    bool call(node_protocol::Client& conn, const Json::Value& request, const std::string& payload,
+              node_protocol::Message& response, std::string& error);
+    void buildTimeSeries();
+    void printSummary() const;
+
+    // 配置
+    std::string test_name_;
+    std::string public_params_file_;
+    std::string work_dir_;
+    std::string host_;              // 为空时启动进程内节点
+    std::string record_dir_;        // 进程内节点的请求录制目录（为空不录制）
+    int port_;
+    int workers_;
+    int identities_;
+    int connections_;
+    double rate_;                   // 目标到达率（请求/秒）
+    double duration_s_;
+    bool poisson_;                  // 泊松到达（否则均匀间隔）
+    std::map<std::string, double> mix_;
+    int preload_files_;             // 每个身份的预置文件数
+    size_t file_size_;
+    int search_keywords_;           // 每个身份的搜索关键词数
+    int keywords_per_file_;
+    double insert_headroom_;        // 预生成请求相对期望数量的余量
+    double report_interval_s_;
+    size_t max_outstanding_;        // 队列上限，超出的到达记为丢弃
+    bool reset_work_dir_;
+    bool verbose_;
+
+    // 组件
+    StorageNode* node_;
+    NodeServer* server_;
+    std::vector<std::unique_ptr<Identity>> identity_data_;
+
+    // 结果
+    std::vector<OpResult> results_;
+    std::vector<WindowStats> windows_;
+    perf_metrics::Registry latency_;        // <op>.response / <op>.service
+    uint64_t arrivals_;
+    uint64_t dropped_;
+    double run_wall_s_;
+    Json::Value server_status_;
+    std::string start_time_;
+    std::string end_time_;
+};
+
+#endif // LOAD_GENERATOR_TEST_H
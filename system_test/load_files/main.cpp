@@ -0,0 +1,37 @@
+/*
+ * main.cpp - 开环负载测试主程序
+ *
+ * 使用 LoadGeneratorTest 类对存储节点施加开环混合负载
+ *
+ * 编译:
+ *   make
+ *
+ * 运行:
+ *   ./load_generator_test [配置文件路径]
+ *   默认配置: system_test/load_files/config/load_test_config.json
+ */
+
+#include "load_test.h"
+#include "../common/harness_main.h"
+
+int main(int argc, char* argv[]) {
+    harness_main::Spec spec;
+    spec.icon = "📈";
+    spec.name = "开环负载测试";
+    spec.run_label = "运行开环负载测试";
+    spec.default_config = "system_test/load_files/config/load_test_config.json";
+    // 过载时的失败也是测量结果的一部分：先保存报告，最后再返回失败
+    spec.save_on_failure = true;
+    spec.failure_note = "存在失败的请求或连接";
+
+    return harness_main::run_harness<LoadGeneratorTest>(argc, argv, spec, [](LoadGeneratorTest& test) {
+        return std::vector<harness_main::Report>{
+            {"详细报告", "system_test/load_files/results/load_detailed.csv",
+             [&test](const std::string& p) { return test.saveDetailedReport(p); }},
+            {"时间序列报告", "system_test/load_files/results/load_timeseries.csv",
+             [&test](const std::string& p) { return test.saveTimeSeriesReport(p); }},
+            {"总结报告", "system_test/load_files/results/load_summary.json",
+             [&test](const std::string& p) { return test.saveSummaryReport(p); }}
+        };
+    });
+}
@@ -0,0 +1,35 @@
+/*
+ * main.cpp - 分页搜索测试主程序
+ *
+ * 使用 PagingSearchTest 类检查 limit / cursor 分页的正确性
+ *
+ * 编译:
+ *   make
+ *
+ * 运行:
+ *   ./paging_search_test [配置文件路径]
+ *   默认配置: system_test/paging_files/config/paging_test_config.json
+ */
+
+#include "paging_test.h"
+#include "../common/harness_main.h"
+
+int main(int argc, char* argv[]) {
+    harness_main::Spec spec;
+    spec.icon = "📑";
+    spec.name = "分页搜索测试";
+    spec.run_label = "运行分页搜索测试";
+    spec.default_config = "system_test/paging_files/config/paging_test_config.json";
+    // 分页结果不一致时仍保存报告，便于对照 paging_detailed.csv 排查
+    spec.save_on_failure = true;
+    spec.failure_note = "存在分页结果不一致";
+
+    return harness_main::run_harness<PagingSearchTest>(argc, argv, spec, [](PagingSearchTest& test) {
+        return std::vector<harness_main::Report>{
+            {"详细报告", "system_test/paging_files/results/paging_detailed.csv",
+             [&test](const std::string& p) { return test.saveDetailedReport(p); }},
+            {"总结报告", "system_test/paging_files/results/paging_summary.json",
+             [&test](const std::string& p) { return test.saveSummaryReport(p); }}
+        };
+    });
+}
@@ -0,0 +1,490 @@
+#include "paging_test.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+
+namespace fs = std::filesystem;
+
+using test_fixture::load_json;
+using test_fixture::QuietCout;
+
+PagingSearchTest::PagingSearchTest()
+    : files_(40),
+      delete_every_(4),
+      file_size_(1024),
+      seed_(42),
+      quiet_node_output_(true),
+      reset_work_dir_(true),
+      client_(nullptr),
+      node_(nullptr),
+      keyword_("paging_kw"),
+      deleted_count_(0) {
+}
+
+PagingSearchTest::~PagingSearchTest() {
+    delete node_;
+    delete client_;
+}
+
+// ==================== 配置与初始化 ====================
+
+bool PagingSearchTest::loadConfig(const std::string& config_file) {
+    Json::Value config;
+    if (!load_json(config_file, config)) {
+        std::cerr << "[错误] 无法读取配置文件: " << config_file << std::endl;
+        return false;
+    }
+
+    test_name_ = config.get("test_name", "storage node search paging").asString();
+
+    const Json::Value& paths = config["paths"];
+    public_params_file_ = paths.get("public_params", "vds-client/data/public_params.json").asString();
+    work_dir_ = paths.get("work_dir", "system_test/paging_files/data/work").asString();
+
+    const Json::Value& options = config["options"];
+    limits_.clear();
+    if (options["limits"].isArray()) {
+        for (const auto& v : options["limits"]) {
+            int limit = v.asInt();
+            if (limit <= 0) {
+                std::cerr << "[错误] limits 取值须为正整数: " << limit << std::endl;
+                return false;
+            }
+            limits_.push_back(limit);
+        }
+    }
+    if (limits_.empty()) {
+        limits_ = {1, 3, 7, 10, 30, 100};
+    }
+    budget_hops_.clear();
+    if (options["budget_hops"].isArray()) {
+        for (const auto& v : options["budget_hops"]) {
+            int hops = v.asInt();
+            if (hops < 0) {
+                std::cerr << "[错误] budget_hops 取值不能为负: " << hops << std::endl;
+                return false;
+            }
+            budget_hops_.push_back(hops);
+        }
+    }
+    if (budget_hops_.empty()) {
+        budget_hops_ = {0, 2};
+    }
+
+    files_ = std::max(1, options.get("files", 40).asInt());
+    delete_every_ = std::max(0, options.get("delete_every", 4).asInt());
+    file_size_ = std::max<Json::UInt64>(1, options.get("file_size", 1024).asUInt64());
+    seed_ = options.get("seed", 42).asUInt64();
+    quiet_node_output_ = options.get("quiet_node_output", true).asBool();
+    reset_work_dir_ = options.get("reset_work_dir", true).asBool();
+
+    std::cout << "[配置] 工作目录: " << work_dir_ << std::endl;
+    std::cout << "[配置] 语料: " << files_ << " 个文件 x " << file_size_ << " 字节, 每 "
+              << delete_every_ << " 个删除一个" << std::endl;
+    std::cout << "[配置] 分页大小:";
+    for (int limit : limits_) {
+        std::cout << " " << limit;
+    }
+    std::cout << ", 跳数预算:";
+    for (int hops : budget_hops_) {
+        std::cout << " " << hops;
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+bool PagingSearchTest::initialize() {
+    if (reset_work_dir_ && fs::exists(work_dir_)) {
+        std::cout << "[初始化] 清空工作目录: " << work_dir_ << std::endl;
+        fs::remove_all(work_dir_);
+    }
+    std::string client_dir = work_dir_ + "/client";
+    std::string node_dir = work_dir_ + "/node";
+    fs::create_directories(client_dir);
+    fs::create_directories(node_dir);
+    fs::create_directories(work_dir_ + "/plain");
+
+    client_ = new StorageClient();
+    StorageClient::configureDataDirectories(client_dir);
+    if (!client_->initialize(public_params_file_) || !client_->initializeDataDirectories()) {
+        std::cerr << "[错误] 客户端初始化失败" << std::endl;
+        return false;
+    }
+    std::string key_file = client_dir + "/private_key.dat";
+    if (!client_->loadKeys(key_file)) {
+        if (!client_->generateKeys(key_file)) {
+            std::cerr << "[错误] 密钥生成失败" << std::endl;
+            return false;
+        }
+        client_->saveKeys(key_file);
+    }
+    client_->setInsertBundleMode(true);
+
+    node_ = new StorageNode(node_dir, 0);
+    if (!node_->load_public_params(public_params_file_) || !node_->initialize_directories()) {
+        std::cerr << "[错误] 存储节点初始化失败" << std::endl;
+        return false;
+    }
+    if (!node_->load_index_database() || !node_->load_search_database()) {
+        std::cerr << "[错误] 存储节点数据库加载失败" << std::endl;
+        return false;
+    }
+
+    return prepareCorpus();
+}
+
+bool PagingSearchTest::prepareCorpus() {
+    std::cout << "\n[准备] 生成并插入 " << files_ << " 个文件..." << std::endl;
+    std::mt19937_64 rng(seed_);
+
+    std::vector<std::string> ids;
+    for (int i = 0; i < files_; ++i) {
+        test_fixture::EncryptedFile file;
+        QuietCout quiet(quiet_node_output_);
+        if (!test_fixture::encrypt_random_file(*client_, work_dir_ + "/client",
+                                               work_dir_ + "/plain/file_" + std::to_string(i) + ".bin",
+                                               file_size_, {keyword_}, rng, file)) {
+            return false;
+        }
+        if (!node_->insert_from_bundle(file.bundle)) {
+            std::cerr << "[错误] 插入失败: " << file.bundle.ID_F << std::endl;
+            return false;
+        }
+        ids.push_back(file.bundle.ID_F);
+    }
+
+    // 最早插入的文件（链尾）始终保留：最后一页的最后一个有效文件恰为链尾，覆盖空游标检查
+    std::vector<bool> deleted(ids.size(), false);
+    for (size_t i = 1; i < ids.size(); ++i) {
+        if (delete_every_ > 0 && i % static_cast<size_t>(delete_every_) == static_cast<size_t>(delete_every_ - 1)) {
+            bool ok;
+            {
+                QuietCout quiet(quiet_node_output_);
+                ok = client_->deleteFile(ids[i]) &&
+                     node_->delete_file_from_json(work_dir_ + "/client/Deles/" + ids[i] + ".json");
+            }
+            if (!ok) {
+                std::cerr << "[错误] 删除失败: " << ids[i] << std::endl;
+                return false;
+            }
+            deleted[i] = true;
+            deleted_count_++;
+        }
+    }
+
+    // 链表由新到旧
+    for (size_t i = ids.size(); i-- > 0;) {
+        if (!deleted[i]) {
+            expected_.push_back(ids[i]);
+        }
+    }
+
+    std::cout << "[准备] 完成: " << ids.size() << " 个文件, 删除 " << deleted_count_ << " 个, 有效 "
+              << expected_.size() << " 个" << std::endl;
+    return true;
+}
+
+// ==================== 测试执行 ====================
+
+bool PagingSearchTest::searchPage(int limit, int max_hops, const std::string& cursor, int page, PageResult& row,
+                                  SearchProofResult& proof, std::vector<ProofFile>& proof_files) {
+    row = {limit, max_hops, page, 0, 0, 0, false, true, 0.0, 0.0, ""};
+    proof = SearchProofResult();
+
+    std::string params_path = work_dir_ + "/client/Search/" + keyword_ + ".json";
+    Json::Value params;
+    bool ok;
+    {
+        QuietCout quiet(quiet_node_output_);
+        ok = client_->searchKeyword(keyword_, limit, cursor, page) && load_json(params_path, params);
+    }
+    if (!ok) {
+        std::cerr << "[错误] 搜索令牌生成失败: limit " << limit << " 第 " << page + 1 << " 页" << std::endl;
+        return false;
+    }
+
+    // 有跳数预算时把 max_hops / continuation 加入参数，写到单独的参数文件
+    if (max_hops > 0) {
+        params["max_hops"] = max_hops;
+        params_path = work_dir_ + "/client/Search/" + keyword_ + "_budget.json";
+    }
+
+    // 每段至少推进一跳，段数不会超过链长
+    for (int segment = 0; segment <= files_ + 1; ++segment) {
+        if (max_hops > 0) {
+            std::ofstream out(params_path);
+            Json::StreamWriterBuilder writer;
+            out << Json::writeString(writer, params);
+            if (!out) {
+                std::cerr << "[错误] 搜索参数写入失败: " << params_path << std::endl;
+                return false;
+            }
+        }
+
+        uint64_t t0 = perf_metrics::now_ns();
+        {
+            QuietCout quiet(quiet_node_output_);
+            ok = node_->SearchKeywordsAssociatedFilesProof(params_path);
+        }
+        row.search_ms += perf_metrics::elapsed_ms(t0);
+        if (!ok) {
+            std::cerr << "[错误] 搜索证明生成失败: limit " << limit << " 第 " << page + 1 << " 页" << std::endl;
+            return false;
+        }
+
+        // 证明文件名由节点按 T、page 与 segment 决定
+        SearchProofResult key;
+        key.T = params["T"].asString();
+        key.page = page;
+        key.segment = segment;
+        std::string proof_file = node_->search_proof_output_path(key);
+        Json::Value proof_json;
+        if (!load_json(proof_file, proof_json)) {
+            std::cerr << "[错误] 证明文件读取失败: " << proof_file << std::endl;
+            return false;
+        }
+        SearchProofResult part = SearchProofResult::from_json(proof_json);
+        if (!part.success || part.page != page || part.segment != segment) {
+            std::cerr << "[错误] 证明文件内容不符: " << proof_file << std::endl;
+            return false;
+        }
+
+        t0 = perf_metrics::now_ns();
+        bool verified;
+        {
+            QuietCout quiet(quiet_node_output_);
+            verified = node_->VerifySearchProof(proof_file);
+        }
+        row.verify_ms += perf_metrics::elapsed_ms(t0);
+
+        if (segment == 0) {
+            row.proof_file = proof_file;
+        }
+        row.segments++;
+        row.hops += part.hops;
+        row.verified = row.verified && verified;
+        proof_files.emplace_back(proof_file, part.AS);
+        proof.AS.insert(proof.AS.end(), part.AS.begin(), part.AS.end());
+        proof.cursor = part.cursor;
+        proof.page = page;
+
+        // 续传令牌只在预算截断、本页未满时返回
+        if (!part.continuation.isObject()) {
+            row.files = proof.AS.size();
+            row.cursor_empty = proof.cursor.empty();
+            proof.success = true;
+            return true;
+        }
+        params["continuation"] = part.continuation;
+    }
+
+    std::cerr << "[错误] 续传段数超过链长: limit " << limit << " 第 " << page + 1 << " 页" << std::endl;
+    return false;
+}
+
+void PagingSearchTest::traverse(int limit, int max_hops, LimitResult& result) {
+    result.limit = limit;
+    result.max_hops = max_hops;
+    size_t valid = expected_.size();
+    result.expected_pages = valid == 0 ? 1 : static_cast<int>((valid + limit - 1) / limit);
+
+    std::vector<std::string> seen;
+    std::vector<std::string> first_page;
+    std::vector<ProofFile> proof_files;
+    std::string cursor;
+
+    // 多翻两页：cursor 在链尾后仍非空时计入页数差异，而不是无限翻页
+    for (int page = 0; page < result.expected_pages + 2; ++page) {
+        PageResult row;
+        SearchProofResult proof;
+        if (!searchPage(limit, max_hops, cursor, page, row, proof, proof_files)) {
+            result.errors++;
+            break;
+        }
+        pages_.push_back(row);
+        result.pages++;
+        if (!row.verified) {
+            result.verify_failures++;
+        }
+        if (proof.AS.size() > static_cast<size_t>(limit)) {
+            result.oversized++;
+        }
+        if (page == 0) {
+            first_page = proof.AS;
+        }
+        seen.insert(seen.end(), proof.AS.begin(), proof.AS.end());
+        if (proof.cursor.empty()) {
+            break;
+        }
+        cursor = proof.cursor;
+    }
+
+    size_t first_count = std::min(static_cast<size_t>(limit), valid);
+    result.first_page_ok = first_page.size() == first_count &&
+                           std::equal(first_page.begin(), first_page.end(), expected_.begin());
+    result.order_ok = seen == expected_;
+    result.files = seen.size();
+
+    std::set<std::string> expected_set(expected_.begin(), expected_.end());
+    std::set<std::string> seen_set;
+    for (const auto& id : seen) {
+        if (!seen_set.insert(id).second) {
+            result.duplicated++;
+        } else if (!expected_set.count(id)) {
+            result.unexpected++;
+        }
+    }
+    for (const auto& id : expected_) {
+        if (!seen_set.count(id)) {
+            result.missing++;
+        }
+    }
+
+    // 翻页结束后重新读取每页的证明文件：文件名冲突时前面的页会被后面的页覆盖
+    for (const auto& item : proof_files) {
+        Json::Value proof_json;
+        if (!load_json(item.first, proof_json) ||
+            SearchProofResult::from_json(proof_json).AS != item.second) {
+            result.overwritten++;
+        }
+    }
+
+    result.passed = result.errors == 0 && result.first_page_ok && result.order_ok &&
+                    result.duplicated == 0 && result.missing == 0 && result.unexpected == 0 &&
+                    result.verify_failures == 0 && result.overwritten == 0 && result.oversized == 0 &&
+                    result.pages == result.expected_pages;
+}
+
+bool PagingSearchTest::runTest() {
+    start_time_ = test_fixture::current_timestamp();
+    limit_results_.clear();
+
+    bool passed = true;
+    for (int max_hops : budget_hops_) {
+        for (int limit : limits_) {
+            limit_results_.emplace_back();
+            LimitResult& result = limit_results_.back();
+            traverse(limit, max_hops, result);
+            std::cout << (result.passed ? "✅" : "❌") << " limit " << result.limit << ", 跳数预算 "
+                      << result.max_hops << ": " << result.pages << " 页 (期望 " << result.expected_pages << "), "
+                      << result.files << " 个文件" << std::endl;
+            if (!result.passed) {
+                std::cerr << "   第一页" << (result.first_page_ok ? "正确" : "错误") << ", 顺序"
+                          << (result.order_ok ? "正确" : "错误") << ", 重复 " << result.duplicated << ", 缺失 "
+                          << result.missing << ", 多余 " << result.unexpected << ", 验证失败 "
+                          << result.verify_failures << ", 证明文件被覆盖 " << result.overwritten
+                          << ", 超出 limit 的页 " << result.oversized << ", 错误 " << result.errors << std::endl;
+                passed = false;
+            }
+        }
+    }
+
+    end_time_ = test_fixture::current_timestamp();
+    printSummary();
+    return passed;
+}
+
+void PagingSearchTest::printSummary() const {
+    std::cout << "\n" << std::string(80, '=') << std::endl;
+    std::cout << "分页搜索测试总结 (有效文件 " << expected_.size() << " 个, 已删除 " << deleted_count_ << " 个)"
+              << std::endl;
+    std::cout << std::string(80, '=') << std::endl;
+    std::cout << std::right << std::setw(8) << "limit" << std::setw(10) << "跳数预算" << std::setw(8) << "页数"
+              << std::setw(8) << "期望"
+              << std::setw(8) << "文件" << std::setw(14) << "搜索ms/页" << std::setw(14) << "验证ms/页"
+              << std::setw(8) << "结果" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& r : limit_results_) {
+        double search_ms = 0.0;
+        double verify_ms = 0.0;
+        int count = 0;
+        for (const auto& p : pages_) {
+            if (p.limit == r.limit && p.max_hops == r.max_hops) {
+                search_ms += p.search_ms;
+                verify_ms += p.verify_ms;
+                count++;
+            }
+        }
+        if (count > 0) {
+            search_ms /= count;
+            verify_ms /= count;
+        }
+        std::cout << std::setw(8) << r.limit << std::setw(10) << r.max_hops << std::setw(8) << r.pages
+                  << std::setw(8) << r.expected_pages
+                  << std::setw(8) << r.files << std::setw(14) << search_ms << std::setw(14) << verify_ms
+                  << std::setw(8) << (r.passed ? "通过" : "失败") << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+}
+
+// ==================== 报告输出 ====================
+
+bool PagingSearchTest::saveDetailedReport(const std::string& csv_file) {
+    fs::create_directories(fs::path(csv_file).parent_path());
+    std::ofstream out(csv_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    out << "limit,max_hops,page,segments,files,hops,cursor_empty,verified,search_ms,verify_ms,proof_file\n";
+    for (const auto& p : pages_) {
+        out << p.limit << "," << p.max_hops << "," << p.page << "," << p.segments << "," << p.files << ","
+            << p.hops << ","
+            << (p.cursor_empty ? "true" : "false") << "," << (p.verified ? "true" : "false") << ","
+            << std::fixed << std::setprecision(3) << p.search_ms << "," << p.verify_ms << ","
+            << fs::path(p.proof_file).filename().string() << "\n";
+        out.unsetf(std::ios::fixed);
+    }
+    return true;
+}
+
+bool PagingSearchTest::saveSummaryReport(const std::string& json_file) {
+    fs::create_directories(fs::path(json_file).parent_path());
+    Json::Value root;
+    root["test_info"]["test_name"] = test_name_;
+    root["test_info"]["start_time"] = start_time_;
+    root["test_info"]["end_time"] = end_time_;
+    root["test_info"]["files"] = files_;
+    root["test_info"]["deleted"] = static_cast<Json::UInt64>(deleted_count_);
+    root["test_info"]["valid_files"] = static_cast<Json::UInt64>(expected_.size());
+    root["test_info"]["file_size"] = static_cast<Json::UInt64>(file_size_);
+    root["test_info"]["seed"] = static_cast<Json::UInt64>(seed_);
+
+    Json::Value limits(Json::arrayValue);
+    bool passed = true;
+    for (const auto& r : limit_results_) {
+        Json::Value item;
+        item["limit"] = r.limit;
+        item["max_hops"] = r.max_hops;
+        item["pages"] = r.pages;
+        item["expected_pages"] = r.expected_pages;
+        item["files"] = static_cast<Json::UInt64>(r.files);
+        item["first_page_ok"] = r.first_page_ok;
+        item["order_ok"] = r.order_ok;
+        item["duplicated"] = r.duplicated;
+        item["missing"] = r.missing;
+        item["unexpected"] = r.unexpected;
+        item["verify_failures"] = r.verify_failures;
+        item["overwritten"] = r.overwritten;
+        item["oversized"] = r.oversized;
+        item["errors"] = r.errors;
+        item["passed"] = r.passed;
+        limits.append(item);
+        passed = passed && r.passed;
+    }
+    root["limits"] = limits;
+    root["passed"] = passed;
+
+    std::ofstream out(json_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "  ";
+    out << Json::writeString(writer, root);
+    return true;
+}
@@ -0,0 +1,112 @@
+#ifndef PAGING_SEARCH_TEST_H
+#define PAGING_SEARCH_TEST_H
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <jsoncpp/json/json.h>
+
+#include "../../vds-client/client.h"
+#include "../../Storage-node/storage_node.h"
+#include "../../common/perf_metrics.h"
+#include "../common/client_fixture.h"
+
+/**
+ * @brief 分页搜索测试（limit / cursor / page）
+ *
+ * 初始化时在独立工作目录中插入 files 个文件（全部带同一个关键词，链表顺序即插入顺序的逆序），
+ * 再删除其中每 delete_every 个文件中的一个（最早插入的文件始终保留，使最后一个有效文件恰为链尾）。
+ * 之后对 limits 中的每个分页大小，从第一页开始沿 cursor 翻页直到 cursor 为空，每页都经过
+ * 客户端 searchKeyword -> 节点 SearchKeywordsAssociatedFilesProof（写证明文件）-> VerifySearchProof，检查：
+ *   first_page - 第一页恰为最新的 min(limit, 有效文件数) 个文件
+ *   traversal  - 各页拼接后与全部有效文件（由新到旧）完全一致，无遗漏、无重复
+ *   verify     - 每页的证明文件都通过验证
+ *   pages      - 页数为 ceil(有效文件数 / limit)：最后一个有效文件是链尾时，该页的 cursor 必须为空
+ *   files      - 各页证明文件互不覆盖（翻页结束后逐个重新读取，AS 与当页一致）
+ *   size       - 每页的文件数不超过 limit
+ * budget_hops 中的每个跳数预算 (>0) 与每个 limit 组合再翻一遍：每页在预算处截断为多个续传段，
+ * 沿 continuation 续传到本页结束（没有 continuation）再按 cursor 翻页，各段的证明分别验证。
+ */
+class PagingSearchTest {
+public:
+    struct PageResult {
+        int limit;
+        int max_hops;          // 跳数预算（0 表示不分段）
+        int page;
+        int segments;          // 本页的续传段数
+        size_t files;          // 本页返回的有效文件数
+        int hops;
+        bool cursor_empty;
+        bool verified;
+        double search_ms;      // 节点生成并保存证明（各段之和）
+        double verify_ms;      // 节点验证证明文件（各段之和）
+        std::string proof_file;  // 第一段的证明文件
+    };
+
+    struct LimitResult {
+        int limit = 0;
+        int max_hops = 0;
+        int pages = 0;
+        int expected_pages = 0;
+        size_t files = 0;
+        bool first_page_ok = false;
+        bool order_ok = false;         // 拼接结果与期望序列完全一致
+        int duplicated = 0;            // 重复出现的文件数
+        int missing = 0;               // 未出现的有效文件数
+        int unexpected = 0;            // 出现的已删除或未知文件数
+        int verify_failures = 0;
+        int overwritten = 0;           // 翻页结束后内容已被改写的证明文件数
+        int oversized = 0;             // 文件数超过 limit 的页数
+        int errors = 0;                // 令牌生成、证明生成或读取失败
+        bool passed = false;
+    };
+
+    PagingSearchTest();
+    ~PagingSearchTest();
+
+    bool loadConfig(const std::string& config_file);
+    bool initialize();
+    bool runTest();
+    bool saveDetailedReport(const std::string& csv_file);
+    bool saveSummaryReport(const std::string& json_file);
+
+private:
+    bool prepareCorpus();
+    // 一页的一个续传段：证明文件与其 AS
+    using ProofFile = std::pair<std::string, std::vector<std::string>>;
+
+    void traverse(int limit, int max_hops, LimitResult& result);
+    bool searchPage(int limit, int max_hops, const std::string& cursor, int page, PageResult& row,
+                    SearchProofResult& proof, std::vector<ProofFile>& proof_files);
+    void printSummary() const;
+
+    // 配置
+    std::string test_name_;
+    std::string public_params_file_;
+    std::string work_dir_;
+    std::vector<int> limits_;
+    std::vector<int> budget_hops_;   // 跳数预算，0 表示不分段
+    int files_;
+    int delete_every_;          // 每 delete_every 个文件删除一个（0 表示不删除）
+    size_t file_size_;
+    uint64_t seed_;
+    bool quiet_node_output_;
+    bool reset_work_dir_;
+
+    // 组件
+    StorageClient* client_;
+    StorageNode* node_;
+
+    // 数据
+    std::string keyword_;
+    std::vector<std::string> expected_;     // 有效文件，由新到旧
+    size_t deleted_count_;
+
+    // 结果
+    std::vector<PageResult> pages_;
+    std::vector<LimitResult> limit_results_;
+    std::string start_time_;
+    std::string end_time_;
+};
+
+#endif // PAGING_SEARCH_TEST_H
@@ -0,0 +1,95 @@
+/*
+ * main.cpp - 性能回归门禁主程序
+ *
+ * 使用 PerfRegressionGate 类比较基线与当前的 summary JSON
+ *
+ * 编译:
+ *   make
+ *
+ * 运行:
+ *   ./perf_gate [--allow-missing-baseline] [配置文件路径]
+ *   默认配置: system_test/perf_gate_files/config/perf_gate_config.json
+ *
+ * 返回值: 0 = 通过, 1 = 存在回归、缺少基线或配置错误
+ */
+
+#include "perf_gate.h"
+#include <iostream>
+#include <cstdlib>
+
+namespace {
+const char* kDefaultConfigPath = "system_test/perf_gate_files/config/perf_gate_config.json";
+}
+
+void printUsage(const char* program_name) {
+    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
+    std::cout << "🚦 性能回归门禁" << std::endl;
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n" << std::endl;
+    std::cout << "用法: " << program_name << " [--allow-missing-baseline] [配置文件路径]" << std::endl;
+    std::cout << "\n参数:" << std::endl;
+    std::cout << "  配置文件路径  - JSON格式的门禁配置文件（可选）" << std::endl;
+    std::cout << "                  默认: " << kDefaultConfigPath << std::endl;
+    std::cout << "  --allow-missing-baseline" << std::endl;
+    std::cout << "                - 跳过缺少基线文件的报告（默认判为失败）" << std::endl;
+    std::cout << "\n示例:" << std::endl;
+    std::cout << "  " << program_name << std::endl;
+    std::cout << "  " << program_name << " custom_gate.json" << std::endl;
+    std::cout << "  " << program_name << " --allow-missing-baseline custom_gate.json" << std::endl;
+    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    // 解析命令行参数
+    std::string config_file = kDefaultConfigPath;
+    bool allow_missing_baseline = false;
+    bool config_given = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--allow-missing-baseline") {
+            allow_missing_baseline = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "❌ 错误: 未知选项 " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        } else if (config_given) {
+            std::cerr << "❌ 错误: 参数过多" << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            config_file = arg;
+            config_given = true;
+        }
+    }
+
+    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
+    std::cout << "🚦 VDS 性能回归门禁 v1.0" << std::endl;
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n" << std::endl;
+
+    PerfRegressionGate gate;
+    gate.setAllowMissingBaseline(allow_missing_baseline);
+
+    std::cout << "[阶段 1/3] 加载配置..." << std::endl;
+    if (!gate.loadConfig(config_file)) {
+        std::cerr << "\n❌ 配置加载失败，门禁中止" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n[阶段 2/3] 比较基线与当前结果..." << std::endl;
+    bool passed = gate.run();
+
+    std::cout << "\n[阶段 3/3] 保存门禁报告..." << std::endl;
+    std::string json_file = "system_test/perf_gate_files/results/perf_gate_report.json";
+    std::string csv_file = "system_test/perf_gate_files/results/perf_gate_report.csv";
+    if (!gate.saveReport(json_file, csv_file)) {
+        std::cerr << "⚠️  警告: 门禁报告保存失败" << std::endl;
+    } else {
+        std::cout << "✅ 门禁报告已保存: " << json_file << std::endl;
+        std::cout << "✅ 门禁报告已保存: " << csv_file << std::endl;
+    }
+
+    return passed ? 0 : 1;
+}
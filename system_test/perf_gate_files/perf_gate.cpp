@@ -0,0 +1,380 @@
+#include "perf_gate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool load_json(const std::string& path, Json::Value& out) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        return false;
+    }
+    Json::CharReaderBuilder builder;
+    std::string errs;
+    return Json::parseFromStream(builder, in, &out, &errs);
+}
+
+std::vector<std::string> split_path(const std::string& path) {
+    std::vector<std::string> segments;
+    std::stringstream ss(path);
+    std::string segment;
+    while (std::getline(ss, segment, '.')) {
+        segments.push_back(segment);
+    }
+    return segments;
+}
+
+std::string signed_pct(double pct) {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1) << (pct >= 0 ? "+" : "") << pct;
+    return ss.str();
+}
+
+} // namespace
+
+PerfRegressionGate::PerfRegressionGate() : allow_missing_baseline_(false), passed_(true) {}
+
+// ==================== 配置 ====================
+
+bool PerfRegressionGate::loadConfig(const std::string& config_file) {
+    Json::Value config;
+    if (!load_json(config_file, config)) {
+        std::cerr << "[错误] 无法读取配置文件: " << config_file << std::endl;
+        return false;
+    }
+
+    gate_name_ = config.get("gate_name", "performance regression gate").asString();
+    // 命令行已允许时不被配置覆盖为 false
+    allow_missing_baseline_ = allow_missing_baseline_ || config.get("allow_missing_baseline", false).asBool();
+
+    const Json::Value& reports = config["reports"];
+    if (!reports.isArray() || reports.empty()) {
+        std::cerr << "[错误] 配置中没有 reports" << std::endl;
+        return false;
+    }
+    for (const auto& item : reports) {
+        ReportSpec spec;
+        spec.name = item.get("name", "").asString();
+        spec.baseline_file = item.get("baseline", "").asString();
+        spec.current_file = item.get("current", "").asString();
+        if (spec.name.empty() || spec.baseline_file.empty() || spec.current_file.empty()) {
+            std::cerr << "[错误] report 须指定 name / baseline / current" << std::endl;
+            return false;
+        }
+
+        // 报告级默认值，指标未指定时继承
+        const Json::Value& defaults = item["defaults"];
+        double default_pct = defaults.get("max_regression_pct", 10.0).asDouble();
+        double default_slack = defaults.get("abs_slack", 0.0).asDouble();
+
+        for (const auto& m : item["metrics"]) {
+            MetricRule rule;
+            rule.path = m.get("path", "").asString();
+            rule.better = m.get("better", "lower").asString();
+            rule.max_regression_pct = m.get("max_regression_pct", default_pct).asDouble();
+            rule.abs_slack = m.get("abs_slack", default_slack).asDouble();
+            rule.required = m.get("required", true).asBool();
+            if (rule.path.empty()) {
+                std::cerr << "[错误] " << spec.name << ": 指标缺少 path" << std::endl;
+                return false;
+            }
+            if (rule.better != "lower" && rule.better != "higher" && rule.better != "equal") {
+                std::cerr << "[错误] " << spec.name << ": 未知的 better 取值 " << rule.better
+                          << " (lower / higher / equal)" << std::endl;
+                return false;
+            }
+            spec.metrics.push_back(rule);
+        }
+        reports_.push_back(spec);
+    }
+
+    std::cout << "[配置] " << gate_name_ << ": " << reports_.size() << " 组报告" << std::endl;
+    if (allow_missing_baseline_) {
+        std::cout << "   ⚠️  允许缺少基线：无基线的报告将被跳过" << std::endl;
+    }
+    for (const auto& spec : reports_) {
+        std::cout << "   ├─ " << spec.name << ": " << spec.metrics.size() << " 条规则" << std::endl;
+        std::cout << "   │   基线 " << spec.baseline_file << std::endl;
+        std::cout << "   │   当前 " << spec.current_file << std::endl;
+    }
+    return true;
+}
+
+// ==================== 比较 ====================
+
+bool PerfRegressionGate::run() {
+    results_.clear();
+    skipped_reports_.clear();
+    missing_baselines_.clear();
+    passed_ = true;
+
+    for (const auto& spec : reports_) {
+        Json::Value baseline;
+        Json::Value current;
+        if (!fs::exists(spec.baseline_file)) {
+            if (allow_missing_baseline_) {
+                std::cout << "⚠️  " << spec.name << ": 基线文件不存在，跳过 (" << spec.baseline_file << ")" << std::endl;
+                skipped_reports_.push_back(spec.name);
+            } else {
+                std::cerr << "[错误] " << spec.name << ": 基线文件不存在: " << spec.baseline_file
+                          << "（可用 make baseline 从当前结果生成，或以 --allow-missing-baseline 显式跳过）"
+                          << std::endl;
+                missing_baselines_.push_back(spec.name);
+                passed_ = false;
+            }
+            continue;
+        }
+        if (!load_json(spec.baseline_file, baseline)) {
+            std::cerr << "[错误] " << spec.name << ": 基线文件解析失败: " << spec.baseline_file << std::endl;
+            passed_ = false;
+            continue;
+        }
+        if (!load_json(spec.current_file, current)) {
+            std::cerr << "[错误] " << spec.name << ": 当前结果不存在或解析失败: " << spec.current_file << std::endl;
+            passed_ = false;
+            continue;
+        }
+        checkReport(spec, baseline, current);
+    }
+
+    for (const auto& r : results_) {
+        if (r.status == "FAIL" || r.status == "MISSING") {
+            passed_ = false;
+        }
+    }
+    printReport();
+    return passed_;
+}
+
+void PerfRegressionGate::checkReport(const ReportSpec& spec, const Json::Value& baseline,
+                                     const Json::Value& current) {
+    // 显式列出的指标优先，通配符展开时跳过
+    std::set<std::string> explicit_paths;
+    for (const auto& rule : spec.metrics) {
+        if (rule.path.find('*') == std::string::npos) {
+            explicit_paths.insert(rule.path);
+        }
+    }
+
+    for (const auto& rule : spec.metrics) {
+        std::vector<std::string> paths;
+        if (rule.path.find('*') == std::string::npos) {
+            paths.push_back(rule.path);
+        } else {
+            // 通配符按基线展开：基线有而当前没有的指标记为 MISSING
+            expandPath(baseline, split_path(rule.path), 0, "", paths);
+            paths.erase(std::remove_if(paths.begin(), paths.end(), [&](const std::string& p) {
+                return explicit_paths.count(p) > 0;
+            }), paths.end());
+        }
+        for (const auto& path : paths) {
+            checkMetric(spec.name, rule, path, baseline, current);
+        }
+    }
+}
+
+void PerfRegressionGate::expandPath(const Json::Value& root, const std::vector<std::string>& segments,
+                                    size_t index, const std::string& prefix,
+                                    std::vector<std::string>& out) const {
+    if (index == segments.size()) {
+        if (root.isNumeric()) {
+            out.push_back(prefix);
+        }
+        return;
+    }
+    const std::string& segment = segments[index];
+    std::string sep = prefix.empty() ? "" : ".";
+    if (segment == "*") {
+        if (!root.isObject()) {
+            return;
+        }
+        for (const auto& name : root.getMemberNames()) {
+            expandPath(root[name], segments, index + 1, prefix + sep + name, out);
+        }
+    } else if (root.isObject() && root.isMember(segment)) {
+        expandPath(root[segment], segments, index + 1, prefix + sep + segment, out);
+    }
+}
+
+const Json::Value* PerfRegressionGate::resolve(const Json::Value& root, const std::string& path) const {
+    const Json::Value* node = &root;
+    for (const auto& segment : split_path(path)) {
+        if (!node->isObject() || !node->isMember(segment)) {
+            return nullptr;
+        }
+        node = &(*node)[segment];
+    }
+    return node->isNumeric() ? node : nullptr;
+}
+
+void PerfRegressionGate::checkMetric(const std::string& report, const MetricRule& rule, const std::string& path,
+                                     const Json::Value& baseline, const Json::Value& current) {
+    CheckResult r;
+    r.report = report;
+    r.metric = path;
+    r.better = rule.better;
+    r.limit_pct = rule.max_regression_pct;
+
+    const Json::Value* base = resolve(baseline, path);
+    const Json::Value* cur = resolve(current, path);
+    if (!base) {
+        // 基线中没有的指标（新增的阶段等）只记录，不参与判定
+        r.status = "NEW";
+        r.note = "基线中没有该指标";
+        if (cur) {
+            r.current = cur->asDouble();
+        }
+        results_.push_back(r);
+        return;
+    }
+    r.baseline = base->asDouble();
+    if (!cur) {
+        r.status = rule.required ? "MISSING" : "PASS";
+        r.note = "当前结果中没有该指标";
+        results_.push_back(r);
+        return;
+    }
+    r.current = cur->asDouble();
+    r.delta = r.current - r.baseline;
+    r.delta_pct = r.baseline != 0 ? r.delta / std::fabs(r.baseline) * 100.0 : 0.0;
+
+    // 变差量（>0 表示变差）
+    double worse;
+    if (rule.better == "lower") {
+        worse = r.delta;
+    } else if (rule.better == "higher") {
+        worse = -r.delta;
+    } else {
+        worse = std::fabs(r.delta);
+    }
+    double worse_pct = r.baseline != 0 ? worse / std::fabs(r.baseline) * 100.0
+                                       : (worse > 0 ? INFINITY : 0.0);
+
+    if (worse > rule.abs_slack && worse_pct > rule.max_regression_pct) {
+        r.status = "FAIL";
+    } else if (rule.better != "equal" && -worse > rule.abs_slack && -worse_pct > rule.max_regression_pct) {
+        r.status = "IMPROVED";
+    } else {
+        r.status = "PASS";
+    }
+    results_.push_back(r);
+}
+
+// ==================== 报告 ====================
+
+void PerfRegressionGate::printReport() const {
+    std::cout << "\n" << std::string(120, '=') << std::endl;
+    std::cout << gate_name_ << std::endl;
+    std::cout << std::string(120, '=') << std::endl;
+    std::cout << std::left << std::setw(10) << "报告" << std::setw(62) << "指标" << std::right
+              << std::setw(13) << "基线" << std::setw(13) << "当前" << std::setw(10) << "变化%"
+              << std::setw(8) << "阈值%" << "  结果" << std::endl;
+
+    size_t fails = 0;
+    size_t improved = 0;
+    std::cout << std::fixed;
+    for (const auto& r : results_) {
+        const char* mark = "✅";
+        if (r.status == "FAIL" || r.status == "MISSING") {
+            mark = "❌";
+            fails++;
+        } else if (r.status == "IMPROVED") {
+            mark = "🚀";
+            improved++;
+        } else if (r.status == "NEW") {
+            mark = "🆕";
+        }
+        std::cout << std::left << std::setw(10) << r.report << std::setw(62) << r.metric << std::right
+                  << std::setprecision(3) << std::setw(13) << r.baseline << std::setw(13) << r.current
+                  << std::setw(10) << signed_pct(r.delta_pct)
+                  << std::setprecision(1) << std::setw(8) << r.limit_pct
+                  << "  " << mark << " " << r.status;
+        if (!r.note.empty()) {
+            std::cout << " (" << r.note << ")";
+        }
+        std::cout << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+
+    std::cout << "\n检查 " << results_.size() << " 项, 回归 " << fails << " 项, 明显改善 " << improved << " 项";
+    if (!skipped_reports_.empty()) {
+        std::cout << ", 跳过报告 " << skipped_reports_.size() << " 组（无基线，已允许）";
+    }
+    if (!missing_baselines_.empty()) {
+        std::cout << ", 缺少基线 " << missing_baselines_.size() << " 组";
+    }
+    std::cout << std::endl;
+    if (passed_) {
+        std::cout << "✅ 门禁通过" << std::endl;
+    } else if (fails > 0) {
+        std::cout << "❌ 门禁未通过：存在性能回归" << std::endl;
+    } else {
+        std::cout << "❌ 门禁未通过：基线或当前结果缺失/无法解析" << std::endl;
+    }
+}
+
+bool PerfRegressionGate::saveReport(const std::string& json_file, const std::string& csv_file) const {
+    fs::create_directories(fs::path(json_file).parent_path());
+    Json::Value root;
+    root["gate_name"] = gate_name_;
+    root["passed"] = passed_;
+    Json::Value checks(Json::arrayValue);
+    for (const auto& r : results_) {
+        Json::Value item;
+        item["report"] = r.report;
+        item["metric"] = r.metric;
+        item["better"] = r.better;
+        item["baseline"] = r.baseline;
+        item["current"] = r.current;
+        item["delta"] = r.delta;
+        item["delta_pct"] = r.delta_pct;
+        item["max_regression_pct"] = r.limit_pct;
+        item["status"] = r.status;
+        if (!r.note.empty()) {
+            item["note"] = r.note;
+        }
+        checks.append(item);
+    }
+    root["checks"] = checks;
+    Json::Value skipped(Json::arrayValue);
+    for (const auto& name : skipped_reports_) {
+        skipped.append(name);
+    }
+    root["skipped_reports"] = skipped;
+    Json::Value missing(Json::arrayValue);
+    for (const auto& name : missing_baselines_) {
+        missing.append(name);
+    }
+    root["missing_baselines"] = missing;
+    root["allow_missing_baseline"] = allow_missing_baseline_;
+
+    std::ofstream out(json_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "  ";
+    out << Json::writeString(writer, root);
+    out.close();
+
+    std::ofstream csv(csv_file);
+    if (!csv.is_open()) {
+        return false;
+    }
+    csv << "report,metric,better,baseline,current,delta,delta_pct,max_regression_pct,status\n";
+    csv << std::fixed << std::setprecision(4);
+    for (const auto& r : results_) {
+        csv << r.report << "," << r.metric << "," << r.better << "," << r.baseline << "," << r.current << ","
+            << r.delta << "," << r.delta_pct << "," << r.limit_pct << "," << r.status << "\n";
+    }
+    return true;
+}
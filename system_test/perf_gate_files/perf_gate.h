@@ -0,0 +1,77 @@
+#ifndef PERF_REGRESSION_GATE_H
+#define PERF_REGRESSION_GATE_H
+
+#include <string>
+#include <vector>
+#include <jsoncpp/json/json.h>
+
+/**
+ * @brief 性能回归门禁（比较两次测试的 summary JSON）
+ *
+ * 配置中每个 report 指定一对基线/当前 summary 文件（如 insert_summary.json、search_summary.json）
+ * 与一组指标规则。指标用点号路径定位（路径段为 * 时展开基线中该层的所有成员），规则给出：
+ *   better              lower（延迟、失败数）/ higher（吞吐量）/ equal（请求与证明大小）
+ *   max_regression_pct  允许的变差百分比（equal 为双向）
+ *   abs_slack           绝对噪声下限：变化量不超过该值时不判为回归（避免亚毫秒指标误报）
+ *   required            当前结果缺少该指标时是否判为失败
+ * 任一指标回归即整体失败，报告输出每个指标的基线值、当前值与变化量。
+ * 缺少基线文件同样判为失败（门禁没有比较任何东西时不能算通过）；只有配置 allow_missing_baseline
+ * 或命令行 --allow-missing-baseline 显式允许时才跳过该报告（如首次建立基线前）。
+ */
+class PerfRegressionGate {
+public:
+    struct MetricRule {
+        std::string path;
+        std::string better = "lower";
+        double max_regression_pct = 10.0;
+        double abs_slack = 0.0;
+        bool required = true;
+    };
+
+    struct CheckResult {
+        std::string report;
+        std::string metric;
+        std::string better;
+        double baseline = 0;
+        double current = 0;
+        double delta = 0;          // current - baseline
+        double delta_pct = 0;      // 相对基线的变化百分比（基线为0时为0）
+        double limit_pct = 0;
+        std::string status;        // PASS / IMPROVED / FAIL / MISSING
+        std::string note;
+    };
+
+    struct ReportSpec {
+        std::string name;
+        std::string baseline_file;
+        std::string current_file;
+        std::vector<MetricRule> metrics;
+    };
+
+    PerfRegressionGate();
+
+    bool loadConfig(const std::string& config_file);
+    void setAllowMissingBaseline(bool allow) { allow_missing_baseline_ = allow; }
+    bool run();
+    bool saveReport(const std::string& json_file, const std::string& csv_file) const;
+
+private:
+    void checkReport(const ReportSpec& spec, const Json::Value& baseline, const Json::Value& current);
+    void checkMetric(const std::string& report, const MetricRule& rule, const std::string& path,
+                     const Json::Value& baseline, const Json::Value& current);
+    void expandPath(const Json::Value& root, const std::vector<std::string>& segments, size_t index,
+                    const std::string& prefix, std::vector<std::string>& out) const;
+    const Json::Value* resolve(const Json::Value& root, const std::string& path) const;
+    void printReport() const;
+
+    std::string gate_name_;
+    std::vector<ReportSpec> reports_;
+    bool allow_missing_baseline_;
+
+    std::vector<CheckResult> results_;
+    std::vector<std::string> skipped_reports_;   // 缺少基线文件且允许跳过的报告
+    std::vector<std::string> missing_baselines_; // 缺少基线文件而判为失败的报告
+    bool passed_;
+};
+
+#endif // PERF_REGRESSION_GATE_H
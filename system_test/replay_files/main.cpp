@@ -0,0 +1,35 @@
+/*
+ * main.cpp - 录制回放测试主程序
+ *
+ * 使用 TraceReplayTest 类在全新数据目录上回放录制的请求
+ *
+ * 编译:
+ *   make
+ *
+ * 运行:
+ *   ./trace_replay_test [配置文件路径]
+ *   默认配置: system_test/replay_files/config/replay_test_config.json
+ */
+
+#include "replay_test.h"
+#include "../common/harness_main.h"
+
+int main(int argc, char* argv[]) {
+    harness_main::Spec spec;
+    spec.icon = "📼";
+    spec.name = "录制回放测试";
+    spec.run_label = "回放录制的请求";
+    spec.default_config = "system_test/replay_files/config/replay_test_config.json";
+    // 回放结果与录制不一致时仍保存报告，便于对照 replay_detailed.csv 排查
+    spec.save_on_failure = true;
+    spec.failure_note = "回放结果与录制不一致";
+
+    return harness_main::run_harness<TraceReplayTest>(argc, argv, spec, [](TraceReplayTest& test) {
+        return std::vector<harness_main::Report>{
+            {"详细报告", "system_test/replay_files/results/replay_detailed.csv",
+             [&test](const std::string& p) { return test.saveDetailedReport(p); }},
+            {"总结报告", "system_test/replay_files/results/replay_summary.json",
+             [&test](const std::string& p) { return test.saveSummaryReport(p); }}
+        };
+    });
+}
@@ -0,0 +1,350 @@
+#include "replay_test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+using test_fixture::load_json;
+
+namespace {
+
+Json::Value histogram_json(const perf_metrics::Histogram& h) {
+    Json::Value item;
+    item["count"] = static_cast<Json::UInt64>(h.count());
+    item["mean_ms"] = h.mean_ns() / 1e6;
+    item["p50_ms"] = h.percentile_ms(50);
+    item["p90_ms"] = h.percentile_ms(90);
+    item["p99_ms"] = h.percentile_ms(99);
+    item["max_ms"] = static_cast<double>(h.max_ns()) / 1e6;
+    return item;
+}
+
+} // namespace
+
+TraceReplayTest::TraceReplayTest()
+    : workers_(0),
+      speed_(1.0),
+      reset_work_dir_(true),
+      verbose_(false),
+      node_(nullptr),
+      server_(nullptr),
+      run_wall_s_(0),
+      trace_span_s_(0) {}
+
+TraceReplayTest::~TraceReplayTest() {
+    if (server_) {
+        server_->stop();
+        delete server_;
+    }
+    delete node_;
+}
+
+// ==================== 配置与初始化 ====================
+
+bool TraceReplayTest::loadConfig(const std::string& config_file) {
+    Json::Value config;
+    if (!load_json(config_file, config)) {
+        std::cerr << "[错误] 无法读取配置文件: " << config_file << std::endl;
+        return false;
+    }
+
+    test_name_ = config.get("test_name", "trace replay").asString();
+
+    const Json::Value& paths = config["paths"];
+    public_params_file_ = paths.get("public_params", "vds-client/data/public_params.json").asString();
+    trace_dir_ = paths.get("trace_dir", "system_test/replay_files/data/trace").asString();
+    work_dir_ = paths.get("work_dir", "system_test/replay_files/data/work").asString();
+
+    workers_ = config["server"].get("workers", 0).asInt();
+
+    const Json::Value& options = config["options"];
+    speed_ = std::max(0.0, options.get("speed", 1.0).asDouble());
+    reset_work_dir_ = options.get("reset_work_dir", true).asBool();
+    verbose_ = options.get("verbose", false).asBool();
+
+    std::cout << "[配置] 录制目录: " << trace_dir_ << std::endl;
+    std::cout << "[配置] 回放数据目录: " << work_dir_ << std::endl;
+    std::cout << "[配置] 回放速度: " << (speed_ > 0 ? std::to_string(speed_) + "x" : std::string("尽快")) << std::endl;
+    return true;
+}
+
+bool TraceReplayTest::initialize() {
+    std::string error;
+    if (!op_trace::read_trace(trace_dir_, records_, error)) {
+        std::cerr << "[错误] " << error << std::endl;
+        return false;
+    }
+    if (records_.empty()) {
+        std::cerr << "[错误] 录制文件中没有请求" << std::endl;
+        return false;
+    }
+    for (const auto& r : records_) {
+        streams_[r.conn].push_back(&r);
+    }
+    trace_span_s_ = (records_.back().received_ns - records_.front().received_ns) / 1e9;
+    std::cout << "[初始化] 读取 " << records_.size() << " 个请求, " << streams_.size()
+              << " 个连接, 录制跨度 " << std::fixed << std::setprecision(2) << trace_span_s_ << " 秒" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+
+    // 回放必须从空数据目录开始，录制中的插入/删除才能以相同顺序重建状态
+    if (fs::exists(work_dir_) && !fs::is_empty(work_dir_)) {
+        if (!reset_work_dir_) {
+            std::cerr << "[错误] 回放数据目录非空: " << work_dir_ << " (设置 reset_work_dir 为 true)" << std::endl;
+            return false;
+        }
+        std::cout << "[初始化] 清空回放数据目录: " << work_dir_ << std::endl;
+        fs::remove_all(work_dir_);
+    }
+    fs::create_directories(work_dir_);
+
+    node_ = new StorageNode(work_dir_, 0);
+    if (!node_->load_public_params(public_params_file_)) {
+        std::cerr << "[错误] 服务端加载公共参数失败" << std::endl;
+        return false;
+    }
+    if (!node_->initialize_directories()) {
+        std::cerr << "[错误] 服务端目录初始化失败" << std::endl;
+        return false;
+    }
+    node_->load_index_database();
+    node_->load_search_database();
+
+    server_ = new NodeServer(node_, 0, workers_, "127.0.0.1");
+    if (!server_->start()) {
+        std::cerr << "[错误] 服务启动失败" << std::endl;
+        return false;
+    }
+    std::cout << "[初始化] 服务监听 127.0.0.1:" << server_->port() << std::endl;
+    return true;
+}
+
+// ==================== 测试执行 ====================
+
+bool TraceReplayTest::mapUploadId(Json::Value& request) {
+    if (!request.isMember("upload_id")) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(upload_mutex_);
+    auto it = upload_ids_.find(request["upload_id"].asString());
+    if (it == upload_ids_.end()) {
+        return false;
+    }
+    request["upload_id"] = it->second;
+    return true;
+}
+
+void TraceReplayTest::replayConnection(const std::vector<const op_trace::Record*>& stream, uint64_t run_start,
+                                       std::vector<ReplayResult>& out) {
+    node_protocol::Client conn;
+    bool connected = conn.connect("127.0.0.1", server_->port());
+    uint64_t origin = records_.front().received_ns;
+
+    for (const op_trace::Record* rec : stream) {
+        ReplayResult r;
+        r.seq = rec->seq;
+        r.conn = rec->conn;
+        r.op = rec->op;
+        r.recorded_ms = (rec->queue_ns + rec->service_ns) / 1e6;
+        r.recorded_ok = rec->ok;
+        r.ok = false;
+        r.scheduled_ns = speed_ > 0 ? static_cast<uint64_t>((rec->received_ns - origin) / speed_) : 0;
+
+        // 负载在等待之前读取，磁盘读取不计入回放延迟
+        std::string payload;
+        Json::Value request = rec->request;
+        bool ready = op_trace::read_payload(trace_dir_, *rec, payload, r.error_msg);
+        if (ready && !mapUploadId(request)) {
+            ready = false;
+            r.error_msg = "录制的上传ID没有对应的回放上传";
+        }
+
+        uint64_t now = perf_metrics::now_ns() - run_start;
+        if (r.scheduled_ns > now) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(r.scheduled_ns - now));
+        }
+        r.start_ns = perf_metrics::now_ns() - run_start;
+
+        if (!connected) {
+            r.error_msg = "连接失败: " + conn.last_error();
+        } else if (ready) {
+            node_protocol::Message resp;
+            if (!conn.call(request, payload, resp)) {
+                r.error_msg = conn.last_error();
+                connected = conn.connect("127.0.0.1", server_->port());
+            } else {
+                r.ok = resp.header.get("ok", false).asBool();
+                r.error_msg = resp.header.get("error", "").asString();
+                if (r.ok && rec->op == "upload_begin" && !rec->upload_id.empty()) {
+                    std::lock_guard<std::mutex> lock(upload_mutex_);
+                    upload_ids_[rec->upload_id] = resp.header["result"]["upload_id"].asString();
+                }
+            }
+        }
+        r.end_ns = perf_metrics::now_ns() - run_start;
+        out.push_back(std::move(r));
+    }
+}
+
+bool TraceReplayTest::runTest() {
+    start_time_ = test_fixture::current_timestamp();
+    std::cout << "\n[回放] " << records_.size() << " 个请求, " << streams_.size() << " 个并发连接" << std::endl;
+
+    std::vector<std::vector<ReplayResult>> per_conn(streams_.size());
+    std::vector<std::thread> pool;
+    uint64_t run_start = perf_metrics::now_ns();
+    size_t index = 0;
+    for (const auto& kv : streams_) {
+        std::vector<ReplayResult>& out = per_conn[index++];
+        const auto& stream = kv.second;
+        pool.emplace_back([this, &stream, &out, run_start]() { replayConnection(stream, run_start, out); });
+    }
+    for (auto& th : pool) {
+        th.join();
+    }
+    run_wall_s_ = perf_metrics::elapsed_ms(run_start) / 1000.0;
+
+    for (auto& part : per_conn) {
+        results_.insert(results_.end(), part.begin(), part.end());
+    }
+    std::sort(results_.begin(), results_.end(), [](const ReplayResult& a, const ReplayResult& b) {
+        return a.seq < b.seq;
+    });
+
+    server_stats_ = server_->stats();
+    server_->stop();
+    end_time_ = test_fixture::current_timestamp();
+
+    if (verbose_) {
+        for (const auto& r : results_) {
+            if (r.ok != r.recorded_ok) {
+                std::cerr << "   ⚠️  #" << r.seq << " " << r.op << " 录制 " << (r.recorded_ok ? "成功" : "失败")
+                          << ", 回放 " << (r.ok ? "成功" : "失败") << " " << r.error_msg << std::endl;
+            }
+        }
+    }
+    printSummary();
+
+    for (const auto& r : results_) {
+        if (r.ok != r.recorded_ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==================== 统计与报告 ====================
+
+void TraceReplayTest::printSummary() const {
+    std::map<std::string, perf_metrics::Histogram> recorded;
+    std::map<std::string, perf_metrics::Histogram> replayed;
+    std::map<std::string, size_t> mismatches;
+    perf_metrics::Histogram lag;
+    for (const auto& r : results_) {
+        recorded[r.op].record(static_cast<uint64_t>(r.recorded_ms * 1e6));
+        replayed[r.op].record(r.end_ns - r.start_ns);
+        lag.record(r.start_ns - std::min(r.start_ns, r.scheduled_ns));
+        if (r.ok != r.recorded_ok) {
+            mismatches[r.op]++;
+        }
+    }
+
+    std::cout << "\n" << std::string(90, '=') << std::endl;
+    std::cout << "录制回放总结" << std::endl;
+    std::cout << std::string(90, '=') << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "录制跨度 " << trace_span_s_ << " 秒, 回放用时 " << run_wall_s_ << " 秒, 发送滞后 p50 "
+              << lag.percentile_ms(50) << " ms / p99 " << lag.percentile_ms(99) << " ms" << std::endl;
+    std::cout << std::left << std::setw(16) << "请求" << std::right << std::setw(8) << "数量"
+              << std::setw(10) << "结果不符" << std::setw(13) << "录制p50 ms" << std::setw(13) << "回放p50 ms"
+              << std::setw(13) << "录制p99 ms" << std::setw(13) << "回放p99 ms" << std::endl;
+    for (const auto& kv : recorded) {
+        const perf_metrics::Histogram& rep = replayed.at(kv.first);
+        auto it = mismatches.find(kv.first);
+        std::cout << std::left << std::setw(16) << kv.first << std::right << std::setw(8) << kv.second.count()
+                  << std::setw(10) << (it == mismatches.end() ? 0 : it->second)
+                  << std::setw(13) << kv.second.percentile_ms(50) << std::setw(13) << rep.percentile_ms(50)
+                  << std::setw(13) << kv.second.percentile_ms(99) << std::setw(13) << rep.percentile_ms(99) << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << "\n📡 服务端: 连接 " << server_stats_.connections_accepted << ", 请求 " << server_stats_.requests
+              << " (失败 " << server_stats_.failed_requests << ")" << std::endl;
+}
+
+bool TraceReplayTest::saveDetailedReport(const std::string& csv_file) {
+    fs::create_directories(fs::path(csv_file).parent_path());
+    std::ofstream out(csv_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    out << "seq,conn,op,scheduled_ms,start_ms,lag_ms,replay_ms,recorded_ms,recorded_ok,ok,error\n";
+    out << std::fixed << std::setprecision(3);
+    for (const auto& r : results_) {
+        out << r.seq << "," << r.conn << "," << r.op << "," << r.scheduled_ns / 1e6 << "," << r.start_ns / 1e6
+            << "," << (r.start_ns - std::min(r.start_ns, r.scheduled_ns)) / 1e6 << ","
+            << (r.end_ns - r.start_ns) / 1e6 << "," << r.recorded_ms << ","
+            << (r.recorded_ok ? "true" : "false") << "," << (r.ok ? "true" : "false")
+            << ",\"" << r.error_msg << "\"\n";
+    }
+    return true;
+}
+
+bool TraceReplayTest::saveSummaryReport(const std::string& json_file) {
+    fs::create_directories(fs::path(json_file).parent_path());
+    Json::Value root;
+    root["test_info"]["test_name"] = test_name_;
+    root["test_info"]["start_time"] = start_time_;
+    root["test_info"]["end_time"] = end_time_;
+    root["test_info"]["trace_dir"] = trace_dir_;
+    root["test_info"]["speed"] = speed_;
+    root["test_info"]["requests"] = static_cast<Json::UInt64>(records_.size());
+    root["test_info"]["connections"] = static_cast<Json::UInt64>(streams_.size());
+    root["test_info"]["trace_span_s"] = trace_span_s_;
+    root["test_info"]["replay_wall_s"] = run_wall_s_;
+
+    std::map<std::string, perf_metrics::Histogram> recorded;
+    std::map<std::string, perf_metrics::Histogram> replayed;
+    std::map<std::string, uint64_t> mismatches;
+    perf_metrics::Histogram lag;
+    uint64_t total_mismatches = 0;
+    for (const auto& r : results_) {
+        recorded[r.op].record(static_cast<uint64_t>(r.recorded_ms * 1e6));
+        replayed[r.op].record(r.end_ns - r.start_ns);
+        lag.record(r.start_ns - std::min(r.start_ns, r.scheduled_ns));
+        if (r.ok != r.recorded_ok) {
+            mismatches[r.op]++;
+            total_mismatches++;
+        }
+    }
+    root["result_mismatches"] = static_cast<Json::UInt64>(total_mismatches);
+    root["send_lag"] = histogram_json(lag);
+
+    Json::Value ops(Json::objectValue);
+    for (const auto& kv : recorded) {
+        Json::Value item;
+        item["mismatches"] = static_cast<Json::UInt64>(mismatches[kv.first]);
+        item["recorded_server"] = histogram_json(kv.second);
+        item["replay_round_trip"] = histogram_json(replayed[kv.first]);
+        ops[kv.first] = item;
+    }
+    root["operations"] = ops;
+
+    root["server"]["connections_accepted"] = static_cast<Json::UInt64>(server_stats_.connections_accepted);
+    root["server"]["requests"] = static_cast<Json::UInt64>(server_stats_.requests);
+    root["server"]["failed_requests"] = static_cast<Json::UInt64>(server_stats_.failed_requests);
+    root["server"]["latency"] = server_->latency().to_json();
+
+    std::ofstream out(json_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "  ";
+    out << Json::writeString(writer, root);
+    return true;
+}
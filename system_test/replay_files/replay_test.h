@@ -0,0 +1,89 @@
+#ifndef TRACE_REPLAY_TEST_H
+#define TRACE_REPLAY_TEST_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <jsoncpp/json/json.h>
+
+#include "../../Storage-node/storage_node.h"
+#include "../../Storage-node/node_server.h"
+#include "../../common/node_protocol.h"
+#include "../../common/op_trace.h"
+#include "../../common/perf_metrics.h"
+#include "../common/test_fixture.h"
+
+/**
+ * @brief 请求录制回放（离线复现线上性能问题）
+ *
+ * 读取存储节点服务模式录制的 requests.jsonl（storage_node ... --serve --record <trace_dir>），
+ * 在全新的数据目录上启动进程内 StorageNode + NodeServer，按录制时的连接数并发回放：
+ * 每个录制连接对应一个回放连接，连接内按到达时刻顺序发送，发送时刻为 received_ns / speed
+ * （speed = 1 为原速，> 1 为加速，0 为不等待、尽快发送）。
+ * upload_begin 分配的上传ID在回放时映射为新的ID。
+ *
+ * 报告每个请求的回放结果与录制结果是否一致、相对计划时刻的滞后，
+ * 以及录制与回放两侧按请求类型的延迟分位数对比。
+ */
+class TraceReplayTest {
+public:
+    struct ReplayResult {
+        uint64_t seq;              // 录制序号
+        uint64_t conn;             // 录制连接ID
+        std::string op;
+        uint64_t scheduled_ns;     // 计划发送时刻（相对回放开始）
+        uint64_t start_ns;         // 实际发送时刻
+        uint64_t end_ns;           // 收到响应时刻
+        double recorded_ms;        // 录制时服务端耗时（queue + service）
+        bool recorded_ok;
+        bool ok;
+        std::string error_msg;
+    };
+
+    TraceReplayTest();
+    ~TraceReplayTest();
+
+    bool loadConfig(const std::string& config_file);
+    bool initialize();
+    bool runTest();
+    bool saveDetailedReport(const std::string& csv_file);
+    bool saveSummaryReport(const std::string& json_file);
+
+private:
+    void replayConnection(const std::vector<const op_trace::Record*>& stream, uint64_t run_start,
+                          std::vector<ReplayResult>& out);
+    bool mapUploadId(Json::Value& request);
+    void printSummary() const;
+
+    // 配置
+    std::string test_name_;
+    std::string public_params_file_;
+    std::string trace_dir_;
+    std::string work_dir_;
+    int workers_;
+    double speed_;                  // 回放速度倍数（0 = 尽快）
+    bool reset_work_dir_;
+    bool verbose_;
+
+    // 组件
+    StorageNode* node_;
+    NodeServer* server_;
+
+    // 录制数据
+    std::vector<op_trace::Record> records_;
+    std::map<uint64_t, std::vector<const op_trace::Record*>> streams_;   // 录制连接 -> 请求
+    std::mutex upload_mutex_;
+    std::map<std::string, std::string> upload_ids_;                        // 录制上传ID -> 回放上传ID
+
+    // 结果
+    std::vector<ReplayResult> results_;
+    double run_wall_s_;
+    double trace_span_s_;           // 录制中首个到最后一个请求的时间跨度
+    NodeServer::Stats server_stats_;
+    std::string start_time_;
+    std::string end_time_;
+};
+
+#endif // TRACE_REPLAY_TEST_H
@@ -0,0 +1,37 @@
+/*
+ * main.cpp - 存储节点规模基准主程序
+ *
+ * 使用 ScaleBenchmarkTest 类测量插入/搜索开销随数据库规模的变化
+ *
+ * 编译:
+ *   make
+ *
+ * 运行:
+ *   ./scale_benchmark_test [配置文件路径]
+ *   默认配置: system_test/scale_files/config/scale_test_config.json
+ */
+
+#include "scale_test.h"
+#include "../common/harness_main.h"
+
+int main(int argc, char* argv[]) {
+    harness_main::Spec spec;
+    spec.icon = "📈";
+    spec.name = "存储节点规模基准";
+    spec.run_label = "运行规模基准测试";
+    spec.default_config = "system_test/scale_files/config/scale_test_config.json";
+
+    return harness_main::run_harness<ScaleBenchmarkTest>(argc, argv, spec, [](ScaleBenchmarkTest& test) {
+        const std::string steps_file = "system_test/scale_files/results/scale_steps.csv";
+        return std::vector<harness_main::Report>{
+            {"详细报告", "system_test/scale_files/results/scale_detailed.csv",
+             [&test](const std::string& p) { return test.saveDetailedReport(p); }},
+            {"规模曲线", steps_file,
+             [&test](const std::string& p) { return test.saveStepReport(p); }},
+            {"绘图脚本", "system_test/scale_files/results/scale_plot.gp",
+             [&test, steps_file](const std::string& p) { return test.savePlotScript(p, steps_file); }},
+            {"总结报告", "system_test/scale_files/results/scale_summary.json",
+             [&test](const std::string& p) { return test.saveSummaryReport(p); }}
+        };
+    });
+}
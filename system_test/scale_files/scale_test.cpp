@@ -0,0 +1,612 @@
+#include "scale_test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <openssl/sha.h>
+
+namespace fs = std::filesystem;
+
+using test_fixture::load_json;
+
+namespace {
+
+uint64_t file_size_or_zero(const std::string& path) {
+    std::error_code ec;
+    uint64_t size = fs::file_size(path, ec);
+    return ec ? 0 : size;
+}
+
+uint64_t directory_size(const std::string& path) {
+    uint64_t total = 0;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file(ec)) {
+            total += file_size_or_zero(it->path().string());
+        }
+    }
+    return total;
+}
+
+} // namespace
+
+ScaleBenchmarkTest::ScaleBenchmarkTest()
+    : probe_inserts_(5),
+      search_files_(8),
+      search_keywords_(4),
+      search_rounds_(5),
+      file_size_(4 * 1024),
+      filler_tags_(4),
+      filler_keywords_(1),
+      measure_reload_(true),
+      capacity_ram_gib_(16.0),
+      reset_work_dir_(true),
+      verbose_(false),
+      client_(nullptr),
+      node_(nullptr),
+      filler_serial_(0) {}
+
+ScaleBenchmarkTest::~ScaleBenchmarkTest() {
+    delete node_;
+    delete client_;
+}
+
+// ==================== 配置与初始化 ====================
+
+bool ScaleBenchmarkTest::loadConfig(const std::string& config_file) {
+    Json::Value config;
+    if (!load_json(config_file, config)) {
+        std::cerr << "[错误] 无法读取配置文件: " << config_file << std::endl;
+        return false;
+    }
+
+    test_name_ = config.get("test_name", "storage node scaling").asString();
+
+    const Json::Value& paths = config["paths"];
+    public_params_file_ = paths.get("public_params", "vds-client/data/public_params.json").asString();
+    work_dir_ = paths.get("work_dir", "system_test/scale_files/data/work").asString();
+
+    const Json::Value& options = config["options"];
+    steps_.clear();
+    if (options["steps"].isArray()) {
+        for (const auto& v : options["steps"]) {
+            steps_.push_back(static_cast<size_t>(v.asUInt64()));
+        }
+    }
+    if (steps_.empty()) {
+        steps_ = {1000, 10000, 100000, 1000000};
+    }
+    std::sort(steps_.begin(), steps_.end());
+    steps_.erase(std::unique(steps_.begin(), steps_.end()), steps_.end());
+
+    probe_inserts_ = std::max(1, options.get("probe_inserts", 5).asInt());
+    search_files_ = std::max(1, options.get("search_files", 8).asInt());
+    search_keywords_ = std::max(1, options.get("search_keywords", 4).asInt());
+    search_rounds_ = std::max(1, options.get("search_rounds", 5).asInt());
+    file_size_ = options.get("file_size", 4 * 1024).asUInt64();
+    filler_tags_ = std::max(1, options.get("filler_tags", 4).asInt());
+    filler_keywords_ = std::max(1, options.get("filler_keywords", 1).asInt());
+    measure_reload_ = options.get("measure_reload", true).asBool();
+    capacity_ram_gib_ = options.get("capacity_ram_gib", 16.0).asDouble();
+    reset_work_dir_ = options.get("reset_work_dir", true).asBool();
+    verbose_ = options.get("verbose", false).asBool();
+
+    std::cout << "[配置] 工作目录: " << work_dir_ << std::endl;
+    std::cout << "[配置] 规模点:";
+    for (size_t s : steps_) {
+        std::cout << " " << s;
+    }
+    std::cout << std::endl;
+    std::cout << "[配置] 每级探测插入: " << probe_inserts_ << ", 搜索: " << search_keywords_ << " 个关键词 x "
+              << search_rounds_ << " 轮, 合成条目: " << filler_tags_ << " 个标签 / "
+              << filler_keywords_ << " 个关键词" << std::endl;
+    return true;
+}
+
+bool ScaleBenchmarkTest::initialize() {
+    if (reset_work_dir_ && fs::exists(work_dir_)) {
+        std::cout << "[初始化] 清空工作目录: " << work_dir_ << std::endl;
+        fs::remove_all(work_dir_);
+    }
+    std::string client_dir = work_dir_ + "/client";
+    std::string node_dir = work_dir_ + "/node";
+    fs::create_directories(client_dir);
+    fs::create_directories(node_dir);
+    fs::create_directories(work_dir_ + "/plain");
+
+    client_ = new StorageClient();
+    StorageClient::configureDataDirectories(client_dir);
+    if (!client_->initialize(public_params_file_) || !client_->initializeDataDirectories()) {
+        std::cerr << "[错误] 客户端初始化失败" << std::endl;
+        return false;
+    }
+    std::string key_file = client_dir + "/private_key.dat";
+    if (!client_->loadKeys(key_file)) {
+        if (!client_->generateKeys(key_file)) {
+            std::cerr << "[错误] 密钥生成失败" << std::endl;
+            return false;
+        }
+        client_->saveKeys(key_file);
+    }
+    client_->setInsertBundleMode(true);
+
+    node_ = new StorageNode(node_dir, 0);
+    if (!node_->load_public_params(public_params_file_) || !node_->initialize_directories()) {
+        std::cerr << "[错误] 存储节点初始化失败" << std::endl;
+        return false;
+    }
+    if (!node_->load_index_database() || !node_->load_search_database()) {
+        std::cerr << "[错误] 存储节点数据库加载失败" << std::endl;
+        return false;
+    }
+
+    // 搜索文件在测试开始前插入：关键词链长度固定，搜索延迟只随数据库规模变化
+    std::cout << "\n[准备] 生成请求..." << std::endl;
+    std::vector<std::string> search_pool;
+    for (int k = 0; k < search_keywords_; ++k) {
+        search_pool.push_back("scale_kw_" + std::to_string(k));
+    }
+    std::vector<insert_bundle::Bundle> search_bundles;
+    if (!prepareFiles("search", search_files_, search_pool, 2, search_bundles)) {
+        return false;
+    }
+    for (const auto& bundle : search_bundles) {
+        if (!node_->insert_from_bundle(bundle)) {
+            std::cerr << "[错误] 搜索文件插入失败: " << bundle.ID_F << std::endl;
+            return false;
+        }
+    }
+
+    // 探测文件使用每级独立的关键词，不改变搜索关键词的令牌
+    probe_bundles_.assign(steps_.size(), {});
+    for (size_t s = 0; s < steps_.size(); ++s) {
+        std::vector<std::string> probe_pool = {"probe_kw_" + std::to_string(s)};
+        if (!prepareFiles("probe" + std::to_string(s), probe_inserts_, probe_pool, 1, probe_bundles_[s])) {
+            return false;
+        }
+    }
+
+    for (const auto& kw : search_pool) {
+        Json::Value params;
+        if (!client_->searchKeyword(kw) || !load_json(work_dir_ + "/client/Search/" + kw + ".json", params)) {
+            std::cerr << "[错误] 搜索令牌生成失败: " << kw << std::endl;
+            return false;
+        }
+        search_params_.push_back(params);
+    }
+
+    if (!captureTemplate()) {
+        return false;
+    }
+
+    std::cout << "[准备] 完成: 搜索文件 " << search_bundles.size() << " (已插入), 探测文件 "
+              << steps_.size() << " x " << probe_inserts_ << ", 搜索令牌 " << search_params_.size() << std::endl;
+    return true;
+}
+
+bool ScaleBenchmarkTest::prepareFiles(const std::string& prefix, int count,
+                                      const std::vector<std::string>& keyword_pool,
+                                      size_t keywords_per_file, std::vector<insert_bundle::Bundle>& out) {
+    std::mt19937_64 rng(std::random_device{}());
+    size_t per_file = std::min(keywords_per_file, keyword_pool.size());
+
+    for (int i = 0; i < count; ++i) {
+        std::vector<std::string> keywords =
+            test_fixture::pick_keywords(keyword_pool, static_cast<size_t>(i) * per_file, per_file);
+        test_fixture::EncryptedFile file;
+        if (!test_fixture::encrypt_random_file(*client_, work_dir_ + "/client",
+                                               work_dir_ + "/plain/" + prefix + "_" + std::to_string(i) + ".bin",
+                                               file_size_, keywords, rng, file)) {
+            return false;
+        }
+        out.push_back(std::move(file.bundle));
+    }
+    return true;
+}
+
+bool ScaleBenchmarkTest::captureTemplate() {
+    // 合成条目复用真实条目的公钥、认证标签与关联标签文本，使每条记录的体积与真实插入一致
+    auto lock = node_->read_lock();
+    if (node_->index_database.empty() || node_->index_database.begin()->second.keywords.empty()) {
+        std::cerr << "[错误] 没有可用作模板的索引条目" << std::endl;
+        return false;
+    }
+    const IndexEntry& entry = node_->index_database.begin()->second;
+    template_PK_ = entry.PK;
+    template_kt_ = entry.keywords.front().kt_wi;
+    template_tags_.clear();
+    for (int i = 0; i < filler_tags_; ++i) {
+        template_tags_.push_back(entry.TS_F[static_cast<size_t>(i) % entry.TS_F.size()]);
+    }
+    return true;
+}
+
+// ==================== 合成条目 ====================
+
+size_t ScaleBenchmarkTest::fillSynthetic(size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+
+    // 每个关键词的 Ti_bar 为不同的 G1 元素（随机起点连乘生成元），保证搜索索引的键唯一
+    element_t token;
+    element_init_G1(token, node_->pairing);
+    element_random(token);
+    std::vector<unsigned char> buf;
+
+    std::lock_guard<std::mutex> writer(node_->writer_mutex);
+    auto lock = node_->write_lock();
+    size_t added = 0;
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    while (added < count) {
+        std::string seed = "scale_filler_" + std::to_string(filler_serial_++);
+        SHA256(reinterpret_cast<const unsigned char*>(seed.data()), seed.size(), digest);
+
+        IndexEntry entry;
+        entry.ID_F = node_->file_id_from_digest(digest);
+        if (node_->index_database.count(entry.ID_F)) {
+            continue;
+        }
+        entry.PK = template_PK_;
+        entry.TS_F = template_tags_;
+        entry.state = "valid";
+        entry.file_path = node_->files_dir + "/" + entry.ID_F + ".enc";
+
+        for (int k = 0; k < filler_keywords_; ++k) {
+            element_mul(token, token, node_->g);
+            seed.push_back('#');
+            SHA256(reinterpret_cast<const unsigned char*>(seed.data()), seed.size(), digest);
+
+            IndexKeywords kw;
+            kw.ptr_i = node_->bytesToHex(digest, SHA256_DIGEST_LENGTH);
+            kw.kt_wi = template_kt_;
+            kw.Ti_bar = node_->serializeElement(token, buf);
+            entry.keywords.push_back(kw);
+
+            IndexSearchEntry search_entry;
+            search_entry.Ti_bar = kw.Ti_bar;
+            search_entry.ID_F = entry.ID_F;
+            search_entry.ptr_i = kw.ptr_i;
+            search_entry.state = entry.state;
+            search_entry.kt_wi = kw.kt_wi;
+            node_->search_database.emplace(kw.Ti_bar, std::move(search_entry));
+        }
+        node_->index_database.emplace(entry.ID_F, std::move(entry));
+        added++;
+    }
+
+    element_clear(token);
+    return added;
+}
+
+// ==================== 测试执行 ====================
+
+void ScaleBenchmarkTest::runStep(size_t step_index, StepResult& step) {
+    step.target = steps_[step_index];
+    const auto& probes = probe_bundles_[step_index];
+
+    size_t current = node_->get_index_count();
+    size_t reserved = current + probes.size();
+    size_t fill_count = step.target > reserved ? step.target - reserved : 0;
+
+    // 1. 合成条目 + 一次全量持久化
+    std::cout << "   [fill] 加入 " << fill_count << " 个合成条目..." << std::endl;
+    uint64_t t0 = perf_metrics::now_ns();
+    step.filled = fillSynthetic(fill_count);
+    step.fill_ms = perf_metrics::elapsed_ms(t0);
+
+    t0 = perf_metrics::now_ns();
+    bool persisted = node_->save_index_database() && node_->save_search_database();
+    step.persist_ms = perf_metrics::elapsed_ms(t0);
+    if (!persisted) {
+        std::cerr << "   ❌ 数据库持久化失败" << std::endl;
+    }
+
+    // 2. 探测插入（完整插入路径，每次插入都重写两个数据库）
+    for (size_t i = 0; i < probes.size(); ++i) {
+        OpResult res{step_index, "insert", i, 0, false};
+        t0 = perf_metrics::now_ns();
+        res.success = node_->insert_from_bundle(probes[i]);
+        uint64_t ns = perf_metrics::now_ns() - t0;
+        res.latency_ms = static_cast<double>(ns) / 1e6;
+        step.insert_ms.record(ns);
+        if (!res.success) {
+            step.insert_failures++;
+            if (verbose_) {
+                std::cerr << "   ⚠️  探测插入失败: " << probes[i].ID_F << std::endl;
+            }
+        }
+        results_.push_back(res);
+    }
+
+    // 3. 固定关键词搜索（内存数据库），每级验证一次结果
+    for (int r = 0; r < search_rounds_; ++r) {
+        for (size_t k = 0; k < search_params_.size(); ++k) {
+            OpResult res{step_index, "search", k, 0, false};
+            t0 = perf_metrics::now_ns();
+            SearchProofResult proof = node_->ComputeSearchProof(search_params_[k]);
+            uint64_t ns = perf_metrics::now_ns() - t0;
+            res.latency_ms = static_cast<double>(ns) / 1e6;
+            res.success = proof.success && !proof.AS.empty();
+            step.search_ms.record(ns);
+            if (!res.success) {
+                step.search_failures++;
+            }
+            results_.push_back(res);
+
+            if (r == 0 && k == 0 && proof.success) {
+                OpResult vres{step_index, "verify_search", k, 0, false};
+                t0 = perf_metrics::now_ns();
+                vres.success = node_->VerifySearchProof(proof);
+                vres.latency_ms = perf_metrics::elapsed_ms(t0);
+                if (!vres.success) {
+                    step.search_failures++;
+                }
+                results_.push_back(vres);
+            }
+        }
+    }
+
+    // 4. 重新加载（路径版搜索/证明接口每次请求都会执行）
+    if (measure_reload_) {
+        t0 = perf_metrics::now_ns();
+        node_->load_index_database();
+        step.reload_index_ms = perf_metrics::elapsed_ms(t0);
+        t0 = perf_metrics::now_ns();
+        node_->load_search_database();
+        step.reload_search_ms = perf_metrics::elapsed_ms(t0);
+    }
+
+    step.index_entries = node_->get_index_count();
+    step.search_entries = node_->get_search_index_count();
+    measureFootprint(step);
+}
+
+void ScaleBenchmarkTest::measureFootprint(StepResult& step) const {
+    step.node_memory = node_->get_memory_usage();
+    step.rss_kb = step.node_memory.process.rss_kb;
+    step.peak_rss_kb = step.node_memory.process.peak_rss_kb;
+    std::string node_dir = node_->get_data_dir();
+    step.index_db_bytes = file_size_or_zero(node_dir + "/index_db.json");
+    step.search_db_bytes = file_size_or_zero(node_dir + "/search_db.json");
+    step.node_dir_bytes = directory_size(node_dir);
+}
+
+bool ScaleBenchmarkTest::runTest() {
+    start_time_ = test_fixture::current_timestamp();
+    step_results_.assign(steps_.size(), StepResult());
+
+    for (size_t s = 0; s < steps_.size(); ++s) {
+        std::cout << "\n[规模] " << (s + 1) << "/" << steps_.size() << ": " << steps_[s] << " 个文件" << std::endl;
+        StepResult& step = step_results_[s];
+        runStep(s, step);
+        std::cout << std::fixed << std::setprecision(2)
+                  << "   插入 p50 " << step.insert_ms.percentile_ms(50) << " ms, 搜索 p50 "
+                  << step.search_ms.percentile_ms(50) << " ms, 持久化 " << step.persist_ms
+                  << " ms, RSS " << step.rss_kb / 1024 << " MB, 数据库内存 "
+                  << step.node_memory.bytes_per_file() << " 字节/文件" << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+
+    end_time_ = test_fixture::current_timestamp();
+    printSummary();
+
+    for (const auto& step : step_results_) {
+        if (step.insert_failures > 0 || step.search_failures > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==================== 统计与报告 ====================
+
+void ScaleBenchmarkTest::printSummary() const {
+    std::cout << "\n" << std::string(100, '=') << std::endl;
+    std::cout << "存储节点规模基准总结" << std::endl;
+    std::cout << std::string(100, '=') << std::endl;
+    std::cout << std::right << std::setw(10) << "文件数" << std::setw(10) << "插入p50" << std::setw(10) << "插入p99"
+              << std::setw(10) << "搜索p50" << std::setw(10) << "搜索p99" << std::setw(12) << "持久化ms"
+              << std::setw(12) << "重载ms" << std::setw(10) << "RSS MB" << std::setw(12) << "磁盘 MB"
+              << std::setw(7) << "失败" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& s : step_results_) {
+        std::cout << std::setw(10) << s.index_entries << std::setw(10) << s.insert_ms.percentile_ms(50)
+                  << std::setw(10) << s.insert_ms.percentile_ms(99) << std::setw(10) << s.search_ms.percentile_ms(50)
+                  << std::setw(10) << s.search_ms.percentile_ms(99) << std::setw(12) << s.persist_ms
+                  << std::setw(12) << (s.reload_index_ms + s.reload_search_ms)
+                  << std::setw(10) << s.rss_kb / 1024.0 << std::setw(12) << s.node_dir_bytes / (1024.0 * 1024.0)
+                  << std::setw(7) << (s.insert_failures + s.search_failures) << std::endl;
+    }
+
+    Json::Value capacity = capacityEstimate();
+    if (capacity.isMember("files_by_rss")) {
+        std::cout << "\n容量估算 (" << capacity_ram_gib_ << " GiB): 按常驻内存 "
+                  << capacity["rss_bytes_per_file"].asDouble() << " 字节/文件 约 "
+                  << capacity["files_by_rss"].asDouble() / 1e6 << " 百万个文件; 按数据结构 "
+                  << capacity["structure_bytes_per_file"].asDouble() << " 字节/文件 约 "
+                  << capacity["files_by_structures"].asDouble() / 1e6 << " 百万个文件" << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+}
+
+bool ScaleBenchmarkTest::saveDetailedReport(const std::string& csv_file) {
+    fs::create_directories(fs::path(csv_file).parent_path());
+    std::ofstream out(csv_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    out << "step,target,op,index,latency_ms,success\n";
+    for (const auto& r : results_) {
+        out << r.step << "," << steps_[r.step] << "," << r.op << "," << r.index << "," << std::fixed
+            << std::setprecision(3) << r.latency_ms << "," << (r.success ? "true" : "false") << "\n";
+    }
+    return true;
+}
+
+bool ScaleBenchmarkTest::saveStepReport(const std::string& csv_file) {
+    fs::create_directories(fs::path(csv_file).parent_path());
+    std::ofstream out(csv_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    // 列顺序与 savePlotScript() 中的列号对应
+    out << "step,target,index_entries,search_entries,filled,fill_ms,persist_ms,"
+        << "insert_count,insert_failures,insert_mean_ms,insert_p50_ms,insert_p90_ms,insert_p99_ms,insert_max_ms,"
+        << "search_count,search_failures,search_mean_ms,search_p50_ms,search_p90_ms,search_p99_ms,search_max_ms,"
+        << "reload_index_ms,reload_search_ms,rss_kb,peak_rss_kb,index_db_bytes,search_db_bytes,node_dir_bytes,"
+        << "index_mem_bytes,search_mem_bytes,mem_bytes_per_file,allocator_in_use_bytes\n";
+    out << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < step_results_.size(); ++i) {
+        const StepResult& s = step_results_[i];
+        out << i << "," << s.target << "," << s.index_entries << "," << s.search_entries << "," << s.filled << ","
+            << s.fill_ms << "," << s.persist_ms << ","
+            << s.insert_ms.count() << "," << s.insert_failures << "," << s.insert_ms.mean_ns() / 1e6 << ","
+            << s.insert_ms.percentile_ms(50) << "," << s.insert_ms.percentile_ms(90) << ","
+            << s.insert_ms.percentile_ms(99) << "," << s.insert_ms.max_ns() / 1e6 << ","
+            << s.search_ms.count() << "," << s.search_failures << "," << s.search_ms.mean_ns() / 1e6 << ","
+            << s.search_ms.percentile_ms(50) << "," << s.search_ms.percentile_ms(90) << ","
+            << s.search_ms.percentile_ms(99) << "," << s.search_ms.max_ns() / 1e6 << ","
+            << s.reload_index_ms << "," << s.reload_search_ms << "," << s.rss_kb << "," << s.peak_rss_kb << ","
+            << s.index_db_bytes << "," << s.search_db_bytes << "," << s.node_dir_bytes << ","
+            << s.node_memory.index.bytes << "," << s.node_memory.search.bytes << ","
+            << s.node_memory.bytes_per_file() << "," << s.node_memory.allocator.in_use_bytes << "\n";
+    }
+    return true;
+}
+
+bool ScaleBenchmarkTest::saveSummaryReport(const std::string& json_file) {
+    fs::create_directories(fs::path(json_file).parent_path());
+    Json::Value root;
+    root["test_info"]["test_name"] = test_name_;
+    root["test_info"]["start_time"] = start_time_;
+    root["test_info"]["end_time"] = end_time_;
+    root["test_info"]["probe_inserts"] = probe_inserts_;
+    root["test_info"]["search_files"] = search_files_;
+    root["test_info"]["search_keywords"] = search_keywords_;
+    root["test_info"]["search_rounds"] = search_rounds_;
+    root["test_info"]["file_size"] = static_cast<Json::UInt64>(file_size_);
+    root["test_info"]["filler_tags"] = filler_tags_;
+    root["test_info"]["filler_keywords"] = filler_keywords_;
+
+    auto latency_json = [](const perf_metrics::Histogram& h) {
+        Json::Value item;
+        item["count"] = static_cast<Json::UInt64>(h.count());
+        item["mean_ms"] = h.mean_ns() / 1e6;
+        item["p50_ms"] = h.percentile_ms(50);
+        item["p90_ms"] = h.percentile_ms(90);
+        item["p99_ms"] = h.percentile_ms(99);
+        item["max_ms"] = static_cast<double>(h.max_ns()) / 1e6;
+        return item;
+    };
+
+    Json::Value steps(Json::arrayValue);
+    bool all_passed = true;
+    for (const auto& s : step_results_) {
+        Json::Value step;
+        step["target"] = static_cast<Json::UInt64>(s.target);
+        step["index_entries"] = static_cast<Json::UInt64>(s.index_entries);
+        step["search_entries"] = static_cast<Json::UInt64>(s.search_entries);
+        step["filled"] = static_cast<Json::UInt64>(s.filled);
+        step["fill_ms"] = s.fill_ms;
+        step["persist_ms"] = s.persist_ms;
+        step["insert"] = latency_json(s.insert_ms);
+        step["insert"]["failures"] = s.insert_failures;
+        step["search"] = latency_json(s.search_ms);
+        step["search"]["failures"] = s.search_failures;
+        if (measure_reload_) {
+            step["reload_index_ms"] = s.reload_index_ms;
+            step["reload_search_ms"] = s.reload_search_ms;
+        }
+        step["memory"]["rss_kb"] = static_cast<Json::UInt64>(s.rss_kb);
+        step["memory"]["peak_rss_kb"] = static_cast<Json::UInt64>(s.peak_rss_kb);
+        step["memory"]["node"] = s.node_memory.to_json();
+        step["disk"]["index_db_bytes"] = static_cast<Json::UInt64>(s.index_db_bytes);
+        step["disk"]["search_db_bytes"] = static_cast<Json::UInt64>(s.search_db_bytes);
+        step["disk"]["node_dir_bytes"] = static_cast<Json::UInt64>(s.node_dir_bytes);
+        steps.append(step);
+        all_passed = all_passed && s.insert_failures == 0 && s.search_failures == 0;
+    }
+    root["steps"] = steps;
+    root["capacity"] = capacityEstimate();
+    root["passed"] = all_passed;
+
+    std::ofstream out(json_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "  ";
+    out << Json::writeString(writer, root);
+    return true;
+}
+
+bool ScaleBenchmarkTest::savePlotScript(const std::string& gnuplot_file, const std::string& step_csv) {
+    fs::create_directories(fs::path(gnuplot_file).parent_path());
+    std::ofstream out(gnuplot_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    std::string png = fs::path(gnuplot_file).replace_extension(".png").string();
+    out << "# 由 scale_benchmark_test 生成，在项目根目录运行: gnuplot " << gnuplot_file << "\n"
+        << "set datafile separator ','\n"
+        << "set terminal pngcairo size 1400,1000\n"
+        << "set output '" << png << "'\n"
+        << "set logscale x\n"
+        << "set grid\n"
+        << "set key left top\n"
+        << "set xlabel 'files in index'\n"
+        << "set multiplot layout 2,2 title 'storage node cost vs. database size'\n"
+        << "set ylabel 'ms'\n"
+        << "set title 'insert (full path)'\n"
+        << "plot '" << step_csv << "' skip 1 using 3:11 with linespoints title 'p50', \\\n"
+        << "     '' skip 1 using 3:13 with linespoints title 'p99'\n"
+        << "set title 'search (fixed chain length)'\n"
+        << "plot '" << step_csv << "' skip 1 using 3:18 with linespoints title 'p50', \\\n"
+        << "     '' skip 1 using 3:20 with linespoints title 'p99'\n"
+        << "set title 'database persist / reload'\n"
+        << "plot '" << step_csv << "' skip 1 using 3:7 with linespoints title 'persist', \\\n"
+        << "     '' skip 1 using 3:($22+$23) with linespoints title 'reload'\n"
+        << "set title 'memory / disk'\n"
+        << "set ylabel 'MB'\n"
+        << "plot '" << step_csv << "' skip 1 using 3:($24/1024) with linespoints title 'RSS', \\\n"
+        << "     '' skip 1 using 3:($28/1048576) with linespoints title 'node dir', \\\n"
+        << "     '' skip 1 using 3:(($29+$30)/1048576) with linespoints title 'index+search (est.)'\n"
+        << "unset multiplot\n";
+    return true;
+}
+
+Json::Value ScaleBenchmarkTest::capacityEstimate() const {
+    Json::Value out;
+    out["ram_gib"] = capacity_ram_gib_;
+    if (step_results_.empty() || step_results_.back().index_entries == 0) {
+        return out;
+    }
+    double ram_bytes = capacity_ram_gib_ * static_cast<double>(1ull << 30);
+
+    // 数据结构估算：不含分配器碎片与进程基础开销，是上限
+    const StepResult& last = step_results_.back();
+    double structure_per_file = last.node_memory.bytes_per_file();
+    out["structure_bytes_per_file"] = structure_per_file;
+    out["files_by_structures"] = structure_per_file > 0 ? ram_bytes / structure_per_file : 0.0;
+
+    // 常驻内存边际增量：最后两级之间每个文件增加的 RSS（只有一级时按总 RSS 平均）
+    double rss_per_file = 0;
+    if (step_results_.size() >= 2) {
+        const StepResult& prev = step_results_[step_results_.size() - 2];
+        if (last.index_entries > prev.index_entries && last.rss_kb > prev.rss_kb) {
+            rss_per_file = static_cast<double>(last.rss_kb - prev.rss_kb) * 1024.0 /
+                           static_cast<double>(last.index_entries - prev.index_entries);
+        }
+    }
+    if (rss_per_file <= 0) {
+        rss_per_file = static_cast<double>(last.rss_kb) * 1024.0 / static_cast<double>(last.index_entries);
+    }
+    out["rss_bytes_per_file"] = rss_per_file;
+    out["files_by_rss"] = rss_per_file > 0 ? ram_bytes / rss_per_file : 0.0;
+    return out;
+}
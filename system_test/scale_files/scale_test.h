@@ -0,0 +1,116 @@
+#ifndef SCALE_BENCHMARK_TEST_H
+#define SCALE_BENCHMARK_TEST_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <filesystem>
+#include <jsoncpp/json/json.h>
+
+#include "../../vds-client/client.h"
+#include "../../Storage-node/storage_node.h"
+#include "../../common/perf_metrics.h"
+#include "../common/client_fixture.h"
+
+/**
+ * @brief 存储节点规模基准（插入/搜索开销随数据库规模的变化）
+ *
+ * 初始化时用客户端插入少量"搜索文件"（固定关键词，链长度在整个测试中不变），
+ * 并为每个规模点预先生成若干"探测文件"的插入请求包。之后按 steps 逐级：
+ *   fill    - 直接向内存数据库批量加入合成条目（唯一 ID_F / Ti_bar，复用标签文本），
+ *             达到目标规模后整体持久化一次（记录全量重写耗时）
+ *   insert  - 通过 insert_from_bundle 插入探测文件（完整路径，含每次插入的全量重写）
+ *   search  - 对固定关键词执行 ComputeSearchProof，并验证一次
+ *   reload  - 从磁盘重新加载索引/搜索数据库（路径版搜索/证明接口每次请求都会执行）
+ * 每个规模点记录延迟分位数、常驻内存、各内存结构的估算占用与磁盘占用，
+ * 并按最后两级的常驻内存增量估算 capacity_ram_gib 内存可容纳的文件数。合成条目没有密文与元数据文件。
+ */
+class ScaleBenchmarkTest {
+public:
+    struct OpResult {
+        size_t step;           // 规模点序号
+        std::string op;        // insert / search / verify_search
+        size_t index;
+        double latency_ms;
+        bool success;
+    };
+
+    struct StepResult {
+        size_t target = 0;             // 目标条目数
+        size_t index_entries = 0;      // 实际索引条目数
+        size_t search_entries = 0;     // 搜索索引条目数
+        size_t filled = 0;             // 本级新增的合成条目数
+        double fill_ms = 0;            // 合成条目加入内存的耗时
+        double persist_ms = 0;         // 一次全量保存两个数据库的耗时
+        double reload_index_ms = 0;    // 重新加载索引数据库
+        double reload_search_ms = 0;   // 重新加载搜索数据库
+        int insert_failures = 0;
+        int search_failures = 0;
+        perf_metrics::Histogram insert_ms;
+        perf_metrics::Histogram search_ms;
+        uint64_t rss_kb = 0;           // 常驻内存（VmRSS）
+        uint64_t peak_rss_kb = 0;      // 峰值常驻内存（VmHWM）
+        MemoryUsage node_memory;       // 节点各内存结构的估算占用
+        uint64_t index_db_bytes = 0;
+        uint64_t search_db_bytes = 0;
+        uint64_t node_dir_bytes = 0;   // 节点数据目录总大小
+    };
+
+    ScaleBenchmarkTest();
+    ~ScaleBenchmarkTest();
+
+    bool loadConfig(const std::string& config_file);
+    bool initialize();
+    bool runTest();
+    bool saveDetailedReport(const std::string& csv_file);
+    bool saveStepReport(const std::string& csv_file);
+    bool saveSummaryReport(const std::string& json_file);
+    bool savePlotScript(const std::string& gnuplot_file, const std::string& step_csv);
+
+private:
+    bool prepareFiles(const std::string& prefix, int count, const std::vector<std::string>& keyword_pool,
+                      size_t keywords_per_file, std::vector<insert_bundle::Bundle>& out);
+    bool captureTemplate();
+    size_t fillSynthetic(size_t count);
+    void runStep(size_t step_index, StepResult& step);
+    void measureFootprint(StepResult& step) const;
+    void printSummary() const;
+    Json::Value capacityEstimate() const;
+
+    // 配置
+    std::string test_name_;
+    std::string public_params_file_;
+    std::string work_dir_;
+    std::vector<size_t> steps_;
+    int probe_inserts_;         // 每个规模点通过完整插入路径测量的次数
+    int search_files_;          // 含固定关键词的文件数
+    int search_keywords_;       // 固定关键词数
+    int search_rounds_;         // 每个规模点每个关键词的搜索次数
+    size_t file_size_;
+    int filler_tags_;           // 合成条目的认证标签数
+    int filler_keywords_;       // 合成条目的关键词数
+    bool measure_reload_;
+    double capacity_ram_gib_;   // 容量估算采用的节点内存（GiB）
+    bool reset_work_dir_;
+    bool verbose_;
+
+    // 组件
+    StorageClient* client_;
+    StorageNode* node_;
+
+    // 数据
+    std::vector<std::vector<insert_bundle::Bundle>> probe_bundles_;   // 每个规模点一组
+    std::vector<Json::Value> search_params_;
+    std::string template_PK_;
+    std::string template_kt_;
+    std::vector<std::string> template_tags_;
+    uint64_t filler_serial_;
+
+    // 结果
+    std::vector<OpResult> results_;
+    std::vector<StepResult> step_results_;
+    std::string start_time_;
+    std::string end_time_;
+};
+
+#endif // SCALE_BENCHMARK_TEST_H
@@ -10,9 +10,11 @@ const char* kDefaultConfig = "system_test/search_files/config/search_test_config
 }
 
 SearchPerformanceTest::SearchPerformanceTest()
-    : client_(nullptr), server_(nullptr), server_port_(9000), max_keywords_(0), verbose_(true), save_intermediate_(true) {
+    : client_(nullptr), server_(nullptr), server_port_(9000), max_keywords_(0), verbose_(true), save_intermediate_(true),
+      batch_threads_(0) {
     callback_c_.on_phase_complete = [this](const std::string& name, double time_ms) {
         current_times_[name] = time_ms;
+        latency_.record_ms(name, time_ms);
         if (verbose_) {
             std::cout << "  [TIME] " << name << ": " << time_ms << " ms" << std::endl;
         }
@@ -25,10 +27,15 @@ SearchPerformanceTest::SearchPerformanceTest()
     };
     callback_s_.on_phase_complete = [this](const std::string& name, double time_ms) {
         current_times_[name] = time_ms;
+        latency_.record_ms(name, time_ms);
         if (verbose_) {
             std::cout << "  [TIME] " << name << ": " << time_ms << " ms" << std::endl;
         }
     };
+    callback_s_.on_op_counters = [this](const std::string& name, const perf_metrics::OpCounters& counters) {
+        current_ops_[name] = counters;
+        op_summary_.record(name, counters);
+    };
 }
 
 SearchPerformanceTest::~SearchPerformanceTest() {
@@ -76,6 +83,11 @@ bool SearchPerformanceTest::loadConfig(const std::string& config_file) {
     save_intermediate_ = options.get("save_intermediate", true).asBool();
     use_keyword_states_ = options.get("use_keyword_states", false).asBool();
     verify_proof_ = options.get("verify_proof", false).asBool();
+    batch_threads_ = options.get("batch_threads", 0).asInt();
+    trace_file_ = options.get("trace_file", "").asString();
+    if (!trace_file_.empty()) {
+        trace_file_ = fs::path(trace_file_).lexically_normal().string();
+    }
 
     statistics_.test_name = config.get("test_name", "search_performance").asString();
 
@@ -165,6 +177,11 @@ bool SearchPerformanceTest::initialize() {
     }
     server_->load_index_database();
     server_->load_search_database();
+    if (!trace_file_.empty()) {
+        callback_s_.on_span = [this](const perf_trace::Span& span) {
+            trace_.record(span);
+        };
+    }
     server_->setPerformanceCallback_s(&callback_s_);
 
     return true;
@@ -188,7 +205,7 @@ SearchPerformanceTest::KeywordTestResult SearchPerformanceTest::testSingleKeywor
         return result;
     }
     auto t_client_end = std::chrono::high_resolution_clock::now();
-    result.t_client_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t_client_end - t_client_start).count();
+    result.t_client_ms = std::chrono::duration<double, std::milli>(t_client_end - t_client_start).count();
     if (current_times_.count("token_generation")) {
         result.t_client_ms = current_times_["token_generation"];
     }
@@ -212,11 +229,17 @@ SearchPerformanceTest::KeywordTestResult SearchPerformanceTest::testSingleKeywor
         return result;
     }
     auto t_server_end = std::chrono::high_resolution_clock::now();
-    result.t_server_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t_server_end - t_server_start).count();
+    result.t_server_ms = std::chrono::duration<double, std::milli>(t_server_end - t_server_start).count();
     if (current_times_.count("server_search_total")) {
         result.t_server_ms = current_times_["server_search_total"];
     }
+    result.server_ops = current_ops_["server_search_total"];
+
+    collectProofResult(result, token);
+    return result;
+}
 
+void SearchPerformanceTest::collectProofResult(KeywordTestResult& result, const std::string& token) {
     // 读取证明文件大小与命中数
     fs::path proof_path = fs::path(server_data_dir_) / "SearchProof" / (token + ".json");
     if (fs::exists(proof_path)) {
@@ -233,13 +256,70 @@ SearchPerformanceTest::KeywordTestResult SearchPerformanceTest::testSingleKeywor
             if (!server_->VerifySearchProof(proof_path.string())) {
                 result.error_msg = "搜索证明验证失败";
                 result.success = false;
-                return result;
+                return;
             }
         }
     }
 
     result.success = true;
-    return result;
+}
+
+bool SearchPerformanceTest::runBatchTest(int total) {
+    std::cout << "\n[批量模式] 线程数: " << batch_threads_ << std::endl;
+
+    // 客户端：先生成全部搜索令牌
+    std::vector<std::string> search_paths;
+    std::vector<std::string> tokens;
+    int count = 0;
+    for (const auto& kw : keywords_) {
+        if (count >= total) break;
+        count++;
+
+        KeywordTestResult r{};
+        r.keyword = kw;
+        r.timestamp = getCurrentTimestamp();
+        clearPerformanceData();
+        if (!client_->searchKeyword(kw)) {
+            r.error_msg = "客户端生成搜索令牌失败";
+            results_.push_back(r);
+            tokens.push_back("");
+            continue;
+        }
+        r.t_client_ms = current_times_["token_generation"];
+        r.request_size = current_sizes_["search_request_size"];
+
+        std::string search_json = client_search_dir_ + "/" + kw + ".json";
+        Json::Value search_params;
+        if (!readJson(search_json, search_params) || search_params.get("T", "").asString().empty()) {
+            r.error_msg = "读取搜索请求失败";
+            results_.push_back(r);
+            tokens.push_back("");
+            continue;
+        }
+        search_paths.push_back(search_json);
+        tokens.push_back(search_params["T"].asString());
+        results_.push_back(r);
+    }
+
+    // 服务端：一次批量调用
+    clearPerformanceData();
+    auto t_start = std::chrono::high_resolution_clock::now();
+    bool batch_ok = server_->SearchKeywordsBatchProof(search_paths, batch_threads_);
+    auto t_end = std::chrono::high_resolution_clock::now();
+    statistics_.batch_total_ms = std::chrono::duration<double, std::milli>(t_end - t_start).count();
+    if (!batch_ok) {
+        std::cerr << "⚠️  批量搜索存在失败的请求" << std::endl;
+    }
+
+    // 批量模式下单请求服务端耗时按均摊计算
+    double per_request_ms = search_paths.empty() ? 0.0 : statistics_.batch_total_ms / search_paths.size();
+    for (size_t k = 0; k < results_.size(); ++k) {
+        KeywordTestResult& r = results_[k];
+        if (tokens[k].empty()) continue;
+        r.t_server_ms = per_request_ms;
+        collectProofResult(r, tokens[k]);
+    }
+    return true;
 }
 
 void SearchPerformanceTest::calculateStatistics() {
@@ -282,21 +362,25 @@ bool SearchPerformanceTest::runTest() {
     int total = keywords_.size();
     if (max_keywords_ > 0 && max_keywords_ < total) total = max_keywords_;
 
-    int count = 0;
-    for (const auto& kw : keywords_) {
-        if (max_keywords_ > 0 && count >= max_keywords_) break;
-        count++;
-        std::cout << "\n[" << count << "/" << total << "] 关键词: " << kw << std::endl;
-        auto r = testSingleKeyword(kw);
-        results_.push_back(r);
-        if (!r.success) {
-            std::cerr << "⚠️  测试失败: " << r.error_msg << std::endl;
+    if (batch_threads_ > 0) {
+        runBatchTest(total);
+    } else {
+        int count = 0;
+        for (const auto& kw : keywords_) {
+            if (max_keywords_ > 0 && count >= max_keywords_) break;
+            count++;
+            std::cout << "\n[" << count << "/" << total << "] 关键词: " << kw << std::endl;
+            auto r = testSingleKeyword(kw);
+            results_.push_back(r);
+            if (!r.success) {
+                std::cerr << "⚠️  测试失败: " << r.error_msg << std::endl;
+            }
         }
     }
 
     auto end = std::chrono::high_resolution_clock::now();
     statistics_.end_time = getCurrentTimestamp();
-    statistics_.total_duration_sec = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 1000.0;
+    statistics_.total_duration_sec = std::chrono::duration<double>(end - start).count();
 
     calculateStatistics();
 
@@ -305,6 +389,14 @@ bool SearchPerformanceTest::runTest() {
               << " 失败: " << statistics_.failure_count << std::endl;
     std::cout << "客户端平均耗时: " << statistics_.t_client_avg << " ms" << std::endl;
     std::cout << "服务端平均耗时: " << statistics_.t_server_avg << " ms" << std::endl;
+    auto histograms = latency_.snapshot();
+    for (const char* name : {"token_generation", "server_search_total"}) {
+        auto it = histograms.find(name);
+        if (it != histograms.end()) {
+            std::cout << name << " p50/p99/p999: " << it->second.percentile_ms(50) << " / "
+                      << it->second.percentile_ms(99) << " / " << it->second.percentile_ms(99.9) << " ms" << std::endl;
+        }
+    }
     std::cout << "请求大小平均: " << statistics_.request_avg << " bytes" << std::endl;
     std::cout << "证明大小平均: " << statistics_.proof_avg << " bytes" << std::endl;
 
@@ -314,10 +406,16 @@ bool SearchPerformanceTest::runTest() {
 bool SearchPerformanceTest::saveDetailedReport(const std::string& csv_file) {
     std::ofstream ofs(csv_file);
     if (!ofs.is_open()) return false;
-    ofs << "keyword,t_client_ms,t_server_ms,request_size,proof_size,result_count,timestamp,success,error_msg\n";
+    ofs << "keyword,t_client_ms,t_server_ms,request_size,proof_size,result_count,"
+        << "pairings,g1_exponentiations,g1_multiplications,hash_to_curve,sha256,aes_decryptions,"
+        << "ciphertext_bytes,json_bytes,timestamp,success,error_msg\n";
     for (const auto& r : results_) {
+        const perf_metrics::OpCounters& ops = r.server_ops;
         ofs << r.keyword << "," << r.t_client_ms << "," << r.t_server_ms << "," << r.request_size
-            << "," << r.proof_size << "," << r.result_count << "," << r.timestamp << ","
+            << "," << r.proof_size << "," << r.result_count << ","
+            << ops.pairings << "," << ops.g1_exponentiations << "," << ops.g1_multiplications << ","
+            << ops.hash_to_curve << "," << ops.sha256 << "," << ops.aes_decryptions << ","
+            << ops.ciphertext_bytes << "," << ops.json_bytes << "," << r.timestamp << ","
             << (r.success ? "true" : "false") << "," << r.error_msg << "\n";
     }
     return true;
@@ -340,6 +438,27 @@ bool SearchPerformanceTest::saveSummaryReport(const std::string& json_file) {
     root["t_server_max"] = statistics_.t_server_max;
     root["request_avg"] = (Json::UInt64)statistics_.request_avg;
     root["proof_avg"] = (Json::UInt64)statistics_.proof_avg;
+    root["batch_threads"] = batch_threads_;
+    root["batch_total_ms"] = statistics_.batch_total_ms;
+    root["latency_percentiles"] = latency_.to_json();
+    root["op_counters"] = op_summary_.to_json();
+
+    // 服务端各阶段合计（仅追踪开启时）：名称 -> 总耗时/次数
+    if (!trace_file_.empty()) {
+        std::map<std::string, std::pair<double, uint64_t>> phases;
+        for (const perf_trace::Span& span : trace_.snapshot()) {
+            auto& total = phases[span.name];
+            total.first += span.dur_us / 1000.0;
+            total.second += span.calls;
+        }
+        Json::Value phases_json(Json::objectValue);
+        for (const auto& kv : phases) {
+            phases_json[kv.first]["total_ms"] = kv.second.first;
+            phases_json[kv.first]["calls"] = (Json::UInt64)kv.second.second;
+        }
+        root["server_phases"] = phases_json;
+        root["trace_file"] = trace_file_;
+    }
 
     Json::StreamWriterBuilder writer;
     writer["indentation"] = "  ";
@@ -349,6 +468,26 @@ bool SearchPerformanceTest::saveSummaryReport(const std::string& json_file) {
     return true;
 }
 
+bool SearchPerformanceTest::saveLatencyReport(const std::string& csv_file) {
+    std::ofstream ofs(csv_file);
+    if (!ofs.is_open()) return false;
+    latency_.write_csv(ofs);
+    return true;
+}
+
+bool SearchPerformanceTest::saveTrace() {
+    if (trace_file_.empty()) {
+        return true;
+    }
+    std::string error;
+    if (!trace_.write(trace_file_, error)) {
+        std::cerr << "[错误] " << error << std::endl;
+        return false;
+    }
+    std::cout << "✅ 阶段追踪已保存: " << trace_file_ << " (" << trace_.size() << " 个阶段)" << std::endl;
+    return true;
+}
+
 std::string SearchPerformanceTest::getCurrentTimestamp() {
     auto now = std::chrono::system_clock::now();
     auto tt = std::chrono::system_clock::to_time_t(now);
@@ -360,6 +499,7 @@ std::string SearchPerformanceTest::getCurrentTimestamp() {
 void SearchPerformanceTest::clearPerformanceData() {
     current_times_.clear();
     current_sizes_.clear();
+    current_ops_.clear();
 }
 
 bool SearchPerformanceTest::readJson(const std::string& path, Json::Value& out) {
@@ -13,6 +13,7 @@
 
 #include "../../vds-client/client.h"
 #include "../../Storage-node/storage_node.h"
+#include "../../common/perf_metrics.h"
 
 class SearchPerformanceTest {
 public:
@@ -23,6 +24,7 @@ public:
         size_t request_size;   // 请求JSON大小
         size_t proof_size;     // 证明JSON大小
         size_t result_count;   // 命中文件数
+        perf_metrics::OpCounters server_ops;  // 服务端搜索的密码学操作计数
         std::string timestamp;
         bool success;
         std::string error_msg;
@@ -44,6 +46,7 @@ public:
         double t_server_max;
         size_t request_avg;
         size_t proof_avg;
+        double batch_total_ms;  // 批量模式下服务端总耗时
     };
 
     SearchPerformanceTest();
@@ -54,6 +57,8 @@ public:
     bool runTest();
     bool saveDetailedReport(const std::string& csv_file);
     bool saveSummaryReport(const std::string& json_file);
+    bool saveLatencyReport(const std::string& csv_file);  // 各阶段延迟分位数 CSV
+    bool saveTrace();      // options.trace_file 非空时导出 Chrome trace-event JSON
 
 private:
     // 配置
@@ -75,12 +80,16 @@ private:
     bool save_intermediate_;
     bool use_keyword_states_;
     bool verify_proof_;
+    int batch_threads_;     // >0 时启用批量搜索（线程数）
+    std::string trace_file_; // 服务端嵌套阶段的 Chrome trace 输出路径（空 = 不追踪）
 
     // 组件
     StorageClient* client_;
     StorageNode* server_;
     PerformanceCallback_c callback_c_;
     PerformanceCallback_s callback_s_;
+    perf_trace::ChromeTraceWriter trace_;
+    perf_metrics::Registry latency_;  // 客户端与服务端各阶段延迟直方图
 
     // 数据
     std::vector<std::string> keywords_;
@@ -88,10 +97,14 @@ private:
     TestStatistics statistics_{};
     std::map<std::string, double> current_times_;
     std::map<std::string, size_t> current_sizes_;
+    std::map<std::string, perf_metrics::OpCounters> current_ops_;
+    perf_metrics::OpCounterSummary op_summary_;  // 按请求类型汇总的操作计数
 
     // 内部方法
     bool loadKeywords();
     KeywordTestResult testSingleKeyword(const std::string& keyword);
+    bool runBatchTest(int total);
+    void collectProofResult(KeywordTestResult& result, const std::string& token);
     void calculateStatistics();
     std::string getCurrentTimestamp();
     void clearPerformanceData();
@@ -0,0 +1,32 @@
+/*
+ * main.cpp - 服务回环测试主程序
+ *
+ * 使用 ServiceLoopbackTest 类进行完整的服务回环测试
+ *
+ * 编译:
+ *   make
+ *
+ * 运行:
+ *   ./service_loopback_test [配置文件路径]
+ *   默认配置: system_test/service_files/config/service_test_config.json
+ */
+
+#include "service_test.h"
+#include "../common/harness_main.h"
+
+int main(int argc, char* argv[]) {
+    harness_main::Spec spec;
+    spec.icon = "📡";
+    spec.name = "服务回环测试";
+    spec.run_label = "运行服务回环测试";
+    spec.default_config = "system_test/service_files/config/service_test_config.json";
+
+    return harness_main::run_harness<ServiceLoopbackTest>(argc, argv, spec, [](ServiceLoopbackTest& test) {
+        return std::vector<harness_main::Report>{
+            {"详细报告", "system_test/service_files/results/service_detailed.csv",
+             [&test](const std::string& p) { return test.saveDetailedReport(p); }},
+            {"总结报告", "system_test/service_files/results/service_summary.json",
+             [&test](const std::string& p) { return test.saveSummaryReport(p); }}
+        };
+    });
+}
@@ -0,0 +1,560 @@
+#include "service_test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+using test_fixture::load_json;
+
+namespace {
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t idx = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+    return values[std::min(idx, values.size() - 1)];
+}
+
+} // namespace
+
+ServiceLoopbackTest::ServiceLoopbackTest()
+    : port_(0),
+      workers_(0),
+      connections_(4),
+      file_count_(32),
+      file_size_(16 * 1024),
+      keyword_pool_(8),
+      keywords_per_file_(3),
+      delete_fraction_(0.25),
+      upload_chunk_size_(0),
+      reset_work_dir_(true),
+      verbose_(false),
+      client_(nullptr),
+      node_(nullptr),
+      server_(nullptr) {}
+
+ServiceLoopbackTest::~ServiceLoopbackTest() {
+    if (server_) {
+        server_->stop();
+        delete server_;
+    }
+    delete node_;
+    delete client_;
+}
+
+// ==================== 配置与初始化 ====================
+
+bool ServiceLoopbackTest::loadConfig(const std::string& config_file) {
+    Json::Value config;
+    if (!load_json(config_file, config)) {
+        std::cerr << "[错误] 无法读取配置文件: " << config_file << std::endl;
+        return false;
+    }
+
+    test_name_ = config.get("test_name", "service loopback").asString();
+
+    const Json::Value& paths = config["paths"];
+    public_params_file_ = paths.get("public_params", "vds-client/data/public_params.json").asString();
+    work_dir_ = paths.get("work_dir", "system_test/service_files/data/work").asString();
+
+    const Json::Value& server = config["server"];
+    port_ = server.get("port", 0).asInt();
+    workers_ = server.get("workers", 0).asInt();
+
+    const Json::Value& options = config["options"];
+    connections_ = std::max(1, options.get("connections", 4).asInt());
+    file_count_ = std::max(1, options.get("file_count", 32).asInt());
+    file_size_ = options.get("file_size", 16 * 1024).asUInt64();
+    keyword_pool_ = std::max(1, options.get("keyword_pool", 8).asInt());
+    keywords_per_file_ = std::min(keyword_pool_, std::max(1, options.get("keywords_per_file", 3).asInt()));
+    delete_fraction_ = std::min(1.0, std::max(0.0, options.get("delete_fraction", 0.25).asDouble()));
+    upload_chunk_size_ = options.get("upload_chunk_size", 0).asUInt64();
+    reset_work_dir_ = options.get("reset_work_dir", true).asBool();
+    verbose_ = options.get("verbose", false).asBool();
+
+    std::cout << "[配置] 工作目录: " << work_dir_ << std::endl;
+    std::cout << "[配置] 并发连接: " << connections_ << ", 服务端工作线程: "
+              << (workers_ > 0 ? std::to_string(workers_) : std::string("自动")) << std::endl;
+    std::cout << "[配置] 文件: " << file_count_ << " x " << file_size_ << " 字节, 关键词池 "
+              << keyword_pool_ << ", 每文件 " << keywords_per_file_ << " 个" << std::endl;
+    if (upload_chunk_size_ > 0) {
+        std::cout << "[配置] 插入方式: 分块上传, 分块大小 " << upload_chunk_size_ << " 字节" << std::endl;
+    }
+    return true;
+}
+
+bool ServiceLoopbackTest::initialize() {
+    if (reset_work_dir_ && fs::exists(work_dir_)) {
+        std::cout << "[初始化] 清空工作目录: " << work_dir_ << std::endl;
+        fs::remove_all(work_dir_);
+    }
+    std::string client_dir = work_dir_ + "/client";
+    std::string node_dir = work_dir_ + "/node";
+    fs::create_directories(client_dir);
+    fs::create_directories(node_dir);
+    fs::create_directories(work_dir_ + "/plain");
+
+    // 客户端
+    client_ = new StorageClient();
+    StorageClient::configureDataDirectories(client_dir);
+    if (!client_->initialize(public_params_file_) || !client_->initializeDataDirectories()) {
+        std::cerr << "[错误] 客户端初始化失败" << std::endl;
+        return false;
+    }
+    std::string key_file = client_dir + "/private_key.dat";
+    if (!client_->loadKeys(key_file)) {
+        if (!client_->generateKeys(key_file)) {
+            std::cerr << "[错误] 密钥生成失败" << std::endl;
+            return false;
+        }
+        client_->saveKeys(key_file);
+    }
+    client_->setInsertBundleMode(true);
+
+    // 存储节点 + 服务
+    node_ = new StorageNode(node_dir, port_);
+    if (!node_->load_public_params(public_params_file_)) {
+        std::cerr << "[错误] 服务端加载公共参数失败" << std::endl;
+        return false;
+    }
+    if (!node_->initialize_directories()) {
+        std::cerr << "[错误] 服务端目录初始化失败" << std::endl;
+        return false;
+    }
+    node_->load_index_database();
+    node_->load_search_database();
+
+    server_ = new NodeServer(node_, port_, workers_, "127.0.0.1");
+    if (!server_->start()) {
+        std::cerr << "[错误] 服务启动失败" << std::endl;
+        return false;
+    }
+    std::cout << "[初始化] 服务监听 127.0.0.1:" << server_->port() << std::endl;
+
+    return prepareFiles();
+}
+
+// 生成明文、插入请求包、搜索令牌与删除令牌（客户端不是线程安全的，全部在发送前完成）
+bool ServiceLoopbackTest::prepareFiles() {
+    std::cout << "\n[准备] 生成测试文件与请求..." << std::endl;
+
+    for (int k = 0; k < keyword_pool_; ++k) {
+        keywords_.push_back("svc_kw_" + std::to_string(k));
+    }
+
+    std::mt19937_64 rng(std::random_device{}());
+    for (int i = 0; i < file_count_; ++i) {
+        TestFile file;
+        file.keywords = test_fixture::pick_keywords(keywords_, static_cast<size_t>(i * keywords_per_file_),
+                                                    static_cast<size_t>(keywords_per_file_));
+
+        test_fixture::EncryptedFile encrypted;
+        if (!test_fixture::encrypt_random_file(*client_, work_dir_ + "/client",
+                                               work_dir_ + "/plain/file_" + std::to_string(i) + ".bin",
+                                               file_size_, file.keywords, rng, encrypted)) {
+            return false;
+        }
+        file.plain_path = encrypted.plain_path;
+        file.bundle_path = encrypted.bundle_path;
+        if (!test_fixture::read_whole_file(file.bundle_path, file.bundle)) {
+            std::cerr << "[错误] 请求包读取失败: " << file.bundle_path << std::endl;
+            return false;
+        }
+        insert_bundle::Bundle& bundle = encrypted.bundle;
+        std::string error;
+        file.ID_F = bundle.ID_F;
+        if (upload_chunk_size_ > 0) {
+            // 分块上传：元数据作为不含密文的请求包发送，密文单独分块
+            file.ciphertext.swap(bundle.ciphertext);
+            if (!insert_bundle::serialize(bundle, file.header, error)) {
+                std::cerr << "[错误] 请求包编码失败: " << error << std::endl;
+                return false;
+            }
+        }
+        files_.push_back(std::move(file));
+    }
+
+    for (const auto& kw : keywords_) {
+        Json::Value params;
+        if (!client_->searchKeyword(kw) || !load_json(work_dir_ + "/client/Search/" + kw + ".json", params)) {
+            std::cerr << "[错误] 搜索令牌生成失败: " << kw << std::endl;
+            return false;
+        }
+        search_params_.push_back(params);
+    }
+
+    size_t delete_count = static_cast<size_t>(file_count_ * delete_fraction_ + 0.5);
+    for (size_t i = 0; i < delete_count; ++i) {
+        Json::Value params;
+        const std::string& ID_F = files_[i].ID_F;
+        if (!client_->deleteFile(ID_F) || !load_json(work_dir_ + "/client/Deles/" + ID_F + ".json", params)) {
+            std::cerr << "[错误] 删除令牌生成失败: " << ID_F << std::endl;
+            return false;
+        }
+        delete_params_.push_back(params);
+    }
+
+    std::cout << "[准备] 完成: " << files_.size() << " 个请求包, " << search_params_.size()
+              << " 个搜索令牌, " << delete_params_.size() << " 个删除令牌" << std::endl;
+    return true;
+}
+
+// ==================== 测试执行 ====================
+
+bool ServiceLoopbackTest::call(node_protocol::Client& conn, const Json::Value& request,
+                               const std::string& payload, node_protocol::Message& response,
+                               std::string& error) {
+    if (!conn.call(request, payload, response)) {
+        error = conn.last_error();
+        return false;
+    }
+    if (!response.header.get("ok", false).asBool()) {
+        error = response.header.get("error", "未知错误").asString();
+        return false;
+    }
+    return true;
+}
+
+bool ServiceLoopbackTest::runPhase(const std::string& op, size_t count, const Job& job) {
+    std::cout << "\n[阶段] " << op << " x " << count << " (" << connections_ << " 个连接)" << std::endl;
+    phase_order_.push_back(op);
+    if (count == 0) {
+        phase_wall_ms_[op] = 0;
+        return true;
+    }
+
+    std::atomic<size_t> next(0);
+    std::mutex results_mutex;
+    bool connect_failed = false;
+    int threads = static_cast<int>(std::min<size_t>(connections_, count));
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&]() {
+            node_protocol::Client conn;
+            if (!conn.connect("127.0.0.1", server_->port())) {
+                std::lock_guard<std::mutex> lock(results_mutex);
+                std::cerr << "[错误] 连接失败: " << conn.last_error() << std::endl;
+                connect_failed = true;
+                return;
+            }
+            std::vector<OpResult> local;
+            size_t i;
+            while ((i = next++) < count) {
+                OpResult r;
+                r.op = op;
+                r.index = i;
+                r.request_bytes = 0;
+                auto t0 = std::chrono::steady_clock::now();
+                r.success = job(conn, i, r.request_bytes, r.error_msg);
+                r.latency_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - t0).count();
+                local.push_back(r);
+                if (!conn.connected()) {
+                    break;
+                }
+            }
+            std::lock_guard<std::mutex> lock(results_mutex);
+            results_.insert(results_.end(), local.begin(), local.end());
+        });
+    }
+    for (auto& th : pool) {
+        th.join();
+    }
+    double wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    phase_wall_ms_[op] = wall_ms;
+
+    int failures = 0;
+    for (const auto& r : results_) {
+        if (r.op == op && !r.success) {
+            failures++;
+            if (verbose_) {
+                std::cerr << "   ⚠️  " << op << "[" << r.index << "] 失败: " << r.error_msg << std::endl;
+            }
+        }
+    }
+    std::cout << "   └─ 用时 " << std::fixed << std::setprecision(1) << wall_ms << " ms, 失败 "
+              << failures << std::endl;
+    return !connect_failed;
+}
+
+bool ServiceLoopbackTest::runTest() {
+    start_time_ = test_fixture::current_timestamp();
+
+    search_proofs_.assign(search_params_.size(), Json::Value());
+    file_proofs_.assign(files_.size(), Json::Value());
+
+    bool ok = true;
+
+    if (upload_chunk_size_ == 0) {
+        ok &= runPhase("insert", files_.size(),
+            [this](node_protocol::Client& conn, size_t i, size_t& bytes, std::string& error) {
+                Json::Value req;
+                req["op"] = "insert";
+                bytes = files_[i].bundle.size();
+                node_protocol::Message resp;
+                return call(conn, req, files_[i].bundle, resp, error);
+            });
+    } else {
+        ok &= runPhase("upload", files_.size(),
+            [this](node_protocol::Client& conn, size_t i, size_t& bytes, std::string& error) {
+                const TestFile& file = files_[i];
+                node_protocol::Message resp;
+                Json::Value begin;
+                begin["op"] = "upload_begin";
+                begin["size"] = static_cast<Json::UInt64>(file.ciphertext.size());
+                if (!call(conn, begin, file.header, resp, error)) {
+                    return false;
+                }
+                std::string upload_id = resp.header["result"]["upload_id"].asString();
+                bytes = file.header.size();
+
+                for (size_t offset = 0; offset < file.ciphertext.size(); offset += upload_chunk_size_) {
+                    size_t n = std::min<size_t>(upload_chunk_size_, file.ciphertext.size() - offset);
+                    Json::Value append;
+                    append["op"] = "upload_append";
+                    append["upload_id"] = upload_id;
+                    append["offset"] = static_cast<Json::UInt64>(offset);
+                    if (!call(conn, append, file.ciphertext.substr(offset, n), resp, error)) {
+                        Json::Value abort;
+                        abort["op"] = "upload_abort";
+                        abort["upload_id"] = upload_id;
+                        std::string ignored;
+                        call(conn, abort, "", resp, ignored);
+                        return false;
+                    }
+                    bytes += n;
+                }
+
+                Json::Value commit;
+                commit["op"] = "upload_commit";
+                commit["upload_id"] = upload_id;
+                return call(conn, commit, "", resp, error);
+            });
+    }
+
+    ok &= runPhase("search", search_params_.size(),
+        [this](node_protocol::Client& conn, size_t i, size_t& bytes, std::string& error) {
+            Json::Value req;
+            req["op"] = "search";
+            req["params"] = search_params_[i];
+            bytes = node_protocol::to_json_text(req).size();
+            node_protocol::Message resp;
+            if (!call(conn, req, "", resp, error)) {
+                return false;
+            }
+            search_proofs_[i] = resp.header["result"];
+            return true;
+        });
+
+    ok &= runPhase("verify_search", search_proofs_.size(),
+        [this](node_protocol::Client& conn, size_t i, size_t& bytes, std::string& error) {
+            if (search_proofs_[i].isNull()) {
+                error = "无可验证的搜索证明";
+                return false;
+            }
+            Json::Value req;
+            req["op"] = "verify_search";
+            req["proof"] = search_proofs_[i];
+            bytes = node_protocol::to_json_text(req).size();
+            node_protocol::Message resp;
+            if (!call(conn, req, "", resp, error)) {
+                return false;
+            }
+            if (!resp.header["result"].get("valid", false).asBool()) {
+                error = "搜索证明验证未通过";
+                return false;
+            }
+            return true;
+        });
+
+    ok &= runPhase("file_proof", files_.size(),
+        [this](node_protocol::Client& conn, size_t i, size_t& bytes, std::string& error) {
+            Json::Value req;
+            req["op"] = "file_proof";
+            req["ID_F"] = files_[i].ID_F;
+            bytes = node_protocol::to_json_text(req).size();
+            node_protocol::Message resp;
+            if (!call(conn, req, "", resp, error)) {
+                return false;
+            }
+            file_proofs_[i] = resp.header["result"];
+            return true;
+        });
+
+    ok &= runPhase("verify_file", file_proofs_.size(),
+        [this](node_protocol::Client& conn, size_t i, size_t& bytes, std::string& error) {
+            if (file_proofs_[i].isNull()) {
+                error = "无可验证的文件证明";
+                return false;
+            }
+            Json::Value req;
+            req["op"] = "verify_file";
+            req["proof"] = file_proofs_[i];
+            bytes = node_protocol::to_json_text(req).size();
+            node_protocol::Message resp;
+            if (!call(conn, req, "", resp, error)) {
+                return false;
+            }
+            if (!resp.header["result"].get("valid", false).asBool()) {
+                error = "文件证明验证未通过";
+                return false;
+            }
+            return true;
+        });
+
+    ok &= runPhase("delete", delete_params_.size(),
+        [this](node_protocol::Client& conn, size_t i, size_t& bytes, std::string& error) {
+            Json::Value req;
+            req["op"] = "delete";
+            req["params"] = delete_params_[i];
+            bytes = node_protocol::to_json_text(req).size();
+            node_protocol::Message resp;
+            return call(conn, req, "", resp, error);
+        });
+
+    ok &= runPhase("status", 1,
+        [this](node_protocol::Client& conn, size_t, size_t& bytes, std::string& error) {
+            Json::Value req;
+            req["op"] = "status";
+            bytes = node_protocol::to_json_text(req).size();
+            node_protocol::Message resp;
+            if (!call(conn, req, "", resp, error)) {
+                return false;
+            }
+            std::cout << "   ├─ 节点文件数: " << resp.header["result"]["file_count"].asUInt64() << std::endl;
+            std::cout << "   └─ 搜索索引数: " << resp.header["result"]["search_index_count"].asUInt64() << std::endl;
+            return true;
+        });
+
+    server_stats_ = server_->stats();
+    server_->stop();
+    end_time_ = test_fixture::current_timestamp();
+
+    calculateStatistics();
+    printSummary();
+    return ok;
+}
+
+// ==================== 统计与报告 ====================
+
+void ServiceLoopbackTest::calculateStatistics() {
+    statistics_.clear();
+    for (const auto& op : phase_order_) {
+        OpStatistics s;
+        s.op = op;
+        s.wall_ms = phase_wall_ms_[op];
+        std::vector<double> latencies;
+        for (const auto& r : results_) {
+            if (r.op != op) continue;
+            s.count++;
+            if (!r.success) s.failures++;
+            latencies.push_back(r.latency_ms);
+        }
+        if (!latencies.empty()) {
+            s.avg_ms = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
+            s.p50_ms = percentile(latencies, 50);
+            s.p95_ms = percentile(latencies, 95);
+            s.p99_ms = percentile(latencies, 99);
+            s.max_ms = *std::max_element(latencies.begin(), latencies.end());
+        }
+        if (s.wall_ms > 0) {
+            s.throughput = s.count / (s.wall_ms / 1000.0);
+        }
+        statistics_.push_back(s);
+    }
+}
+
+void ServiceLoopbackTest::printSummary() const {
+    std::cout << "\n" << std::string(80, '=') << std::endl;
+    std::cout << "服务回环测试总结" << std::endl;
+    std::cout << std::string(80, '=') << std::endl;
+    std::cout << std::left << std::setw(16) << "请求" << std::right
+              << std::setw(8) << "数量" << std::setw(8) << "失败"
+              << std::setw(11) << "avg ms" << std::setw(11) << "p50 ms" << std::setw(11) << "p95 ms"
+              << std::setw(11) << "max ms" << std::setw(12) << "req/s" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& s : statistics_) {
+        std::cout << std::left << std::setw(16) << s.op << std::right
+                  << std::setw(8) << s.count << std::setw(8) << s.failures
+                  << std::setw(11) << s.avg_ms << std::setw(11) << s.p50_ms << std::setw(11) << s.p95_ms
+                  << std::setw(11) << s.max_ms << std::setw(12) << s.throughput << std::endl;
+    }
+    std::cout << "\n📡 服务端: 连接 " << server_stats_.connections_accepted
+              << ", 请求 " << server_stats_.requests << " (失败 " << server_stats_.failed_requests << ")"
+              << ", 接收 " << server_stats_.bytes_in << " B, 发送 " << server_stats_.bytes_out << " B" << std::endl;
+}
+
+bool ServiceLoopbackTest::saveDetailedReport(const std::string& csv_file) {
+    fs::create_directories(fs::path(csv_file).parent_path());
+    std::ofstream out(csv_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    out << "op,index,latency_ms,request_bytes,success,error\n";
+    for (const auto& r : results_) {
+        out << r.op << "," << r.index << "," << std::fixed << std::setprecision(3) << r.latency_ms << ","
+            << r.request_bytes << "," << (r.success ? "true" : "false") << ",\"" << r.error_msg << "\"\n";
+    }
+    return true;
+}
+
+bool ServiceLoopbackTest::saveSummaryReport(const std::string& json_file) {
+    fs::create_directories(fs::path(json_file).parent_path());
+    Json::Value root;
+    root["test_info"]["test_name"] = test_name_;
+    root["test_info"]["start_time"] = start_time_;
+    root["test_info"]["end_time"] = end_time_;
+    root["test_info"]["connections"] = connections_;
+    root["test_info"]["workers"] = workers_;
+    root["test_info"]["file_count"] = file_count_;
+    root["test_info"]["file_size"] = static_cast<Json::UInt64>(file_size_);
+    root["test_info"]["keyword_pool"] = keyword_pool_;
+    root["test_info"]["keywords_per_file"] = keywords_per_file_;
+
+    Json::Value ops(Json::arrayValue);
+    for (const auto& s : statistics_) {
+        Json::Value op;
+        op["op"] = s.op;
+        op["count"] = s.count;
+        op["failures"] = s.failures;
+        op["wall_ms"] = s.wall_ms;
+        op["avg_ms"] = s.avg_ms;
+        op["p50_ms"] = s.p50_ms;
+        op["p95_ms"] = s.p95_ms;
+        op["p99_ms"] = s.p99_ms;
+        op["max_ms"] = s.max_ms;
+        op["throughput_rps"] = s.throughput;
+        ops.append(op);
+    }
+    root["operations"] = ops;
+
+    root["server"]["connections_accepted"] = static_cast<Json::UInt64>(server_stats_.connections_accepted);
+    root["server"]["requests"] = static_cast<Json::UInt64>(server_stats_.requests);
+    root["server"]["failed_requests"] = static_cast<Json::UInt64>(server_stats_.failed_requests);
+    root["server"]["bytes_in"] = static_cast<Json::UInt64>(server_stats_.bytes_in);
+    root["server"]["bytes_out"] = static_cast<Json::UInt64>(server_stats_.bytes_out);
+    root["server"]["latency"] = server_->latency().to_json();
+
+    std::ofstream out(json_file);
+    if (!out.is_open()) {
+        return false;
+    }
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "  ";
+    out << Json::writeString(writer, root);
+    return true;
+}
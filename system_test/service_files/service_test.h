@@ -0,0 +1,118 @@
+#ifndef SERVICE_LOOPBACK_TEST_H
+#define SERVICE_LOOPBACK_TEST_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <filesystem>
+#include <jsoncpp/json/json.h>
+
+#include "../../vds-client/client.h"
+#include "../../Storage-node/storage_node.h"
+#include "../../Storage-node/node_server.h"
+#include "../../common/node_protocol.h"
+#include "../common/client_fixture.h"
+
+/**
+ * @brief 存储节点TCP服务回环测试
+ *
+ * 在进程内启动 StorageNode + NodeServer（127.0.0.1），客户端生成插入请求包、
+ * 搜索令牌与删除令牌后，由多个连接并发发送：
+ *   insert（或分块 upload） -> search -> verify_search -> file_proof -> verify_file -> delete -> status
+ * 记录每类请求的延迟分布与吞吐量。
+ */
+class ServiceLoopbackTest {
+public:
+    struct OpResult {
+        std::string op;
+        size_t index;          // 请求序号
+        double latency_ms;     // 往返延迟
+        size_t request_bytes;  // 请求帧负载大小
+        bool success;
+        std::string error_msg;
+    };
+
+    struct OpStatistics {
+        std::string op;
+        int count = 0;
+        int failures = 0;
+        double wall_ms = 0;       // 本阶段墙钟时间
+        double avg_ms = 0;
+        double p50_ms = 0;
+        double p95_ms = 0;
+        double p99_ms = 0;
+        double max_ms = 0;
+        double throughput = 0;    // 请求/秒
+    };
+
+    ServiceLoopbackTest();
+    ~ServiceLoopbackTest();
+
+    bool loadConfig(const std::string& config_file);
+    bool initialize();
+    bool runTest();
+    bool saveDetailedReport(const std::string& csv_file);
+    bool saveSummaryReport(const std::string& json_file);
+
+private:
+    struct TestFile {
+        std::string plain_path;
+        std::string bundle_path;
+        std::string bundle;                  // 请求包内容（insert 负载）
+        std::string header;                  // 分块上传：不含密文的请求包
+        std::string ciphertext;              // 分块上传：密文
+        std::string ID_F;
+        std::vector<std::string> keywords;
+    };
+
+    // 并发任务：在给定连接上执行第 index 个请求
+    typedef std::function<bool(node_protocol::Client&, size_t, size_t&, std::string&)> Job;
+
+    bool prepareFiles();
+    bool runPhase(const std::string& op, size_t count, const Job& job);
+    bool call(node_protocol::Client& conn, const Json::Value& request, const std::string& payload,
+              node_protocol::Message& response, std::string& error);
+    void calculateStatistics();
+    void printSummary() const;
+
+    // 配置
+    std::string test_name_;
+    std::string public_params_file_;
+    std::string work_dir_;          // 客户端/节点数据根目录（每次运行可清空）
+    int port_;                      // 0 = 系统分配
+    int workers_;                   // 服务端工作线程数
+    int connections_;               // 并发连接数
+    int file_count_;
+    size_t file_size_;
+    int keyword_pool_;
+    int keywords_per_file_;
+    double delete_fraction_;
+    size_t upload_chunk_size_;      // >0 时插入改用 upload_begin/append/commit 分块上传
+    bool reset_work_dir_;
+    bool verbose_;
+
+    // 组件
+    StorageClient* client_;
+    StorageNode* node_;
+    NodeServer* server_;
+
+    // 数据
+    std::vector<TestFile> files_;
+    std::vector<std::string> keywords_;
+    std::vector<Json::Value> search_params_;
+    std::vector<Json::Value> search_proofs_;
+    std::vector<Json::Value> file_proofs_;
+    std::vector<Json::Value> delete_params_;
+
+    // 结果
+    std::vector<OpResult> results_;
+    std::map<std::string, double> phase_wall_ms_;
+    std::vector<OpStatistics> statistics_;
+    std::vector<std::string> phase_order_;
+    NodeServer::Stats server_stats_;
+    std::string start_time_;
+    std::string end_time_;
+};
+
+#endif // SERVICE_LOOPBACK_TEST_H
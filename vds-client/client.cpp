@@ -1,9 +1,11 @@
 #include "client.h"
+#include "../common/perf_metrics.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <cstring>
+#include <algorithm>
 #include <ctime>
 #include <random>
 #include <filesystem>
@@ -26,14 +28,12 @@ namespace fs = std::filesystem;
  * }
  */
 #define PERF_TIMER_START(name) \
-    auto perf_##name##_start = std::chrono::high_resolution_clock::now();
+    uint64_t perf_##name##_start = perf_metrics::now_ns();
 
+// 以纳秒计时、按 double 毫秒上报（不截断），便于测试工具汇总为延迟直方图
 #define PERF_TIMER_END(name) \
     if (perf_callback_c) { \
-        auto perf_##name##_end = std::chrono::high_resolution_clock::now(); \
-        auto perf_##name##_duration = std::chrono::duration_cast<std::chrono::milliseconds>( \
-            perf_##name##_end - perf_##name##_start).count(); \
-        perf_callback_c->on_phase_complete(#name, static_cast<double>(perf_##name##_duration)); \
+        perf_callback_c->on_phase_complete(#name, perf_metrics::elapsed_ms(perf_##name##_start)); \
     }
 
 
@@ -48,6 +48,7 @@ StorageClient::StorageClient()
 }
 
 StorageClient::~StorageClient() {
+    scratch_pool_.clear();  // 临时变量依赖pairing_，先于pairing_clear释放
     if (initialized_) {
         element_clear(g_);
         element_clear(mu_);
@@ -225,6 +226,7 @@ bool StorageClient::initialize(const std::string& public_params_file) {
         "sign1 1\n"
         "sign0 1\n";
     
+    scratch_pool_.clear();  // 已有的临时变量属于旧的pairing_
     if (pairing_init_set_str(pairing_, PAIRING_PARAMS) != 0) {
         std::cerr << "[错误] 配对参数初始化失败" << std::endl;
         return false;
@@ -714,19 +716,24 @@ bool StorageClient::encryptFile(const std::string& file_path,
     
     // ========== v4.1修改：使用新的目录结构和唯一文件名 ==========
     
-    // 1. 生成唯一的加密文件路径（使用绝对路径生成的安全名称）
-    std::string enc_filename = safe_name + ".enc";
-    std::string enc_file = generateUniqueFilePath(ENC_FILES_DIR, enc_filename);
-    
-    if (!writeFile(enc_file, ciphertext)) {
-        std::cerr << "[错误] 无法保存加密文件: " << enc_file << std::endl;
-        std::cerr << "       请检查:" << std::endl;
-        std::cerr << "       1. 目录权限" << std::endl;
-        std::cerr << "       2. 磁盘空间" << std::endl;
-        PERF_TIMER_END(client_encrypt_total)  // 失败也记录
-        return false;
+    // 1. 生成唯一的输出文件名（使用绝对路径生成的安全名称）
+    //    请求包模式下密文直接写入 Insert/*.vdsb，不再单独保存 .enc
+    std::string enc_file;
+    if (insert_bundle_mode_) {
+        enc_file = generateUniqueFilePath(INSERT_DIR, safe_name + insert_bundle::kExtension);
+    } else {
+        enc_file = generateUniqueFilePath(ENC_FILES_DIR, safe_name + ".enc");
+        
+        if (!writeFile(enc_file, ciphertext)) {
+            std::cerr << "[错误] 无法保存加密文件: " << enc_file << std::endl;
+            std::cerr << "       请检查:" << std::endl;
+            std::cerr << "       1. 目录权限" << std::endl;
+            std::cerr << "       2. 磁盘空间" << std::endl;
+            PERF_TIMER_END(client_encrypt_total)  // 失败也记录
+            return false;
+        }
+        std::cout << "[成功] 加密文件已保存: " << enc_file << std::endl;
     }
-    std::cout << "[成功] 加密文件已保存: " << enc_file << std::endl;
     
     // 生成认证标签
     std::vector<std::string> auth_tags;
@@ -738,6 +745,7 @@ bool StorageClient::encryptFile(const std::string& file_path,
     
     // 处理关键词数据
     Json::Value keywords_data(Json::arrayValue);
+    insert_bundle::Bundle bundle;
     for (const auto& keyword : keywords) {
         Json::Value kw_obj;
         
@@ -772,7 +780,18 @@ bool StorageClient::encryptFile(const std::string& file_path,
         }
         kw_obj["kt_wi"] = kt;
         
-        keywords_data.append(kw_obj);
+        if (insert_bundle_mode_) {
+            insert_bundle::Keyword bundle_kw;
+            if (!element_codec::to_bytes(Ti_bar, element_format_, bundle_kw.Ti_bar) ||
+                !element_codec::to_bytes(kt, element_format_, bundle_kw.kt_wi)) {
+                std::cerr << "[错误] 关键词标签编码失败" << std::endl;
+                return false;
+            }
+            bundle_kw.ptr_i = ptr;
+            bundle.keywords.push_back(std::move(bundle_kw));
+        } else {
+            keywords_data.append(kw_obj);
+        }
         
         // 更新状态存储（会自动保存到 ./data/keyword_states.json）
         if (!updateKeywordState(keyword, new_state, file_id)) {
@@ -780,42 +799,75 @@ bool StorageClient::encryptFile(const std::string& file_path,
         }
     }
     
-    // 2. 构建并保存 insert.json 到 Insert 目录
-    Json::Value insert_json;
-    insert_json["PK"] = getPublicKey();
-    insert_json["ID_F"] = file_id;
-    
-    Json::Value ts_f_array(Json::arrayValue);
-    for (const auto& tag : auth_tags) {
-        ts_f_array.append(tag);
-    }
-    insert_json["TS_F"] = ts_f_array;
-    insert_json["state"] = "valid";
-    insert_json["keywords"] = keywords_data;
-    
-    // 使用与加密文件相同的基础名生成insert文件名（含绝对路径信息）
+    // 2. 构建并保存插入请求到 Insert 目录
     fs::path enc_path(enc_file);
-    std::string base_name = enc_path.stem().string(); // 移除.enc扩展名
-    std::string insert_filename = base_name + "_insert.json";
-    std::string insert_json_path = INSERT_DIR + "/" + insert_filename;
-    
-    std::ofstream insert_file(insert_json_path);
-    if (!insert_file.is_open()) {
-        std::cerr << "[错误] 无法创建 " << insert_json_path << std::endl;
-        return false;
-    }
-    
+    std::string base_name = enc_path.stem().string(); // 移除.enc/.vdsb扩展名
+    std::string insert_request_path;
     Json::StreamWriterBuilder writer;
     writer["indentation"] = "  ";
-    insert_file << Json::writeString(writer, insert_json);
-    insert_file.close();
-    std::cout << "[成功] insert.json 已生成: " << insert_json_path << std::endl;
+    
+    if (insert_bundle_mode_) {
+        // 单个二进制请求包：元素以原始字节存储，密文紧随其后
+        bundle.compressed = (element_format_ == ElementFormat::CompressedBase64);
+        bundle.ID_F = file_id;
+        bundle.state = "valid";
+        if (!element_codec::to_bytes(getPublicKey(), element_format_, bundle.PK)) {
+            std::cerr << "[错误] 公钥编码失败" << std::endl;
+            return false;
+        }
+        std::vector<unsigned char> tag_bytes;
+        for (const auto& tag : auth_tags) {
+            if (!element_codec::to_bytes(tag, element_format_, tag_bytes) ||
+                (bundle.tag_len != 0 && tag_bytes.size() != bundle.tag_len)) {
+                std::cerr << "[错误] 认证标签编码失败" << std::endl;
+                return false;
+            }
+            bundle.tag_len = static_cast<uint32_t>(tag_bytes.size());
+            bundle.tags.insert(bundle.tags.end(), tag_bytes.begin(), tag_bytes.end());
+        }
+        bundle.ciphertext = std::move(ciphertext_str);
+        
+        std::string error;
+        if (!insert_bundle::write(enc_file, bundle, error)) {
+            std::cerr << "[错误] 插入请求包写入失败: " << error << std::endl;
+            return false;
+        }
+        insert_request_path = enc_file;
+        std::cout << "[成功] 插入请求包已生成: " << insert_request_path << std::endl;
+    } else {
+        Json::Value insert_json;
+        insert_json["PK"] = getPublicKey();
+        insert_json["ID_F"] = file_id;
+        
+        Json::Value ts_f_array(Json::arrayValue);
+        for (const auto& tag : auth_tags) {
+            ts_f_array.append(tag);
+        }
+        insert_json["TS_F"] = ts_f_array;
+        insert_json["state"] = "valid";
+        insert_json["keywords"] = keywords_data;
+        insert_json["element_format"] = element_codec::format_name(element_format_);
+        
+        // 使用与加密文件相同的基础名生成insert文件名（含绝对路径信息）
+        insert_request_path = INSERT_DIR + "/" + base_name + "_insert.json";
+        
+        std::ofstream insert_file(insert_request_path);
+        if (!insert_file.is_open()) {
+            std::cerr << "[错误] 无法创建 " << insert_request_path << std::endl;
+            return false;
+        }
+        
+        insert_file << Json::writeString(writer, insert_json);
+        insert_file.close();
+        std::cout << "[成功] insert.json 已生成: " << insert_request_path << std::endl;
+    }
     
     // 3. 生成并保存元数据到 MetaFiles 目录
     Json::Value metadata;
     metadata["file_id"] = file_id;
     metadata["original_file"] = abs_str;
     metadata["encrypted_file"] = enc_file;
+    metadata["insert_request"] = insert_request_path;
     metadata["keywords"] = Json::Value(Json::arrayValue);
     for (const auto& kw : keywords) {
         metadata["keywords"].append(kw);
@@ -834,8 +886,10 @@ bool StorageClient::encryptFile(const std::string& file_path,
     
     std::cout << "\n[完成] 文件加密成功" << std::endl;
     std::cout << "📦 生成的文件:" << std::endl;
-    std::cout << "   - " << enc_file << std::endl;
-    std::cout << "   - " << insert_json_path << std::endl;
+    if (!insert_bundle_mode_) {
+        std::cout << "   - " << enc_file << std::endl;
+    }
+    std::cout << "   - " << insert_request_path << std::endl;
     std::cout << "   - " << metadata_file << std::endl;
     std::cout << "   - " << KEYWORD_STATES_FILE << " (已自动更新)" << std::endl;
     
@@ -855,9 +909,17 @@ bool StorageClient::decryptFile(const std::string& encrypted_file,
     
     std::cout << "\n[文件解密] 开始解密文件: " << encrypted_file << std::endl;
     
-    // 读取加密文件
+    // 读取加密文件（插入请求包只取出其中的密文部分）
     std::vector<unsigned char> ciphertext;
-    if (!readFile(encrypted_file, ciphertext)) {
+    if (insert_bundle::is_bundle(encrypted_file)) {
+        insert_bundle::Bundle bundle;
+        std::string error;
+        if (!insert_bundle::read(encrypted_file, bundle, error)) {
+            std::cerr << "[错误] 插入请求包读取失败: " << error << std::endl;
+            return false;
+        }
+        ciphertext.assign(bundle.ciphertext.begin(), bundle.ciphertext.end());
+    } else if (!readFile(encrypted_file, ciphertext)) {
         return false;
     }
     std::cout << "[解密] 密文大小: " << ciphertext.size() << " 字节" << std::endl;
@@ -984,55 +1046,37 @@ bool StorageClient::decryptFileData(const std::vector<unsigned char>& ciphertext
 bool StorageClient::generateAuthTags(const std::string& file_id,
                                     const std::vector<unsigned char>& ciphertext,
                                     std::vector<std::string>& auth_tags) {
-    // 将密文分块
-    auto blocks = splitIntoBlocks(ciphertext, BLOCK_SIZE);
+    // 按块直接读取密文（末块补零），临时变量全部来自scratch
+    PbcScratchPool::Lease scratch = scratch_pool_.acquire(pairing_);
+    size_t num_blocks = (ciphertext.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
     auth_tags.clear();
+    auth_tags.reserve(num_blocks);
     
-    for (size_t i = 0; i < blocks.size(); ++i) {
+    for (size_t i = 0; i < num_blocks; ++i) {
         // σ_i = [H_2(ID_F||i) * ∏_{j=1}^s μ^{c_{i,j}}]^sk
         
-        element_t sigma;
-        element_init_G1(sigma, pairing_);
-        
-        // 计算 H_2(ID_F||i)
-        std::string hash_input = file_id + std::to_string(i);
-        element_t h2_result;
-        element_init_G1(h2_result, pairing_);
-        computeHashH2(hash_input, h2_result);
-        
-        element_set(sigma, h2_result);
+        // 计算 H_2(ID_F||i)，sigma 从 H_2 结果开始累乘
+        scratch->text.assign(file_id);
+        scratch->text.append(std::to_string(i));
+        computeHashH2(scratch->text, scratch->aux);
         
         // 计算 ∏_{j=1}^s μ^{c_{i,j}}
-        auto sectors = splitIntoBlocks(blocks[i], SECTOR_SIZE);
+        const unsigned char* block = scratch->padded_block(
+            ciphertext.data(), ciphertext.size(), i, BLOCK_SIZE);
         
-        for (size_t j = 0; j < sectors.size(); ++j) {
+        for (size_t j = 0; j < SECTORS_PER_BLOCK; ++j) {
             // 将扇区数据转换为整数
-            mpz_t c_ij;
-            mpz_init(c_ij);
-            mpz_import(c_ij, sectors[j].size(), 1, 1, 0, 0, sectors[j].data());
-            
-            // 计算 μ^{c_{i,j}}
-            element_t mu_power;
-            element_init_G1(mu_power, pairing_);
-            element_pow_mpz(mu_power, mu_, c_ij);
-            
-            // 累乘到sigma
-            element_mul(sigma, sigma, mu_power);
+            mpz_import(scratch->c_ij, SECTOR_SIZE, 1, 1, 0, 0, block + j * SECTOR_SIZE);
             
-            element_clear(mu_power);
-            mpz_clear(c_ij);
+            // 计算 μ^{c_{i,j}} 并累乘到sigma
+            element_pow_mpz(scratch->pow, mu_, scratch->c_ij);
+            element_mul(scratch->aux, scratch->aux, scratch->pow);
         }
         
         // 计算 [...]^sk
-        element_t final_sigma;
-        element_init_G1(final_sigma, pairing_);
-        element_pow_mpz(final_sigma, sigma, sk_);
+        element_pow_mpz(scratch->pow, scratch->aux, sk_);
         
-        auth_tags.push_back(serializeElement(final_sigma));
-        
-        element_clear(final_sigma);
-        element_clear(sigma);
-        element_clear(h2_result);
+        auth_tags.push_back(serializeElement(scratch->pow, scratch->bytes));
     }
     
     return true;
@@ -1047,51 +1091,31 @@ bool StorageClient::generateKeywordAssociatedTag(const std::string& file_id,
                                                 const std::string& current_state,
                                                 const std::string& previous_state,
                                                 std::string& kt_output) {
-    element_t kt;
-    element_init_G1(kt, pairing_);
+    PbcScratchPool::Lease scratch = scratch_pool_.acquire(pairing_);
     
     // 计算 H_2(ID_F)
-    element_t h2_id;
-    element_init_G1(h2_id, pairing_);
-    computeHashH2(file_id, h2_id);
-    
-    element_set(kt, h2_id);
+    computeHashH2(file_id, scratch->aux);
     
     // 计算 H_2(st_d||Ti)
-    element_t h2_current;
-    element_init_G1(h2_current, pairing_);
-    computeHashH2(Ti + current_state, h2_current);
+    scratch->text.assign(Ti);
+    scratch->text.append(current_state);
+    computeHashH2(scratch->text, scratch->hash);
     
-    element_mul(kt, kt, h2_current);
+    element_mul(scratch->aux, scratch->aux, scratch->hash);
     
     if (previous_state != current_state) {
         // 有前一状态: 除以 H_2(st_{d-1}||Ti)
-        element_t h2_previous;
-        element_init_G1(h2_previous, pairing_);
-        computeHashH2(Ti + previous_state, h2_previous);
-        
-        // 计算逆元
-        element_t h2_prev_inv;
-        element_init_G1(h2_prev_inv, pairing_);
-        element_invert(h2_prev_inv, h2_previous);
+        scratch->text.assign(Ti);
+        scratch->text.append(previous_state);
+        computeHashH2(scratch->text, scratch->hash);
         
-        element_mul(kt, kt, h2_prev_inv);
-        
-        element_clear(h2_prev_inv);
-        element_clear(h2_previous);
+        element_div(scratch->aux, scratch->aux, scratch->hash);
     }
     
     // 计算 [...]^sk
-    element_t final_kt;
-    element_init_G1(final_kt, pairing_);
-    element_pow_mpz(final_kt, kt, sk_);
-    
-    kt_output = serializeElement(final_kt);
+    element_pow_mpz(scratch->pow, scratch->aux, sk_);
     
-    element_clear(final_kt);
-    element_clear(kt);
-    element_clear(h2_current);
-    element_clear(h2_id);
+    kt_output = serializeElement(scratch->pow, scratch->bytes);
     
     return true;
 }
@@ -1122,12 +1146,7 @@ std::string StorageClient::computeHashH3(const std::string& input) {
     SHA256(reinterpret_cast<const unsigned char*>(input.c_str()),
            input.length(), hash);
     
-    std::ostringstream oss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; ++i) {
-        oss << std::hex << std::setw(2) << std::setfill('0')
-            << static_cast<int>(hash[i]);
-    }
-    return oss.str();
+    return hex_codec::encode(hash, SHA256_DIGEST_LENGTH);
 }
 
 std::string StorageClient::generateSearchToken(const std::string& keyword) {
@@ -1175,12 +1194,7 @@ std::string StorageClient::generateRandomState() {
         return "";
     }
     
-    std::ostringstream oss;
-    for (int i = 0; i < 32; ++i) {
-        oss << std::hex << std::setw(2) << std::setfill('0')
-            << static_cast<int>(random_bytes[i]);
-    }
-    return oss.str();
+    return hex_codec::encode(random_bytes, 32);
 }
 
 std::string StorageClient::encryptPointer(const std::string& current_state_hash,
@@ -1197,10 +1211,11 @@ std::string StorageClient::encryptPointer(const std::string& current_state_hash,
     }
     
     // 从哈希中提取前32字节作为AES密钥
-    unsigned char key[32];
-    for (size_t i = 0; i < 32 && i * 2 < current_state_hash.length(); ++i) {
-        std::string byte_str = current_state_hash.substr(i * 2, 2);
-        key[i] = static_cast<unsigned char>(std::stoi(byte_str, nullptr, 16));
+    unsigned char key[32] = {0};
+    size_t key_hex_len = std::min<size_t>(current_state_hash.length(), 64) & ~static_cast<size_t>(1);
+    if (!hex_codec::decode(current_state_hash.data(), key_hex_len, key)) {
+        EVP_CIPHER_CTX_free(ctx);
+        return "";
     }
     
     unsigned char iv[16] = {0}; // 使用零IV
@@ -1237,14 +1252,12 @@ std::string StorageClient::encryptPointer(const std::string& current_state_hash,
 std::string StorageClient::generateStateAssociatedToken(const std::string& Ti, 
                                                        const std::string& st_d) {
     // 计算 H_2(Ti||st_d)
-    element_t result;
-    element_init_G1(result, pairing_);
-    computeHashH2(Ti + st_d, result);
-    
-    std::string serialized = serializeElement(result);
-    element_clear(result);
+    PbcScratchPool::Lease scratch = scratch_pool_.acquire(pairing_);
+    scratch->text.assign(Ti);
+    scratch->text.append(st_d);
+    computeHashH2(scratch->text, scratch->hash);
     
-    return serialized;
+    return serializeElement(scratch->hash, scratch->bytes);
 }
 
 // ============================================================================
@@ -1440,43 +1453,29 @@ std::vector<std::vector<unsigned char>> StorageClient::splitIntoBlocks(
 
 // 元素到字符串的序列化与反序列化
 std::string StorageClient::serializeElement(element_t elem) {
-    int len = element_length_in_bytes(elem);
-    std::vector<unsigned char> buf(len);
-    element_to_bytes(buf.data(), elem);
-    return bytesToHex(buf);
+    std::vector<unsigned char> buf;
+    return serializeElement(elem, buf);
+}
+
+std::string StorageClient::serializeElement(element_t elem, std::vector<unsigned char>& buf) {
+    return element_codec::encode(elem, element_format_, buf);
 }
 
 bool StorageClient::deserializeElement(const std::string& hex_str, element_t elem) {
-    if (hex_str.length() % 2 != 0) {
-        return false;
-    }
-    
+    // 按长度自动识别未压缩hex / 压缩base64
     std::vector<unsigned char> bytes;
-    bytes = hexToBytes(hex_str);
-    int bytes_read = element_from_bytes(elem, bytes.data());
-    if (bytes_read <= 0) {
-        return false;
-    }
-    return true;
+    return element_codec::decode(hex_str, elem, bytes);
 }
 
 
 std::string StorageClient::bytesToHex(const std::vector<unsigned char>& bytes) {
-    std::ostringstream oss;
-    for (unsigned char byte : bytes) {
-        oss << std::hex << std::setw(2) << std::setfill('0')
-            << static_cast<int>(byte);
-    }
-    return oss.str();
+    return hex_codec::encode(bytes.data(), bytes.size());
 }
 
 std::vector<unsigned char> StorageClient::hexToBytes(const std::string& hex_str) {
+    // 非法输入（奇数长度或非hex字符）返回空
     std::vector<unsigned char> bytes;
-    for (size_t i = 0; i < hex_str.length(); i += 2) {
-        std::string byte_str = hex_str.substr(i, 2);
-        unsigned char byte = static_cast<unsigned char>(std::stoi(byte_str, nullptr, 16));
-        bytes.push_back(byte);
-    }
+    hex_codec::decode(hex_str, bytes);
     return bytes;
 }
 
@@ -1533,6 +1532,7 @@ bool StorageClient::deleteFile(const std::string& file_id) {
     root["PK"] = pk_serialized;
     root["ID_F"] = file_id;
     root["del"] = del_serialized;
+    root["element_format"] = element_codec::format_name(element_format_);
     
     // 6. 写入文件（直接覆盖同名文件）
     std::string output_path = DELES_DIR + "/" + file_id + ".json";
@@ -1566,7 +1566,7 @@ bool StorageClient::deleteFile(const std::string& file_id) {
 // v4.2新增：搜索令牌生成函数
 // ============================================================================
 
-bool StorageClient::searchKeyword(const std::string& keyword) {
+bool StorageClient::searchKeyword(const std::string& keyword, int limit, const std::string& cursor, int page) {
     std::cout << "\n[搜索令牌] 开始生成搜索令牌..." << std::endl;
     
     // 1. 检查初始化状态
@@ -1611,6 +1611,14 @@ bool StorageClient::searchKeyword(const std::string& keyword) {
     root["T"] = search_token;
     root["std"] = current_state;
     root["PK"] = pk_serialized;
+    root["element_format"] = element_codec::format_name(element_format_);
+    if (limit > 0) {
+        root["limit"] = limit;
+    }
+    if (!cursor.empty()) {
+        root["cursor"] = cursor;
+        root["page"] = page;
+    }
     
     // 6. 写入文件（直接覆盖同名文件）
     std::string output_path = SEARCH_DIR + "/" + keyword + ".json";
@@ -1637,6 +1645,10 @@ bool StorageClient::searchKeyword(const std::string& keyword) {
     std::cout << "   - T: 搜索令牌 (" << search_token.substr(0, 16) << "...)" << std::endl;
     std::cout << "   - std: 当前状态 " << (current_state.empty() ? "(空)" : "(" + current_state.substr(0, 16) + "...)") << std::endl;
     std::cout << "   - PK: 公钥" << std::endl;
+    if (limit > 0) {
+        std::cout << "   - limit: " << limit
+                  << (cursor.empty() ? " (第一页)" : " (第 " + std::to_string(page + 1) + " 页)") << std::endl;
+    }
     
     return true;
 }
@@ -11,6 +11,10 @@
 #include <pbc/pbc.h>
 #include <jsoncpp/json/json.h>
 #include <functional>
+#include "../common/pbc_scratch.h"
+#include "../common/hex_codec.h"
+#include "../common/element_codec.h"
+#include "../common/insert_bundle.h"
 
 // ==================== 性能监控回调结构体 ====================
 /**
@@ -99,8 +103,8 @@ public:
      * 1. 自动提取原始文件名
      * 2. 检查文件是否存在，存在则添加时间戳后缀
      * 3. 自动保存到对应目录：
-     *    - EncFiles/[filename].enc
-     *    - Insert/[filename]_insert.json
+     *    - Insert/[filename].vdsb（二进制插入请求包，默认）
+     *      或 EncFiles/[filename].enc + Insert/[filename]_insert.json（旧版格式）
      *    - MetaFiles/[filename]_metadata.json
      * 4. 自动更新 ./data/keyword_states.json
      * 
@@ -111,7 +115,7 @@ public:
     
     /**
      * @brief 解密文件
-     * @param encrypted_file 加密文件路径
+     * @param encrypted_file 加密文件路径（.enc 或 .vdsb 插入请求包）
      * @param output_path 输出文件路径
      * @return 成功返回true
      */
@@ -146,8 +150,14 @@ public:
      * 注意：
      * - 如果关键词不存在状态，std设为空字符串
      * - 同名文件存在时直接覆盖
+     * 
+     * 分页：
+     * - limit > 0 时节点在命中 limit 个有效文件后停止（链表由新到旧）
+     * - cursor 为上一页证明返回的 cursor，非空时从该状态继续
+     * - page 为页序号（第一页为0），续页须为上一页证明的 page + 1，节点按页序号命名证明文件
      */
-    bool searchKeyword(const std::string& keyword);
+    bool searchKeyword(const std::string& keyword, int limit = 0, const std::string& cursor = "",
+                       int page = 0);
     
     /**
      * @brief 获取公钥
@@ -251,6 +261,34 @@ public:
     void setPerformanceCallback_c(PerformanceCallback_c* callback) {
         perf_callback_c = callback;
     }
+    
+    /**
+     * @brief 设置G1元素的输出格式（PK、TS_F、kt_wi、Ti_bar、del）
+     * @param format 默认 CompressedBase64；UncompressedHex 与旧版节点兼容
+     * 
+     * 所用格式写入 insert.json / 搜索与删除请求的 element_format 字段，
+     * 存储节点据此转换为其数据库格式。
+     */
+    void setElementFormat(ElementFormat format) {
+        element_format_ = format;
+    }
+    
+    ElementFormat getElementFormat() const {
+        return element_format_;
+    }
+    
+    /**
+     * @brief 设置插入请求的输出形式
+     * @param enabled true（默认）写出单个 Insert/<name>.vdsb 二进制请求包；
+     *                false 写出旧版 EncFiles/<name>.enc + Insert/<name>_insert.json
+     */
+    void setInsertBundleMode(bool enabled) {
+        insert_bundle_mode_ = enabled;
+    }
+    
+    bool getInsertBundleMode() const {
+        return insert_bundle_mode_;
+    }
 
 private:
     // ============ 密码学操作 ============
@@ -346,6 +384,7 @@ private:
         size_t block_size);
     
     std::string serializeElement(element_t elem);
+    std::string serializeElement(element_t elem, std::vector<unsigned char>& buf);  // 复用buf
     
     bool deserializeElement(const std::string& hex_str, element_t elem);
     
@@ -385,6 +424,15 @@ private:
     unsigned char ek_[32];  // 加密密钥（随机生成）
     element_t pk_;          // 公钥（计算得到：pk = g^sk）
     
+    // 标签生成内核复用的临时变量（须在 pairing_clear 之前清空）
+    PbcScratchPool scratch_pool_;
+    
+    // 元素序列化格式（见 setElementFormat）
+    ElementFormat element_format_ = ElementFormat::CompressedBase64;
+    
+    // 插入请求输出形式（见 setInsertBundleMode）
+    bool insert_bundle_mode_ = true;
+    
     // 关键词状态管理（前向安全）
     std::map<std::string, std::string> keyword_states_;  // 关键词->当前状态
     std::string keyword_states_file_;    // 当前加载的状态文件路径
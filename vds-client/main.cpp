@@ -81,9 +81,9 @@ void printInitializationGuide() {
 void printDataDirectoryStructure() {
     std::cout << "\n📂 数据目录结构:" << std::endl;
     std::cout << "./data/" << std::endl;
-    std::cout << "├── Insert/           # insert.json 文件（供 Storage Node）" << std::endl;
+    std::cout << "├── Insert/           # 插入请求包 .vdsb（供 Storage Node）" << std::endl;
     std::cout << "├── Deles/            # 删除令牌文件 (v4.2新增)" << std::endl;
-    std::cout << "├── EncFiles/         # 加密文件 (.enc)" << std::endl;
+    std::cout << "├── EncFiles/         # 加密文件 (.enc，旧版插入格式)" << std::endl;
     std::cout << "├── MetaFiles/        # 元数据文件" << std::endl;
     std::cout << "├── Search/           # 搜索令牌文件" << std::endl;
     std::cout << "└── keyword_states.json  # 关键词状态（自动维护）\n" << std::endl;